@@ -46,10 +46,15 @@ public:
 
     virtual void blockUntilWriteComplete() override
     {
-        while (!digitalRead(CTS))
+        while (!isWriteComplete())
             ;
     }
 
+    virtual bool isWriteComplete() override
+    {
+        return digitalRead(CTS);
+    }
+
     virtual tcb::span<uint8_t> requestBuffer(const uint8_t index) override
     {
         switch (index)
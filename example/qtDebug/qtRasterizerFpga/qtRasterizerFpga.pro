@@ -34,6 +34,7 @@ SOURCES += main.cpp\
     $${RIXGL_PATH}/pixelpipeline/PixelPipeline.cpp \
     $${RIXGL_PATH}/glImpl.cpp \
     $${RIXGL_PATH}/renderer/Rasterizer.cpp \
+    $${RIXGL_PATH}/renderer/CoarseDepthBuffer.cpp \
     $${RIXGL_PATH}/renderer/Renderer.cpp \
     $${RIXGL_PATH}/pixelpipeline/Fogging.cpp \
     $${RIXGL_PATH}/pixelpipeline/Texture.cpp \
@@ -70,6 +71,8 @@ QMAKE_CFLAGS += -I$${PATH_PREFIX}/lib/3rdParty/span/include/
 DEFINES += RIX_CORE_TMU_COUNT=2
 DEFINES += RIX_CORE_MAX_TEXTURE_SIZE=256
 DEFINES += RIX_CORE_ENABLE_MIPMAPPING=true
+DEFINES += RIX_CORE_ENABLE_TEXTURE_COMPRESSION=true
+DEFINES += RIX_CORE_ENABLE_PALETTED_TEXTURES=true
 # Display Settings
 DEFINES += RIX_CORE_MAX_DISPLAY_WIDTH=640
 DEFINES += RIX_CORE_MAX_DISPLAY_HEIGHT=480
@@ -90,6 +93,8 @@ DEFINES += RIX_CORE_DEPTH_BUFFER_LOC=0x01A00000
 DEFINES += RIX_CORE_STENCIL_BUFFER_LOC=0x01900000
 DEFINES += RIX_CORE_THREADED_RASTERIZATION=true
 DEFINES += RIX_CORE_ENABLE_VSYNC=false
+DEFINES += RIX_CORE_COARSE_OCCLUSION_CULLING=false
+DEFINES += RIX_CORE_RELEASE_TEXTURE_HOST_COPIES=false
 equals(VARIANT, "RasterIX_IF") {
     DEFINES += RIX_CORE_FRAMEBUFFER_SIZE_IN_PIXEL_LG=15
 }
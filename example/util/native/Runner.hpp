@@ -13,7 +13,7 @@ public:
     Runner()
     {
         spdlog::set_level(spdlog::level::trace);
-        rr::RIXGL::createInstance(m_busConnector, m_workerThread, m_uploadThread);
+        rr::RIXGL::createInstance(m_busConnector, m_workerThread, m_uploadThread, { &m_vertexThreads[0], &m_vertexThreads[1] });
         rr::RIXGL::getInstance().setRenderResolution(RESOLUTION_W, RESOLUTION_H);
     }
 
@@ -38,5 +38,6 @@ private:
     rr::FT60XBusConnector m_busConnector {};
     rr::MultiThreadRunner m_workerThread {};
     rr::MultiThreadRunner m_uploadThread {};
+    std::array<rr::MultiThreadRunner, 2> m_vertexThreads {};
     Scene m_scene {};
 };
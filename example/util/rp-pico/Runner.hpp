@@ -50,10 +50,15 @@ public:
 
     virtual void blockUntilWriteComplete() override
     {
-        while (dma_channel_is_busy(dma_tx) || !gpio_get(CTS))
+        while (!isWriteComplete())
             ;
     }
 
+    virtual bool isWriteComplete() override
+    {
+        return !dma_channel_is_busy(dma_tx) && gpio_get(CTS);
+    }
+
     virtual tcb::span<uint8_t> requestBuffer(const uint8_t index) override
     {
         switch (index)
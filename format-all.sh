@@ -12,6 +12,7 @@ declare -a files=(
     example/stencilShadow
     example/util
     example/platformio
+    tools
 )
 
 for i in "${files[@]}"
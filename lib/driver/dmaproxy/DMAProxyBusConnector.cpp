@@ -21,8 +21,6 @@
 namespace rr
 {
 
-const std::size_t DMAProxyBusConnector::INVALID_BUFFER { BUFFER_SIZE + 1 };
-
 DMAProxyBusConnector::DMAProxyBusConnector()
 {
     const char* tx_channel_names[] = { "dma_proxy_tx" };
@@ -58,7 +56,9 @@ void DMAProxyBusConnector::writeData(const uint8_t index, const uint32_t size)
         SPDLOG_ERROR("Index {} out of bounds.", index);
         return;
     }
-    blockUntilWriteComplete();
+    // The driver tracks the completion of each buffer. Transfers of other buffers stay queued in the
+    // DMA channel and are executed in order. Only the transfer of this buffer must be finished.
+    blockUntilBufferIsFree(index);
     int buffer_id = index;
     m_txChannel.buf_ptr[buffer_id].length = size;
     ioctl(m_txChannel.fd, START_XFER, &buffer_id);
@@ -66,12 +66,61 @@ void DMAProxyBusConnector::writeData(const uint8_t index, const uint32_t size)
     {
         SPDLOG_ERROR("Proxy tx transfer error");
     }
-    m_busyBufferId = index;
+    m_busyBuffers.set(index);
 }
 
 void DMAProxyBusConnector::blockUntilWriteComplete()
 {
-    waitForDma();
+    for (uint8_t i = 0; i < BUFFER_COUNT; i++)
+    {
+        blockUntilBufferIsFree(i);
+    }
+}
+
+bool DMAProxyBusConnector::isWriteComplete()
+{
+    for (uint8_t i = 0; i < BUFFER_COUNT; i++)
+    {
+        if (!isBufferFree(i))
+            return false;
+    }
+    return true;
+}
+
+bool DMAProxyBusConnector::canQueueTransfers() const
+{
+    return true;
+}
+
+void DMAProxyBusConnector::blockUntilBufferIsFree(const uint8_t index)
+{
+    if (!m_busyBuffers.test(index))
+        return;
+    int buffer_id = index;
+    ioctl(m_txChannel.fd, FINISH_XFER, &buffer_id);
+    if (m_txChannel.buf_ptr[buffer_id].status != channel_buffer::proxy_status::PROXY_NO_ERROR)
+    {
+        SPDLOG_ERROR("Proxy tx transfer error");
+    }
+    m_busyBuffers.reset(index);
+}
+
+bool DMAProxyBusConnector::isBufferFree(const uint8_t index)
+{
+    if (!m_busyBuffers.test(index))
+        return true;
+    int buffer_id = index;
+    ioctl(m_txChannel.fd, POLL_XFER, &buffer_id);
+    const channel_buffer::proxy_status status = m_txChannel.buf_ptr[buffer_id].status;
+    if (status == channel_buffer::proxy_status::PROXY_BUSY)
+        return false;
+    if (status != channel_buffer::proxy_status::PROXY_NO_ERROR)
+    {
+        SPDLOG_ERROR("Proxy tx transfer error");
+    }
+    // The driver has already finished the transfer, it must not be finished again with blockUntilBufferIsFree()
+    m_busyBuffers.reset(index);
+    return true;
 }
 
 tcb::span<uint8_t> DMAProxyBusConnector::requestBuffer(const uint8_t index)
@@ -90,12 +139,4 @@ uint8_t DMAProxyBusConnector::getBufferCount() const
     return BUFFER_COUNT;
 }
 
-void DMAProxyBusConnector::waitForDma()
-{
-    if (m_busyBufferId == INVALID_BUFFER)
-        return;
-    ioctl(m_txChannel.fd, FINISH_XFER, &m_busyBufferId);
-    m_busyBufferId = INVALID_BUFFER;
-}
-
 } // namespace rr
\ No newline at end of file
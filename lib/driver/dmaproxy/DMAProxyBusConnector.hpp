@@ -20,6 +20,7 @@
 
 #include "IBusConnector.hpp"
 #include <atomic>
+#include <bitset>
 
 struct channel_buffer;
 namespace rr
@@ -33,6 +34,10 @@ public:
 
     virtual void writeData(const uint8_t index, const uint32_t size) override;
     virtual void blockUntilWriteComplete() override;
+    virtual bool isWriteComplete() override;
+    virtual bool canQueueTransfers() const override;
+    virtual void blockUntilBufferIsFree(const uint8_t index) override;
+    virtual bool isBufferFree(const uint8_t index) override;
     virtual tcb::span<uint8_t> requestBuffer(const uint8_t index) override;
     virtual uint8_t getBufferCount() const override;
 
@@ -43,12 +48,9 @@ private:
         int fd;
     };
 
-    void waitForDma();
-
-    static const std::size_t INVALID_BUFFER;
     Channel m_txChannel;
     tcb::span<uint8_t> m_tmpBuffer {};
-    std::size_t m_busyBufferId { INVALID_BUFFER };
+    std::bitset<256> m_busyBuffers {}; ///< Buffers which are queued in the DMA channel
 };
 
 } // namespace rr
@@ -262,6 +262,20 @@ static void wait_for_transfer(struct dma_proxy_channel* pchannel_p)
         pchannel_p->buffer_table_p[bdindex].status = PROXY_NO_ERROR;
 }
 
+/* Check without blocking if a DMA transfer which was previously submitted to the DMA engine is finished.
+ * The status is PROXY_BUSY as long as the transfer is ongoing. Otherwise the transfer is finished like
+ * with wait_for_transfer and must not be finished again.
+ */
+static void poll_transfer(struct dma_proxy_channel* pchannel_p)
+{
+    int bdindex = pchannel_p->bdindex;
+
+    if (completion_done(&pchannel_p->bdtable[bdindex].cmp))
+        wait_for_transfer(pchannel_p);
+    else
+        pchannel_p->buffer_table_p[bdindex].status = PROXY_BUSY;
+}
+
 /* The following functions are designed to test the driver from within the device
  * driver without any user space. It uses the first channel buffer for the transmit and receive.
  * If this works but the user application does not then the user application is at fault.
@@ -391,6 +405,9 @@ static long ioctl(struct file* file, unsigned int cmd, unsigned long arg)
         start_transfer(pchannel_p);
         wait_for_transfer(pchannel_p);
         break;
+    case POLL_XFER:
+        poll_transfer(pchannel_p);
+        break;
     }
 
     return 0;
@@ -33,6 +33,7 @@
 #define FINISH_XFER _IOW('a', 'a', int32_t*)
 #define START_XFER _IOW('a', 'b', int32_t*)
 #define XFER _IOR('a', 'c', int32_t*)
+#define POLL_XFER _IOW('a', 'd', int32_t*)
 
 struct channel_buffer
 {
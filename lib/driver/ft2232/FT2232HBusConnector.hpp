@@ -88,6 +88,11 @@ public:
     {
     }
 
+    virtual bool isWriteComplete() override
+    {
+        return true;
+    }
+
 private:
     FT_HANDLE fthandle;
     FT_HANDLE fthandlegpio;
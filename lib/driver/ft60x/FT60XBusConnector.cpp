@@ -4,6 +4,11 @@ namespace rr
 {
 FT60XBusConnector::~FT60XBusConnector()
 {
+    blockUntilWriteComplete();
+    for (OVERLAPPED& overlapped : m_overlapped)
+    {
+        FT_ReleaseOverlapped(fthandle, &overlapped);
+    }
     FT_Close(fthandle);
 }
 
@@ -26,16 +31,87 @@ FT60XBusConnector::FT60XBusConnector()
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
     ftStatus = FT_WriteGPIO(fthandle, 0x3, 0x0);
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    m_overlapped.resize(getBufferCount());
+    for (OVERLAPPED& overlapped : m_overlapped)
+    {
+        ftStatus = FT_InitializeOverlapped(fthandle, &overlapped);
+        if (FT_FAILED(ftStatus))
+        {
+            printf("Failed to initialize overlapped write\r\n");
+        }
+    }
 }
 
 void FT60XBusConnector::writeData(const uint8_t index, const uint32_t size)
 {
+    // Only the previous write of this buffer must be completed, the writes of the other buffers stay outstanding
+    blockUntilBufferIsFree(index);
     ULONG transferred;
-    FT_WritePipe(fthandle, 0x2, (PUCHAR)(this->m_dlMem[index].data()), size, &transferred, NULL);
+    const FT_STATUS ftStatus = FT_WritePipe(fthandle, 0x2, (PUCHAR)(this->m_dlMem[index].data()), size, &transferred, &m_overlapped[index]);
+    if (ftStatus == FT_IO_PENDING)
+    {
+        m_pendingBuffers.set(index);
+    }
+    else if (FT_FAILED(ftStatus))
+    {
+        printf("Failed to write buffer %d (status %d)\r\n", index, static_cast<int>(ftStatus));
+    }
 }
 
 void FT60XBusConnector::blockUntilWriteComplete()
 {
+    for (uint8_t i = 0; i < getBufferCount(); i++)
+    {
+        blockUntilBufferIsFree(i);
+    }
+}
+
+bool FT60XBusConnector::isWriteComplete()
+{
+    for (uint8_t i = 0; i < getBufferCount(); i++)
+    {
+        if (!isBufferFree(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FT60XBusConnector::canQueueTransfers() const
+{
+    return true;
+}
+
+void FT60XBusConnector::blockUntilBufferIsFree(const uint8_t index)
+{
+    finishWrite(index, true);
+}
+
+bool FT60XBusConnector::isBufferFree(const uint8_t index)
+{
+    finishWrite(index, false);
+    return !m_pendingBuffers.test(index);
+}
+
+void FT60XBusConnector::finishWrite(const uint8_t index, const bool wait)
+{
+    if (!m_pendingBuffers.test(index))
+    {
+        return;
+    }
+    ULONG transferred;
+    const FT_STATUS ftStatus = FT_GetOverlappedResult(fthandle, &m_overlapped[index], &transferred, wait);
+    if (ftStatus == FT_IO_INCOMPLETE)
+    {
+        return;
+    }
+    if (FT_FAILED(ftStatus))
+    {
+        printf("Failed to write buffer %d (status %d)\r\n", index, static_cast<int>(ftStatus));
+    }
+    m_pendingBuffers.reset(index);
 }
 
 } // namespace rr
\ No newline at end of file
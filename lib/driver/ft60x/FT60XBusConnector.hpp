@@ -1,8 +1,10 @@
 #ifndef FT60XBUSCONNECTOR_H
 #define FT60XBUSCONNECTOR_H
 
+#include <bitset>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include "GenericMemoryBusConnector.hpp"
 #include <ftd3xx.h>
@@ -14,6 +16,9 @@ namespace rr
 // Bus connector to use an FT600 chip configured in the FT245 FIFO mode.
 // Important: Before you use this class, configure the FT600 in the FT245 FIFO mode with FT60X Chip Configuration Programmer. Otherwise, it will not work.
 // This class uses GPIO0 to reset the FPGA
+// The buffers are written with overlapped writes. Each buffer has its own OVERLAPPED structure, so that a
+// write of every buffer can be outstanding. The driver executes them in order, which keeps the USB busy while
+// the next display list is built. A buffer is reused when its write is completed.
 class FT60XBusConnector : public GenericMemoryBusConnector<11, 8 * 1024 * 1024>
 {
 public:
@@ -23,9 +28,17 @@ public:
 
     virtual void writeData(const uint8_t index, const uint32_t size) override;
     virtual void blockUntilWriteComplete() override;
+    virtual bool isWriteComplete() override;
+    virtual bool canQueueTransfers() const override;
+    virtual void blockUntilBufferIsFree(const uint8_t index) override;
+    virtual bool isBufferFree(const uint8_t index) override;
 
 private:
+    void finishWrite(const uint8_t index, const bool wait);
+
     FT_HANDLE fthandle;
+    std::vector<OVERLAPPED> m_overlapped {}; ///< One per buffer
+    std::bitset<256> m_pendingBuffers {}; ///< Buffers with an outstanding write
 };
 
 } // namespace rr
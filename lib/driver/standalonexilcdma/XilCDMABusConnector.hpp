@@ -4,6 +4,7 @@
 #include "xil_printf.h"
 #include "xparameters.h"
 #include <array>
+#include <cstring>
 #include <tcb/span.hpp>
 #include <xil_cache.h>
 
@@ -66,6 +67,21 @@ public:
         waitForDma();
     }
 
+    virtual bool isWriteComplete()
+    {
+        return !XAxiDma_Busy(&AxiDma, XAXIDMA_DMA_TO_DEVICE);
+    }
+
+    virtual bool canReadData() const { return true; }
+
+    virtual bool readData(const uint32_t addr, tcb::span<uint8_t> data)
+    {
+        // The device memory is shared with the CPU. Stale lines must be removed from the cache before reading.
+        Xil_DCacheInvalidateRange(static_cast<UINTPTR>(addr), data.size());
+        std::memcpy(data.data(), reinterpret_cast<const uint8_t*>(static_cast<UINTPTR>(addr)), data.size());
+        return true;
+    }
+
     virtual tcb::span<uint8_t> requestBuffer(const uint8_t index) { return { m_dlMem[index] }; }
     virtual uint8_t getBufferCount() const { return m_dlMem.size(); }
 
@@ -54,6 +54,11 @@ public:
     {
     }
 
+    virtual bool isWriteComplete() override
+    {
+        return true;
+    }
+
     void clk()
     {
         m_top.aclk = 1;
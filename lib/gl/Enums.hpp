@@ -116,7 +116,12 @@ enum class PixelFormat
 {
     RGBA4444,
     RGBA5551,
-    RGB565
+    RGB565,
+    RGB_DXT1,
+    RGBA_DXT1,
+    INDEX8_RGBA4444,
+    INDEX8_RGBA5551,
+    INDEX8_RGB565
 };
 
 enum class TexEnvMode
@@ -30,14 +30,42 @@ public:
     /// @brief Uploads a chunk of data
     /// @param index The index of the buffer to upload
     /// @param size How many bytes of this buffer to upload
-    /// @note: A new transfer is started when the previous one is finished.
-    ///     As long as the previous one is ongoing, this function blocks.
+    /// @note: The transfers are executed in the order of the calls. If the connector can't queue transfers
+    ///     (see canQueueTransfers()), a new transfer is started when the previous one is finished. As long as
+    ///     the previous one is ongoing, this function blocks. A connector which can queue transfers only blocks
+    ///     when the buffer itself is still transferred.
     virtual void writeData(const uint8_t index, const uint32_t size) = 0;
 
-    /// @brief Blocks until a new writeData() can be called without blocking.
-    ///     This also implies that the currently transferred buffer is free for reuse.
+    /// @brief Blocks until all transfers started with writeData() are finished.
+    ///     This also implies that all buffers are free for reuse.
     virtual void blockUntilWriteComplete() = 0;
 
+    /// @brief Checks without blocking if all transfers started with writeData() are finished.
+    /// @return true when no transfer is ongoing
+    virtual bool isWriteComplete() = 0;
+
+    /// @brief Returns if several transfers can be in flight. If not, only the buffer of the last transfer
+    ///     can still be in use when writeData() returns.
+    virtual bool canQueueTransfers() const { return false; }
+
+    /// @brief Blocks until the transfer of a buffer is finished. Afterwards the buffer is free for reuse.
+    ///     Connectors which can queue transfers must track the completion per buffer.
+    /// @param index The index of the buffer
+    virtual void blockUntilBufferIsFree(const uint8_t index)
+    {
+        (void)index;
+        blockUntilWriteComplete();
+    }
+
+    /// @brief Checks without blocking if the transfer of a buffer is finished.
+    /// @param index The index of the buffer
+    /// @return true when the buffer is not transferred
+    virtual bool isBufferFree(const uint8_t index)
+    {
+        (void)index;
+        return isWriteComplete();
+    }
+
     /// @brief Requests a buffer which supports the requirements for the given device (for instance DMA capabilities).
     /// @param index The index of the requested buffer
     /// @return Returns the requested buffer, or an empty optional if no buffer is available for the given index
@@ -46,6 +74,21 @@ public:
     /// @brief Returns the number of buffers available to request
     /// @return The number of buffers which can be requested
     virtual uint8_t getBufferCount() const = 0;
+
+    /// @brief Returns if the host can read the memory of the device with readData()
+    virtual bool canReadData() const { return false; }
+
+    /// @brief Reads the memory of the device. Only possible on systems where the host has access to the
+    ///     memory of the device, for instance the Zynq, where the device memory is part of the shared DDR.
+    /// @param addr The physical address of the data
+    /// @param data The buffer which receives the data
+    /// @return false if the device memory can't be read
+    virtual bool readData(const uint32_t addr, tcb::span<uint8_t> data)
+    {
+        (void)addr;
+        (void)data;
+        return false;
+    }
 };
 
 } // namespace rr
@@ -0,0 +1,369 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef GL_MIPMAP_GENERATOR_HPP_
+#define GL_MIPMAP_GENERATOR_HPP_
+
+#include "pixelpipeline/Texture.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace rr
+{
+
+/// @brief Generates the mipmap levels of a texture (GL_GENERATE_MIPMAP, glGenerateMipmap).
+/// The levels are calculated with a 2x2 box filter directly from the already converted texels of level 0.
+class MipmapGenerator
+{
+public:
+    /// @brief Prepares the generation of the levels 1..n of the bound texture from level 0. The levels
+    ///     get their new sizes and memory immediately, the texels are calculated by the returned job.
+    ///     The job must run after the job which writes level 0.
+    /// @param texture The texture unit with the bound texture
+    /// @param xoffset Horizontal offset of the changed region of level 0
+    /// @param yoffset Vertical offset of the changed region of level 0
+    /// @param width Width of the changed region of level 0
+    /// @param height Height of the changed region of level 0
+    ///     Only the texels which depend on the changed region are generated again. Levels which
+    ///     do not have the size or format of the generated level are generated completely.
+    /// @return The job which calculates the texels, or an empty function if the format of the
+    ///     texture does not allow the generation
+    static std::function<void()> generate(
+        Texture& texture,
+        const std::size_t xoffset,
+        const std::size_t yoffset,
+        const std::size_t width,
+        const std::size_t height)
+    {
+        TextureObjectMipmap& mipmap = texture.getTexture();
+        const TextureObject& base = mipmap[0];
+        if (!base.pixels || base.isCompressed() || base.isPaletted())
+        {
+            SPDLOG_WARN("generateMipmap is not possible with the format of the base level");
+            return {};
+        }
+        switch (base.getPixelFormat())
+        {
+        case PixelFormat::RGB565:
+            return generateLevels<Rgb565>(texture, mipmap, xoffset, yoffset, width, height);
+        case PixelFormat::RGBA4444:
+            return generateLevels<Rgba4444>(texture, mipmap, xoffset, yoffset, width, height);
+        case PixelFormat::RGBA5551:
+            return generateLevels<Rgba5551>(texture, mipmap, xoffset, yoffset, width, height);
+        default:
+            SPDLOG_WARN("generateMipmap is not possible with the format of the base level");
+            return {};
+        }
+    }
+
+private:
+    /// @brief Region of a level, x1 and y1 are exclusive
+    struct Region
+    {
+        std::size_t x0;
+        std::size_t y0;
+        std::size_t x1;
+        std::size_t y1;
+    };
+
+    /// @brief Calculation of the changed region of one level
+    struct Level
+    {
+        std::shared_ptr<const uint16_t> src; ///< The previous level
+        std::size_t srcWidth;
+        std::size_t srcHeight;
+        std::shared_ptr<uint16_t> dst;
+        std::shared_ptr<const uint16_t> kept; ///< The old texels outside of the region, if the level is kept
+        std::size_t dstWidth;
+        std::size_t dstHeight;
+        Region region;
+    };
+
+    template <typename Format>
+    static std::function<void()> generateLevels(
+        Texture& texture,
+        TextureObjectMipmap& mipmap,
+        const std::size_t xoffset,
+        const std::size_t yoffset,
+        const std::size_t width,
+        const std::size_t height)
+    {
+        std::vector<Level> levels {};
+        Region region {
+            (std::min)(xoffset, mipmap[0].width),
+            (std::min)(yoffset, mipmap[0].height),
+            (std::min)(xoffset + width, mipmap[0].width),
+            (std::min)(yoffset + height, mipmap[0].height)
+        };
+        bool stopped = false;
+        std::size_t level = 1;
+        for (; (level < mipmap.size()) && ((mipmap[level - 1].width > 1) || (mipmap[level - 1].height > 1)); level++)
+        {
+            const TextureObject& src = mipmap[level - 1];
+            TextureObject& dst = mipmap[level];
+            const std::size_t dstWidth = (std::max)(src.width / 2, static_cast<std::size_t>(1));
+            const std::size_t dstHeight = (std::max)(src.height / 2, static_cast<std::size_t>(1));
+
+            const bool keepLevel = dst.pixels
+                && (dst.width == dstWidth)
+                && (dst.height == dstHeight)
+                && (dst.intendedPixelFormat == src.intendedPixelFormat);
+            if (keepLevel)
+            {
+                region = {
+                    region.x0 / 2,
+                    region.y0 / 2,
+                    (std::min)((region.x1 + 1) / 2, dstWidth),
+                    (std::min)((region.y1 + 1) / 2, dstHeight)
+                };
+            }
+            else
+            {
+                region = { 0, 0, dstWidth, dstHeight };
+            }
+            if ((region.x0 >= region.x1) || (region.y0 >= region.y1))
+            {
+                stopped = true;
+                break;
+            }
+
+            std::shared_ptr<uint16_t> pixels(new uint16_t[dstWidth * dstHeight], [](const uint16_t* p)
+                { delete[] p; });
+            if (!pixels)
+            {
+                SPDLOG_ERROR("generateMipmap Out Of Memory");
+                stopped = true;
+                break;
+            }
+            levels.push_back({ src.pixels,
+                src.width,
+                src.height,
+                pixels,
+                keepLevel ? dst.pixels : nullptr,
+                dstWidth,
+                dstHeight,
+                region });
+
+            dst.pixels = pixels;
+            dst.width = dstWidth;
+            dst.height = dstHeight;
+            dst.intendedPixelFormat = src.intendedPixelFormat;
+            texture.markTextureRegionDirty(level, region.x0, region.y0, region.x1 - region.x0, region.y1 - region.y0);
+        }
+
+        if (!stopped)
+        {
+            // Levels below the 1x1 level are not part of the texture anymore
+            for (; level < mipmap.size(); level++)
+            {
+                mipmap[level] = {};
+            }
+        }
+
+        return [levels = std::move(levels)]()
+        {
+            for (const Level& l : levels)
+            {
+                if (l.kept)
+                {
+                    std::memcpy(l.dst.get(), l.kept.get(), l.dstWidth * l.dstHeight * sizeof(uint16_t));
+                }
+                for (std::size_t y = l.region.y0; y < l.region.y1; y++)
+                {
+                    const uint16_t* row0 = l.src.get() + ((y * 2) * l.srcWidth);
+                    const uint16_t* row1 = (l.srcHeight > 1) ? (row0 + l.srcWidth) : row0;
+                    downsampleRow<Format>(l.dst.get() + (y * l.dstWidth), row0, row1, l.srcWidth, l.region.x0, l.region.x1);
+                }
+            }
+        };
+    }
+
+    /// @brief Filters two rows of the source level into one row of the destination level
+    /// @param dst The destination row
+    /// @param row0 The first source row
+    /// @param row1 The second source row. Equal to row0 if the source level has only one row.
+    /// @param srcWidth The width of the source level
+    /// @param x0 The first texel of the destination row
+    /// @param x1 The texel after the last texel of the destination row
+    template <typename Format>
+    static void downsampleRow(
+        uint16_t* __restrict dst,
+        const uint16_t* __restrict row0,
+        const uint16_t* __restrict row1,
+        const std::size_t srcWidth,
+        const std::size_t x0,
+        const std::size_t x1)
+    {
+        std::size_t x = x0;
+#if defined(__SSE2__)
+        for (; (x + 8) <= x1; x += 8)
+        {
+            const __m128i lo { Format::averageSse(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + (x * 2))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + (x * 2)))) };
+            const __m128i hi { Format::averageSse(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + (x * 2) + 8)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + (x * 2) + 8))) };
+            // Sign extend the 16 bit colors to let the saturating pack keep them unchanged
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16)));
+        }
+#elif defined(__ARM_NEON)
+        for (; (x + 8) <= x1; x += 8)
+        {
+            const uint16x8x2_t texels0 { vld2q_u16(row0 + (x * 2)) };
+            const uint16x8x2_t texels1 { vld2q_u16(row1 + (x * 2)) };
+            vst1q_u16(dst + x, Format::averageNeon(texels0.val[0], texels0.val[1], texels1.val[0], texels1.val[1]));
+        }
+#endif
+        for (; x < x1; x++)
+        {
+            const std::size_t xa = x * 2;
+            const std::size_t xb = (std::min)(xa + 1, srcWidth - 1);
+            dst[x] = Format::average(row0[xa], row0[xb], row1[xa], row1[xb]);
+        }
+    }
+
+    template <uint8_t Pos, uint8_t Size>
+    static uint16_t averageComponent(const uint16_t a, const uint16_t b, const uint16_t c, const uint16_t d)
+    {
+        static constexpr uint16_t Mask = (1 << Size) - 1;
+        const uint16_t sum = ((a >> Pos) & Mask) + ((b >> Pos) & Mask) + ((c >> Pos) & Mask) + ((d >> Pos) & Mask) + 2;
+        return static_cast<uint16_t>((sum >> 2) << Pos);
+    }
+
+#if defined(__SSE2__)
+    /// @brief Averages the components of the texel pairs in the 32 bit lanes of two rows
+    /// @return The averaged components in the lower 16 bit of the 32 bit lanes
+    template <uint8_t Pos, uint8_t Size>
+    static __m128i averageComponentSse(const __m128i row0, const __m128i row1)
+    {
+        const __m128i mask { _mm_set1_epi32((1 << Size) - 1) };
+        const __m128i sum { _mm_add_epi32(
+            _mm_add_epi32(
+                _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(row0, Pos), mask), _mm_and_si128(_mm_srli_epi32(row0, Pos + 16), mask)),
+                _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(row1, Pos), mask), _mm_and_si128(_mm_srli_epi32(row1, Pos + 16), mask))),
+            _mm_set1_epi32(2)) };
+        return _mm_slli_epi32(_mm_srli_epi32(sum, 2), Pos);
+    }
+#endif
+
+#if defined(__ARM_NEON)
+    /// @brief Averages the components of the even and odd texels of two rows
+    template <uint8_t Pos, uint8_t Size>
+    static uint16x8_t averageComponentNeon(const uint16x8_t even0, const uint16x8_t odd0, const uint16x8_t even1, const uint16x8_t odd1)
+    {
+        const uint16x8_t mask { vdupq_n_u16((1 << Size) - 1) };
+        uint16x8_t sum { vdupq_n_u16(2) };
+        if constexpr (Pos == 0)
+        {
+            sum = vaddq_u16(sum, vaddq_u16(vaddq_u16(vandq_u16(even0, mask), vandq_u16(odd0, mask)), vaddq_u16(vandq_u16(even1, mask), vandq_u16(odd1, mask))));
+        }
+        else
+        {
+            sum = vaddq_u16(sum,
+                vaddq_u16(
+                    vaddq_u16(vandq_u16(vshrq_n_u16(even0, Pos), mask), vandq_u16(vshrq_n_u16(odd0, Pos), mask)),
+                    vaddq_u16(vandq_u16(vshrq_n_u16(even1, Pos), mask), vandq_u16(vshrq_n_u16(odd1, Pos), mask))));
+        }
+        return vshlq_n_u16(vshrq_n_u16(sum, 2), Pos);
+    }
+#endif
+
+    struct Rgb565
+    {
+        static uint16_t average(const uint16_t a, const uint16_t b, const uint16_t c, const uint16_t d)
+        {
+            return averageComponent<11, 5>(a, b, c, d) | averageComponent<5, 6>(a, b, c, d) | averageComponent<0, 5>(a, b, c, d);
+        }
+#if defined(__SSE2__)
+        static __m128i averageSse(const __m128i row0, const __m128i row1)
+        {
+            return _mm_or_si128(
+                _mm_or_si128(averageComponentSse<11, 5>(row0, row1), averageComponentSse<5, 6>(row0, row1)),
+                averageComponentSse<0, 5>(row0, row1));
+        }
+#elif defined(__ARM_NEON)
+        static uint16x8_t averageNeon(const uint16x8_t e0, const uint16x8_t o0, const uint16x8_t e1, const uint16x8_t o1)
+        {
+            return vorrq_u16(
+                vorrq_u16(averageComponentNeon<11, 5>(e0, o0, e1, o1), averageComponentNeon<5, 6>(e0, o0, e1, o1)),
+                averageComponentNeon<0, 5>(e0, o0, e1, o1));
+        }
+#endif
+    };
+
+    struct Rgba4444
+    {
+        static uint16_t average(const uint16_t a, const uint16_t b, const uint16_t c, const uint16_t d)
+        {
+            return averageComponent<12, 4>(a, b, c, d) | averageComponent<8, 4>(a, b, c, d) | averageComponent<4, 4>(a, b, c, d) | averageComponent<0, 4>(a, b, c, d);
+        }
+#if defined(__SSE2__)
+        static __m128i averageSse(const __m128i row0, const __m128i row1)
+        {
+            return _mm_or_si128(
+                _mm_or_si128(averageComponentSse<12, 4>(row0, row1), averageComponentSse<8, 4>(row0, row1)),
+                _mm_or_si128(averageComponentSse<4, 4>(row0, row1), averageComponentSse<0, 4>(row0, row1)));
+        }
+#elif defined(__ARM_NEON)
+        static uint16x8_t averageNeon(const uint16x8_t e0, const uint16x8_t o0, const uint16x8_t e1, const uint16x8_t o1)
+        {
+            return vorrq_u16(
+                vorrq_u16(averageComponentNeon<12, 4>(e0, o0, e1, o1), averageComponentNeon<8, 4>(e0, o0, e1, o1)),
+                vorrq_u16(averageComponentNeon<4, 4>(e0, o0, e1, o1), averageComponentNeon<0, 4>(e0, o0, e1, o1)));
+        }
+#endif
+    };
+
+    struct Rgba5551
+    {
+        static uint16_t average(const uint16_t a, const uint16_t b, const uint16_t c, const uint16_t d)
+        {
+            return averageComponent<11, 5>(a, b, c, d) | averageComponent<6, 5>(a, b, c, d) | averageComponent<1, 5>(a, b, c, d) | averageComponent<0, 1>(a, b, c, d);
+        }
+#if defined(__SSE2__)
+        static __m128i averageSse(const __m128i row0, const __m128i row1)
+        {
+            return _mm_or_si128(
+                _mm_or_si128(averageComponentSse<11, 5>(row0, row1), averageComponentSse<6, 5>(row0, row1)),
+                _mm_or_si128(averageComponentSse<1, 5>(row0, row1), averageComponentSse<0, 1>(row0, row1)));
+        }
+#elif defined(__ARM_NEON)
+        static uint16x8_t averageNeon(const uint16x8_t e0, const uint16x8_t o0, const uint16x8_t e1, const uint16x8_t o1)
+        {
+            return vorrq_u16(
+                vorrq_u16(averageComponentNeon<11, 5>(e0, o0, e1, o1), averageComponentNeon<6, 5>(e0, o0, e1, o1)),
+                vorrq_u16(averageComponentNeon<1, 5>(e0, o0, e1, o1), averageComponentNeon<0, 1>(e0, o0, e1, o1)));
+        }
+#endif
+    };
+};
+
+} // namespace rr
+
+#endif // GL_MIPMAP_GENERATOR_HPP_
@@ -17,6 +17,7 @@
 
 #include "RIXGL.hpp"
 #include "RenderConfigs.hpp"
+#include "TextureContainer.hpp"
 #include "glImpl.h"
 #include "pixelpipeline/PixelPipeline.hpp"
 #include "renderer/dse/DmaStreamEngine.hpp"
@@ -43,9 +44,13 @@ RIXGL& RIXGL::getInstance()
 class WithThreadedRasterization
 {
 public:
-    WithThreadedRasterization(IBusConnector& busConnector, IThreadRunner& uploadThread, IThreadRunner& workerThread)
+    WithThreadedRasterization(
+        IBusConnector& busConnector,
+        IThreadRunner& uploadThread,
+        IThreadRunner& workerThread,
+        const std::vector<IThreadRunner*>& vertexThreads)
         : dmaStreamEngine { busConnector }
-        , device { dmaStreamEngine, uploadThread, workerThread }
+        , device { dmaStreamEngine, uploadThread, workerThread, vertexThreads }
     {
     }
 
@@ -58,14 +63,16 @@ public:
     DSEC::DmaStreamEngine dmaStreamEngine;
     ThreadedRasterizer<
         RenderConfig::THREADED_RASTERIZATION_BUFFER_COUNT,
-        RenderConfig::THREADED_RASTERIZATION_BUFFER_SIZE>
+        RenderConfig::THREADED_RASTERIZATION_BUFFER_SIZE,
+        RenderConfig::THREADED_RASTERIZATION_CHUNK_SIZE,
+        RenderConfig::THREADED_RASTERIZATION_QUEUE_DEPTH>
         device;
 };
 
 class OnlyDse
 {
 public:
-    OnlyDse(IBusConnector& busConnector, IThreadRunner&, IThreadRunner&)
+    OnlyDse(IBusConnector& busConnector, IThreadRunner&, IThreadRunner&, const std::vector<IThreadRunner*>&)
         : device { busConnector }
     {
     }
@@ -81,9 +88,14 @@ public:
 class RenderDevice
 {
 public:
-    RenderDevice(IBusConnector& busConnector, IThreadRunner& workerThread, IThreadRunner& uploadThread)
-        : device { busConnector, uploadThread, workerThread }
-        , pixelPipeline { device.device }
+    RenderDevice(
+        IBusConnector& busConnector,
+        IThreadRunner& workerThread,
+        IThreadRunner& uploadThread,
+        const std::vector<IThreadRunner*>& vertexThreads,
+        const std::vector<IThreadRunner*>& textureThreads)
+        : device { busConnector, uploadThread, workerThread, vertexThreads }
+        , pixelPipeline { device.device, textureThreads }
         , vertexPipeline { pixelPipeline }
     {
     }
@@ -104,13 +116,18 @@ public:
     VertexArray vertexArray {};
 };
 
-bool RIXGL::createInstance(IBusConnector& busConnector, IThreadRunner& workerThread, IThreadRunner& uploadThread)
+bool RIXGL::createInstance(
+    IBusConnector& busConnector,
+    IThreadRunner& workerThread,
+    IThreadRunner& uploadThread,
+    const std::vector<IThreadRunner*>& vertexThreads,
+    const std::vector<IThreadRunner*>& textureThreads)
 {
     if (instance)
     {
         delete instance;
     }
-    instance = new RIXGL { busConnector, workerThread, uploadThread };
+    instance = new RIXGL { busConnector, workerThread, uploadThread, vertexThreads, textureThreads };
     return instance != nullptr;
 }
 
@@ -124,8 +141,13 @@ void RIXGL::destroy()
     }
 }
 
-RIXGL::RIXGL(IBusConnector& busConnector, IThreadRunner& workerThread, IThreadRunner& uploadThread)
-    : m_renderDevice { new RenderDevice { busConnector, workerThread, uploadThread } }
+RIXGL::RIXGL(
+    IBusConnector& busConnector,
+    IThreadRunner& workerThread,
+    IThreadRunner& uploadThread,
+    const std::vector<IThreadRunner*>& vertexThreads,
+    const std::vector<IThreadRunner*>& textureThreads)
+    : m_renderDevice { new RenderDevice { busConnector, workerThread, uploadThread, vertexThreads, textureThreads } }
 {
     // Register Open GL 1.0 procedures
     addLibProcedure("glAccum", ADDRESS_OF(impl_glAccum));
@@ -570,6 +592,33 @@ RIXGL::RIXGL(IBusConnector& busConnector, IThreadRunner& workerThread, IThreadRu
     addLibProcedure("glActiveStencilFaceEXT", ADDRESS_OF(impl_glActiveStencilFaceEXT));
     addLibProcedure("glBlendEquation", ADDRESS_OF(impl_glBlendEquation));
     addLibProcedure("glBlendFuncSeparate", ADDRESS_OF(impl_glBlendFuncSeparate));
+    if (isTextureCompressionAvailable())
+    {
+        addLibExtension("GL_EXT_texture_compression_dxt1");
+    }
+    if (isPalettedTextureAvailable())
+    {
+        addLibExtension("GL_EXT_paletted_texture");
+        addLibProcedure("glColorTableEXT", ADDRESS_OF(impl_glColorTableEXT));
+        addLibProcedure("glColorSubTableEXT", ADDRESS_OF(impl_glColorSubTableEXT));
+    }
+    if (isMipmappingAvailable())
+    {
+        addLibExtension("GL_SGIS_generate_mipmap");
+        addLibProcedure("glGenerateMipmap", ADDRESS_OF(impl_glGenerateMipmap));
+        addLibProcedure("glGenerateMipmapEXT", ADDRESS_OF(impl_glGenerateMipmap));
+    }
+    addLibExtension("GL_NV_fence");
+    {
+
+        addLibProcedure("glGenFencesNV", ADDRESS_OF(impl_glGenFencesNV));
+        addLibProcedure("glDeleteFencesNV", ADDRESS_OF(impl_glDeleteFencesNV));
+        addLibProcedure("glSetFenceNV", ADDRESS_OF(impl_glSetFenceNV));
+        addLibProcedure("glTestFenceNV", ADDRESS_OF(impl_glTestFenceNV));
+        addLibProcedure("glFinishFenceNV", ADDRESS_OF(impl_glFinishFenceNV));
+        addLibProcedure("glIsFenceNV", ADDRESS_OF(impl_glIsFenceNV));
+        addLibProcedure("glGetFenceivNV", ADDRESS_OF(impl_glGetFenceivNV));
+    }
     // addLibExtension("GL_EXT_compiled_vertex_array");
     // {
 
@@ -664,6 +713,16 @@ bool RIXGL::isMipmappingAvailable() const
     return RenderConfig::ENABLE_MIPMAPPING;
 }
 
+bool RIXGL::isTextureCompressionAvailable() const
+{
+    return RenderConfig::ENABLE_TEXTURE_COMPRESSION;
+}
+
+bool RIXGL::isPalettedTextureAvailable() const
+{
+    return RenderConfig::ENABLE_PALETTED_TEXTURES;
+}
+
 bool RIXGL::setRenderResolution(const std::size_t x, const std::size_t y)
 {
     return m_renderDevice->pixelPipeline.setRenderResolution(x, y);
@@ -679,4 +738,81 @@ void RIXGL::enableVSync(const bool enable)
     m_renderDevice->pixelPipeline.enableVSync(enable);
 }
 
+void RIXGL::flush()
+{
+    m_renderDevice->pixelPipeline.flush();
+}
+
+void RIXGL::finish()
+{
+    m_renderDevice->pixelPipeline.finish();
+}
+
+uint32_t RIXGL::genFence()
+{
+    while ((m_nextFenceName == 0) || (m_fences.find(m_nextFenceName) != m_fences.end()))
+    {
+        m_nextFenceName++;
+    }
+    m_fences[m_nextFenceName] = std::nullopt;
+    return m_nextFenceName++;
+}
+
+void RIXGL::deleteFence(const uint32_t fence)
+{
+    m_fences.erase(fence);
+}
+
+bool RIXGL::isFence(const uint32_t fence) const
+{
+    auto it = m_fences.find(fence);
+    return (it != m_fences.end()) && it->second.has_value();
+}
+
+void RIXGL::setFence(const uint32_t fence)
+{
+    m_fences[fence] = m_renderDevice->pixelPipeline.insertFence();
+}
+
+bool RIXGL::testFence(const uint32_t fence)
+{
+    return m_renderDevice->pixelPipeline.isFenceSignaled(*m_fences.at(fence));
+}
+
+void RIXGL::finishFence(const uint32_t fence)
+{
+    m_renderDevice->pixelPipeline.blockUntilFenceIsSignaled(*m_fences.at(fence));
+}
+
+bool RIXGL::loadTextureContainer(const std::shared_ptr<const uint8_t>& container, const std::size_t size)
+{
+    const std::optional<TextureObjectMipmap> mipmap = TextureContainer::read(container, size);
+    if (!mipmap)
+    {
+        return false;
+    }
+    for (std::size_t level = 0; (level < mipmap->size()) && ((*mipmap)[level].width > 0); level++)
+    {
+        const TextureObject& texObj = (*mipmap)[level];
+        if ((texObj.width > getMaxTextureSize()) || (texObj.height > getMaxTextureSize())
+            || ((level != 0) && !isMipmappingAvailable())
+            || (texObj.isCompressed() && !isTextureCompressionAvailable())
+            || (texObj.isPaletted() && !isPalettedTextureAvailable()))
+        {
+            SPDLOG_ERROR("loadTextureContainer level {} is not supported by the hardware", level);
+            return false;
+        }
+    }
+    m_renderDevice->pixelPipeline.texture().setTexture(*mipmap);
+    return true;
+}
+
+std::vector<uint8_t> RIXGL::saveTextureContainer()
+{
+    Texture& texture = m_renderDevice->pixelPipeline.texture();
+    // The texels might still be converted in the background
+    texture.waitForTextureJobs();
+    return TextureContainer::write(texture.getTexture());
+}
+
 } // namespace rr
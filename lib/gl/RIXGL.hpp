@@ -23,6 +23,8 @@
 #include <array>
 #include <functional>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -36,6 +38,15 @@ class VertexQueue;
 class RIXGL
 {
 public:
+    /// @brief Pixel storage modes which describe the layout of pixels in client memory (glPixelStorei)
+    struct PixelStore
+    {
+        std::size_t rowLength { 0 }; ///< Pixels per row. 0 means the width of the image
+        std::size_t skipRows { 0 }; ///< Rows skipped before the first pixel
+        std::size_t skipPixels { 0 }; ///< Pixels skipped at the beginning of each row
+        std::size_t alignment { 4 }; ///< Alignment of the beginning of each row in bytes
+    };
+
     /// @brief Getting the instance of the current render context
     /// @return The instance of the current render context
     static RIXGL& getInstance();
@@ -48,9 +59,19 @@ public:
     ///     system like the rppico, an own runner needs to be implemented to offload work to other cores.
     /// @param uploadThread Runner to run the upload in a thread. A real thread implementation here is only
     ///     required when multiple display lists are used (see RasterIX_IF).
+    /// @param vertexThreads Optional runners which are used together with the workerThread to transform,
+    ///     clip and set up independent draws in parallel. Only used with threaded rasterization.
+    /// @param textureThreads Optional runners which convert the pixels of glTexImage2D and glTexSubImage2D
+    ///     and generate the mipmap levels in the background. The calls then only copy the client pixels.
+    ///     The upload of the display list which uses the texture waits for the conversion.
     /// @return true if the creation was successful. This function currently uses heap memory. A false
     ///     can occur when the memory allocation fails.
-    static bool createInstance(IBusConnector& busConnector, IThreadRunner& workerThread, IThreadRunner& uploadThread);
+    static bool createInstance(
+        IBusConnector& busConnector,
+        IThreadRunner& workerThread,
+        IThreadRunner& uploadThread,
+        const std::vector<IThreadRunner*>& vertexThreads = {},
+        const std::vector<IThreadRunner*>& textureThreads = {});
 
     /// @brief  Destroys the current context, switches the framebuffer to the system framebuffer and
     ///     and frees all allocated memory.
@@ -60,6 +81,7 @@ public:
     uint32_t getError() const { return m_error; }
 
     VertexPipeline& pipeline();
+    PixelStore& unpackPixelStore() { return m_unpackPixelStore; }
     VertexQueue& vertexQueue();
     VertexArray& vertexArray();
 
@@ -87,6 +109,14 @@ public:
     /// @return true when mipmapping is available
     bool isMipmappingAvailable() const;
 
+    /// @brief Queries if the hardware is able to decode compressed textures
+    /// @return true if compressed textures are supported
+    bool isTextureCompressionAvailable() const;
+
+    /// @brief Queries if the hardware is able to expand paletted textures
+    /// @return true if paletted textures are supported
+    bool isPalettedTextureAvailable() const;
+
     /// @brief Sets the resolution of the screen
     /// @param x screen width
     /// @param y screen height
@@ -97,17 +127,72 @@ public:
     /// @param enable true to enable vsync
     void enableVSync(const bool enable);
 
+    /// @brief Hands all commands issued so far to the hardware without waiting for the swap (glFlush)
+    void flush();
+
+    /// @brief Blocks until the hardware has processed everything which was handed to it (glFinish)
+    void finish();
+
+    /// @brief Reserves an unused fence name
+    /// @return The fence name
+    uint32_t genFence();
+
+    /// @brief Frees a fence name. Names which are not used are silently ignored.
+    /// @param fence The fence name
+    void deleteFence(const uint32_t fence);
+
+    /// @brief Checks if the name belongs to a fence which was set at least once
+    /// @param fence The fence name
+    /// @return true if the fence was set
+    bool isFence(const uint32_t fence) const;
+
+    /// @brief Sets the fence behind all commands issued so far
+    /// @param fence The fence name
+    void setFence(const uint32_t fence);
+
+    /// @brief Checks without blocking if the hardware has processed everything in front of the fence
+    /// @param fence The fence name. The fence must be set.
+    /// @return true if the fence is signaled
+    bool testFence(const uint32_t fence);
+
+    /// @brief Blocks until the hardware has processed everything in front of the fence
+    /// @param fence The fence name. The fence must be set.
+    void finishFence(const uint32_t fence);
+
+    /// @brief Loads a texture container (see TextureContainer.hpp) into the texture which is bound to the active TMU.
+    ///     The texels are already converted, they are uploaded straight from the container.
+    /// @param container The container, for instance a mapped file. The texture keeps a reference to it.
+    /// @param size The size of the container in bytes
+    /// @return false if the container is invalid or uses features which the hardware does not support
+    bool loadTextureContainer(const std::shared_ptr<const uint8_t>& container, const std::size_t size);
+
+    /// @brief Writes the converted texture, which is bound to the active TMU, into a texture container
+    /// @return The container, or an empty vector if the texture has no levels
+    std::vector<uint8_t> saveTextureContainer();
+
 private:
-    RIXGL(IBusConnector& busConnector, IThreadRunner& workerThread, IThreadRunner& uploadThread);
+    RIXGL(
+        IBusConnector& busConnector,
+        IThreadRunner& workerThread,
+        IThreadRunner& uploadThread,
+        const std::vector<IThreadRunner*>& vertexThreads,
+        const std::vector<IThreadRunner*>& textureThreads);
     ~RIXGL();
     RenderDevice* m_renderDevice { nullptr };
 
     // Errors
     uint32_t m_error { 0 };
 
+    // Pixel storage modes used to read pixels from client memory
+    PixelStore m_unpackPixelStore {};
+
     // OpenGL extensions
     std::map<std::string, const void*> m_glProcedures;
     std::string m_glExtensions;
+
+    // NV_fence objects. A fence name without a value was generated but not set yet.
+    std::map<uint32_t, std::optional<uint32_t>> m_fences;
+    uint32_t m_nextFenceName { 1 };
 };
 
 } // namespace rr
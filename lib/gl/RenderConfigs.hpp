@@ -14,6 +14,8 @@ struct RenderConfig
     static constexpr std::size_t TMU_COUNT { RIX_CORE_TMU_COUNT };
     static constexpr std::size_t MAX_TEXTURE_SIZE { RIX_CORE_MAX_TEXTURE_SIZE };
     static constexpr bool ENABLE_MIPMAPPING { RIX_CORE_ENABLE_MIPMAPPING };
+    static constexpr bool ENABLE_TEXTURE_COMPRESSION { RIX_CORE_ENABLE_TEXTURE_COMPRESSION };
+    static constexpr bool ENABLE_PALETTED_TEXTURES { RIX_CORE_ENABLE_PALETTED_TEXTURES };
 
     // Display Settings
     static constexpr std::size_t MAX_DISPLAY_WIDTH { RIX_CORE_MAX_DISPLAY_WIDTH };
@@ -23,11 +25,14 @@ struct RenderConfig
 
     // Rasterizer settings
     static constexpr bool USE_FLOAT_INTERPOLATION { RIX_CORE_USE_FLOAT_INTERPOLATION };
+    static constexpr bool COARSE_OCCLUSION_CULLING { RIX_CORE_COARSE_OCCLUSION_CULLING };
 
     // Texture Memory Settings
     static constexpr std::size_t NUMBER_OF_TEXTURE_PAGES { RIX_CORE_NUMBER_OF_TEXTURE_PAGES };
     static constexpr std::size_t NUMBER_OF_TEXTURES { RIX_CORE_NUMBER_OF_TEXTURES };
     static constexpr std::size_t TEXTURE_PAGE_SIZE { RIX_CORE_TEXTURE_PAGE_SIZE };
+    static constexpr std::size_t TEXTURE_PAGE_BLOCK_SIZE { 1024 }; // Smallest part of a page which can be streamed into a TMU
+    static constexpr bool RELEASE_TEXTURE_HOST_COPIES { RIX_CORE_RELEASE_TEXTURE_HOST_COPIES }; // Frees the host copy of a texture after its upload, if the device memory can be read back
 
     // Memory RAM location. This is used as memory offset for all device memory
     // address calculations. Mostly useful for architectures with shared memory
@@ -44,6 +49,8 @@ struct RenderConfig
     static constexpr bool THREADED_RASTERIZATION { RIX_CORE_THREADED_RASTERIZATION };
     static constexpr std::size_t THREADED_RASTERIZATION_BUFFER_COUNT { 2 };
     static constexpr std::size_t THREADED_RASTERIZATION_BUFFER_SIZE { 1024 * 1024 * 4 };
+    static constexpr std::size_t THREADED_RASTERIZATION_CHUNK_SIZE { 1024 * 64 };
+    static constexpr std::size_t THREADED_RASTERIZATION_QUEUE_DEPTH { 64 };
     static constexpr bool ENABLE_VSYNC { RIX_CORE_ENABLE_VSYNC };
 
     static constexpr std::size_t getDisplayLines()
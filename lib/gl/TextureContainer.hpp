@@ -0,0 +1,219 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef GL_TEXTURE_CONTAINER_HPP_
+#define GL_TEXTURE_CONTAINER_HPP_
+
+#include "RenderConfigs.hpp"
+#include "renderer/TextureObject.hpp"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+namespace rr
+{
+
+// Container for textures which are already converted into the texel formats of the TMU, including all
+// mipmap levels. A texture from a container is uploaded without conversion and mipmap generation.
+// Layout of a container (all fields are 32 bit little endian words):
+// +--------------------------------------------------+
+// | Header                                           |
+// +--------------------------------------------------+
+// | Level 0 .. Header::levels - 1                    |
+// +--------------------------------------------------+
+// | Padding up to Header::dataOffset                 |
+// +--------------------------------------------------+
+// | Palette (only paletted textures, PALETTE_BYTES)  |
+// +--------------------------------------------------+
+// | Texels of level 0 .. Header::levels - 1          |
+// +--------------------------------------------------+
+// The data has the same layout as the pages of the texture in the texture memory. It starts at a multiple
+// of the page size. When the container is mapped into the memory, the pages are copied straight from it.
+class TextureContainer
+{
+public:
+    static constexpr uint32_t MAGIC { 0x54584952 }; ///< "RIXT"
+    static constexpr uint32_t VERSION { 1 };
+
+    /// @brief Writes a texture into a container
+    /// @param mipmap The converted texture
+    /// @param alignment The alignment of the data, typically the size of a texture page
+    /// @return The container, or an empty vector if the texture has no levels
+    static std::vector<uint8_t> write(const TextureObjectMipmap& mipmap, const std::size_t alignment = RenderConfig::TEXTURE_PAGE_SIZE)
+    {
+        const TextureObject& base = mipmap[0];
+        const std::size_t levels = getNumberOfLevels(mipmap);
+        if ((levels == 0) || (alignment == 0))
+        {
+            SPDLOG_ERROR("TextureContainer::write texture without levels");
+            return {};
+        }
+
+        Header header {};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.alignment = static_cast<uint32_t>(alignment);
+        header.levels = static_cast<uint32_t>(levels);
+        header.paletteFormat = static_cast<uint32_t>(base.paletteFormat);
+        const std::size_t headerSize = sizeof(Header) + (levels * sizeof(Level));
+        header.dataOffset = static_cast<uint32_t>(((headerSize + alignment - 1) / alignment) * alignment);
+        header.dataSize = static_cast<uint32_t>(base.isPaletted() ? TextureObject::PALETTE_BYTES : 0);
+        for (std::size_t level = 0; level < levels; level++)
+        {
+            header.dataSize += static_cast<uint32_t>(mipmap[level].getSizeInBytes());
+        }
+
+        std::vector<uint8_t> container(header.dataOffset + header.dataSize, 0);
+        std::memcpy(container.data(), &header, sizeof(Header));
+        std::size_t offset = header.dataOffset;
+        if (base.isPaletted())
+        {
+            // A texture without palette is black, like in the texture memory
+            if (base.palette)
+            {
+                std::memcpy(container.data() + offset, base.palette.get(), TextureObject::PALETTE_BYTES);
+            }
+            offset += TextureObject::PALETTE_BYTES;
+        }
+        for (std::size_t level = 0; level < levels; level++)
+        {
+            const TextureObject& texObj = mipmap[level];
+            const Level l {
+                static_cast<uint32_t>(texObj.width),
+                static_cast<uint32_t>(texObj.height),
+                static_cast<uint32_t>(texObj.intendedPixelFormat),
+                static_cast<uint32_t>(texObj.getSizeInBytes()),
+            };
+            std::memcpy(container.data() + sizeof(Header) + (level * sizeof(Level)), &l, sizeof(Level));
+            if (texObj.pixels)
+            {
+                std::memcpy(container.data() + offset, texObj.pixels.get(), l.size);
+            }
+            offset += l.size;
+        }
+        return container;
+    }
+
+    /// @brief Reads a texture from a container. The levels point into the memory of the container, nothing is copied.
+    /// @param container The container. Its memory is kept as long as a level references it.
+    /// @param size The size of the container in bytes
+    /// @return The texture, or an empty optional if the container is invalid
+    static std::optional<TextureObjectMipmap> read(const std::shared_ptr<const uint8_t>& container, const std::size_t size)
+    {
+        Header header {};
+        if (!container || (size < sizeof(Header)))
+        {
+            SPDLOG_ERROR("TextureContainer::read container is too small");
+            return std::nullopt;
+        }
+        std::memcpy(&header, container.get(), sizeof(Header));
+        if ((header.magic != MAGIC) || (header.version != VERSION))
+        {
+            SPDLOG_ERROR("TextureContainer::read invalid magic 0x{:X} or version {}", header.magic, header.version);
+            return std::nullopt;
+        }
+        if ((header.levels == 0) || (header.levels > (TextureObject::MAX_LOD + 1))
+            || ((sizeof(Header) + (header.levels * sizeof(Level))) > header.dataOffset)
+            || ((header.dataOffset % 2) != 0)
+            || ((static_cast<std::size_t>(header.dataOffset) + header.dataSize) > size))
+        {
+            SPDLOG_ERROR("TextureContainer::read invalid header");
+            return std::nullopt;
+        }
+        if (header.alignment != RenderConfig::TEXTURE_PAGE_SIZE)
+        {
+            SPDLOG_WARN("TextureContainer::read container is aligned to {} bytes instead of the page size", header.alignment);
+        }
+
+        TextureObjectMipmap mipmap {};
+        const uint8_t* data = container.get() + header.dataOffset;
+        std::size_t offset = 0;
+        for (std::size_t level = 0; level < header.levels; level++)
+        {
+            Level l {};
+            std::memcpy(&l, container.get() + sizeof(Header) + (level * sizeof(Level)), sizeof(Level));
+            if (l.format > static_cast<uint32_t>(TextureObject::IntendedInternalPixelFormat::COLOR_INDEX8))
+            {
+                SPDLOG_ERROR("TextureContainer::read level {} has an invalid format {}", level, l.format);
+                return std::nullopt;
+            }
+            TextureObject& texObj = mipmap[level];
+            texObj.width = l.width;
+            texObj.height = l.height;
+            texObj.intendedPixelFormat = static_cast<TextureObject::IntendedInternalPixelFormat>(l.format);
+            if ((level == 0) && texObj.isPaletted())
+            {
+                // The palette belongs to the texture and is stored in the base level
+                texObj.paletteFormat = static_cast<TextureObject::IntendedInternalPixelFormat>(header.paletteFormat);
+                texObj.palette = { container, reinterpret_cast<const uint16_t*>(data) };
+                offset += TextureObject::PALETTE_BYTES;
+            }
+            if ((l.size == 0) || (l.size != texObj.getSizeInBytes())
+                || (texObj.isPaletted() != mipmap[0].isPaletted())
+                || ((offset + l.size) > header.dataSize))
+            {
+                SPDLOG_ERROR("TextureContainer::read level {} is invalid", level);
+                return std::nullopt;
+            }
+            texObj.pixels = { container, reinterpret_cast<const uint16_t*>(data + offset) };
+            offset += l.size;
+        }
+        return mipmap;
+    }
+
+private:
+    struct Header
+    {
+#pragma pack(push, 4)
+        uint32_t magic;
+        uint32_t version;
+        uint32_t alignment; ///< Alignment of the data in bytes
+        uint32_t levels; ///< Number of mipmap levels
+        uint32_t paletteFormat; ///< TextureObject::IntendedInternalPixelFormat of the palette
+        uint32_t dataOffset; ///< Offset of the palette and the texels from the beginning of the container
+        uint32_t dataSize; ///< Size of the palette and the texels in bytes
+        uint32_t reserved;
+#pragma pack(pop)
+    };
+
+    struct Level
+    {
+#pragma pack(push, 4)
+        uint32_t width;
+        uint32_t height;
+        uint32_t format; ///< TextureObject::IntendedInternalPixelFormat of the texels
+        uint32_t size; ///< Size of the texels in bytes
+#pragma pack(pop)
+    };
+
+    static std::size_t getNumberOfLevels(const TextureObjectMipmap& mipmap)
+    {
+        std::size_t levels = 0;
+        while ((levels < mipmap.size()) && (mipmap[levels].width > 0) && (mipmap[levels].height > 0))
+        {
+            levels++;
+        }
+        return levels;
+    }
+};
+
+} // namespace rr
+
+#endif // GL_TEXTURE_CONTAINER_HPP_
@@ -18,11 +18,21 @@
 #ifndef GL_TEXTURE_CONVERTER_HPP_
 #define GL_TEXTURE_CONVERTER_HPP_
 
+#include "RIXGL.hpp"
 #include "gl.h"
 #include "pixelpipeline/Texture.hpp"
 #include <algorithm>
 #include <cstring>
+#include <functional>
+#include <memory>
 #include <spdlog/spdlog.h>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace rr
 {
@@ -30,7 +40,22 @@ namespace rr
 class TextureConverter
 {
 public:
-    static void convert(
+    /// @brief Prepares the conversion of an image from client memory into the texture memory.
+    ///     The format and type are checked on the calling thread, the conversion can run on any thread.
+    /// @param texMemShared The texture memory
+    /// @param ipf The intended pixel format of the texture
+    /// @param originalTextureWidth The width of the texture
+    /// @param xoffset Horizontal offset of the image in the texture
+    /// @param yoffset Vertical offset of the image in the texture
+    /// @param width Width of the image
+    /// @param height Height of the image
+    /// @param format The format of the client pixels
+    /// @param type The type of the client pixels
+    /// @param pixels The client pixels
+    /// @param unpack The layout of the image in client memory
+    /// @param copyPixels Copies the client pixels. Then the conversion does not depend on the client memory anymore.
+    /// @return The conversion, or an empty function if the format and type are not supported
+    static std::function<void()> prepareConversion(
         std::shared_ptr<uint16_t> texMemShared,
         const TextureObject::IntendedInternalPixelFormat ipf,
         const std::size_t originalTextureWidth,
@@ -40,60 +65,91 @@ public:
         const GLsizei height,
         const GLenum format,
         const GLenum type,
-        const uint8_t* pixels)
+        const uint8_t* pixels,
+        const RIXGL::PixelStore& unpack,
+        const bool copyPixels)
     {
-        std::size_t i = 0;
-        // TODO: Also use GL_UNPACK_ROW_LENGTH configured via glPixelStorei
-        for (std::size_t y = yoffset; y < static_cast<std::size_t>(height + yoffset); y++)
+        // The conversion is selected once and then executed row by row
+        const RowConversion rowConversion { selectRowConversion(ipf, format, type) };
+        if (!rowConversion.convert)
+        {
+            return {};
+        }
+        const SourceImage source { stageSourceImage(pixels, unpack, width, height, rowConversion.bytesPerPixel, copyPixels) };
+        if (!source.pixels)
+        {
+            return {};
+        }
+        return [=]()
         {
-            for (std::size_t x = xoffset; x < static_cast<std::size_t>(width + xoffset); x++)
+            for (std::size_t y = 0; y < static_cast<std::size_t>(height); y++)
             {
-                const std::size_t texPos { (y * originalTextureWidth) + x };
-                switch (format)
-                {
-                case GL_RGB:
-                    i += convertRgbTexel(
-                        texMemShared.get()[texPos],
-                        ipf,
-                        type,
-                        pixels + i);
-                    break;
-                case GL_RGBA:
-                    i += convertRgbaTexel(
-                        texMemShared.get()[texPos],
-                        ipf,
-                        type,
-                        pixels + i);
-                    break;
-                case GL_ALPHA:
-                case GL_RED:
-                case GL_GREEN:
-                case GL_BLUE:
-                case GL_BGR:
-                case GL_BGRA:
-                    i += convertBgraTexel(
-                        texMemShared.get()[texPos],
-                        ipf,
-                        type,
-                        pixels + i);
-                    break;
-                case GL_LUMINANCE:
-                case GL_LUMINANCE_ALPHA:
-                    SPDLOG_WARN("glTexSubImage2D unsupported format");
-                    return;
-                default:
-                    SPDLOG_WARN("glTexSubImage2D invalid format");
-                    RIXGL::getInstance().setError(GL_INVALID_ENUM);
-                    return;
-                }
-                if (RIXGL::getInstance().getError() != GL_NO_ERROR)
-                {
-                    return;
-                }
+                rowConversion.convert(
+                    texMemShared.get() + ((y + yoffset) * originalTextureWidth) + xoffset,
+                    source.pixels.get() + (y * source.rowStride),
+                    width);
             }
+        };
+    }
+
+    /// @brief Converts an image from client memory into the texture memory on the calling thread.
+    ///     See prepareConversion().
+    static void convert(
+        std::shared_ptr<uint16_t> texMemShared,
+        const TextureObject::IntendedInternalPixelFormat ipf,
+        const std::size_t originalTextureWidth,
+        const GLint xoffset,
+        const GLint yoffset,
+        const GLsizei width,
+        const GLsizei height,
+        const GLenum format,
+        const GLenum type,
+        const uint8_t* pixels,
+        const RIXGL::PixelStore& unpack)
+    {
+        const std::function<void()> conversion { prepareConversion(texMemShared, ipf, originalTextureWidth, xoffset, yoffset, width, height, format, type, pixels, unpack, false) };
+        if (conversion)
+        {
+            conversion();
         }
     }
 
+    /// @brief Prepares the copy of color indices from client memory into the texture memory of a paletted texture.
+    ///     See prepareConversion().
+    static std::function<void()> prepareIndexConversion(
+        std::shared_ptr<uint16_t> texMemShared,
+        const std::size_t originalTextureWidth,
+        const GLint xoffset,
+        const GLint yoffset,
+        const GLsizei width,
+        const GLsizei height,
+        const GLenum type,
+        const uint8_t* pixels,
+        const RIXGL::PixelStore& unpack,
+        const bool copyPixels)
+    {
+        if (type != GL_UNSIGNED_BYTE)
+        {
+            SPDLOG_WARN("glTexSubImage2D unsupported index type 0x{:X}", type);
+            RIXGL::getInstance().setError(GL_INVALID_ENUM);
+            return {};
+        }
+        const SourceImage source { stageSourceImage(pixels, unpack, width, height, 1, copyPixels) };
+        if (!source.pixels)
+        {
+            return {};
+        }
+        return [=]()
+        {
+            // The indices are stored with one byte per texel
+            uint8_t* indices = reinterpret_cast<uint8_t*>(texMemShared.get());
+            for (std::size_t y = 0; y < static_cast<std::size_t>(height); y++)
+            {
+                std::memcpy(indices + ((y + yoffset) * originalTextureWidth) + xoffset, source.pixels.get() + (y * source.rowStride), width);
+            }
+        };
+    }
+
     static TextureObject::IntendedInternalPixelFormat convertToIntendedPixelFormat(const GLint internalFormat)
     {
         switch (internalFormat)
@@ -138,6 +194,7 @@ public:
         case GL_RGB10:
         case GL_RGB12:
         case GL_RGB16:
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
             return TextureObject::IntendedInternalPixelFormat::RGB;
         case 4:
         case GL_COMPRESSED_RGBA:
@@ -150,7 +207,16 @@ public:
         case GL_RGBA16:
             return TextureObject::IntendedInternalPixelFormat::RGBA;
         case GL_RGB5_A1:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
             return TextureObject::IntendedInternalPixelFormat::RGBA1;
+        case GL_COLOR_INDEX8_EXT:
+            if (RIXGL::getInstance().isPalettedTextureAvailable())
+            {
+                return TextureObject::IntendedInternalPixelFormat::COLOR_INDEX8;
+            }
+            SPDLOG_ERROR("glTexImage2D paletted textures are not supported");
+            RIXGL::getInstance().setError(GL_INVALID_ENUM);
+            return TextureObject::IntendedInternalPixelFormat::RGBA;
         case GL_DEPTH_COMPONENT:
             SPDLOG_WARN("glTexImage2D internal format GL_DEPTH_COMPONENT not supported");
             return TextureObject::IntendedInternalPixelFormat::RGBA;
@@ -162,199 +228,627 @@ public:
         return TextureObject::IntendedInternalPixelFormat::RGBA;
     }
 
+    static TextureObject::IntendedInternalPixelFormat convertToCompressedPixelFormat(const GLenum internalFormat)
+    {
+        if (RIXGL::getInstance().isTextureCompressionAvailable())
+        {
+            switch (internalFormat)
+            {
+            case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+                return TextureObject::IntendedInternalPixelFormat::COMPRESSED_RGB_DXT1;
+            case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+                return TextureObject::IntendedInternalPixelFormat::COMPRESSED_RGBA_DXT1;
+            default:
+                break;
+            }
+        }
+        SPDLOG_ERROR("glCompressedTexImage2D invalid internalformat 0x{:X}", internalFormat);
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        return TextureObject::IntendedInternalPixelFormat::COMPRESSED_RGB_DXT1;
+    }
+
 private:
-    template <uint8_t ColorPos, uint8_t ComponentSize, uint8_t Mask>
-    static uint8_t convertColorComponentToUint8(const uint16_t color)
+    using IPF = TextureObject::IntendedInternalPixelFormat;
+    using RowConverter = void (*)(uint16_t* __restrict dst, const uint8_t* __restrict src, const std::size_t count);
+
+    struct RowConversion
     {
-        static constexpr uint8_t ComponentShift = 8 - ComponentSize;
-        static constexpr uint8_t ComponentShiftFill = ComponentSize - ComponentShift;
-        return (((color >> ColorPos) & Mask) << ComponentShift) | (((color >> ColorPos) & Mask) >> ComponentShiftFill);
+        RowConverter convert { nullptr };
+        std::size_t bytesPerPixel { 0 };
+    };
+
+    struct Color
+    {
+        uint8_t r;
+        uint8_t g;
+        uint8_t b;
+        uint8_t a;
+    };
+
+    // Readers for the supported format and type combinations of the client pixels.
+    // Packed types are read with memcpy because rows are not necessarily aligned to the type.
+    template <typename T>
+    static T load(const uint8_t* pixels)
+    {
+        T val;
+        std::memcpy(&val, pixels, sizeof(T));
+        return val;
     }
 
-    static std::size_t convertRgbTexel(uint16_t& texel, const TextureObject::IntendedInternalPixelFormat ipf, const GLenum type, const uint8_t* pixels)
+    struct RgbUnsignedByte
     {
-        switch (type)
-        {
-        case GL_UNSIGNED_SHORT_5_6_5:
+        static constexpr std::size_t BYTES { 3 };
+        static Color read(const uint8_t* p) { return { p[0], p[1], p[2], 0xff }; }
+    };
+
+    struct RgbUnsignedShort565
+    {
+        static constexpr std::size_t BYTES { 2 };
+        static Color read(const uint8_t* p)
         {
-            const uint16_t color = *reinterpret_cast<const uint16_t*>(pixels);
-            texel = TextureObject::convertColor(
-                ipf,
+            const uint16_t color { load<uint16_t>(p) };
+            return {
                 convertColorComponentToUint8<11, 5, 0x1f>(color),
                 convertColorComponentToUint8<5, 6, 0x3f>(color),
                 convertColorComponentToUint8<0, 5, 0x1f>(color),
-                0xff);
-            return 2;
-        }
-        case GL_UNSIGNED_BYTE:
-            texel = TextureObject::convertColor(
-                ipf,
-                pixels[0],
-                pixels[1],
-                pixels[2],
-                0xff);
-            return 3;
-        case GL_BYTE:
-        case GL_BITMAP:
-        case GL_UNSIGNED_SHORT:
-        case GL_UNSIGNED_INT:
-        case GL_INT:
-        case GL_FLOAT:
-        case GL_UNSIGNED_BYTE_3_3_2:
-        case GL_UNSIGNED_BYTE_2_3_3_REV:
-        case GL_UNSIGNED_SHORT_5_6_5_REV:
-            SPDLOG_WARN("glTexSubImage2D unsupported type 0x{:X}", type);
-            return 0;
-        case GL_UNSIGNED_SHORT_5_5_5_1:
-        case GL_UNSIGNED_SHORT_1_5_5_5_REV:
-        case GL_UNSIGNED_SHORT_4_4_4_4:
-        case GL_UNSIGNED_SHORT_4_4_4_4_REV:
-        case GL_UNSIGNED_INT_8_8_8_8:
-        case GL_UNSIGNED_INT_8_8_8_8_REV:
-        case GL_UNSIGNED_INT_10_10_10_2:
-        case GL_UNSIGNED_INT_2_10_10_10_REV:
-            SPDLOG_WARN("glTexSubImage2D invalid operation");
-            RIXGL::getInstance().setError(GL_INVALID_OPERATION);
-            return 0;
-        default:
-            SPDLOG_WARN("glTexSubImage2D invalid type");
-            RIXGL::getInstance().setError(GL_INVALID_ENUM);
-            return 0;
+                0xff
+            };
         }
-        return 0;
-    }
+    };
 
-    static std::size_t convertRgbaTexel(uint16_t& texel, const TextureObject::IntendedInternalPixelFormat ipf, const GLenum type, const uint8_t* pixels)
+    struct RgbaUnsignedByte
     {
-        switch (type)
-        {
-        case GL_UNSIGNED_SHORT_5_5_5_1:
+        static constexpr std::size_t BYTES { 4 };
+        static Color read(const uint8_t* p) { return { p[0], p[1], p[2], p[3] }; }
+    };
+
+    struct RgbaUnsignedShort5551
+    {
+        static constexpr std::size_t BYTES { 2 };
+        static Color read(const uint8_t* p)
         {
-            const uint16_t color = *reinterpret_cast<const uint16_t*>(pixels);
-            texel = TextureObject::convertColor(
-                ipf,
+            const uint16_t color { load<uint16_t>(p) };
+            return {
                 convertColorComponentToUint8<11, 5, 0x1f>(color),
                 convertColorComponentToUint8<6, 5, 0x1f>(color),
                 convertColorComponentToUint8<1, 5, 0x1f>(color),
-                (color & 0x1) ? 0xff : 0);
+                static_cast<uint8_t>((color & 0x1) ? 0xff : 0)
+            };
         }
-            return 2;
-        case GL_UNSIGNED_SHORT_4_4_4_4:
+    };
+
+    struct RgbaUnsignedShort4444
+    {
+        static constexpr std::size_t BYTES { 2 };
+        static Color read(const uint8_t* p)
         {
-            const uint16_t color = *reinterpret_cast<const uint16_t*>(pixels);
-            texel = TextureObject::convertColor(
-                ipf,
+            const uint16_t color { load<uint16_t>(p) };
+            return {
                 convertColorComponentToUint8<12, 4, 0xf>(color),
                 convertColorComponentToUint8<8, 4, 0xf>(color),
                 convertColorComponentToUint8<4, 4, 0xf>(color),
-                convertColorComponentToUint8<0, 4, 0xf>(color));
+                convertColorComponentToUint8<0, 4, 0xf>(color)
+            };
         }
-            return 2;
-        case GL_UNSIGNED_BYTE:
-            texel = TextureObject::convertColor(
-                ipf,
-                pixels[0],
-                pixels[1],
-                pixels[2],
-                pixels[3]);
-            return 4;
-        case GL_BYTE:
-        case GL_BITMAP:
-        case GL_UNSIGNED_SHORT:
-        case GL_UNSIGNED_INT:
-        case GL_INT:
-        case GL_FLOAT:
-        case GL_UNSIGNED_SHORT_1_5_5_5_REV:
-        case GL_UNSIGNED_SHORT_4_4_4_4_REV:
-        case GL_UNSIGNED_INT_8_8_8_8:
-        case GL_UNSIGNED_INT_8_8_8_8_REV:
-        case GL_UNSIGNED_INT_10_10_10_2:
-        case GL_UNSIGNED_INT_2_10_10_10_REV:
-            SPDLOG_WARN("glTexSubImage2D unsupported type 0x{:X}", type);
-            return 0;
-        case GL_UNSIGNED_BYTE_3_3_2:
-        case GL_UNSIGNED_BYTE_2_3_3_REV:
-        case GL_UNSIGNED_SHORT_5_6_5:
-        case GL_UNSIGNED_SHORT_5_6_5_REV:
-            SPDLOG_WARN("glTexSubImage2D invalid operation");
-            RIXGL::getInstance().setError(GL_INVALID_OPERATION);
-            return 0;
-        default:
-            SPDLOG_WARN("glTexSubImage2D invalid type");
-            RIXGL::getInstance().setError(GL_INVALID_ENUM);
-            return 0;
+    };
+
+    struct RgbaUnsignedInt8888
+    {
+        static constexpr std::size_t BYTES { 4 };
+        static Color read(const uint8_t* p)
+        {
+            const uint32_t color { load<uint32_t>(p) };
+            return {
+                static_cast<uint8_t>(color >> 24),
+                static_cast<uint8_t>(color >> 16),
+                static_cast<uint8_t>(color >> 8),
+                static_cast<uint8_t>(color)
+            };
         }
-        return 0;
-    }
+    };
 
-    static std::size_t convertBgraTexel(uint16_t& texel, const TextureObject::IntendedInternalPixelFormat ipf, const GLenum type, const uint8_t* pixels)
+    struct RgbaUnsignedInt8888Rev
     {
-        switch (type)
+        static constexpr std::size_t BYTES { 4 };
+        static Color read(const uint8_t* p)
         {
-        case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+            const uint32_t color { load<uint32_t>(p) };
+            return {
+                static_cast<uint8_t>(color),
+                static_cast<uint8_t>(color >> 8),
+                static_cast<uint8_t>(color >> 16),
+                static_cast<uint8_t>(color >> 24)
+            };
+        }
+    };
+
+    struct BgrUnsignedByte
+    {
+        static constexpr std::size_t BYTES { 3 };
+        static Color read(const uint8_t* p) { return { p[2], p[1], p[0], 0xff }; }
+    };
+
+    struct BgraUnsignedByte
+    {
+        static constexpr std::size_t BYTES { 4 };
+        static Color read(const uint8_t* p) { return { p[2], p[1], p[0], p[3] }; }
+    };
+
+    struct BgraUnsignedShort1555Rev
+    {
+        static constexpr std::size_t BYTES { 2 };
+        static Color read(const uint8_t* p)
         {
-            const uint16_t color = *reinterpret_cast<const uint16_t*>(pixels);
-            texel = TextureObject::convertColor(
-                ipf,
+            const uint16_t color { load<uint16_t>(p) };
+            return {
                 convertColorComponentToUint8<10, 5, 0x1f>(color),
                 convertColorComponentToUint8<5, 5, 0x1f>(color),
                 convertColorComponentToUint8<0, 5, 0x1f>(color),
-                ((color >> 15) & 0x1) ? 0xff : 0);
-            return 2;
+                static_cast<uint8_t>(((color >> 15) & 0x1) ? 0xff : 0)
+            };
         }
-        case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+    };
+
+    struct BgraUnsignedShort4444Rev
+    {
+        static constexpr std::size_t BYTES { 2 };
+        static Color read(const uint8_t* p)
         {
-            const uint16_t color = *reinterpret_cast<const uint16_t*>(pixels);
-            texel = TextureObject::convertColor(
-                ipf,
+            const uint16_t color { load<uint16_t>(p) };
+            return {
                 convertColorComponentToUint8<8, 4, 0xf>(color),
                 convertColorComponentToUint8<4, 4, 0xf>(color),
                 convertColorComponentToUint8<0, 4, 0xf>(color),
-                convertColorComponentToUint8<12, 4, 0xf>(color));
-            return 2;
+                convertColorComponentToUint8<12, 4, 0xf>(color)
+            };
         }
+    };
+
+    struct BgraUnsignedInt8888
+    {
+        static constexpr std::size_t BYTES { 4 };
+        static Color read(const uint8_t* p)
+        {
+            const uint32_t color { load<uint32_t>(p) };
+            return {
+                static_cast<uint8_t>(color >> 8),
+                static_cast<uint8_t>(color >> 16),
+                static_cast<uint8_t>(color >> 24),
+                static_cast<uint8_t>(color)
+            };
+        }
+    };
+
+    struct BgraUnsignedInt8888Rev
+    {
+        static constexpr std::size_t BYTES { 4 };
+        static Color read(const uint8_t* p)
+        {
+            const uint32_t color { load<uint32_t>(p) };
+            return {
+                static_cast<uint8_t>(color >> 16),
+                static_cast<uint8_t>(color >> 8),
+                static_cast<uint8_t>(color),
+                static_cast<uint8_t>(color >> 24)
+            };
+        }
+    };
+
+    struct AlphaUnsignedByte
+    {
+        static constexpr std::size_t BYTES { 1 };
+        static Color read(const uint8_t* p) { return { 0, 0, 0, p[0] }; }
+    };
+
+    struct RedUnsignedByte
+    {
+        static constexpr std::size_t BYTES { 1 };
+        static Color read(const uint8_t* p) { return { p[0], 0, 0, 0xff }; }
+    };
+
+    struct GreenUnsignedByte
+    {
+        static constexpr std::size_t BYTES { 1 };
+        static Color read(const uint8_t* p) { return { 0, p[0], 0, 0xff }; }
+    };
+
+    struct BlueUnsignedByte
+    {
+        static constexpr std::size_t BYTES { 1 };
+        static Color read(const uint8_t* p) { return { 0, 0, p[0], 0xff }; }
+    };
+
+    struct LuminanceUnsignedByte
+    {
+        static constexpr std::size_t BYTES { 1 };
+        static Color read(const uint8_t* p) { return { p[0], p[0], p[0], 0xff }; }
+    };
+
+    struct LuminanceAlphaUnsignedByte
+    {
+        static constexpr std::size_t BYTES { 2 };
+        static Color read(const uint8_t* p) { return { p[0], p[0], p[0], p[1] }; }
+    };
+
+    template <uint8_t ColorPos, uint8_t ComponentSize, uint8_t Mask>
+    static uint8_t convertColorComponentToUint8(const uint16_t color)
+    {
+        static constexpr uint8_t ComponentShift = 8 - ComponentSize;
+        static constexpr uint8_t ComponentShiftFill = ComponentSize - ComponentShift;
+        return (((color >> ColorPos) & Mask) << ComponentShift) | (((color >> ColorPos) & Mask) >> ComponentShiftFill);
+    }
+
+    /// @brief Calculates the distance between two rows in client memory in bytes
+    static std::size_t getRowStride(const RIXGL::PixelStore& unpack, const std::size_t width, const std::size_t bytesPerPixel)
+    {
+        const std::size_t rowLength { (unpack.rowLength > 0) ? unpack.rowLength : width };
+        const std::size_t rowBytes { rowLength * bytesPerPixel };
+        return ((rowBytes + unpack.alignment - 1) / unpack.alignment) * unpack.alignment;
+    }
+
+    /// @brief First row of the image which is converted
+    struct SourceImage
+    {
+        std::shared_ptr<const uint8_t> pixels {};
+        std::size_t rowStride { 0 };
+    };
+
+    /// @brief Applies the unpack state to the client pixels. With copyPixels, the rows are copied without
+    ///     padding into an own buffer, otherwise the image references the client memory.
+    static SourceImage stageSourceImage(
+        const uint8_t* pixels,
+        const RIXGL::PixelStore& unpack,
+        const std::size_t width,
+        const std::size_t height,
+        const std::size_t bytesPerPixel,
+        const bool copyPixels)
+    {
+        const std::size_t rowStride { getRowStride(unpack, width, bytesPerPixel) };
+        const uint8_t* src { pixels + (unpack.skipRows * rowStride) + (unpack.skipPixels * bytesPerPixel) };
+        if (!copyPixels)
+        {
+            return { std::shared_ptr<const uint8_t>(src, [](const uint8_t*) {}), rowStride };
+        }
+        const std::size_t rowBytes { width * bytesPerPixel };
+        std::shared_ptr<uint8_t> copy(new uint8_t[(std::max)(rowBytes * height, static_cast<std::size_t>(1))], [](const uint8_t* p)
+            { delete[] p; });
+        if (!copy)
+        {
+            SPDLOG_ERROR("glTexSubImage2D Out Of Memory");
+            return {};
+        }
+        for (std::size_t y = 0; y < height; y++)
+        {
+            std::memcpy(copy.get() + (y * rowBytes), src + (y * rowStride), rowBytes);
+        }
+        return { copy, rowBytes };
+    }
+
+    template <IPF Ipf, typename Source>
+    static void convertRow(uint16_t* __restrict dst, const uint8_t* __restrict src, const std::size_t count)
+    {
+        std::size_t i { 0 };
+        if constexpr (std::is_same_v<Source, RgbaUnsignedByte>)
+        {
+            i = convertRgbaUnsignedByteRowSimd<Ipf>(dst, src, count);
+        }
+        else if constexpr (std::is_same_v<Source, RgbUnsignedByte>)
+        {
+            i = convertRgbUnsignedByteRowSimd<Ipf>(dst, src, count);
+        }
+        for (; i < count; i++)
+        {
+            const Color color { Source::read(src + (i * Source::BYTES)) };
+            dst[i] = TextureObject::convertColor(Ipf, color.r, color.g, color.b, color.a);
+        }
+    }
+
+    template <IPF Ipf>
+    static constexpr bool isSimdFormat()
+    {
+        return (Ipf == IPF::RGB) || (Ipf == IPF::RGBA) || (Ipf == IPF::RGBA1);
+    }
+
+#if defined(__SSE2__)
+    /// @brief Converts four RGBA8888 texels into the 16 bit texture format
+    /// @return The 16 bit colors, sign extended to 32 bit to pass the saturating pack unchanged
+    template <IPF Ipf>
+    static __m128i convertTexelsSse(const __m128i texels)
+    {
+        __m128i color;
+        if constexpr (Ipf == IPF::RGB)
+        {
+            color = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_and_si128(_mm_slli_epi32(texels, 8), _mm_set1_epi32(0xf800)),
+                    _mm_and_si128(_mm_srli_epi32(texels, 5), _mm_set1_epi32(0x07e0))),
+                _mm_and_si128(_mm_srli_epi32(texels, 19), _mm_set1_epi32(0x001f)));
+        }
+        else if constexpr (Ipf == IPF::RGBA)
+        {
+            color = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_and_si128(_mm_slli_epi32(texels, 8), _mm_set1_epi32(0xf000)),
+                    _mm_and_si128(_mm_srli_epi32(texels, 4), _mm_set1_epi32(0x0f00))),
+                _mm_or_si128(
+                    _mm_and_si128(_mm_srli_epi32(texels, 16), _mm_set1_epi32(0x00f0)),
+                    _mm_srli_epi32(texels, 28)));
+        }
+        else
+        {
+            color = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_and_si128(_mm_slli_epi32(texels, 8), _mm_set1_epi32(0xf800)),
+                    _mm_and_si128(_mm_srli_epi32(texels, 5), _mm_set1_epi32(0x07c0))),
+                _mm_or_si128(
+                    _mm_and_si128(_mm_srli_epi32(texels, 18), _mm_set1_epi32(0x003e)),
+                    _mm_srli_epi32(texels, 31)));
+        }
+        return _mm_srai_epi32(_mm_slli_epi32(color, 16), 16);
+    }
+#endif
+
+#if defined(__ARM_NEON)
+    template <int ComponentShift, int ColorPos>
+    static uint16x8_t placeComponentNeon(const uint8x8_t component)
+    {
+        return vshlq_n_u16(vmovl_u8(vshr_n_u8(component, ComponentShift)), ColorPos);
+    }
+
+    /// @brief Converts eight texels, split into their components, into the 16 bit texture format
+    template <IPF Ipf>
+    static uint16x8_t convertTexelsNeon(const uint8x8_t r, const uint8x8_t g, const uint8x8_t b, const uint8x8_t a)
+    {
+        if constexpr (Ipf == IPF::RGB)
+        {
+            return vorrq_u16(
+                vorrq_u16(placeComponentNeon<3, 11>(r), placeComponentNeon<2, 5>(g)),
+                placeComponentNeon<3, 0>(b));
+        }
+        else if constexpr (Ipf == IPF::RGBA)
+        {
+            return vorrq_u16(
+                vorrq_u16(placeComponentNeon<4, 12>(r), placeComponentNeon<4, 8>(g)),
+                vorrq_u16(placeComponentNeon<4, 4>(b), placeComponentNeon<4, 0>(a)));
+        }
+        else
+        {
+            return vorrq_u16(
+                vorrq_u16(placeComponentNeon<3, 11>(r), placeComponentNeon<3, 6>(g)),
+                vorrq_u16(placeComponentNeon<3, 1>(b), placeComponentNeon<7, 0>(a)));
+        }
+    }
+#endif
+
+    /// @brief Converts as many RGBA8888 texels with SIMD instructions as possible
+    /// @return The number of converted texels. The remaining texels are converted by the caller.
+    template <IPF Ipf>
+    static std::size_t convertRgbaUnsignedByteRowSimd([[maybe_unused]] uint16_t* __restrict dst, [[maybe_unused]] const uint8_t* __restrict src, [[maybe_unused]] const std::size_t count)
+    {
+        std::size_t i { 0 };
+#if defined(__SSE2__)
+        if constexpr (isSimdFormat<Ipf>())
+        {
+            for (; (i + 8) <= count; i += 8)
+            {
+                const __m128i lo { convertTexelsSse<Ipf>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (i * 4)))) };
+                const __m128i hi { convertTexelsSse<Ipf>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (i * 4) + 16))) };
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+            }
+        }
+#elif defined(__ARM_NEON)
+        if constexpr (isSimdFormat<Ipf>())
+        {
+            for (; (i + 8) <= count; i += 8)
+            {
+                const uint8x8x4_t texels { vld4_u8(src + (i * 4)) };
+                vst1q_u16(dst + i, convertTexelsNeon<Ipf>(texels.val[0], texels.val[1], texels.val[2], texels.val[3]));
+            }
+        }
+#endif
+        return i;
+    }
+
+    /// @brief Converts as many RGB888 texels with SIMD instructions as possible
+    /// @return The number of converted texels. The remaining texels are converted by the caller.
+    template <IPF Ipf>
+    static std::size_t convertRgbUnsignedByteRowSimd([[maybe_unused]] uint16_t* __restrict dst, [[maybe_unused]] const uint8_t* __restrict src, [[maybe_unused]] const std::size_t count)
+    {
+        std::size_t i { 0 };
+#if defined(__ARM_NEON)
+        if constexpr (isSimdFormat<Ipf>())
+        {
+            for (; (i + 8) <= count; i += 8)
+            {
+                const uint8x8x3_t texels { vld3_u8(src + (i * 3)) };
+                vst1q_u16(dst + i, convertTexelsNeon<Ipf>(texels.val[0], texels.val[1], texels.val[2], vdup_n_u8(0xff)));
+            }
+        }
+#endif
+        return i;
+    }
+
+    template <typename Source>
+    static RowConversion selectRowConversion(const IPF ipf)
+    {
+        switch (ipf)
+        {
+        case IPF::ALPHA:
+            return { &convertRow<IPF::ALPHA, Source>, Source::BYTES };
+        case IPF::LUMINANCE:
+            return { &convertRow<IPF::LUMINANCE, Source>, Source::BYTES };
+        case IPF::INTENSITY:
+            return { &convertRow<IPF::INTENSITY, Source>, Source::BYTES };
+        case IPF::LUMINANCE_ALPHA:
+            return { &convertRow<IPF::LUMINANCE_ALPHA, Source>, Source::BYTES };
+        case IPF::RGB:
+            return { &convertRow<IPF::RGB, Source>, Source::BYTES };
+        case IPF::RGBA:
+            return { &convertRow<IPF::RGBA, Source>, Source::BYTES };
+        case IPF::RGBA1:
+            return { &convertRow<IPF::RGBA1, Source>, Source::BYTES };
+        default:
+            SPDLOG_WARN("glTexSubImage2D internal format can not be converted");
+            RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+            return {};
+        }
+    }
+
+    static RowConversion selectRowConversion(const IPF ipf, const GLenum format, const GLenum type)
+    {
+        switch (format)
+        {
+        case GL_RGB:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<RgbUnsignedByte>(ipf);
+            }
+            if (type == GL_UNSIGNED_SHORT_5_6_5)
+            {
+                return selectRowConversion<RgbUnsignedShort565>(ipf);
+            }
+            break;
+        case GL_RGBA:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<RgbaUnsignedByte>(ipf);
+            }
+            if (type == GL_UNSIGNED_SHORT_5_5_5_1)
+            {
+                return selectRowConversion<RgbaUnsignedShort5551>(ipf);
+            }
+            if (type == GL_UNSIGNED_SHORT_4_4_4_4)
+            {
+                return selectRowConversion<RgbaUnsignedShort4444>(ipf);
+            }
+            if (type == GL_UNSIGNED_INT_8_8_8_8)
+            {
+                return selectRowConversion<RgbaUnsignedInt8888>(ipf);
+            }
+            if (type == GL_UNSIGNED_INT_8_8_8_8_REV)
+            {
+                return selectRowConversion<RgbaUnsignedInt8888Rev>(ipf);
+            }
+            break;
+        case GL_BGR:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<BgrUnsignedByte>(ipf);
+            }
+            break;
+        case GL_BGRA:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<BgraUnsignedByte>(ipf);
+            }
+            if (type == GL_UNSIGNED_SHORT_1_5_5_5_REV)
+            {
+                return selectRowConversion<BgraUnsignedShort1555Rev>(ipf);
+            }
+            if (type == GL_UNSIGNED_SHORT_4_4_4_4_REV)
+            {
+                return selectRowConversion<BgraUnsignedShort4444Rev>(ipf);
+            }
+            if (type == GL_UNSIGNED_INT_8_8_8_8)
+            {
+                return selectRowConversion<BgraUnsignedInt8888>(ipf);
+            }
+            if (type == GL_UNSIGNED_INT_8_8_8_8_REV)
+            {
+                return selectRowConversion<BgraUnsignedInt8888Rev>(ipf);
+            }
+            break;
+        case GL_ALPHA:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<AlphaUnsignedByte>(ipf);
+            }
+            break;
+        case GL_RED:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<RedUnsignedByte>(ipf);
+            }
+            break;
+        case GL_GREEN:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<GreenUnsignedByte>(ipf);
+            }
+            break;
+        case GL_BLUE:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<BlueUnsignedByte>(ipf);
+            }
+            break;
+        case GL_LUMINANCE:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<LuminanceUnsignedByte>(ipf);
+            }
+            break;
+        case GL_LUMINANCE_ALPHA:
+            if (type == GL_UNSIGNED_BYTE)
+            {
+                return selectRowConversion<LuminanceAlphaUnsignedByte>(ipf);
+            }
+            break;
+        default:
+            SPDLOG_WARN("glTexSubImage2D invalid format");
+            RIXGL::getInstance().setError(GL_INVALID_ENUM);
+            return {};
+        }
+        reportUnsupportedType(format, type);
+        return {};
+    }
+
+    static void reportUnsupportedType(const GLenum format, const GLenum type)
+    {
+        switch (type)
+        {
         case GL_UNSIGNED_BYTE:
-            texel = TextureObject::convertColor(
-                ipf,
-                pixels[2],
-                pixels[1],
-                pixels[0],
-                pixels[3]);
-            return 4;
-        case GL_UNSIGNED_INT_8_8_8_8_REV:
-            texel = TextureObject::convertColor(
-                ipf,
-                pixels[2],
-                pixels[1],
-                pixels[0],
-                pixels[3]);
-            return 4;
         case GL_BYTE:
         case GL_BITMAP:
         case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
         case GL_UNSIGNED_INT:
         case GL_INT:
         case GL_FLOAT:
-        case GL_UNSIGNED_SHORT_5_5_5_1:
-        case GL_UNSIGNED_SHORT_4_4_4_4:
-        case GL_UNSIGNED_INT_8_8_8_8:
-        case GL_UNSIGNED_INT_10_10_10_2:
-        case GL_UNSIGNED_INT_2_10_10_10_REV:
             SPDLOG_WARN("glTexSubImage2D unsupported type 0x{:X}", type);
-            return 0;
+            return;
         case GL_UNSIGNED_BYTE_3_3_2:
         case GL_UNSIGNED_BYTE_2_3_3_REV:
         case GL_UNSIGNED_SHORT_5_6_5:
         case GL_UNSIGNED_SHORT_5_6_5_REV:
-            SPDLOG_WARN("glTexSubImage2D invalid operation");
-            RIXGL::getInstance().setError(GL_INVALID_OPERATION);
-            return 0;
+            if (format == GL_RGB)
+            {
+                SPDLOG_WARN("glTexSubImage2D unsupported type 0x{:X}", type);
+                return;
+            }
+            break;
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+        case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+        case GL_UNSIGNED_INT_8_8_8_8:
+        case GL_UNSIGNED_INT_8_8_8_8_REV:
+        case GL_UNSIGNED_INT_10_10_10_2:
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+            if ((format == GL_RGBA) || (format == GL_BGRA))
+            {
+                SPDLOG_WARN("glTexSubImage2D unsupported type 0x{:X}", type);
+                return;
+            }
+            break;
         default:
             SPDLOG_WARN("glTexSubImage2D invalid type");
             RIXGL::getInstance().setError(GL_INVALID_ENUM);
-            return 0;
+            return;
         }
-        return 0;
+        // Packed types which do not match the number of components of the format
+        SPDLOG_WARN("glTexSubImage2D invalid operation");
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
     }
 };
 } // namespace rr
@@ -427,4 +427,14 @@ GLAPI_WRAPPER void APIENTRY glUnlockArrays() { impl_glUnlockArrays(); }
 GLAPI_WRAPPER void APIENTRY glActiveStencilFaceEXT(GLenum face) { impl_glActiveStencilFaceEXT(face); }
 GLAPI_WRAPPER void APIENTRY glBlendEquation(GLenum mode) { impl_glBlendEquation(mode); };
 GLAPI_WRAPPER void APIENTRY glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha) { impl_glBlendFuncSeparate(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha); };
+GLAPI_WRAPPER void APIENTRY glGenFencesNV(GLsizei n, GLuint* fences) { impl_glGenFencesNV(n, fences); }
+GLAPI_WRAPPER void APIENTRY glDeleteFencesNV(GLsizei n, const GLuint* fences) { impl_glDeleteFencesNV(n, fences); }
+GLAPI_WRAPPER void APIENTRY glSetFenceNV(GLuint fence, GLenum condition) { impl_glSetFenceNV(fence, condition); }
+GLAPI_WRAPPER GLboolean APIENTRY glTestFenceNV(GLuint fence) { return impl_glTestFenceNV(fence); }
+GLAPI_WRAPPER void APIENTRY glFinishFenceNV(GLuint fence) { impl_glFinishFenceNV(fence); }
+GLAPI_WRAPPER GLboolean APIENTRY glIsFenceNV(GLuint fence) { return impl_glIsFenceNV(fence); }
+GLAPI_WRAPPER void APIENTRY glGetFenceivNV(GLuint fence, GLenum pname, GLint* params) { impl_glGetFenceivNV(fence, pname, params); }
+GLAPI_WRAPPER void APIENTRY glColorTableEXT(GLenum target, GLenum internalFormat, GLsizei width, GLenum format, GLenum type, const GLvoid* table) { impl_glColorTableEXT(target, internalFormat, width, format, type, table); }
+GLAPI_WRAPPER void APIENTRY glColorSubTableEXT(GLenum target, GLsizei start, GLsizei count, GLenum format, GLenum type, const GLvoid* data) { impl_glColorSubTableEXT(target, start, count, format, type, data); }
+GLAPI_WRAPPER void APIENTRY glGenerateMipmap(GLenum target) { impl_glGenerateMipmap(target); }
 // -------------------------------------------------------
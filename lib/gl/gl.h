@@ -369,6 +369,28 @@ extern "C"
 #define GL_STENCIL_TEST_TWO_SIDE_EXT 0x8910
 #define GL_ACTIVE_STENCIL_FACE_EXT 0x8911
 
+// NV_fence
+#define GL_ALL_COMPLETED_NV 0x84F2
+#define GL_FENCE_STATUS_NV 0x84F3
+#define GL_FENCE_CONDITION_NV 0x84F4
+
+// EXT_texture_compression_dxt1
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+
+// EXT_paletted_texture
+#define GL_COLOR_INDEX1_EXT 0x80E2
+#define GL_COLOR_INDEX2_EXT 0x80E3
+#define GL_COLOR_INDEX4_EXT 0x80E4
+#define GL_COLOR_INDEX8_EXT 0x80E5
+#define GL_COLOR_INDEX12_EXT 0x80E6
+#define GL_COLOR_INDEX16_EXT 0x80E7
+#define GL_TEXTURE_INDEX_SIZE_EXT 0x80ED
+
+// SGIS_generate_mipmap
+#define GL_GENERATE_MIPMAP 0x8191
+#define GL_GENERATE_MIPMAP_HINT 0x8192
+
 // Buffers, Pixel Drawing/Reading
 #define GL_NONE 0x0
 #define GL_LEFT 0x0406
@@ -1301,6 +1323,16 @@ extern "C"
     GLAPI_WRAPPER void APIENTRY glActiveStencilFaceEXT(GLenum face);
     GLAPI_WRAPPER void APIENTRY glBlendEquation(GLenum mode);
     GLAPI_WRAPPER void APIENTRY glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha);
+    GLAPI_WRAPPER void APIENTRY glGenFencesNV(GLsizei n, GLuint* fences);
+    GLAPI_WRAPPER void APIENTRY glDeleteFencesNV(GLsizei n, const GLuint* fences);
+    GLAPI_WRAPPER void APIENTRY glSetFenceNV(GLuint fence, GLenum condition);
+    GLAPI_WRAPPER GLboolean APIENTRY glTestFenceNV(GLuint fence);
+    GLAPI_WRAPPER void APIENTRY glFinishFenceNV(GLuint fence);
+    GLAPI_WRAPPER GLboolean APIENTRY glIsFenceNV(GLuint fence);
+    GLAPI_WRAPPER void APIENTRY glGetFenceivNV(GLuint fence, GLenum pname, GLint* params);
+    GLAPI_WRAPPER void APIENTRY glColorTableEXT(GLenum target, GLenum internalFormat, GLsizei width, GLenum format, GLenum type, const GLvoid* table);
+    GLAPI_WRAPPER void APIENTRY glColorSubTableEXT(GLenum target, GLsizei start, GLsizei count, GLenum format, GLenum type, const GLvoid* data);
+    GLAPI_WRAPPER void APIENTRY glGenerateMipmap(GLenum target);
     // -------------------------------------------------------
 
 #ifdef __cplusplus
@@ -18,6 +18,7 @@
 #define NOMINMAX // Windows workaround
 #include "glImpl.h"
 #include "RIXGL.hpp"
+#include "MipmapGenerator.hpp"
 #include "TextureConverter.hpp"
 #include "glTypeConverters.h"
 #include "pixelpipeline/PixelPipeline.hpp"
@@ -957,12 +958,16 @@ GLAPI void APIENTRY impl_glFeedbackBuffer(GLsizei size, GLenum type, GLfloat* bu
 
 GLAPI void APIENTRY impl_glFinish(void)
 {
-    SPDLOG_WARN("glFinish not implemented");
+    SPDLOG_DEBUG("glFinish called");
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    RIXGL::getInstance().finish();
 }
 
 GLAPI void APIENTRY impl_glFlush(void)
 {
-    SPDLOG_WARN("glFlush not implemented");
+    SPDLOG_DEBUG("glFlush called");
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    RIXGL::getInstance().flush();
 }
 
 GLAPI void APIENTRY impl_glFogf(GLenum pname, GLfloat param)
@@ -1144,6 +1149,28 @@ GLAPI void APIENTRY impl_glGetIntegerv(GLenum pname, GLint* params)
     case GL_MAX_TEXTURE_UNITS:
         *params = RIXGL::getInstance().getTmuCount();
         break;
+    case GL_NUM_COMPRESSED_TEXTURE_FORMATS:
+        *params = RIXGL::getInstance().isTextureCompressionAvailable() ? 2 : 0;
+        break;
+    case GL_COMPRESSED_TEXTURE_FORMATS:
+        if (RIXGL::getInstance().isTextureCompressionAvailable())
+        {
+            params[0] = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            params[1] = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        }
+        break;
+    case GL_UNPACK_ROW_LENGTH:
+        *params = RIXGL::getInstance().unpackPixelStore().rowLength;
+        break;
+    case GL_UNPACK_SKIP_ROWS:
+        *params = RIXGL::getInstance().unpackPixelStore().skipRows;
+        break;
+    case GL_UNPACK_SKIP_PIXELS:
+        *params = RIXGL::getInstance().unpackPixelStore().skipPixels;
+        break;
+    case GL_UNPACK_ALIGNMENT:
+        *params = RIXGL::getInstance().unpackPixelStore().alignment;
+        break;
     case GL_DOUBLEBUFFER:
         *params = 1;
         break;
@@ -1942,23 +1969,67 @@ GLAPI void APIENTRY impl_glPixelMapusv(GLenum map, GLsizei mapsize, const GLusho
 
 GLAPI void APIENTRY impl_glPixelStoref(GLenum pname, GLfloat param)
 {
-    SPDLOG_WARN("glPixelStoref not implemented");
+    SPDLOG_DEBUG("glPixelStoref redirected to glPixelStorei");
+    impl_glPixelStorei(pname, static_cast<GLint>(std::lround(param)));
 }
 
 GLAPI void APIENTRY impl_glPixelStorei(GLenum pname, GLint param)
 {
     SPDLOG_DEBUG("glPixelStorei pname 0x{:X} param 0x{:X} called", pname, param);
     RIXGL::getInstance().setError(GL_NO_ERROR);
-    // TODO: Implement GL_UNPACK_ROW_LENGTH
-    if (pname == GL_PACK_ALIGNMENT)
+
+    RIXGL::PixelStore& unpack { RIXGL::getInstance().unpackPixelStore() };
+    switch (pname)
     {
+    case GL_UNPACK_ROW_LENGTH:
+    case GL_UNPACK_SKIP_ROWS:
+    case GL_UNPACK_SKIP_PIXELS:
+        if (param < 0)
+        {
+            SPDLOG_ERROR("glPixelStorei pname 0x{:X} negative param {}", pname, param);
+            RIXGL::getInstance().setError(GL_INVALID_VALUE);
+            return;
+        }
+        if (pname == GL_UNPACK_ROW_LENGTH)
+        {
+            unpack.rowLength = param;
+        }
+        else if (pname == GL_UNPACK_SKIP_ROWS)
+        {
+            unpack.skipRows = param;
+        }
+        else
+        {
+            unpack.skipPixels = param;
+        }
+        break;
+    case GL_UNPACK_ALIGNMENT:
+        if ((param != 1) && (param != 2) && (param != 4) && (param != 8))
+        {
+            SPDLOG_ERROR("glPixelStorei invalid GL_UNPACK_ALIGNMENT {}", param);
+            RIXGL::getInstance().setError(GL_INVALID_VALUE);
+            return;
+        }
+        unpack.alignment = param;
+        break;
+    case GL_UNPACK_SWAP_BYTES:
+    case GL_UNPACK_LSB_FIRST:
+        // Only the default is supported
+        if (param != GL_FALSE)
+        {
+            SPDLOG_WARN("glPixelStorei pname 0x{:X} and param 0x{:X} not supported", pname, param);
+            RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        }
+        break;
+    case GL_PACK_ALIGNMENT:
         SPDLOG_WARN("glPixelStorei pname GL_PACK_ALIGNMENT not supported");
         RIXGL::getInstance().setError(GL_INVALID_ENUM);
-        return;
+        break;
+    default:
+        SPDLOG_WARN("glPixelStorei pname 0x{:X} and param 0x{:X} not supported", pname, param);
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        break;
     }
-
-    SPDLOG_WARN("glPixelStorei pname 0x{:X} and param 0x{:X} not supported", pname, param);
-    RIXGL::getInstance().setError(GL_INVALID_ENUM);
 }
 
 GLAPI void APIENTRY impl_glPixelTransferf(GLenum pname, GLfloat param)
@@ -3091,6 +3162,8 @@ GLAPI void APIENTRY impl_glTexImage2D(GLenum target, GLint level, GLint internal
     texObj.width = widthRounded;
     texObj.height = heightRounded;
     texObj.intendedPixelFormat = intendedInternalPixelFormat;
+    // The old pixel data can have a different size or format. Drop it, so that glTexSubImage2D reinitializes the texture.
+    texObj.pixels.reset();
 
     SPDLOG_DEBUG("glTexImage2D redirect to glTexSubImage2D");
     impl_glTexSubImage2D(target, level, 0, 0, width, height, format, type, pixels);
@@ -3098,6 +3171,20 @@ GLAPI void APIENTRY impl_glTexImage2D(GLenum target, GLint level, GLint internal
 
 GLAPI void APIENTRY impl_glTexParameterf(GLenum target, GLenum pname, GLfloat param)
 {
+    if ((target == GL_TEXTURE_2D) && ((pname == GL_TEXTURE_MIN_LOD) || (pname == GL_TEXTURE_MAX_LOD)))
+    {
+        SPDLOG_DEBUG("glTexParameterf target 0x{:X} pname 0x{:X} param {}", target, pname, param);
+        RIXGL::getInstance().setError(GL_NO_ERROR);
+        if (pname == GL_TEXTURE_MIN_LOD)
+        {
+            RIXGL::getInstance().pipeline().texture().setMinLod(param);
+        }
+        else
+        {
+            RIXGL::getInstance().pipeline().texture().setMaxLod(param);
+        }
+        return;
+    }
     SPDLOG_DEBUG("glTexParameterf target 0x{:X} pname 0x{:X} param {} redirected to glTexParameteri", target, pname, param);
     impl_glTexParameteri(target, pname, static_cast<GLint>(param));
 }
@@ -3161,6 +3248,43 @@ GLAPI void APIENTRY impl_glTexParameteri(GLenum target, GLenum pname, GLint para
                 break;
             }
             break;
+        case GL_TEXTURE_BASE_LEVEL:
+            if (param >= 0)
+            {
+                RIXGL::getInstance().pipeline().texture().setBaseLevel(static_cast<std::size_t>(param));
+            }
+            else
+            {
+                RIXGL::getInstance().setError(GL_INVALID_VALUE);
+            }
+            break;
+        case GL_TEXTURE_MAX_LEVEL:
+            if (param >= 0)
+            {
+                RIXGL::getInstance().pipeline().texture().setMaxLevel(static_cast<std::size_t>(param));
+            }
+            else
+            {
+                RIXGL::getInstance().setError(GL_INVALID_VALUE);
+            }
+            break;
+        case GL_GENERATE_MIPMAP:
+            if (RIXGL::getInstance().isMipmappingAvailable())
+            {
+                RIXGL::getInstance().pipeline().texture().setGenerateMipmap(param != GL_FALSE);
+            }
+            else
+            {
+                SPDLOG_WARN("glTexParameteri GL_GENERATE_MIPMAP requires mipmapping on hardware");
+                RIXGL::getInstance().setError(GL_INVALID_ENUM);
+            }
+            break;
+        case GL_TEXTURE_MIN_LOD:
+            RIXGL::getInstance().pipeline().texture().setMinLod(static_cast<float>(param));
+            break;
+        case GL_TEXTURE_MAX_LOD:
+            RIXGL::getInstance().pipeline().texture().setMaxLod(static_cast<float>(param));
+            break;
         default:
             SPDLOG_WARN("glTexParameteri pname 0x{:X} not supported", pname);
             RIXGL::getInstance().setError(GL_INVALID_ENUM);
@@ -3752,31 +3876,60 @@ GLAPI void APIENTRY impl_glTexSubImage2D(GLenum target, GLint level, GLint xoffs
 
     TextureObject& texObj { RIXGL::getInstance().pipeline().texture().getTexture()[level] };
 
-    std::shared_ptr<uint16_t> texMemShared(new uint16_t[(texObj.width * texObj.height * 2)], [](const uint16_t* p)
-        { delete[] p; });
-    if (!texMemShared)
+    if (texObj.getSizeInBytes() == 0)
     {
-        SPDLOG_ERROR("glTexSubImage2D Out Of Memory");
+        // The level is not defined, or the host copy of the texture is not available anymore
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        SPDLOG_ERROR("glTexSubImage2D on an undefined texture level.");
         return;
     }
 
-    // In case, the current object contains pixel data, copy the data. Otherwise just initialize the memory.
-    if (texObj.pixels)
+    if (texObj.isCompressed())
     {
-        memcpy(texMemShared.get(), texObj.pixels.get(), texObj.width * texObj.height * 2);
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        SPDLOG_ERROR("glTexSubImage2D on a compressed texture is not supported.");
+        return;
     }
-    else
+
+    if ((pixels != nullptr) && texObj.isPaletted() && (format != GL_COLOR_INDEX))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        SPDLOG_ERROR("glTexSubImage2D paletted textures require the format GL_COLOR_INDEX.");
+        return;
+    }
+
+    const std::size_t sizeInBytes { texObj.getSizeInBytes() };
+    std::shared_ptr<uint16_t> texMemShared(new uint16_t[(sizeInBytes + 1) / 2], [](const uint16_t* p)
+        { delete[] p; });
+    if (!texMemShared)
     {
-        // Initialize the memory with zero for non power of two textures.
-        // Its probably the most reasonable init, because if the alpha channel is activated,
-        // then the not used area is then just transparent.
-        memset(texMemShared.get(), 0, texObj.width * texObj.height * 2);
+        SPDLOG_ERROR("glTexSubImage2D Out Of Memory");
+        return;
     }
 
+    // With texture threads, the conversion runs in the background. Then the client pixels are copied,
+    // because the application can reuse its memory as soon as this call returns.
+    Texture& texture { RIXGL::getInstance().pipeline().texture() };
+    const bool copyPixels { texture.isTextureJobAsync() };
+
     // Check if pixels is null. If so, just set the empty memory area and don't copy anything.
-    if (pixels != nullptr)
+    std::function<void()> conversion {};
+    if ((pixels != nullptr) && texObj.isPaletted())
+    {
+        conversion = TextureConverter::prepareIndexConversion(texMemShared,
+            texObj.width,
+            xoffset,
+            yoffset,
+            width,
+            height,
+            type,
+            reinterpret_cast<const uint8_t*>(pixels),
+            RIXGL::getInstance().unpackPixelStore(),
+            copyPixels);
+    }
+    else if (pixels != nullptr)
     {
-        TextureConverter::convert(texMemShared,
+        conversion = TextureConverter::prepareConversion(texMemShared,
             texObj.intendedPixelFormat,
             texObj.width,
             xoffset,
@@ -3785,10 +3938,62 @@ GLAPI void APIENTRY impl_glTexSubImage2D(GLenum target, GLint level, GLint xoffs
             height,
             format,
             type,
-            reinterpret_cast<const uint8_t*>(pixels));
+            reinterpret_cast<const uint8_t*>(pixels),
+            RIXGL::getInstance().unpackPixelStore(),
+            copyPixels);
     }
 
+    // In case, the current object contains pixel data, copy the data. Otherwise just initialize the memory.
+    const bool initializeTexture { !texObj.pixels };
+    const std::shared_ptr<const uint16_t> oldPixels { texObj.pixels };
     texObj.pixels = texMemShared;
+
+    // Only the changed region of the texture is uploaded again
+    if (initializeTexture)
+    {
+        texture.markTextureRegionDirty(level, 0, 0, texObj.width, texObj.height);
+    }
+    else if (pixels != nullptr)
+    {
+        texture.markTextureRegionDirty(level, xoffset, yoffset, width, height);
+    }
+
+    // Regenerate only the texels of the other levels which depend on the changed region
+    std::function<void()> mipmapGeneration {};
+    if ((level == 0) && texture.getGenerateMipmap() && !texObj.isPaletted())
+    {
+        if (initializeTexture)
+        {
+            mipmapGeneration = MipmapGenerator::generate(texture, 0, 0, texObj.width, texObj.height);
+        }
+        else if (pixels != nullptr)
+        {
+            mipmapGeneration = MipmapGenerator::generate(texture, xoffset, yoffset, width, height);
+        }
+    }
+
+    texture.postTextureJob([=]()
+        {
+            if (oldPixels)
+            {
+                memcpy(texMemShared.get(), oldPixels.get(), sizeInBytes);
+            }
+            else
+            {
+                // Initialize the memory with zero for non power of two textures.
+                // Its probably the most reasonable init, because if the alpha channel is activated,
+                // then the not used area is then just transparent.
+                memset(texMemShared.get(), 0, sizeInBytes);
+            }
+            if (conversion)
+            {
+                conversion();
+            }
+            if (mipmapGeneration)
+            {
+                mipmapGeneration();
+            }
+        });
 }
 
 GLAPI void APIENTRY impl_glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer)
@@ -3849,7 +4054,75 @@ GLAPI void APIENTRY impl_glCompressedTexImage3D(GLenum target, GLint level, GLen
 
 GLAPI void APIENTRY impl_glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data)
 {
-    SPDLOG_WARN("glCompressedTexImage2D not implemented");
+    SPDLOG_DEBUG("glCompressedTexImage2D target 0x{:X} level 0x{:X} internalformat 0x{:X} width {} height {} border 0x{:X} imageSize {} called", target, level, internalformat, width, height, border, imageSize);
+
+    (void)border;
+
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    const std::size_t maxTexSize { RIXGL::getInstance().getMaxTextureSize() };
+
+    if (target != GL_TEXTURE_2D)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        SPDLOG_ERROR("glCompressedTexImage2D invalid target.");
+        return;
+    }
+
+    if ((level < 0) || (static_cast<std::size_t>(level) > RIXGL::getInstance().getMaxLOD()))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_VALUE);
+        SPDLOG_ERROR("glCompressedTexImage2D invalid lod.");
+        return;
+    }
+
+    if (!RIXGL::getInstance().isMipmappingAvailable() && (level != 0))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_VALUE);
+        SPDLOG_ERROR("Mipmapping on hardware not supported.");
+        return;
+    }
+
+    // The compressed blocks are directly streamed into the TMU. Therefore the texture can't be resized and must already be power of two.
+    if ((width <= 0) || (height <= 0)
+        || (static_cast<std::size_t>(width) > maxTexSize) || (static_cast<std::size_t>(height) > maxTexSize)
+        || ((width & (width - 1)) != 0) || ((height & (height - 1)) != 0))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_VALUE);
+        SPDLOG_ERROR("glCompressedTexImage2D texture with invalid size ({}, {}).", width, height);
+        return;
+    }
+
+    const TextureObject::IntendedInternalPixelFormat intendedInternalPixelFormat { TextureConverter::convertToCompressedPixelFormat(internalformat) };
+
+    if (RIXGL::getInstance().getError() != GL_NO_ERROR)
+    {
+        return;
+    }
+
+    const std::size_t sizeInBytes { TextureObject::getCompressedSizeInBytes(width, height) };
+    if ((imageSize < 0) || (static_cast<std::size_t>(imageSize) != sizeInBytes) || (data == nullptr))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_VALUE);
+        SPDLOG_ERROR("glCompressedTexImage2D invalid imageSize {} (expected {}).", imageSize, sizeInBytes);
+        return;
+    }
+
+    std::shared_ptr<uint16_t> texMemShared(new uint16_t[sizeInBytes / 2], [](const uint16_t* p)
+        { delete[] p; });
+    if (!texMemShared)
+    {
+        SPDLOG_ERROR("glCompressedTexImage2D Out Of Memory");
+        return;
+    }
+    memcpy(texMemShared.get(), data, sizeInBytes);
+
+    TextureObject& texObj { RIXGL::getInstance().pipeline().texture().getTexture()[level] };
+    texObj.width = width;
+    texObj.height = height;
+    texObj.intendedPixelFormat = intendedInternalPixelFormat;
+    texObj.pixels = texMemShared;
+
+    RIXGL::getInstance().pipeline().texture().markTextureRegionDirty(level, 0, 0, texObj.width, texObj.height);
 }
 
 GLAPI void APIENTRY impl_glCompressedTexImage1D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLint border, GLsizei imageSize, const GLvoid* data)
@@ -4346,3 +4619,252 @@ GLAPI void APIENTRY impl_glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRG
 {
     SPDLOG_WARN("glBlendFuncSeparate not implemented");
 }
+
+GLAPI void APIENTRY impl_glGenFencesNV(GLsizei n, GLuint* fences)
+{
+    SPDLOG_DEBUG("glGenFencesNV n 0x{:X} called", n);
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    if (n < 0)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_VALUE);
+        return;
+    }
+    for (GLsizei i = 0; i < n; i++)
+    {
+        fences[i] = RIXGL::getInstance().genFence();
+    }
+}
+
+GLAPI void APIENTRY impl_glDeleteFencesNV(GLsizei n, const GLuint* fences)
+{
+    SPDLOG_DEBUG("glDeleteFencesNV n 0x{:X} called", n);
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    if (n < 0)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_VALUE);
+        return;
+    }
+    for (GLsizei i = 0; i < n; i++)
+    {
+        RIXGL::getInstance().deleteFence(fences[i]);
+    }
+}
+
+GLAPI void APIENTRY impl_glSetFenceNV(GLuint fence, GLenum condition)
+{
+    SPDLOG_DEBUG("glSetFenceNV fence 0x{:X} condition 0x{:X} called", fence, condition);
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    if (condition != GL_ALL_COMPLETED_NV)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        return;
+    }
+    RIXGL::getInstance().setFence(fence);
+}
+
+GLAPI GLboolean APIENTRY impl_glTestFenceNV(GLuint fence)
+{
+    SPDLOG_DEBUG("glTestFenceNV fence 0x{:X} called", fence);
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    if (!RIXGL::getInstance().isFence(fence))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        return GL_TRUE;
+    }
+    return RIXGL::getInstance().testFence(fence);
+}
+
+GLAPI void APIENTRY impl_glFinishFenceNV(GLuint fence)
+{
+    SPDLOG_DEBUG("glFinishFenceNV fence 0x{:X} called", fence);
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    if (!RIXGL::getInstance().isFence(fence))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        return;
+    }
+    RIXGL::getInstance().finishFence(fence);
+}
+
+GLAPI GLboolean APIENTRY impl_glIsFenceNV(GLuint fence)
+{
+    SPDLOG_DEBUG("glIsFenceNV fence 0x{:X} called", fence);
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    return RIXGL::getInstance().isFence(fence);
+}
+
+GLAPI void APIENTRY impl_glGetFenceivNV(GLuint fence, GLenum pname, GLint* params)
+{
+    SPDLOG_DEBUG("glGetFenceivNV fence 0x{:X} pname 0x{:X} called", fence, pname);
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+    if (!RIXGL::getInstance().isFence(fence))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        return;
+    }
+    switch (pname)
+    {
+    case GL_FENCE_STATUS_NV:
+        *params = RIXGL::getInstance().testFence(fence);
+        break;
+    case GL_FENCE_CONDITION_NV:
+        *params = GL_ALL_COMPLETED_NV;
+        break;
+    default:
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        break;
+    }
+}
+
+GLAPI void APIENTRY impl_glColorTableEXT(GLenum target, GLenum internalFormat, GLsizei width, GLenum format, GLenum type, const GLvoid* table)
+{
+    SPDLOG_DEBUG("glColorTableEXT target 0x{:X} internalFormat 0x{:X} width {} format 0x{:X} type 0x{:X} called", target, internalFormat, width, format, type);
+
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+
+    if (target != GL_TEXTURE_2D)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        SPDLOG_ERROR("glColorTableEXT invalid target.");
+        return;
+    }
+
+    if ((width <= 0) || ((width & (width - 1)) != 0) || (static_cast<std::size_t>(width) > TextureObject::PALETTE_SIZE))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_VALUE);
+        SPDLOG_ERROR("glColorTableEXT invalid width {}.", width);
+        return;
+    }
+
+    const TextureObject::IntendedInternalPixelFormat paletteFormat { TextureConverter::convertToIntendedPixelFormat(internalFormat) };
+    if ((RIXGL::getInstance().getError() != GL_NO_ERROR) || (paletteFormat == TextureObject::IntendedInternalPixelFormat::COLOR_INDEX8))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        return;
+    }
+
+    // The TMU always loads the complete palette. Not specified colors are black.
+    std::shared_ptr<uint16_t> palette(new uint16_t[TextureObject::PALETTE_SIZE], [](const uint16_t* p)
+        { delete[] p; });
+    if (!palette)
+    {
+        SPDLOG_ERROR("glColorTableEXT Out Of Memory");
+        return;
+    }
+    memset(palette.get(), 0, TextureObject::PALETTE_BYTES);
+
+    if (table != nullptr)
+    {
+        TextureConverter::convert(palette,
+            paletteFormat,
+            TextureObject::PALETTE_SIZE,
+            0,
+            0,
+            width,
+            1,
+            format,
+            type,
+            reinterpret_cast<const uint8_t*>(table),
+            RIXGL::getInstance().unpackPixelStore());
+        if (RIXGL::getInstance().getError() != GL_NO_ERROR)
+        {
+            return;
+        }
+    }
+
+    // The palette belongs to the texture and is stored in the base level
+    TextureObject& texObj { RIXGL::getInstance().pipeline().texture().getTexture()[0] };
+    texObj.palette = palette;
+    texObj.paletteFormat = paletteFormat;
+}
+
+GLAPI void APIENTRY impl_glColorSubTableEXT(GLenum target, GLsizei start, GLsizei count, GLenum format, GLenum type, const GLvoid* data)
+{
+    SPDLOG_DEBUG("glColorSubTableEXT target 0x{:X} start {} count {} format 0x{:X} type 0x{:X} called", target, start, count, format, type);
+
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+
+    if (target != GL_TEXTURE_2D)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        SPDLOG_ERROR("glColorSubTableEXT invalid target.");
+        return;
+    }
+
+    if ((start < 0) || (count < 0) || (static_cast<std::size_t>(start + count) > TextureObject::PALETTE_SIZE))
+    {
+        RIXGL::getInstance().setError(GL_INVALID_VALUE);
+        SPDLOG_ERROR("glColorSubTableEXT invalid range.");
+        return;
+    }
+
+    TextureObject& texObj { RIXGL::getInstance().pipeline().texture().getTexture()[0] };
+    if (!texObj.palette)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        SPDLOG_ERROR("glColorSubTableEXT called without a color table.");
+        return;
+    }
+
+    if ((count == 0) || (data == nullptr))
+    {
+        return;
+    }
+
+    std::shared_ptr<uint16_t> palette(new uint16_t[TextureObject::PALETTE_SIZE], [](const uint16_t* p)
+        { delete[] p; });
+    if (!palette)
+    {
+        SPDLOG_ERROR("glColorSubTableEXT Out Of Memory");
+        return;
+    }
+    memcpy(palette.get(), texObj.palette.get(), TextureObject::PALETTE_BYTES);
+
+    TextureConverter::convert(palette,
+        texObj.paletteFormat,
+        TextureObject::PALETTE_SIZE,
+        start,
+        0,
+        count,
+        1,
+        format,
+        type,
+        reinterpret_cast<const uint8_t*>(data),
+        RIXGL::getInstance().unpackPixelStore());
+    if (RIXGL::getInstance().getError() != GL_NO_ERROR)
+    {
+        return;
+    }
+
+    texObj.palette = palette;
+}
+
+GLAPI void APIENTRY impl_glGenerateMipmap(GLenum target)
+{
+    SPDLOG_DEBUG("glGenerateMipmap target 0x{:X} called", target);
+
+    RIXGL::getInstance().setError(GL_NO_ERROR);
+
+    if (target != GL_TEXTURE_2D)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_ENUM);
+        SPDLOG_ERROR("glGenerateMipmap invalid target.");
+        return;
+    }
+
+    if (!RIXGL::getInstance().isMipmappingAvailable())
+    {
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        SPDLOG_ERROR("Mipmapping on hardware not supported.");
+        return;
+    }
+
+    const TextureObject& texObj { RIXGL::getInstance().pipeline().texture().getTexture()[0] };
+    const std::function<void()> mipmapGeneration { MipmapGenerator::generate(RIXGL::getInstance().pipeline().texture(), 0, 0, texObj.width, texObj.height) };
+    if (!mipmapGeneration)
+    {
+        RIXGL::getInstance().setError(GL_INVALID_OPERATION);
+        return;
+    }
+    RIXGL::getInstance().pipeline().texture().postTextureJob(mipmapGeneration);
+}
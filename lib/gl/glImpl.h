@@ -450,6 +450,16 @@ extern "C"
     GLAPI void APIENTRY impl_glActiveStencilFaceEXT(GLenum face);
     GLAPI void APIENTRY impl_glBlendEquation(GLenum mode);
     GLAPI void APIENTRY impl_glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha);
+    GLAPI void APIENTRY impl_glGenFencesNV(GLsizei n, GLuint* fences);
+    GLAPI void APIENTRY impl_glDeleteFencesNV(GLsizei n, const GLuint* fences);
+    GLAPI void APIENTRY impl_glSetFenceNV(GLuint fence, GLenum condition);
+    GLAPI GLboolean APIENTRY impl_glTestFenceNV(GLuint fence);
+    GLAPI void APIENTRY impl_glFinishFenceNV(GLuint fence);
+    GLAPI GLboolean APIENTRY impl_glIsFenceNV(GLuint fence);
+    GLAPI void APIENTRY impl_glGetFenceivNV(GLuint fence, GLenum pname, GLint* params);
+    GLAPI void APIENTRY impl_glColorTableEXT(GLenum target, GLenum internalFormat, GLsizei width, GLenum format, GLenum type, const GLvoid* table);
+    GLAPI void APIENTRY impl_glColorSubTableEXT(GLenum target, GLsizei start, GLsizei count, GLenum format, GLenum type, const GLvoid* data);
+    GLAPI void APIENTRY impl_glGenerateMipmap(GLenum target);
     // -------------------------------------------------------
 
 #ifdef __cplusplus
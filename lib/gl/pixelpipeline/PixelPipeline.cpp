@@ -19,8 +19,8 @@
 
 namespace rr
 {
-PixelPipeline::PixelPipeline(IDevice& device)
-    : m_renderer { device }
+PixelPipeline::PixelPipeline(IDevice& device, const std::vector<IThreadRunner*>& textureThreads)
+    : m_renderer { device, textureThreads }
 {
 }
 
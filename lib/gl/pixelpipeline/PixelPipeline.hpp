@@ -33,7 +33,7 @@ namespace rr
 class PixelPipeline
 {
 public:
-    PixelPipeline(IDevice& device);
+    PixelPipeline(IDevice& device, const std::vector<IThreadRunner*>& textureThreads = {});
     void deinit();
 
     // Drawing
@@ -42,6 +42,13 @@ public:
 
     // Switch and updating of display lists
     void swapDisplayList() { m_renderer.swapDisplayList(); }
+    void flush() { m_renderer.flush(); }
+    void finish() { m_renderer.finish(); }
+
+    // Synchronization
+    uint32_t insertFence() { return m_renderer.insertFence(); }
+    bool isFenceSignaled(const uint32_t fence) { return m_renderer.isFenceSignaled(fence); }
+    void blockUntilFenceIsSignaled(const uint32_t fence) { m_renderer.blockUntilFenceIsSignaled(fence); }
 
     // General configs
     bool setRenderResolution(const std::size_t x, const std::size_t y) { return m_renderer.setRenderResolution(x, y); }
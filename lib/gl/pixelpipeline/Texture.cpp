@@ -16,6 +16,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Texture.hpp"
+#include <algorithm>
 
 namespace rr
 {
@@ -47,8 +48,18 @@ bool Texture::updateTexture()
 
     if (m_textureObjectMipmap)
     {
-        ret = m_renderer.updateTexture(m_tmuConf[m_tmu].boundTexture, *m_textureObjectMipmap);
+        if (m_textureObjectMipmapAvailable)
+        {
+            ret = m_renderer.updateTexture(m_tmuConf[m_tmu].boundTexture, *m_textureObjectMipmap, m_dirtyRanges);
+        }
+        else
+        {
+            // The unknown texels would be uploaded as zeros, therefore the modification is discarded
+            SPDLOG_ERROR("Texture {} can't be modified, its host copy is not available", m_tmuConf[m_tmu].boundTexture);
+            ret = false;
+        }
         m_textureObjectMipmap = std::nullopt;
+        m_dirtyRanges = {};
 
         // Rebind texture to update the rasterizer with the new texture meta information
         // TODO: Check if this is still required
@@ -61,11 +72,57 @@ TextureObjectMipmap& Texture::getTexture()
 {
     if (!m_textureObjectMipmap)
     {
-        m_textureObjectMipmap = std::make_optional<TextureObjectMipmap>(m_renderer.getTexture(m_tmuConf[m_tmu].boundTexture));
+        const std::optional<TextureObjectMipmap> mipmap = m_renderer.getTexture(m_tmuConf[m_tmu].boundTexture);
+        m_textureObjectMipmapAvailable = mipmap.has_value();
+        m_textureObjectMipmap = mipmap.value_or(TextureObjectMipmap {});
     }
     return *m_textureObjectMipmap;
 }
 
+void Texture::setTexture(const TextureObjectMipmap& mipmap)
+{
+    // Replaces all levels. The current levels are not required, therefore they are not requested from the renderer.
+    m_textureObjectMipmap = mipmap;
+    m_textureObjectMipmapAvailable = true;
+    m_dirtyRanges = {};
+    for (std::size_t level = 0; level < mipmap.size(); level++)
+    {
+        markTextureRegionDirty(level, 0, 0, mipmap[level].width, mipmap[level].height);
+    }
+}
+
+void Texture::markTextureRegionDirty(const std::size_t level, const std::size_t xoffset, const std::size_t yoffset, const std::size_t width, const std::size_t height)
+{
+    const TextureObject& texObj = getTexture()[level];
+    if ((width == 0) || (height == 0) || (xoffset >= texObj.width) || (yoffset >= texObj.height))
+    {
+        return;
+    }
+    std::size_t begin = 0;
+    std::size_t end = texObj.getSizeInBytes();
+    if (!texObj.isCompressed())
+    {
+        // The texture is stored line by line. The range starts at the first texel of the first line
+        // and ends after the last texel of the last line.
+        // Compressed textures are stored in blocks and are always marked as a whole.
+        const std::size_t bytesPerTexel = texObj.isPaletted() ? 1 : 2;
+        const std::size_t xEnd = (std::min)(xoffset + width, texObj.width);
+        const std::size_t yLast = (std::min)(yoffset + height, texObj.height) - 1;
+        begin = ((yoffset * texObj.width) + xoffset) * bytesPerTexel;
+        end = ((yLast * texObj.width) + xEnd) * bytesPerTexel;
+    }
+
+    TextureObjectDirtyRange& range = m_dirtyRanges[level];
+    if (range.empty())
+    {
+        range = { begin, end };
+    }
+    else
+    {
+        range = { (std::min)(range.begin, begin), (std::max)(range.end, end) };
+    }
+}
+
 bool Texture::useTexture()
 {
     updateTexture();
@@ -31,7 +31,13 @@ public:
     Texture(Renderer& renderer);
 
     bool updateTexture();
+
+    /// @brief Returns the levels of the bound texture to modify them. The modifications are uploaded with updateTexture().
+    ///     When the host copy of the texture is released and can't be read back, the levels are empty and
+    ///     the modifications are discarded.
     TextureObjectMipmap& getTexture();
+    void setTexture(const TextureObjectMipmap& mipmap);
+    void markTextureRegionDirty(const std::size_t level, const std::size_t xoffset, const std::size_t yoffset, const std::size_t width, const std::size_t height);
     bool useTexture();
     bool isTextureValid(const uint16_t texId) const { return m_renderer.isTextureValid(texId); };
     std::pair<bool, uint16_t> createTexture() { return m_renderer.createTexture(); }
@@ -42,6 +48,15 @@ public:
     void setTexWrapModeT(const TextureWrapMode mode) { m_renderer.setTextureWrapModeT(m_tmu, m_tmuConf[m_tmu].boundTexture, mode); }
     void setEnableMagFilter(const bool val) { m_renderer.enableTextureMagFiltering(m_tmu, m_tmuConf[m_tmu].boundTexture, val); }
     void setEnableMinFilter(const bool val) { m_renderer.enableTextureMinFiltering(m_tmu, m_tmuConf[m_tmu].boundTexture, val); }
+    void setBaseLevel(const std::size_t val) { m_renderer.setTextureBaseLevel(m_tmu, m_tmuConf[m_tmu].boundTexture, val); }
+    void setMaxLevel(const std::size_t val) { m_renderer.setTextureMaxLevel(m_tmu, m_tmuConf[m_tmu].boundTexture, val); }
+    void setGenerateMipmap(const bool val) { m_renderer.setTextureGenerateMipmap(m_tmuConf[m_tmu].boundTexture, val); }
+    bool getGenerateMipmap() const { return m_renderer.isTextureGenerateMipmap(m_tmuConf[m_tmu].boundTexture); }
+    bool postTextureJob(const std::function<void()>& job) { return m_renderer.postTextureJob(m_tmuConf[m_tmu].boundTexture, job); }
+    bool isTextureJobAsync() const { return m_renderer.isTextureJobAsync(); }
+    void waitForTextureJobs() { m_renderer.waitForTextureJobs(); }
+    void setMinLod(const float val) { m_renderer.setTextureMinLod(m_tmu, m_tmuConf[m_tmu].boundTexture, val); }
+    void setMaxLod(const float val) { m_renderer.setTextureMaxLod(m_tmu, m_tmuConf[m_tmu].boundTexture, val); }
 
     bool setTexEnvMode(const TexEnvMode mode);
     void setCombineRgb(const Combine val) { texEnv().setCombineRgb(val); }
@@ -103,6 +118,8 @@ private:
     std::array<TmuConfig, RenderConfig::TMU_COUNT> m_tmuConf {};
     std::size_t m_tmu { 0 };
     std::optional<TextureObjectMipmap> m_textureObjectMipmap {};
+    bool m_textureObjectMipmapAvailable { true };
+    TextureObjectMipmapDirtyRanges m_dirtyRanges {};
 };
 
 } // namespace rr
@@ -0,0 +1,198 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef _BITMAP_ALLOCATOR_HPP_
+#define _BITMAP_ALLOCATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace rr
+{
+
+// Allocator for a fixed number of equally sized resources (pages, slots, names).
+// Every resource is represented by one bit, which is set when the resource is free.
+// A free resource is found with a find-first-set on the first word which still contains a free bit.
+template <std::size_t SIZE>
+class BitmapAllocator
+{
+public:
+    BitmapAllocator()
+    {
+        reset();
+    }
+
+    /// @brief Marks all resources as free
+    void reset()
+    {
+        m_bitmap.fill(~Word { 0 });
+        // Bits after SIZE are never free
+        if constexpr ((SIZE % WORD_BITS) != 0)
+        {
+            m_bitmap[NUMBER_OF_WORDS - 1] = (Word { 1 } << (SIZE % WORD_BITS)) - 1;
+        }
+        m_firstFreeWord = 0;
+        m_freeCount = SIZE;
+    }
+
+    /// @brief Allocates the free resource with the lowest index
+    /// @return The index of the resource or nothing if all resources are in use
+    std::optional<std::size_t> alloc()
+    {
+        for (; m_firstFreeWord < NUMBER_OF_WORDS; m_firstFreeWord++)
+        {
+            Word& word = m_bitmap[m_firstFreeWord];
+            if (word != 0)
+            {
+                const std::size_t bit = findFirstSet(word);
+                word &= word - 1;
+                m_freeCount--;
+                return (m_firstFreeWord * WORD_BITS) + bit;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// @brief Allocates a specific resource
+    /// @param index The index of the resource
+    /// @return false if the resource is already in use
+    bool alloc(const std::size_t index)
+    {
+        if (!isFree(index))
+        {
+            return false;
+        }
+        m_bitmap[index / WORD_BITS] &= ~mask(index);
+        m_freeCount--;
+        return true;
+    }
+
+    /// @brief Allocates the first run of consecutive free resources
+    /// @param count The number of resources
+    /// @return The index of the first resource of the run or nothing if there is no run which is long enough
+    std::optional<std::size_t> allocRange(const std::size_t count)
+    {
+        if ((count == 0) || (count > m_freeCount))
+        {
+            return std::nullopt;
+        }
+        std::size_t runStart = 0;
+        std::size_t runLength = 0;
+        for (std::size_t index = m_firstFreeWord * WORD_BITS; index < SIZE; index++)
+        {
+            if (((index % WORD_BITS) == 0) && (m_bitmap[index / WORD_BITS] == 0))
+            {
+                // Skip completely allocated words
+                runLength = 0;
+                index += WORD_BITS - 1;
+                continue;
+            }
+            if (!isFree(index))
+            {
+                runLength = 0;
+                continue;
+            }
+            if (runLength == 0)
+            {
+                runStart = index;
+            }
+            runLength++;
+            if (runLength == count)
+            {
+                for (std::size_t i = runStart; i < (runStart + count); i++)
+                {
+                    alloc(i);
+                }
+                return runStart;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// @brief Frees a resource. Freeing an already free resource has no effect.
+    /// @param index The index of the resource
+    void free(const std::size_t index)
+    {
+        if ((index >= SIZE) || isFree(index))
+        {
+            return;
+        }
+        m_bitmap[index / WORD_BITS] |= mask(index);
+        m_freeCount++;
+        if ((index / WORD_BITS) < m_firstFreeWord)
+        {
+            m_firstFreeWord = index / WORD_BITS;
+        }
+    }
+
+    bool isFree(const std::size_t index) const
+    {
+        return (index < SIZE) && ((m_bitmap[index / WORD_BITS] & mask(index)) != 0);
+    }
+
+    /// @brief Returns the length of the longest run of consecutive free resources
+    std::size_t getLargestFreeRange() const
+    {
+        std::size_t largest = 0;
+        std::size_t runLength = 0;
+        for (std::size_t index = 0; index < SIZE; index++)
+        {
+            runLength = isFree(index) ? (runLength + 1) : 0;
+            largest = (std::max)(largest, runLength);
+        }
+        return largest;
+    }
+
+    std::size_t getFreeCount() const { return m_freeCount; }
+    static constexpr std::size_t size() { return SIZE; }
+
+private:
+    using Word = uint32_t;
+    static constexpr std::size_t WORD_BITS { sizeof(Word) * 8 };
+    static constexpr std::size_t NUMBER_OF_WORDS { (SIZE + WORD_BITS - 1) / WORD_BITS };
+
+    static Word mask(const std::size_t index)
+    {
+        return Word { 1 } << (index % WORD_BITS);
+    }
+
+    static std::size_t findFirstSet(const Word word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctz(word));
+#else
+        std::size_t bit = 0;
+        for (Word w = word; (w & 1) == 0; w >>= 1)
+        {
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    std::array<Word, NUMBER_OF_WORDS> m_bitmap {};
+    // All words in front of this word are completely allocated
+    std::size_t m_firstFreeWord { 0 };
+    std::size_t m_freeCount { SIZE };
+};
+
+} // namespace rr
+
+#endif // _BITMAP_ALLOCATOR_HPP_
@@ -0,0 +1,380 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "CoarseDepthBuffer.hpp"
+#include "renderer/registers/DepthBufferAddrReg.hpp"
+#include "renderer/registers/DepthBufferClearDepthReg.hpp"
+#include "renderer/registers/FeatureEnableReg.hpp"
+#include "renderer/registers/FragmentPipelineReg.hpp"
+#include "renderer/registers/RenderResolutionReg.hpp"
+#include "renderer/registers/ScissorEndReg.hpp"
+#include "renderer/registers/ScissorStartReg.hpp"
+#include <algorithm>
+#include <limits>
+#include <spdlog/spdlog.h>
+
+namespace rr
+{
+
+void CoarseDepthBuffer::setRegister(const uint32_t regAddr, const uint32_t regData)
+{
+    switch (regAddr)
+    {
+    case FeatureEnableReg::getAddr():
+    {
+        FeatureEnableReg reg {};
+        reg.deserialize(regData);
+        m_enableDepthTest = reg.getEnableDepthTest();
+        m_enableAlphaTest = reg.getEnableAlphaTest();
+        m_enableStencilTest = reg.getEnableStencilTest();
+        m_enableScissor = reg.getEnableScissor();
+    }
+    break;
+    case FragmentPipelineReg::getAddr():
+    {
+        FragmentPipelineReg reg {};
+        reg.deserialize(regData);
+        m_depthFunc = reg.getDepthFunc();
+        m_depthMask = reg.getDepthMask();
+    }
+    break;
+    case DepthBufferClearDepthReg::getAddr():
+    {
+        DepthBufferClearDepthReg reg {};
+        reg.deserialize(regData);
+        m_clearDepth = static_cast<float>(reg.getValue()) / 65535.0f;
+    }
+    break;
+    case ScissorStartReg::getAddr():
+    {
+        ScissorStartReg reg {};
+        reg.deserialize(regData);
+        m_scissorStartX = reg.getX();
+        m_scissorStartY = reg.getY();
+    }
+    break;
+    case ScissorEndReg::getAddr():
+    {
+        ScissorEndReg reg {};
+        reg.deserialize(regData);
+        m_scissorEndX = reg.getX();
+        m_scissorEndY = reg.getY();
+    }
+    break;
+    case RenderResolutionReg::getAddr():
+    {
+        RenderResolutionReg reg {};
+        reg.deserialize(regData);
+        setResolution(reg.getX(), reg.getY());
+    }
+    break;
+    case DepthBufferAddrReg::getAddr():
+        invalidate();
+        break;
+    default:
+        break;
+    }
+}
+
+void CoarseDepthBuffer::setResolution(const std::size_t x, const std::size_t y)
+{
+    if ((x == m_resolutionX) && (y == m_resolutionY))
+    {
+        return;
+    }
+    m_resolutionX = x;
+    m_resolutionY = y;
+    m_tilesX = (x + TILE_SIZE - 1) / TILE_SIZE;
+    m_tilesY = (y + TILE_SIZE - 1) / TILE_SIZE;
+    m_tiles.resize(m_tilesX * m_tilesY);
+    invalidate();
+}
+
+void CoarseDepthBuffer::clear()
+{
+    for (std::size_t y = 0; y < m_tilesY; y++)
+    {
+        for (std::size_t x = 0; x < m_tilesX; x++)
+        {
+            Rect tile = getTile(x, y);
+            clipToScreen(tile);
+            float& tileDepth = m_tiles[(y * m_tilesX) + x];
+            if (isInsideScissor(tile))
+            {
+                tileDepth = m_clearDepth;
+            }
+            else if (m_enableScissor)
+            {
+                // Partially cleared tiles contain the old and the new values
+                tileDepth = std::max(tileDepth, m_clearDepth);
+            }
+        }
+    }
+}
+
+void CoarseDepthBuffer::invalidate()
+{
+    std::fill(m_tiles.begin(), m_tiles.end(), std::numeric_limits<float>::infinity());
+}
+
+bool CoarseDepthBuffer::drawTriangle(const TriangleStreamTypes::TriangleDesc& desc)
+{
+    if (!m_enableDepthTest)
+    {
+        // Without depth test, the depth buffer is neither read nor written
+        return true;
+    }
+
+    const bool depthCanOnlyDecrease = (m_depthFunc == TestFunc::LESS) || (m_depthFunc == TestFunc::LEQUAL);
+    if (!depthCanOnlyDecrease)
+    {
+        if (m_depthMask && (m_depthFunc != TestFunc::NEVER) && (m_depthFunc != TestFunc::EQUAL))
+        {
+            invalidateArea(desc.param);
+        }
+        return true;
+    }
+
+    // A fragment which fails the depth test can still update the stencil buffer
+    if (!m_enableStencilTest)
+    {
+        m_statistics.testedTriangles++;
+        if (isOccluded(desc.param))
+        {
+            m_statistics.culledTriangles++;
+            return false;
+        }
+    }
+
+    // The alpha and stencil test can discard fragments. Such triangles might not write every pixel.
+    if (m_depthMask && !m_enableAlphaTest && !m_enableStencilTest)
+    {
+        updateOccluder(desc.param);
+    }
+    return true;
+}
+
+bool CoarseDepthBuffer::isOccluded(const TriangleStreamTypes::StaticParams& params) const
+{
+    if (m_tiles.empty())
+    {
+        return false;
+    }
+    Rect area { params.bbStartX, params.bbStartY, params.bbEndX - 1, params.bbEndY - 1 };
+    if (!clipToScreen(area))
+    {
+        return false;
+    }
+    for (std::size_t y = area.startY / TILE_SIZE; y <= area.endY / TILE_SIZE; y++)
+    {
+        for (std::size_t x = area.startX / TILE_SIZE; x <= area.endX / TILE_SIZE; x++)
+        {
+            Rect rect = getTile(x, y);
+            if (!clipToBoundingBox(rect, params) || isOutsideOfAnEdge(params, rect))
+            {
+                // No fragment of the triangle is in this tile
+                continue;
+            }
+            // The depth is a plane. Within the tile, the minimum is in one of the corners.
+            if ((getMinDepth(params, rect) - DEPTH_EPSILON) <= m_tiles[(y * m_tilesX) + x])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void CoarseDepthBuffer::updateOccluder(const TriangleStreamTypes::StaticParams& params)
+{
+    // Only triangles which can completely cover a tile are used as occluders
+    if (((params.bbEndX - params.bbStartX) < static_cast<int32_t>(TILE_SIZE))
+        || ((params.bbEndY - params.bbStartY) < static_cast<int32_t>(TILE_SIZE))
+        || m_tiles.empty())
+    {
+        return;
+    }
+    Rect area { params.bbStartX, params.bbStartY, params.bbEndX - 1, params.bbEndY - 1 };
+    if (!clipToScreen(area))
+    {
+        return;
+    }
+    bool isOccluder = false;
+    for (std::size_t y = area.startY / TILE_SIZE; y <= area.endY / TILE_SIZE; y++)
+    {
+        for (std::size_t x = area.startX / TILE_SIZE; x <= area.endX / TILE_SIZE; x++)
+        {
+            Rect tile = getTile(x, y);
+            clipToScreen(tile);
+            // The triangle is convex. When all corners are inside, then the whole tile is covered.
+            if (isInsideScissor(tile) && isInsideOfAllEdges(params, tile))
+            {
+                float& tileDepth = m_tiles[(y * m_tilesX) + x];
+                tileDepth = std::min(tileDepth, getMaxDepth(params, tile));
+                isOccluder = true;
+            }
+        }
+    }
+    if (isOccluder)
+    {
+        m_statistics.occluderTriangles++;
+    }
+}
+
+void CoarseDepthBuffer::invalidateArea(const TriangleStreamTypes::StaticParams& params)
+{
+    Rect area { params.bbStartX, params.bbStartY, params.bbEndX - 1, params.bbEndY - 1 };
+    if (m_tiles.empty() || !clipToScreen(area))
+    {
+        return;
+    }
+    for (std::size_t y = area.startY / TILE_SIZE; y <= area.endY / TILE_SIZE; y++)
+    {
+        for (std::size_t x = area.startX / TILE_SIZE; x <= area.endX / TILE_SIZE; x++)
+        {
+            m_tiles[(y * m_tilesX) + x] = std::numeric_limits<float>::infinity();
+        }
+    }
+}
+
+bool CoarseDepthBuffer::clipToBoundingBox(Rect& rect, const TriangleStreamTypes::StaticParams& params) const
+{
+    rect.startX = std::max(rect.startX, static_cast<int32_t>(params.bbStartX));
+    rect.startY = std::max(rect.startY, static_cast<int32_t>(params.bbStartY));
+    rect.endX = std::min(rect.endX, static_cast<int32_t>(params.bbEndX) - 1);
+    rect.endY = std::min(rect.endY, static_cast<int32_t>(params.bbEndY) - 1);
+    if (m_enableScissor)
+    {
+        rect.startX = std::max(rect.startX, m_scissorStartX);
+        rect.startY = std::max(rect.startY, m_scissorStartY);
+        rect.endX = std::min(rect.endX, m_scissorEndX - 1);
+        rect.endY = std::min(rect.endY, m_scissorEndY - 1);
+    }
+    return (rect.startX <= rect.endX) && (rect.startY <= rect.endY);
+}
+
+bool CoarseDepthBuffer::clipToScreen(Rect& rect) const
+{
+    rect.startX = std::max(rect.startX, 0);
+    rect.startY = std::max(rect.startY, 0);
+    rect.endX = std::min(rect.endX, static_cast<int32_t>(m_resolutionX) - 1);
+    rect.endY = std::min(rect.endY, static_cast<int32_t>(m_resolutionY) - 1);
+    return (rect.startX <= rect.endX) && (rect.startY <= rect.endY);
+}
+
+bool CoarseDepthBuffer::isInsideScissor(const Rect& rect) const
+{
+    if (!m_enableScissor)
+    {
+        return true;
+    }
+    return (rect.startX >= m_scissorStartX)
+        && (rect.startY >= m_scissorStartY)
+        && (rect.endX < m_scissorEndX)
+        && (rect.endY < m_scissorEndY);
+}
+
+CoarseDepthBuffer::Rect CoarseDepthBuffer::getTile(const std::size_t tileX, const std::size_t tileY) const
+{
+    const int32_t x = static_cast<int32_t>(tileX * TILE_SIZE);
+    const int32_t y = static_cast<int32_t>(tileY * TILE_SIZE);
+    return { x, y, x + static_cast<int32_t>(TILE_SIZE) - 1, y + static_cast<int32_t>(TILE_SIZE) - 1 };
+}
+
+std::array<int64_t, 4> CoarseDepthBuffer::getEdgeFunctionAtCorners(const TriangleStreamTypes::StaticParams& params,
+    const Rect& rect,
+    const std::size_t edge)
+{
+    // Evaluates the edge function like the hardware at the pixel positions
+    const int64_t dx0 = rect.startX - params.bbStartX;
+    const int64_t dy0 = rect.startY - params.bbStartY;
+    const int64_t dx1 = rect.endX - params.bbStartX;
+    const int64_t dy1 = rect.endY - params.bbStartY;
+    const int64_t wInit = params.wInit[edge];
+    const int64_t wXInc = params.wXInc[edge];
+    const int64_t wYInc = params.wYInc[edge];
+    return {
+        wInit + (wXInc * dx0) + (wYInc * dy0),
+        wInit + (wXInc * dx1) + (wYInc * dy0),
+        wInit + (wXInc * dx0) + (wYInc * dy1),
+        wInit + (wXInc * dx1) + (wYInc * dy1),
+    };
+}
+
+bool CoarseDepthBuffer::isOutsideOfAnEdge(const TriangleStreamTypes::StaticParams& params, const Rect& rect)
+{
+    // A pixel is inside of the triangle, when all edge functions are positive or zero
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        const std::array<int64_t, 4> w = getEdgeFunctionAtCorners(params, rect, i);
+        if (std::all_of(w.begin(), w.end(), [](const int64_t v)
+                { return v < 0; }))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CoarseDepthBuffer::isInsideOfAllEdges(const TriangleStreamTypes::StaticParams& params, const Rect& rect)
+{
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        const std::array<int64_t, 4> w = getEdgeFunctionAtCorners(params, rect, i);
+        if (std::any_of(w.begin(), w.end(), [](const int64_t v)
+                { return v < 0; }))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+float CoarseDepthBuffer::getMinDepth(const TriangleStreamTypes::StaticParams& params, const Rect& rect)
+{
+    const float dx0 = static_cast<float>(rect.startX - params.bbStartX);
+    const float dy0 = static_cast<float>(rect.startY - params.bbStartY);
+    const float dx1 = static_cast<float>(rect.endX - params.bbStartX);
+    const float dy1 = static_cast<float>(rect.endY - params.bbStartY);
+    const float x = std::min(params.depthZwXInc[0] * dx0, params.depthZwXInc[0] * dx1);
+    const float y = std::min(params.depthZwYInc[0] * dy0, params.depthZwYInc[0] * dy1);
+    // The depth buffer saturates the values to its range
+    return std::clamp(params.depthZw[0] + x + y, 0.0f, 1.0f);
+}
+
+float CoarseDepthBuffer::getMaxDepth(const TriangleStreamTypes::StaticParams& params, const Rect& rect)
+{
+    const float dx0 = static_cast<float>(rect.startX - params.bbStartX);
+    const float dy0 = static_cast<float>(rect.startY - params.bbStartY);
+    const float dx1 = static_cast<float>(rect.endX - params.bbStartX);
+    const float dy1 = static_cast<float>(rect.endY - params.bbStartY);
+    const float x = std::max(params.depthZwXInc[0] * dx0, params.depthZwXInc[0] * dx1);
+    const float y = std::max(params.depthZwYInc[0] * dy0, params.depthZwYInc[0] * dy1);
+    // The depth buffer saturates the values to its range
+    return std::clamp(params.depthZw[0] + x + y, 0.0f, 1.0f);
+}
+
+void CoarseDepthBuffer::logStatistics()
+{
+    SPDLOG_DEBUG("Coarse occlusion culling: {} of {} tested triangles culled, {} occluders",
+        m_statistics.culledTriangles,
+        m_statistics.testedTriangles,
+        m_statistics.occluderTriangles);
+    resetStatistics();
+}
+
+} // namespace rr
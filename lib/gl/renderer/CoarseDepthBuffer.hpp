@@ -0,0 +1,123 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef COARSE_DEPTH_BUFFER_HPP
+#define COARSE_DEPTH_BUFFER_HPP
+
+#include "Enums.hpp"
+#include "commands/TriangleStreamTypes.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rr
+{
+
+// Low resolution copy of the depth buffer to reject hidden triangles before they are sent to the hardware.
+// Every tile stores the maximum depth value, which the tile can contain in the hardware depth buffer.
+// The tiles are updated with triangles which completely cover a tile (occluders). A triangle is occluded,
+// when it is behind the stored maximum in every tile it touches.
+// The buffer mirrors the register writes, clears and triangles in the same order as the hardware receives them.
+// All decisions are conservative: A triangle which would change a pixel is never rejected.
+class CoarseDepthBuffer
+{
+public:
+    static constexpr std::size_t TILE_SIZE { 8 };
+    // Tolerance for the 16 bit quantization of the depth buffer and the interpolation errors of the hardware
+    static constexpr float DEPTH_EPSILON { 1.0f / 4096.0f };
+
+    struct Statistics
+    {
+        std::size_t testedTriangles { 0 }; ///< Triangles which were tested against the buffer
+        std::size_t culledTriangles { 0 }; ///< Triangles which were rejected
+        std::size_t occluderTriangles { 0 }; ///< Triangles which updated at least one tile
+    };
+
+    /// @brief Mirrors a register write. Only the registers which are relevant for the depth buffer are decoded.
+    /// @param regAddr The address of the register
+    /// @param regData The serialized register value
+    void setRegister(const uint32_t regAddr, const uint32_t regData);
+
+    /// @brief Mirrors a clear of the depth buffer with the current clear depth and scissor
+    void clear();
+
+    /// @brief Marks the content of the depth buffer as unknown, for instance when the depth buffer is replaced.
+    void invalidate();
+
+    /// @brief Tests if the triangle is hidden. If it is visible, the tiles are updated with the triangle.
+    /// @param desc The set up triangle, how it is sent to the hardware
+    /// @return false if the triangle is completely hidden and can be discarded
+    bool drawTriangle(const TriangleStreamTypes::TriangleDesc& desc);
+
+    const Statistics& getStatistics() const { return m_statistics; }
+    void resetStatistics() { m_statistics = {}; }
+
+    /// @brief Logs the statistics of the last frame and resets them
+    void logStatistics();
+
+private:
+    struct Rect
+    {
+        int32_t startX;
+        int32_t startY;
+        int32_t endX; // inclusive
+        int32_t endY; // inclusive
+    };
+
+    void setResolution(const std::size_t x, const std::size_t y);
+    bool isOccluded(const TriangleStreamTypes::StaticParams& params) const;
+    void updateOccluder(const TriangleStreamTypes::StaticParams& params);
+    void invalidateArea(const TriangleStreamTypes::StaticParams& params);
+    bool clipToBoundingBox(Rect& rect, const TriangleStreamTypes::StaticParams& params) const;
+    bool clipToScreen(Rect& rect) const;
+    bool isInsideScissor(const Rect& rect) const;
+    Rect getTile(const std::size_t tileX, const std::size_t tileY) const;
+
+    static std::array<int64_t, 4> getEdgeFunctionAtCorners(const TriangleStreamTypes::StaticParams& params,
+        const Rect& rect,
+        const std::size_t edge);
+    static bool isOutsideOfAnEdge(const TriangleStreamTypes::StaticParams& params, const Rect& rect);
+    static bool isInsideOfAllEdges(const TriangleStreamTypes::StaticParams& params, const Rect& rect);
+    static float getMinDepth(const TriangleStreamTypes::StaticParams& params, const Rect& rect);
+    static float getMaxDepth(const TriangleStreamTypes::StaticParams& params, const Rect& rect);
+
+    std::vector<float> m_tiles {};
+    std::size_t m_tilesX { 0 };
+    std::size_t m_tilesY { 0 };
+    std::size_t m_resolutionX { 0 };
+    std::size_t m_resolutionY { 0 };
+
+    // Mirrored state of the pixel pipeline
+    bool m_enableDepthTest { false };
+    bool m_enableAlphaTest { false };
+    bool m_enableStencilTest { false };
+    bool m_enableScissor { false };
+    bool m_depthMask { false };
+    TestFunc m_depthFunc { TestFunc::LESS };
+    float m_clearDepth { 1.0f };
+    int32_t m_scissorStartX { 0 };
+    int32_t m_scissorStartY { 0 };
+    int32_t m_scissorEndX { 0 };
+    int32_t m_scissorEndY { 0 };
+
+    Statistics m_statistics {};
+};
+
+} // namespace rr
+
+#endif // COARSE_DEPTH_BUFFER_HPP
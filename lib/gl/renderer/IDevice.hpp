@@ -35,17 +35,79 @@ public:
     /// @param size The size of the display list in bytes.
     virtual void streamDisplayList(const uint8_t index, const uint32_t size) = 0;
 
+    /// @brief Informs the device about a display list which is still written. The device can start to
+    ///     process it before streamDisplayList() is called with the final size.
+    ///
+    /// @param index The index of the display list in the device's memory.
+    /// @param size The size of the display list in bytes which will not change anymore. Must point to
+    ///     the end of a draw, like the start of a SetVertexCtxCmd.
+    /// @param force Hands the partial display list to the device, even if the device would usually wait
+    ///     for more data.
+    virtual void streamPartialDisplayList(const uint8_t index, const uint32_t size, const bool force) = 0;
+
     /// @brief Writes data to a specific address in the device's memory.
     ///
     /// @param data The data to write.
     /// @param addr The address to write to.
     virtual void writeToDeviceMemory(tcb::span<const uint8_t> data, const uint32_t addr) = 0;
 
+    /// @brief Requests a buffer for a write to a specific address in the device's memory. The caller fills
+    ///     the buffer directly. The writes are collected and transferred with flushWritesToDeviceMemory().
+    ///     Writes to consecutive addresses might be merged into one transfer.
+    ///
+    /// @param addr The address to write to.
+    /// @param size The size of the data in bytes.
+    /// @return The buffer to fill with the data. Empty if the write is too big for the device.
+    virtual tcb::span<uint8_t> requestWriteToDeviceMemory(const uint32_t addr, const uint32_t size) = 0;
+
+    /// @brief Transfers all writes requested with requestWriteToDeviceMemory() to the device.
+    ///     The writes are executed after all previously streamed display lists.
+    virtual void flushWritesToDeviceMemory() = 0;
+
+    /// @brief Reads data from a specific address in the device's memory. Blocks until all writes to the
+    ///     device memory are executed.
+    ///
+    /// @param data The buffer which receives the data.
+    /// @param addr The address to read from.
+    /// @return false if the device memory can't be read back.
+    virtual bool readFromDeviceMemory(tcb::span<uint8_t> data, const uint32_t addr) = 0;
+
+    /// @brief Returns if the device memory can be read back with readFromDeviceMemory().
+    virtual bool canReadFromDeviceMemory() const = 0;
+
     /// @brief Waits until the device is idle and ready for new commands.
     ///     When this method returns, the buffer used in streamDisplayList can be safely reused.
     ///     Same is true for the buffer in writeToDeviceMemory.
     virtual void blockUntilDeviceIsIdle() = 0;
 
+    /// @brief Creates a fence behind all display lists which were streamed with streamDisplayList().
+    ///
+    /// @return The fence. Fences are increasing sequence numbers.
+    virtual uint32_t insertFence() = 0;
+
+    /// @brief Checks without blocking if the device has processed all display lists in front of the fence.
+    ///
+    /// @param fence The fence to check.
+    virtual bool isFenceSignaled(const uint32_t fence) = 0;
+
+    /// @brief Waits until the device has processed all display lists in front of the fence.
+    ///
+    /// @param fence The fence to wait for.
+    virtual void blockUntilFenceIsSignaled(const uint32_t fence) = 0;
+
+    /// @brief Checks if a sequence number has reached a fence. The sequence numbers wrap around,
+    ///     therefore they are compared by their distance, which must be less than 2^31.
+    ///
+    /// @param sequence The sequence number, for instance of the last processed display list.
+    /// @param fence The fence.
+    static bool isFenceReached(const uint32_t sequence, const uint32_t fence) { return static_cast<int32_t>(sequence - fence) >= 0; }
+
+    /// @brief Waits until a display list buffer is not used by the device anymore. Afterwards a new display
+    ///     list can be written into it. Other display lists might still be in flight.
+    ///
+    /// @param index The index of the display list buffer.
+    virtual void blockUntilDisplayListBufferIsFree(const uint8_t index) = 0;
+
     /// @brief Requests a buffer to write display lists into.
     ///
     /// @param index The index of the buffer to request.
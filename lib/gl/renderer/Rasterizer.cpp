@@ -16,9 +16,11 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Rasterizer.hpp"
+#include <cmath>
 #include <cstring>
 
 #include <algorithm> // std::max
+#include <limits>
 
 namespace rr
 {
@@ -73,6 +75,100 @@ bool Rasterizer::increment(TriangleStreamTypes::TriangleDesc& desc,
     return false;
 }
 
+bool Rasterizer::tightenBoundingBox(TriangleStreamTypes::TriangleDesc& desc,
+    const std::size_t lineStart,
+    const std::size_t lineEnd)
+{
+    TriangleStreamTypes::StaticParams& params = desc.param;
+    const int64_t dyStart = static_cast<int64_t>(std::max<std::size_t>(lineStart, params.bbStartY)) - params.bbStartY;
+    const int64_t dyEnd = static_cast<int64_t>(std::min<std::size_t>(lineEnd, params.bbEndY)) - params.bbStartY - 1;
+    const int64_t dxEnd = static_cast<int64_t>(params.bbEndX) - params.bbStartX - 1;
+    if (dyStart > dyEnd)
+    {
+        return false;
+    }
+    if (dxEnd < 0)
+    {
+        // Leave unusual bounding boxes to the hardware
+        return true;
+    }
+
+    int64_t lo = 0;
+    int64_t hi = dxEnd;
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        const int64_t wInit = params.wInit[i];
+        const int64_t wXInc = params.wXInc[i];
+        const int64_t wYInc = params.wYInc[i];
+
+        // The hardware calculates the edge functions with 32 bit. Only tighten the bounding box, when the
+        // edge functions are not overflowing. Then the 64 bit results are equal to the hardware.
+        for (const int64_t dy : { dyStart, dyEnd })
+        {
+            for (const int64_t dx : { int64_t { 0 }, dxEnd })
+            {
+                const int64_t w = wInit + (wXInc * dx) + (wYInc * dy);
+                if ((w < std::numeric_limits<int32_t>::min()) || (w > std::numeric_limits<int32_t>::max()))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // A column contains a pixel of the triangle only when each edge function is positive in one of the lines.
+        // The edge function is linear, therefore it is enough to check the first and the last line.
+        const int64_t w = wInit + std::max(wYInc * dyStart, wYInc * dyEnd);
+        if (wXInc > 0)
+        {
+            // w + (wXInc * dx) >= 0  ->  dx >= ceil(-w / wXInc)
+            const int64_t n = -w;
+            lo = std::max(lo, (n >= 0) ? ((n + wXInc - 1) / wXInc) : -((-n) / wXInc));
+        }
+        else if (wXInc < 0)
+        {
+            // w + (wXInc * dx) >= 0  ->  dx <= floor(w / -wXInc)
+            const int64_t d = -wXInc;
+            hi = std::min(hi, (w >= 0) ? (w / d) : -((-w + d - 1) / d));
+        }
+        else if (w < 0)
+        {
+            return false;
+        }
+    }
+    if (lo > hi)
+    {
+        return false;
+    }
+
+    params.bbEndX = static_cast<uint16_t>(params.bbStartX + hi + 1);
+    if (lo > 0)
+    {
+        const int32_t bbDiff = static_cast<int32_t>(lo);
+        params.bbStartX = static_cast<uint16_t>(params.bbStartX + bbDiff);
+
+        const auto wInitTmp = params.wInit;
+        params.wInit = params.wXInc;
+        params.wInit *= bbDiff;
+        params.wInit += wInitTmp;
+
+        params.depthZw += params.depthZwXInc * bbDiff;
+
+        const auto colorTmp = params.color;
+        params.color = params.colorXInc;
+        params.color *= bbDiff;
+        params.color += colorTmp;
+
+        for (std::size_t i = 0; i < desc.texture.size(); i++)
+        {
+            const auto texStqTmp = desc.texture[i].texStq;
+            desc.texture[i].texStq = desc.texture[i].texStqXInc;
+            desc.texture[i].texStq *= bbDiff;
+            desc.texture[i].texStq += texStqTmp;
+        }
+    }
+    return true;
+}
+
 VecInt Rasterizer::edgeFunctionFixPoint(const Vec2i& a, const Vec2i& b, const Vec2i& c)
 {
     VecInt val1 = (c[0] - a[0]) * (b[1] - a[1]);
@@ -81,6 +177,43 @@ VecInt Rasterizer::edgeFunctionFixPoint(const Vec2i& a, const Vec2i& b, const Ve
     return ges;
 }
 
+bool Rasterizer::coversSamplePoint(const Vec2i& v0, const Vec2i& v1, const Vec2i& v2, const VecInt sign)
+{
+    // The hardware samples the edge functions at the integer pixel positions. A sample on an edge is
+    // inside of the triangle. Calculate the first and last sample position in the bounding box.
+    const int32_t sampleStartX = (std::min(std::min(v0[0], v1[0]), v2[0]) + EDGE_FUNC_ONE_P_ZERO - 1) >> EDGE_FUNC_SIZE;
+    const int32_t sampleStartY = (std::min(std::min(v0[1], v1[1]), v2[1]) + EDGE_FUNC_ONE_P_ZERO - 1) >> EDGE_FUNC_SIZE;
+    const int32_t sampleEndX = std::max(std::max(v0[0], v1[0]), v2[0]) >> EDGE_FUNC_SIZE;
+    const int32_t sampleEndY = std::max(std::max(v0[1], v1[1]), v2[1]) >> EDGE_FUNC_SIZE;
+
+    // Slivers which are between two pixel rows or columns
+    if ((sampleStartX > sampleEndX) || (sampleStartY > sampleEndY))
+    {
+        return false;
+    }
+
+    // For bigger triangles it is cheaper to let the hardware walk over the bounding box
+    if (((sampleEndX - sampleStartX) >= SAMPLE_TEST_SIZE) || ((sampleEndY - sampleStartY) >= SAMPLE_TEST_SIZE))
+    {
+        return true;
+    }
+
+    for (int32_t y = sampleStartY; y <= sampleEndY; y++)
+    {
+        for (int32_t x = sampleStartX; x <= sampleEndX; x++)
+        {
+            const Vec2i p = { x << EDGE_FUNC_SIZE, y << EDGE_FUNC_SIZE };
+            if (((edgeFunctionFixPoint(v1, v2, p) * sign) >= 0)
+                && ((edgeFunctionFixPoint(v2, v0, p) * sign) >= 0)
+                && ((edgeFunctionFixPoint(v0, v1, p) * sign) >= 0))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 bool Rasterizer::rasterize(TriangleStreamTypes::TriangleDesc& __restrict desc,
     const TransformedTriangle& triangle) const
 {
@@ -98,6 +231,11 @@ bool Rasterizer::rasterize(TriangleStreamTypes::TriangleDesc& __restrict desc,
         return false;
     }
 
+    if (!coversSamplePoint(v0, v1, v2, sign))
+    {
+        return false;
+    }
+
     // Initialize Bounding box
     // Get the bounding box
     int32_t bbStartX = std::min(std::min(v0[0], v1[0]), v2[0]);
@@ -287,6 +425,293 @@ bool Rasterizer::rasterize(TriangleStreamTypes::TriangleDesc& __restrict desc,
     return true;
 }
 
+bool Rasterizer::TriangleBatch::add(const TransformedTriangle& triangle)
+{
+    const std::array<const Vec4*, 3> vertices { &triangle.vertex0, &triangle.vertex1, &triangle.vertex2 };
+    const std::array<const Vec4*, 3> colors { &triangle.color0, &triangle.color1, &triangle.color2 };
+    const std::array<const std::array<Vec4, RenderConfig::TMU_COUNT>*, 3> textures { &triangle.texture0, &triangle.texture1, &triangle.texture2 };
+    for (std::size_t v = 0; v < 3; v++)
+    {
+        for (std::size_t c = 0; c < 4; c++)
+        {
+            vertex[v][c][count] = (*vertices[v])[c];
+            color[v][c][count] = (*colors[v])[c];
+        }
+        for (std::size_t tmu = 0; tmu < RenderConfig::TMU_COUNT; tmu++)
+        {
+            texture[tmu][v][0][count] = (*textures[v])[tmu][0];
+            texture[tmu][v][1][count] = (*textures[v])[tmu][1];
+            texture[tmu][v][2][count] = (*textures[v])[tmu][3];
+        }
+    }
+    count++;
+    return count == BATCH_SIZE;
+}
+
+std::bitset<Rasterizer::BATCH_SIZE> Rasterizer::rasterize(const std::array<TriangleStreamTypes::TriangleDesc*, BATCH_SIZE>& descs,
+    const TriangleBatch& batch) const
+{
+    // Every step is calculated for all lanes before the next step starts. The operations and their order
+    // are the same as in the scalar rasterize(), therefore the results are bit identical.
+    using LaneI = std::array<int32_t, BATCH_SIZE>;
+    using LaneF = std::array<float, BATCH_SIZE>;
+
+    std::array<LaneI, 3> vx;
+    std::array<LaneI, 3> vy;
+    for (std::size_t v = 0; v < 3; v++)
+    {
+        for (std::size_t l = 0; l < BATCH_SIZE; l++)
+        {
+            vx[v][l] = static_cast<int32_t>((batch.vertex[v][0][l] * static_cast<float>(EDGE_FUNC_ONE_P_ZERO)) + 0.5f);
+            vy[v][l] = static_cast<int32_t>((batch.vertex[v][1][l] * static_cast<float>(EDGE_FUNC_ONE_P_ZERO)) + 0.5f);
+        }
+    }
+
+    LaneI area;
+    LaneI sign;
+    std::array<bool, BATCH_SIZE> visible;
+    for (std::size_t l = 0; l < BATCH_SIZE; l++)
+    {
+        area[l] = ((vx[2][l] - vx[0][l]) * (vy[1][l] - vy[0][l])) - ((vy[2][l] - vy[0][l]) * (vx[1][l] - vx[0][l]));
+        sign[l] = (area[l] <= 0) ? -1 : 1;
+        area[l] *= sign[l];
+        visible[l] = area[l] > 0;
+    }
+
+    for (std::size_t l = 0; l < BATCH_SIZE; l++)
+    {
+        visible[l] = visible[l]
+            && coversSamplePoint({ vx[0][l], vy[0][l] }, { vx[1][l], vy[1][l] }, { vx[2][l], vy[2][l] }, sign[l]);
+    }
+
+    // Bounding box
+    LaneI bbStartX;
+    LaneI bbStartY;
+    LaneI bbEndX;
+    LaneI bbEndY;
+    for (std::size_t l = 0; l < BATCH_SIZE; l++)
+    {
+        bbStartX[l] = std::min(std::min(vx[0][l], vx[1][l]), vx[2][l]) + EDGE_FUNC_ZERO_P_FIVE;
+        bbStartY[l] = std::min(std::min(vy[0][l], vy[1][l]), vy[2][l]) + EDGE_FUNC_ZERO_P_FIVE;
+        bbEndX[l] = std::max(std::max(vx[0][l], vx[1][l]), vx[2][l]) + EDGE_FUNC_ONE_P_ZERO + EDGE_FUNC_ZERO_P_FIVE;
+        bbEndY[l] = std::max(std::max(vy[0][l], vy[1][l]), vy[2][l]) + EDGE_FUNC_ONE_P_ZERO + EDGE_FUNC_ZERO_P_FIVE;
+    }
+
+    std::array<uint16_t, BATCH_SIZE> paramBbStartX;
+    std::array<uint16_t, BATCH_SIZE> paramBbStartY;
+    std::array<uint16_t, BATCH_SIZE> paramBbEndX;
+    std::array<uint16_t, BATCH_SIZE> paramBbEndY;
+    for (std::size_t l = 0; l < BATCH_SIZE; l++)
+    {
+        paramBbStartX[l] = bbStartX[l] >> EDGE_FUNC_SIZE;
+        paramBbStartY[l] = bbStartY[l] >> EDGE_FUNC_SIZE;
+        paramBbEndX[l] = bbEndX[l] >> EDGE_FUNC_SIZE;
+        paramBbEndY[l] = bbEndY[l] >> EDGE_FUNC_SIZE;
+    }
+
+    if (m_enableScissor)
+    {
+        for (std::size_t l = 0; l < BATCH_SIZE; l++)
+        {
+            const int32_t startX = std::max(bbStartX[l], m_scissorStartX);
+            const int32_t startY = std::max(bbStartY[l], m_scissorStartY);
+            const int32_t endX = std::min(bbEndX[l], m_scissorEndX);
+            const int32_t endY = std::min(bbEndY[l], m_scissorEndY);
+            visible[l] = visible[l] && (startX < endX) && (startY < endY);
+        }
+    }
+
+    // Edge functions. The increments are the difference of the edge function at the neighbor pixel
+    // and the start pixel, which simplifies to the edge direction.
+    std::array<LaneI, 3> wi;
+    std::array<LaneI, 3> wIncX;
+    std::array<LaneI, 3> wIncY;
+    for (std::size_t k = 0; k < 3; k++)
+    {
+        const LaneI& ax = vx[(k + 1) % 3];
+        const LaneI& ay = vy[(k + 1) % 3];
+        const LaneI& bx = vx[(k + 2) % 3];
+        const LaneI& by = vy[(k + 2) % 3];
+        for (std::size_t l = 0; l < BATCH_SIZE; l++)
+        {
+            const int32_t px = static_cast<int32_t>(paramBbStartX[l]) << EDGE_FUNC_SIZE;
+            const int32_t py = static_cast<int32_t>(paramBbStartY[l]) << EDGE_FUNC_SIZE;
+            wi[k][l] = (((px - ax[l]) * (by[l] - ay[l])) - ((py - ay[l]) * (bx[l] - ax[l]))) * sign[l];
+            wIncX[k][l] = ((by[l] - ay[l]) * EDGE_FUNC_ONE_P_ZERO) * sign[l];
+            wIncY[k][l] = ((ax[l] - bx[l]) * EDGE_FUNC_ONE_P_ZERO) * sign[l];
+        }
+    }
+
+    std::array<LaneF, 3> wNorm;
+    std::array<LaneF, 3> wIncXNorm;
+    std::array<LaneF, 3> wIncYNorm;
+    for (std::size_t l = 0; l < BATCH_SIZE; l++)
+    {
+        const float areaInv = 1.0f / area[l];
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            wNorm[k][l] = static_cast<float>(wi[k][l]) * areaInv;
+            wIncXNorm[k][l] = static_cast<float>(wIncX[k][l]) * areaInv;
+            wIncYNorm[k][l] = static_cast<float>(wIncY[k][l]) * areaInv;
+        }
+    }
+
+    const auto interpolate = [](const LaneF& a0, const LaneF& a1, const LaneF& a2, const std::array<LaneF, 3>& norm, LaneF& out)
+    {
+        for (std::size_t l = 0; l < BATCH_SIZE; l++)
+        {
+            out[l] = ((a0[l] * norm[0][l]) + (a1[l] * norm[1][l])) + (a2[l] * norm[2][l]);
+        }
+    };
+
+    for (std::size_t l = 0; l < batch.count; l++)
+    {
+        if (visible[l])
+        {
+            TriangleStreamTypes::StaticParams& params = descs[l]->param;
+            params.bbStartX = paramBbStartX[l];
+            params.bbStartY = paramBbStartY[l];
+            params.bbEndX = paramBbEndX[l];
+            params.bbEndY = paramBbEndY[l];
+            for (std::size_t k = 0; k < 3; k++)
+            {
+                params.wInit[k] = wi[k][l];
+                params.wXInc[k] = wIncX[k][l];
+                params.wYInc[k] = wIncY[k][l];
+            }
+        }
+    }
+
+    // Avoid that the w gets too small/big by normalizing it
+    std::array<LaneF, 3> w { batch.vertex[0][3], batch.vertex[1][3], batch.vertex[2][3] };
+    if (m_enableScaling)
+    {
+        for (std::size_t l = 0; l < BATCH_SIZE; l++)
+        {
+            float tmp = 0;
+            tmp += w[0][l] * w[0][l];
+            tmp += w[1][l] * w[1][l];
+            tmp += w[2][l] * w[2][l];
+            tmp = sqrtf(tmp);
+            // A multiplication with one keeps w untouched, like the early return in Vec::normalize()
+            tmp = (tmp == 0.0f) ? 1.0f : (1.0f / tmp);
+            w[0][l] = w[0][l] * tmp;
+            w[1][l] = w[1][l] * tmp;
+            w[2][l] = w[2][l] * tmp;
+        }
+    }
+
+    // Texture
+    for (std::size_t i = 0; i < RenderConfig::TMU_COUNT; i++)
+    {
+        if (!m_tmuEnable[i])
+        {
+            continue;
+        }
+        std::array<std::array<LaneF, 3>, 3> tex = batch.texture[i]; // [vertex][s, t, q]
+
+        // Avoid overflowing the integer part by adding an offset
+        if (m_enableScaling)
+        {
+            for (std::size_t c = 0; c < 2; c++)
+            {
+                for (std::size_t l = 0; l < BATCH_SIZE; l++)
+                {
+                    const float minC = std::min(tex[0][c][l], std::min(tex[1][c][l], tex[2][c][l]));
+                    const float maxC = std::max(tex[0][c][l], std::max(tex[1][c][l], tex[2][c][l]));
+                    const float minG = (minC < -4.0f) ? static_cast<float>(static_cast<int32_t>(minC)) : 0.0f;
+                    const float maxG = (maxC > 4.0f) ? static_cast<float>(static_cast<int32_t>(maxC)) : 0.0f;
+                    for (std::size_t v = 0; v < 3; v++)
+                    {
+                        tex[v][c][l] -= minG;
+                        tex[v][c][l] -= maxG;
+                    }
+                }
+            }
+        }
+
+        // Perspective correction
+        for (std::size_t v = 0; v < 3; v++)
+        {
+            for (std::size_t c = 0; c < 3; c++)
+            {
+                for (std::size_t l = 0; l < BATCH_SIZE; l++)
+                {
+                    tex[v][c][l] = tex[v][c][l] * w[v][l];
+                }
+            }
+        }
+
+        std::array<LaneF, 3> texStq;
+        std::array<LaneF, 3> texStqXInc;
+        std::array<LaneF, 3> texStqYInc;
+        for (std::size_t c = 0; c < 3; c++)
+        {
+            interpolate(tex[0][c], tex[1][c], tex[2][c], wNorm, texStq[c]);
+            interpolate(tex[0][c], tex[1][c], tex[2][c], wIncXNorm, texStqXInc[c]);
+            interpolate(tex[0][c], tex[1][c], tex[2][c], wIncYNorm, texStqYInc[c]);
+        }
+        for (std::size_t l = 0; l < batch.count; l++)
+        {
+            if (visible[l])
+            {
+                TriangleStreamTypes::Texture& t = descs[l]->texture[i];
+                for (std::size_t c = 0; c < 3; c++)
+                {
+                    t.texStq[c] = texStq[c][l];
+                    t.texStqXInc[c] = texStqXInc[c][l];
+                    t.texStqYInc[c] = texStqYInc[c][l];
+                }
+            }
+        }
+    }
+
+    // Depth
+    std::array<LaneF, 2> depthZw;
+    std::array<LaneF, 2> depthZwXInc;
+    std::array<LaneF, 2> depthZwYInc;
+    for (std::size_t c = 0; c < 2; c++)
+    {
+        interpolate(batch.vertex[0][2 + c], batch.vertex[1][2 + c], batch.vertex[2][2 + c], wNorm, depthZw[c]);
+        interpolate(batch.vertex[0][2 + c], batch.vertex[1][2 + c], batch.vertex[2][2 + c], wIncXNorm, depthZwXInc[c]);
+        interpolate(batch.vertex[0][2 + c], batch.vertex[1][2 + c], batch.vertex[2][2 + c], wIncYNorm, depthZwYInc[c]);
+    }
+
+    // Color
+    std::array<LaneF, 4> color;
+    std::array<LaneF, 4> colorXInc;
+    std::array<LaneF, 4> colorYInc;
+    for (std::size_t c = 0; c < 4; c++)
+    {
+        interpolate(batch.color[0][c], batch.color[1][c], batch.color[2][c], wNorm, color[c]);
+        interpolate(batch.color[0][c], batch.color[1][c], batch.color[2][c], wIncXNorm, colorXInc[c]);
+        interpolate(batch.color[0][c], batch.color[1][c], batch.color[2][c], wIncYNorm, colorYInc[c]);
+    }
+
+    std::bitset<BATCH_SIZE> visibleMask {};
+    for (std::size_t l = 0; l < batch.count; l++)
+    {
+        if (visible[l])
+        {
+            TriangleStreamTypes::StaticParams& params = descs[l]->param;
+            for (std::size_t c = 0; c < 2; c++)
+            {
+                params.depthZw[c] = depthZw[c][l];
+                params.depthZwXInc[c] = depthZwXInc[c][l];
+                params.depthZwYInc[c] = depthZwYInc[c][l];
+            }
+            for (std::size_t c = 0; c < 4; c++)
+            {
+                params.color[c] = color[c][l];
+                params.colorXInc[c] = colorXInc[c][l];
+                params.colorYInc[c] = colorYInc[c][l];
+            }
+            visibleMask.set(l);
+        }
+    }
+    return visibleMask;
+}
+
 float Rasterizer::edgeFunctionFloat(const Vec4& a, const Vec4& b, const Vec4& c)
 {
     float val1 = (c[0] - a[0]) * (b[1] - a[1]);
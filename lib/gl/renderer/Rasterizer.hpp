@@ -34,9 +34,37 @@ public:
     {
     }
 
+    // Number of triangles which are set up at once by the batched rasterize(). The batched setup
+    // computes every value for all lanes in a loop, which the compiler maps onto SIMD registers (SSE, NEON).
+    static constexpr std::size_t BATCH_SIZE { 8 };
+
+    // The attributes of up to BATCH_SIZE triangles in a structure of arrays layout
+    struct TriangleBatch
+    {
+        template <std::size_t N>
+        using Lanes = std::array<std::array<float, BATCH_SIZE>, N>;
+
+        /// @brief Copies the triangle into the next free lane
+        /// @param triangle The triangle to add
+        /// @return true when the batch is full
+        bool add(const TransformedTriangle& triangle);
+
+        std::size_t count { 0 };
+        std::array<Lanes<4>, 3> vertex {}; ///< [vertex][x, y, z, w][lane]
+        std::array<Lanes<4>, 3> color {}; ///< [vertex][r, g, b, a][lane]
+        std::array<std::array<Lanes<3>, 3>, RenderConfig::TMU_COUNT> texture {}; ///< [tmu][vertex][s, t, q][lane]
+    };
+
     bool rasterize(TriangleStreamTypes::TriangleDesc& __restrict desc,
         const TransformedTriangle& triangle) const;
 
+    /// @brief Sets up all triangles of a batch. Calculates the same values as rasterize() for every triangle.
+    /// @param descs The descriptors which receive the triangles. Only the first batch.count descriptors are written.
+    /// @param batch The triangles to set up
+    /// @return The visibility of the triangles. A not visible triangle has an undefined descriptor.
+    std::bitset<BATCH_SIZE> rasterize(const std::array<TriangleStreamTypes::TriangleDesc*, BATCH_SIZE>& descs,
+        const TriangleBatch& batch) const;
+
     void setScissorBox(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height);
     void enableScissor(const bool enable) { m_enableScissor = enable; }
     void enableTmu(const std::size_t tmu, const bool enable) { m_tmuEnable[tmu] = enable; }
@@ -57,6 +85,17 @@ public:
         const std::size_t lineStart,
         const std::size_t lineEnd);
 
+    /// @brief Shrinks the bounding box in x direction to the part of the triangle which is within the lines
+    ///     lineStart to lineEnd. The attributes are moved to the new bounding box start.
+    ///     Must be called before increment().
+    /// @param desc The triangle
+    /// @param lineStart The first line of the current display area
+    /// @param lineEnd The end of the current display area (exclusive)
+    /// @return false if the triangle has no pixel in this display area
+    static bool tightenBoundingBox(TriangleStreamTypes::TriangleDesc& desc,
+        const std::size_t lineStart,
+        const std::size_t lineEnd);
+
     static bool checkIfTriangleIsInBounds(const TriangleStreamTypes::StaticParams& params,
         const std::size_t lineStart,
         const std::size_t lineEnd)
@@ -70,9 +109,20 @@ private:
     static constexpr uint32_t EDGE_FUNC_SIZE = 5;
     static constexpr int32_t EDGE_FUNC_ZERO_P_FIVE = (1 << (EDGE_FUNC_SIZE - 1));
     static constexpr int32_t EDGE_FUNC_ONE_P_ZERO = (1 << EDGE_FUNC_SIZE);
+    // Triangles with a bounding box of up to SAMPLE_TEST_SIZE x SAMPLE_TEST_SIZE sample points are tested
+    // sample by sample if they cover one of the sample points.
+    static constexpr int32_t SAMPLE_TEST_SIZE = 2;
 
     inline static VecInt edgeFunctionFixPoint(const Vec2i& a, const Vec2i& b, const Vec2i& c);
 
+    /// @brief Conservative test if a triangle covers at least one sample point (pixel) of the hardware rasterizer
+    /// @param v0 Vertex 0 in the edge function fix point format
+    /// @param v1 Vertex 1 in the edge function fix point format
+    /// @param v2 Vertex 2 in the edge function fix point format
+    /// @param sign The sign of the area of the triangle
+    /// @return false if it is certain that the triangle covers no sample point
+    static bool coversSamplePoint(const Vec2i& v0, const Vec2i& v1, const Vec2i& v2, const VecInt sign);
+
     int32_t m_scissorStartX { 0 };
     int32_t m_scissorStartY { 0 };
     int32_t m_scissorEndX { 0 };
@@ -18,8 +18,9 @@
 
 namespace rr
 {
-Renderer::Renderer(IDevice& device)
+Renderer::Renderer(IDevice& device, const std::vector<IThreadRunner*>& textureThreads)
     : m_device { device }
+    , m_textureManager { device, textureThreads }
 {
     m_displayListBuffer.getBack().clearAssembler();
     m_displayListBuffer.getFront().clearAssembler();
@@ -46,7 +47,13 @@ Renderer::Renderer(IDevice& device)
 
 void Renderer::deinit()
 {
-    clearDisplayListAssembler();
+    m_textureManager.waitForTextureJobs();
+    if constexpr (!RenderConfig::THREADED_RASTERIZATION)
+    {
+        // The threaded rasterizer might already process parts of the display list (see uploadPartialDisplayList()).
+        // Therefore it can only be discarded without threaded rasterization.
+        clearDisplayListAssembler();
+    }
     setColorBufferAddress(RenderConfig::COLOR_BUFFER_LOC_0);
     swapScreenToNewColorBuffer();
     uploadDisplayList();
@@ -60,6 +67,13 @@ bool Renderer::drawTriangle(const TransformedTriangle& triangle)
     {
         return true;
     }
+    if constexpr (ENABLE_COARSE_DEPTH_BUFFER)
+    {
+        if (!m_coarseDepthBuffer.drawTriangle(triangleCmd.payload()[0]))
+        {
+            return true;
+        }
+    }
     return addCommand(triangleCmd);
 }
 
@@ -67,6 +81,7 @@ void Renderer::setVertexContext(const vertextransforming::VertexTransformingData
 {
     if constexpr (RenderConfig::THREADED_RASTERIZATION)
     {
+        uploadPartialDisplayList(false);
         if (!addCommand(SetVertexCtxCmd { ctx }))
         {
             SPDLOG_CRITICAL("Cannot push vertex context into queue. This may brake the rendering.");
@@ -98,10 +113,23 @@ void Renderer::intermediateUpload()
 
 void Renderer::swapDisplayList()
 {
+    if constexpr (ENABLE_COARSE_DEPTH_BUFFER)
+    {
+        m_coarseDepthBuffer.logStatistics();
+    }
     addCommitFramebufferCommand();
     addColorBufferAddressOfTheScreen();
     swapScreenToNewColorBuffer();
     uploadTextures();
+    [[maybe_unused]] const TextureManagerType::Statistics textureStatistics = m_textureManager.getStatistics();
+    SPDLOG_DEBUG("Texture memory: {} of {} free pages in one range, {} of {} textures fragmented into {} page runs, {} pages moved",
+        textureStatistics.largestFreeRange,
+        textureStatistics.freePages,
+        textureStatistics.fragmentedTextures,
+        textureStatistics.textures,
+        textureStatistics.pageRuns,
+        textureStatistics.migratedPages);
+    m_textureManager.resetStatistics();
     uploadDisplayList();
     switchDisplayLists();
     clearDisplayListAssembler();
@@ -140,10 +168,58 @@ void Renderer::uploadDisplayList()
         m_displayListBuffer.getBack().getDisplayListSize());
 }
 
+void Renderer::uploadPartialDisplayList(const bool force)
+{
+    // Textures are uploaded when the display list is complete. Until then, the display list must not
+    // be processed by the device, because it might already reference the new texture pages.
+    // The TextureLoadOptimizer can still replace texture loads after the last SetVertexCtxCmd with NOPs.
+    // Therefore the partial display list is only uploaded in front of a new SetVertexCtxCmd.
+    if (!m_textureManager.textureUpdateRequired())
+    {
+        m_device.streamPartialDisplayList(
+            m_displayListBuffer.getBack().getDisplayListBufferId(),
+            m_displayListBuffer.getBack().getDisplayListSize(),
+            force);
+    }
+}
+
+void Renderer::flush()
+{
+    if constexpr (RenderConfig::THREADED_RASTERIZATION)
+    {
+        // The threaded rasterizer can only render a frame with multiple display lists when it is complete.
+        // Therefore it only gets the partial display list to start with the processing.
+        uploadPartialDisplayList(true);
+    }
+    else if (m_displayListBuffer.getBack().getDisplayListSize() > 0)
+    {
+        intermediateUpload();
+    }
+}
+
+uint32_t Renderer::insertFence()
+{
+    flush();
+    if constexpr (RenderConfig::THREADED_RASTERIZATION)
+    {
+        // flush() only hands over a partial display list. The commands are processed with the
+        // display list which is currently assembled.
+        return m_device.insertFence() + 1;
+    }
+    return m_device.insertFence();
+}
+
 bool Renderer::clear(const bool colorBuffer, const bool depthBuffer, const bool stencilBuffer)
 {
     FramebufferCmd cmd { colorBuffer, depthBuffer, stencilBuffer, m_resolutionX * m_resolutionY };
     cmd.enableMemset();
+    if constexpr (ENABLE_COARSE_DEPTH_BUFFER)
+    {
+        if (depthBuffer)
+        {
+            m_coarseDepthBuffer.clear();
+        }
+    }
     return addCommand(cmd);
 }
 
@@ -153,15 +229,19 @@ bool Renderer::useTexture(const std::size_t tmu, const uint16_t texId)
     {
         return false;
     }
-    bool ret { true };
-
-    const tcb::span<const std::size_t> pages = m_textureManager.getPages(texId);
-    ret = ret && addCommand(TextureStreamCmd { tmu, pages });
+    // Reloads the texture if it was evicted
+    bool ret { m_textureManager.useTexture(texId) };
 
+    // The config is written before the stream, because the TMU requires the pixel format and
+    // the texture size to decode compressed textures while loading them
     TmuTextureReg reg = m_textureManager.getTmuConfig(texId);
     reg.setTmu(tmu);
     ret = ret && writeReg(reg);
 
+    // Streams only the mipmap levels which are selectable with the current filter and lod range
+    const TextureManagerType::TextureStream stream = m_textureManager.getTextureStream(texId);
+    ret = ret && addCommand(TextureStreamCmd { tmu, stream.pages, stream.pageOffset, stream.size });
+
     return ret;
 }
 
@@ -215,7 +295,32 @@ bool Renderer::enableTextureMagFiltering(const std::size_t tmu, const uint16_t t
 bool Renderer::enableTextureMinFiltering(const std::size_t tmu, const uint16_t texId, bool filter)
 {
     m_textureManager.enableTextureMinFiltering(texId, filter);
-    return writeToTextureConfig(tmu, m_textureManager.getTmuConfig(texId));
+    // Without min filter, only the base level is streamed. The texture is streamed again with the new levels.
+    return useTexture(tmu, texId);
+}
+
+bool Renderer::setTextureBaseLevel(const std::size_t tmu, const uint16_t texId, const std::size_t level)
+{
+    m_textureManager.setTextureBaseLevel(texId, level);
+    return useTexture(tmu, texId);
+}
+
+bool Renderer::setTextureMaxLevel(const std::size_t tmu, const uint16_t texId, const std::size_t level)
+{
+    m_textureManager.setTextureMaxLevel(texId, level);
+    return useTexture(tmu, texId);
+}
+
+bool Renderer::setTextureMinLod(const std::size_t tmu, const uint16_t texId, const float lod)
+{
+    m_textureManager.setTextureMinLod(texId, lod);
+    return useTexture(tmu, texId);
+}
+
+bool Renderer::setTextureMaxLod(const std::size_t tmu, const uint16_t texId, const float lod)
+{
+    m_textureManager.setTextureMaxLod(texId, lod);
+    return useTexture(tmu, texId);
 }
 
 bool Renderer::setRenderResolution(const std::size_t x, const std::size_t y)
@@ -244,11 +349,11 @@ bool Renderer::setColorBufferAddress(const uint32_t addr)
 void Renderer::uploadTextures()
 {
     m_textureManager.uploadTextures(
-        [&](uint32_t gramAddr, const tcb::span<const uint8_t> data)
+        [&](uint32_t gramAddr, const uint32_t size)
         {
-            m_device.writeToDeviceMemory(data, gramAddr);
-            return true;
+            return m_device.requestWriteToDeviceMemory(gramAddr, size);
         });
+    m_device.flushWritesToDeviceMemory();
 }
 
 void Renderer::swapFramebuffer()
@@ -18,6 +18,7 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
+#include "CoarseDepthBuffer.hpp"
 #include "IThreadRunner.hpp"
 #include "Rasterizer.hpp"
 #include "Renderer.hpp"
@@ -30,10 +31,12 @@
 #include "renderer/IDevice.hpp"
 #include <algorithm>
 #include <array>
+#include <functional>
 #include <limits>
 #include <optional>
 #include <stdint.h>
 #include <string.h>
+#include <vector>
 
 #include "RenderConfigs.hpp"
 #include "commands/FogLutStreamCmd.hpp"
@@ -70,7 +73,10 @@ namespace rr
 class Renderer
 {
 public:
-    Renderer(IDevice& device);
+    /// @brief Creates the renderer
+    /// @param device The device which receives the display lists
+    /// @param textureThreads Optional runners which convert textures in the background
+    Renderer(IDevice& device, const std::vector<IThreadRunner*>& textureThreads = {});
 
     void deinit();
 
@@ -87,6 +93,34 @@ public:
     /// the framebuffers
     void swapDisplayList();
 
+    /// @brief Hands the already written part of the display list to the device without waiting for the swap.
+    ///     With threaded rasterization, the rasterizer starts to process it, but the frame is still
+    ///     finished with the next swap.
+    void flush();
+
+    /// @brief Flushes the display list and blocks until the device has processed all display lists
+    ///     which were handed to it.
+    void finish()
+    {
+        flush();
+        blockUntilFenceIsSignaled(m_device.insertFence());
+    }
+
+    /// @brief Flushes the display list and creates a fence behind all commands added so far.
+    ///     With threaded rasterization the display list is only completed with the next swap.
+    ///     The fence is signaled after this display list is processed.
+    /// @return The fence which can be queried with isFenceSignaled()
+    uint32_t insertFence();
+
+    /// @brief Checks without blocking if the device has processed everything in front of the fence
+    /// @param fence The fence created with insertFence()
+    /// @return true if the fence is signaled
+    bool isFenceSignaled(const uint32_t fence) { return m_device.isFenceSignaled(fence); }
+
+    /// @brief Blocks until the device has processed everything in front of the fence
+    /// @param fence The fence created with insertFence()
+    void blockUntilFenceIsSignaled(const uint32_t fence) { m_device.blockUntilFenceIsSignaled(fence); }
+
     /// @brief Creates a new texture
     /// @return pair with the first value to indicate if the operation succeeded (true) and the second value with the id
     std::pair<bool, uint16_t> createTexture() { return m_textureManager.createTexture(); }
@@ -102,10 +136,21 @@ public:
     /// @return true if succeeded, false if it was not possible to apply this command (for instance, displaylist was out if memory)
     bool updateTexture(const uint16_t texId, const TextureObjectMipmap& textureObject) { return m_textureManager.updateTexture(texId, textureObject); }
 
+    /// @brief Updates the changed parts of the texture with the given id. Only the texture pages
+    ///     which contain a changed range are uploaded again.
+    /// @param texId The texture id which texture has to be updated
+    /// @param textureObject The object which contains the texture and all its meta data
+    /// @param dirtyRanges The changed byte ranges of every mipmap level
+    /// @return true if succeeded
+    bool updateTexture(const uint16_t texId, const TextureObjectMipmap& textureObject, const TextureObjectMipmapDirtyRanges& dirtyRanges)
+    {
+        return m_textureManager.updateTexture(texId, textureObject, dirtyRanges);
+    }
+
     /// @brief Returns a texture associated to the texId
     /// @param texId The texture id of the texture to get the data from
-    /// @return The texture object
-    TextureObjectMipmap getTexture(const uint16_t texId) { return m_textureManager.getTexture(texId); }
+    /// @return The texture object, or std::nullopt if the released host copy can't be read back from the device
+    std::optional<TextureObjectMipmap> getTexture(const uint16_t texId) { return m_textureManager.getTexture(texId); }
 
     /// @brief Queries if the current texture id is a valid texture
     /// @param texId Texture id to query
@@ -151,6 +196,58 @@ public:
     /// @return true if succeeded, false if it was not possible to apply this command (for instance, displaylist was out if memory)
     bool enableTextureMinFiltering(const std::size_t tmu, const uint16_t texId, bool filter);
 
+    /// @brief Sets the lowest mipmap level which is used (GL_TEXTURE_BASE_LEVEL)
+    /// @param tmu The used TMU
+    /// @param texId The texture from where to change the parameter
+    /// @param level The base level
+    /// @return true if succeeded, false if it was not possible to apply this command (for instance, displaylist was out if memory)
+    bool setTextureBaseLevel(const std::size_t tmu, const uint16_t texId, const std::size_t level);
+
+    /// @brief Sets the highest mipmap level which is used (GL_TEXTURE_MAX_LEVEL)
+    /// @param tmu The used TMU
+    /// @param texId The texture from where to change the parameter
+    /// @param level The max level
+    /// @return true if succeeded, false if it was not possible to apply this command (for instance, displaylist was out if memory)
+    bool setTextureMaxLevel(const std::size_t tmu, const uint16_t texId, const std::size_t level);
+
+    /// @brief Enables the generation of the mipmap levels when level 0 changes (GL_GENERATE_MIPMAP).
+    ///     The levels are generated on the host, this only stores the parameter of the texture.
+    /// @param texId The texture from where to change the parameter
+    /// @param enable True to enable the generation
+    void setTextureGenerateMipmap(const uint16_t texId, const bool enable) { m_textureManager.setTextureGenerateMipmap(texId, enable); }
+
+    /// @brief Queries if the mipmap levels are generated when level 0 changes (GL_GENERATE_MIPMAP)
+    /// @param texId The texture
+    /// @return true if the generation is enabled
+    bool isTextureGenerateMipmap(const uint16_t texId) const { return m_textureManager.isTextureGenerateMipmap(texId); }
+
+    /// @brief Runs a job which writes the host copy of a texture. With texture threads, the job runs in
+    ///     the background. The first display list which uses the texture waits for it during the upload.
+    /// @param texId The texture which is written by the job
+    /// @param job The job. It must not access the renderer.
+    /// @return false if the texture is invalid
+    bool postTextureJob(const uint16_t texId, const std::function<void()>& job) { return m_textureManager.postTextureJob(texId, job); }
+
+    /// @return true if the textures are converted in the background. The job must then own the client pixels.
+    bool isTextureJobAsync() const { return m_textureManager.isTextureJobAsync(); }
+
+    /// @brief Blocks until all textures are written by their jobs
+    void waitForTextureJobs() { m_textureManager.waitForTextureJobs(); }
+
+    /// @brief Sets the minimum level of detail relative to the base level (GL_TEXTURE_MIN_LOD)
+    /// @param tmu The used TMU
+    /// @param texId The texture from where to change the parameter
+    /// @param lod The minimum lod
+    /// @return true if succeeded, false if it was not possible to apply this command (for instance, displaylist was out if memory)
+    bool setTextureMinLod(const std::size_t tmu, const uint16_t texId, const float lod);
+
+    /// @brief Sets the maximum level of detail relative to the base level (GL_TEXTURE_MAX_LOD)
+    /// @param tmu The used TMU
+    /// @param texId The texture from where to change the parameter
+    /// @param lod The maximum lod
+    /// @return true if succeeded, false if it was not possible to apply this command (for instance, displaylist was out if memory)
+    bool setTextureMaxLod(const std::size_t tmu, const uint16_t texId, const float lod);
+
     /// @brief Sets the resolution of the renderer
     /// @param x X is the width of the produced image
     /// @param y Y is the height of the produced image
@@ -233,6 +330,9 @@ private:
     using TextureManagerType = TextureMemoryManager<RenderConfig>;
     using DisplayListDoubleBufferType = displaylist::DisplayListDoubleBuffer<DisplayListAssemblerType>;
 
+    // With threaded rasterization, the triangles are set up in the ThreadedRasterizer, which has its own buffer
+    static constexpr bool ENABLE_COARSE_DEPTH_BUFFER { RenderConfig::COARSE_OCCLUSION_CULLING && !RenderConfig::THREADED_RASTERIZATION };
+
     /// @brief Will render a triangle which is constructed with the given parameters
     /// @return true if the triangle was rendered, otherwise the display list was full and the triangle can't be added
     bool drawTriangle(const TransformedTriangle& triangle);
@@ -240,9 +340,17 @@ private:
     /// @brief Uploads the display list to the hardware
     void uploadDisplayList();
 
+    /// @brief Hands the already written part of the display list to the device, so it can start to process it
+    /// @param force Hands it to the device, even if only a few bytes were written since the last call
+    void uploadPartialDisplayList(const bool force);
+
     template <typename TArg>
     bool writeReg(const TArg& regVal)
     {
+        if constexpr (ENABLE_COARSE_DEPTH_BUFFER)
+        {
+            m_coarseDepthBuffer.setRegister(regVal.getAddr(), regVal.serialize());
+        }
         return addCommand(WriteRegisterCmd { regVal });
     }
 
@@ -260,6 +368,8 @@ private:
 
     void clearDisplayListAssembler()
     {
+        // The previous display list of this buffer might still be transferred
+        m_device.blockUntilDisplayListBufferIsFree(m_displayListBuffer.getBack().getDisplayListBufferId());
         m_displayListBuffer.getBack().clearAssembler();
     }
 
@@ -310,6 +420,7 @@ private:
     IDevice& m_device;
     TextureManagerType m_textureManager;
     Rasterizer m_rasterizer { !RenderConfig::USE_FLOAT_INTERPOLATION };
+    CoarseDepthBuffer m_coarseDepthBuffer {};
 
     const std::function<bool(const TransformedTriangle&)> drawTriangleLambda = [this](const TransformedTriangle& triangle)
     { return drawTriangle(triangle); };
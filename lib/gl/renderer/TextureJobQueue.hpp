@@ -0,0 +1,152 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef _TEXTURE_JOB_QUEUE_HPP_
+#define _TEXTURE_JOB_QUEUE_HPP_
+
+#include "IThreadRunner.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace rr
+{
+
+// Distributes the conversion of textures to a set of runners.
+// Every runner executes one job at a time. The jobs are assigned round robin to the runners.
+// A job is identified by a number, which is used to wait for the job or to check if it is finished.
+// Without runners, the jobs are executed directly on the calling thread.
+class TextureJobQueue
+{
+public:
+    using Job = uint32_t;
+    static constexpr Job NO_JOB { 0 };
+
+    /// @brief Creates the queue
+    /// @param threads The runners which execute the jobs. If empty, the jobs are executed synchronously.
+    TextureJobQueue(const std::vector<IThreadRunner*>& threads)
+        : m_workers(threads.size())
+    {
+        for (std::size_t i = 0; i < threads.size(); i++)
+        {
+            m_workers[i].runner = threads[i];
+        }
+    }
+
+    ~TextureJobQueue()
+    {
+        waitAll();
+    }
+
+    /// @return true if the jobs are executed by runners
+    bool isAsync() const
+    {
+        return !m_workers.empty();
+    }
+
+    /// @brief Executes a job. Blocks if the selected runner still executes its previous job.
+    /// @param job The job
+    /// @return The number of the job, or NO_JOB if the job was already executed
+    Job post(const std::function<void()>& job)
+    {
+        if (m_workers.empty())
+        {
+            job();
+            return NO_JOB;
+        }
+        Worker& worker = m_workers[m_nextWorker];
+        m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+        worker.runner->wait();
+
+        m_lastJob++;
+        if (m_lastJob == NO_JOB)
+        {
+            m_lastJob++;
+        }
+        worker.job = m_lastJob;
+        worker.done.store(false, std::memory_order_relaxed);
+        worker.runner->run([&worker, job]()
+            {
+                job();
+                worker.done.store(true, std::memory_order_release);
+            });
+        return worker.job;
+    }
+
+    /// @brief Checks without blocking if a job is finished
+    /// @param job The job number returned by post()
+    /// @return true if the job is finished
+    bool isDone(const Job job) const
+    {
+        const Worker* worker = findWorker(job);
+        return !worker || worker->done.load(std::memory_order_acquire);
+    }
+
+    /// @brief Blocks until a job is finished
+    /// @param job The job number returned by post()
+    void wait(const Job job)
+    {
+        const Worker* worker = findWorker(job);
+        if (worker)
+        {
+            worker->runner->wait();
+        }
+    }
+
+    /// @brief Blocks until all jobs are finished
+    void waitAll()
+    {
+        for (Worker& worker : m_workers)
+        {
+            worker.runner->wait();
+        }
+    }
+
+private:
+    struct Worker
+    {
+        IThreadRunner* runner { nullptr };
+        Job job { NO_JOB }; ///< The last job which was assigned to this runner
+        std::atomic<bool> done { true }; ///< Set by the runner when the last job is finished
+    };
+
+    const Worker* findWorker(const Job job) const
+    {
+        if (job == NO_JOB)
+        {
+            return nullptr;
+        }
+        // A job which is not assigned to a runner anymore was waited for by the next post() on this runner
+        for (const Worker& worker : m_workers)
+        {
+            if (worker.job == job)
+            {
+                return &worker;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<Worker> m_workers;
+    std::size_t m_nextWorker { 0 };
+    Job m_lastJob { NO_JOB };
+};
+
+} // namespace rr
+
+#endif // _TEXTURE_JOB_QUEUE_HPP_
@@ -17,15 +17,21 @@
 
 #ifndef TEXTUREMEMORYMANAGER_HPP
 #define TEXTUREMEMORYMANAGER_HPP
+#include "BitmapAllocator.hpp"
+#include "IDevice.hpp"
+#include "TextureJobQueue.hpp"
 #include "TextureObject.hpp"
 #include "registers/TmuTextureReg.hpp"
+#include <algorithm>
 #include <array>
+#include <bitset>
 #include <cmath>
 #include <cstring>
 #include <functional>
 #include <optional>
 #include <spdlog/spdlog.h>
 #include <tcb/span.hpp>
+#include <vector>
 
 namespace rr
 {
@@ -35,25 +41,64 @@ class TextureMemoryManager
 public:
     static constexpr std::size_t TEXTURE_PAGE_SIZE { RenderConfig::TEXTURE_PAGE_SIZE };
     static constexpr std::size_t MAX_PAGES_PER_TEXTURE { static_cast<std::size_t>((static_cast<float>(RenderConfig::MAX_TEXTURE_SIZE * RenderConfig::MAX_TEXTURE_SIZE * 2.0f * 1.33f) / static_cast<float>(RenderConfig::TEXTURE_PAGE_SIZE)) + 1.0f) };
+    // Number of pages which the compaction moves at most per upload. A texture is always moved completely.
+    static constexpr std::size_t COMPACTION_PAGES_PER_UPLOAD { (std::max)(std::size_t { 1 }, (64 * 1024) / TEXTURE_PAGE_SIZE) };
+    // Number of fragmented textures for which the compaction searches contiguous pages per upload
+    static constexpr std::size_t COMPACTION_CANDIDATES_PER_UPLOAD { 4 };
+    // Textures which require at most half a page share pages with other small textures. They are
+    // placed at a block offset within the page.
+    static constexpr std::size_t TEXTURE_PAGE_BLOCK_SIZE { RenderConfig::TEXTURE_PAGE_BLOCK_SIZE };
+    static constexpr std::size_t BLOCKS_PER_PAGE { TEXTURE_PAGE_SIZE / TEXTURE_PAGE_BLOCK_SIZE };
+    static constexpr std::size_t MAX_BLOCKS_PER_SHARED_TEXTURE { BLOCKS_PER_PAGE / 2 };
+    static_assert(BLOCKS_PER_PAGE <= 32, "The blocks of a page must fit into an uint32_t");
 
-    TextureMemoryManager()
+    struct Statistics
     {
+        std::size_t usedPages { 0 };
+        std::size_t freePages { 0 };
+        std::size_t largestFreeRange { 0 }; ///< Longest run of free pages
+        std::size_t textures { 0 }; ///< Textures with pages
+        std::size_t fragmentedTextures { 0 }; ///< Textures whose pages are not contiguous
+        std::size_t pageRuns { 0 }; ///< Runs of contiguous pages of all textures. Equal to textures without fragmentation.
+        std::size_t sharedPages { 0 }; ///< Pages which contain several small textures
+        std::size_t migratedPages { 0 }; ///< Pages moved by the compaction since the last reset
+    };
+
+    /// @brief Part of a texture which is streamed into a TMU
+    struct TextureStream
+    {
+        tcb::span<const std::size_t> pages {}; ///< Pages which contain the streamed mipmap levels
+        std::size_t pageOffset { 0 }; ///< Offset of the first streamed level in the first page
+        std::size_t size { 0 }; ///< Size of the streamed levels in bytes
+    };
+
+    /// @brief Creates the texture memory manager
+    /// @param device The device which provides the fences. They are used to find textures which are not
+    ///     referenced anymore by display lists which are in flight.
+    /// @param textureThreads Runners which write the host copies of the textures in the background.
+    ///     If empty, the host copies are written synchronously.
+    TextureMemoryManager(IDevice& device, const std::vector<IThreadRunner*>& textureThreads = {})
+        : m_device { device }
+        , m_textureJobs { textureThreads }
+    {
+        // The texture name and the texture slot 0 are reserved as default texture
+        m_textureNameAllocator.alloc(0);
+        m_textureAllocator.alloc(0);
     }
 
     std::pair<bool, uint16_t> createTexture()
     {
-        for (std::size_t i = 1; i < RenderConfig::NUMBER_OF_TEXTURES; i++)
+        const std::optional<std::size_t> texId = m_textureNameAllocator.alloc();
+        if (!texId)
         {
-            if (!m_textureLut[i])
-            {
-                return { createTextureWithName(i), static_cast<uint16_t>(i) };
-            }
+            return { false, 0 };
         }
-        return { false, 0 };
+        return { createTextureWithName(*texId), static_cast<uint16_t>(*texId) };
     }
 
     bool createTextureWithName(const uint16_t texId)
     {
+        m_textureNameAllocator.alloc(texId);
         m_textureLut[texId] = allocTexture();
         if (m_textureLut[texId])
         {
@@ -62,8 +107,12 @@ public:
             setTextureWrapModeS(texId, TextureWrapMode::REPEAT);
             setTextureWrapModeT(texId, TextureWrapMode::REPEAT);
             enableTextureMagFiltering(texId, true);
+            m_textures[*m_textureLut[texId]].lodRange = {};
+            m_textures[*m_textureLut[texId]].generateMipmap = false;
+            m_textures[*m_textureLut[texId]].pendingJob = TextureJobQueue::NO_JOB;
             return true;
         }
+        m_textureNameAllocator.free(texId);
         return false;
     }
 
@@ -80,7 +129,6 @@ public:
 
         if (m_textureEntryFlags[textureSlot].requiresUpload)
         {
-            m_textureEntryFlags[textureSlot].requiresDelete = true;
             std::optional<std::size_t> newTextureSlot = allocTexture();
 
             if (!newTextureSlot)
@@ -89,14 +137,21 @@ public:
                 return false;
             }
 
+            // The old slot is still referenced by the current display list. It is deleted after the upload.
+            m_textureEntryFlags[textureSlot].requiresDelete = true;
+            markDirty(textureSlot);
             textureSlot = *newTextureSlot;
             m_textureLut[texId] = newTextureSlot;
+            m_textures[textureSlot].dirtyPages.reset();
             SPDLOG_DEBUG("Use new texture slot {} for texId {}", *newTextureSlot, texId);
         }
         else
         {
             // If it is already uploaded, then it is safe to delete the pages to free them for the reallocation.
-            deallocPages(m_textures[textureSlot]);
+            deallocPages(textureSlot);
+            m_textures[textureSlot].dirtyPages.reset();
+            m_textureEntryFlags[textureSlot].evicted = false;
+            m_textureEntryFlags[textureSlot].released = false;
         }
         m_textures[textureSlot].textures = textureObject;
 
@@ -107,27 +162,80 @@ public:
         m_textures[textureSlot].tmuConfig.setWarpModeT(m_textures[textureSlotOld].tmuConfig.getWrapModeT());
         m_textures[textureSlot].tmuConfig.setEnableMagFilter(m_textures[textureSlotOld].tmuConfig.getEnableMagFilter());
         m_textures[textureSlot].tmuConfig.setEnableMinFilter(m_textures[textureSlotOld].tmuConfig.getEnableMinFilter());
+        m_textures[textureSlot].lodRange = m_textures[textureSlotOld].lodRange;
+        m_textures[textureSlot].generateMipmap = m_textures[textureSlotOld].generateMipmap;
+        m_textures[textureSlot].pendingJob = m_textures[textureSlotOld].pendingJob;
 
         m_textures[textureSlot].tmuConfig.setPixelFormat(textureObject[0].getPixelFormat());
         m_textures[textureSlot].tmuConfig.setTextureWidth(textureObject[0].width);
         m_textures[textureSlot].tmuConfig.setTextureHeight(textureObject[0].height);
 
         // Allocate memory pages
-        const std::size_t textureSize = m_textures[textureSlot].getTextureSize();
-        const std::size_t texturePages = (textureSize / TEXTURE_PAGE_SIZE) + ((textureSize % TEXTURE_PAGE_SIZE) ? 1 : 0);
+        const std::size_t texturePages = m_textures[textureSlot].getNumberOfPages();
         SPDLOG_DEBUG("Use number of pages: {}", texturePages);
-        ret = allocPages(m_textures[textureSlot], texturePages);
-        if (!ret)
+        if ((texturePages == 0) || (texturePages > MAX_PAGES_PER_TEXTURE))
+        {
+            SPDLOG_ERROR("Texture requires an invalid number of pages: {}", texturePages);
+            ret = false;
+        }
+        else if (!allocPages(textureSlot, texturePages))
         {
-            SPDLOG_ERROR("Ran out of memory during page allocation");
-            deallocPages(m_textures[textureSlot]);
+            // All pages are used by the current display list. The texture is loaded from the host copy when it is used.
+            SPDLOG_DEBUG("Ran out of pages, texture {} is evicted", texId);
+            m_textureEntryFlags[textureSlot].requiresUpload = false;
+            m_textureEntryFlags[textureSlot].evicted = true;
         }
 
-        m_textureUpdateRequired = true;
+        markDirty(textureSlot);
 
         return ret;
     }
 
+    bool updateTexture(const uint16_t texId, const TextureObjectMipmap& textureObject, const TextureObjectMipmapDirtyRanges& dirtyRanges)
+    {
+        if (!m_textureLut[texId])
+        {
+            SPDLOG_ERROR("updateTexture with invalid texID called");
+            return false;
+        }
+        const std::size_t textureSlot = *m_textureLut[texId];
+        Texture& texture = m_textures[textureSlot];
+
+        // A texture which is not uploaded yet keeps its old content for the already recorded draws, and a texture
+        // with a new layout requires a new page allocation. Both cases require the upload of the complete texture.
+        if (m_textureEntryFlags[textureSlot].requiresUpload || (texture.pages == 0) || !texture.hasSameLayout(textureObject))
+        {
+            return updateTexture(texId, textureObject);
+        }
+
+        // The palette is stored in front of the first level
+        if (texture.textures[0].palette != textureObject[0].palette)
+        {
+            texture.dirtyPages.set(0);
+        }
+        texture.textures = textureObject;
+        m_textureEntryFlags[textureSlot].released = false;
+        std::size_t levelOffset = texture.getPaletteSize();
+        for (std::size_t level = 0; level < textureObject.size(); level++)
+        {
+            const TextureObjectDirtyRange& range = dirtyRanges[level];
+            if (!range.empty())
+            {
+                const std::size_t firstPage = (levelOffset + range.begin) / TEXTURE_PAGE_SIZE;
+                const std::size_t lastPage = (std::min)((levelOffset + range.end - 1) / TEXTURE_PAGE_SIZE, texture.pages - 1);
+                for (std::size_t page = firstPage; page <= lastPage; page++)
+                {
+                    texture.dirtyPages.set(page);
+                }
+            }
+            levelOffset += Texture::getLevelSize(textureObject[level]);
+        }
+        SPDLOG_DEBUG("Update {} of {} pages of texId {}", texture.dirtyPages.count(), texture.pages, texId);
+
+        markDirty(textureSlot);
+        return true;
+    }
+
     void setTextureWrapModeS(const uint16_t texId, TextureWrapMode mode)
     {
         if (!m_textureLut[texId])
@@ -172,6 +280,65 @@ public:
         tex.tmuConfig.setEnableMinFilter(filter);
     }
 
+    void setTextureBaseLevel(const uint16_t texId, const std::size_t level)
+    {
+        if (!m_textureLut[texId])
+        {
+            SPDLOG_ERROR("setTextureBaseLevel with invalid texID called");
+            return;
+        }
+        m_textures[*m_textureLut[texId]].lodRange.baseLevel = level;
+    }
+
+    void setTextureMaxLevel(const uint16_t texId, const std::size_t level)
+    {
+        if (!m_textureLut[texId])
+        {
+            SPDLOG_ERROR("setTextureMaxLevel with invalid texID called");
+            return;
+        }
+        m_textures[*m_textureLut[texId]].lodRange.maxLevel = level;
+    }
+
+    void setTextureGenerateMipmap(const uint16_t texId, const bool enable)
+    {
+        if (!m_textureLut[texId])
+        {
+            SPDLOG_ERROR("setTextureGenerateMipmap with invalid texID called");
+            return;
+        }
+        m_textures[*m_textureLut[texId]].generateMipmap = enable;
+    }
+
+    bool isTextureGenerateMipmap(const uint16_t texId) const
+    {
+        if (!m_textureLut[texId])
+        {
+            return false;
+        }
+        return m_textures[*m_textureLut[texId]].generateMipmap;
+    }
+
+    void setTextureMinLod(const uint16_t texId, const float lod)
+    {
+        if (!m_textureLut[texId])
+        {
+            SPDLOG_ERROR("setTextureMinLod with invalid texID called");
+            return;
+        }
+        m_textures[*m_textureLut[texId]].lodRange.minLod = lod;
+    }
+
+    void setTextureMaxLod(const uint16_t texId, const float lod)
+    {
+        if (!m_textureLut[texId])
+        {
+            SPDLOG_ERROR("setTextureMaxLod with invalid texID called");
+            return;
+        }
+        m_textures[*m_textureLut[texId]].lodRange.maxLod = lod;
+    }
+
     bool textureValid(const uint16_t texId) const
     {
         if (!m_textureLut[texId])
@@ -179,8 +346,7 @@ public:
             SPDLOG_ERROR("textureValid with invalid texID called");
             return false;
         }
-        const TextureEntry& tex = m_textureEntryFlags[*m_textureLut[texId]];
-        return (texId != 0) && tex.inUse;
+        return (texId != 0) && !m_textureAllocator.isFree(*m_textureLut[texId]);
     }
 
     TmuTextureReg getTmuConfig(const uint16_t texId) const
@@ -191,30 +357,96 @@ public:
             return {};
         }
         const Texture& tex = m_textures[*m_textureLut[texId]];
-        return tex.tmuConfig;
+        if (tex.getNumberOfLevels() == 0)
+        {
+            return tex.tmuConfig;
+        }
+        const LevelRange range = tex.getLevelRange();
+        // The TMU only receives the levels from streamStart on. It sees streamStart as its base level.
+        TmuTextureReg reg = tex.tmuConfig;
+        reg.setTextureWidth(tex.textures[range.streamStart].width);
+        reg.setTextureHeight(tex.textures[range.streamStart].height);
+        reg.setMinLod(static_cast<uint8_t>(range.first - range.streamStart));
+        reg.setMaxLod(static_cast<uint8_t>(range.last - range.streamStart));
+        return reg;
+    }
+
+    /// @brief Marks a texture as used by the display list which is currently assembled. An evicted
+    ///     texture gets new pages and is uploaded again from its host copy.
+    /// @param texId The texture which is used
+    /// @return false if the texture is evicted and no pages could be allocated for it
+    bool useTexture(const uint16_t texId)
+    {
+        if (!textureValid(texId))
+        {
+            return false;
+        }
+        const std::size_t textureSlot = *m_textureLut[texId];
+        TextureEntry& textureEntry = m_textureEntryFlags[textureSlot];
+        if (textureEntry.evicted)
+        {
+            if (!allocPages(textureSlot, m_textures[textureSlot].getNumberOfPages()))
+            {
+                SPDLOG_ERROR("Was not able to reload evicted texture {}", texId);
+                deallocPages(textureSlot);
+                return false;
+            }
+            SPDLOG_DEBUG("Reload evicted texture {}", texId);
+            textureEntry.evicted = false;
+            textureEntry.requiresUpload = true;
+            markDirty(textureSlot);
+        }
+        if (m_textures[textureSlot].pages > 0)
+        {
+            touchTexture(textureSlot);
+        }
+        return true;
     }
 
-    tcb::span<const std::size_t> getPages(const uint16_t texId) const
+    /// @brief Returns the part of the texture which the TMU requires. Only the mipmap levels selectable
+    ///     with the base level, max level and LOD range of the texture are streamed.
+    TextureStream getTextureStream(const uint16_t texId) const
     {
-        if (textureValid(texId))
+        if (!textureValid(texId))
+        {
+            return {};
+        }
+        const Texture& tex = m_textures[*m_textureLut[texId]];
+        if (tex.pages == 0)
         {
-            const Texture& tex = m_textures[*m_textureLut[texId]];
-            return { tex.pageTable.data(), tex.pages };
+            return {};
         }
-        return {};
+        const LevelRange range = tex.getLevelRange();
+        // A stream which starts with the first level also contains the palette
+        const std::size_t start = (range.streamStart == 0) ? 0 : tex.getLevelOffset(range.streamStart);
+        const std::size_t end = tex.getLevelOffset(range.last + 1);
+        const std::size_t firstPage = start / TEXTURE_PAGE_SIZE;
+        const std::size_t lastPage = (end - 1) / TEXTURE_PAGE_SIZE;
+        return {
+            { tex.pageTable.data() + firstPage, lastPage - firstPage + 1 },
+            tex.pageOffset + (start % TEXTURE_PAGE_SIZE),
+            end - start,
+        };
     }
 
-    TextureObjectMipmap getTexture(const uint16_t texId)
+    /// @brief Returns the host copy of a texture to modify it. A released host copy is read back from the device.
+    /// @return std::nullopt if the released host copy can't be read back
+    std::optional<TextureObjectMipmap> getTexture(const uint16_t texId)
     {
         if (!m_textureLut[texId])
         {
             SPDLOG_ERROR("getTexture with invalid texID called");
-            return {};
+            return std::make_optional<TextureObjectMipmap>();
         }
         const std::size_t textureSlot = *m_textureLut[texId];
-        if (!m_textureEntryFlags[textureSlot].inUse)
+        if (m_textureAllocator.isFree(textureSlot))
         {
-            return {};
+            return std::make_optional<TextureObjectMipmap>();
+        }
+        // The texture is returned to be modified, therefore a released host copy is required again
+        if (m_textureEntryFlags[textureSlot].released && !restoreHostCopy(textureSlot))
+        {
+            return std::nullopt;
         }
         return m_textures[textureSlot].textures;
     }
@@ -228,96 +460,344 @@ public:
         }
         const std::size_t texLutId = *m_textureLut[texId];
         m_textureLut[texId] = std::nullopt;
+        m_textureNameAllocator.free(texId);
         m_textureEntryFlags[texLutId].requiresDelete = true;
-        m_textureUpdateRequired = true;
+        markDirty(texLutId);
         return true;
     }
 
-    bool uploadTextures(const std::function<bool(uint32_t gramAddr, const tcb::span<const uint8_t> data)> uploader)
+    /// @brief Runs a job which writes the host copy of a texture, for instance the conversion of the
+    ///     client pixels. With texture threads, the job runs in the background and the texture is pending
+    ///     until the job is finished. The texture is uploaded when the job is finished, or earlier, when a
+    ///     display list uses the texture. Then the upload waits for the job.
+    /// @param texId The texture which is written by the job
+    /// @param job The job. It must not access the texture manager.
+    /// @return false if the texture is invalid
+    bool postTextureJob(const uint16_t texId, const std::function<void()>& job)
     {
-        if (!m_textureUpdateRequired)
-            return true;
-        m_textureUpdateRequired = false;
+        if (!m_textureLut[texId])
+        {
+            SPDLOG_ERROR("postTextureJob with invalid texID called");
+            return false;
+        }
+        Texture& tex = m_textures[*m_textureLut[texId]];
+        // The jobs of a texture can depend on each other, like a glTexSubImage2D after a glTexImage2D
+        m_textureJobs.wait(tex.pendingJob);
+        tex.pendingJob = m_textureJobs.post(job);
+        return true;
+    }
 
-        // Upload textures
-        for (std::size_t i = 0; i < RenderConfig::NUMBER_OF_TEXTURES; i++)
+    /// @return true if the host copies are written in the background
+    bool isTextureJobAsync() const
+    {
+        return m_textureJobs.isAsync();
+    }
+
+    /// @brief Blocks until all texture jobs are finished
+    void waitForTextureJobs()
+    {
+        m_textureJobs.waitAll();
+    }
+
+    bool textureUpdateRequired() const
+    {
+        return m_dirtyTexturesCount != 0;
+    }
+
+    /// @brief Uploads the pages of all dirty textures and deletes the textures which are not used anymore
+    /// @param pageBufferProvider Returns the buffer into which a page is written. The pages are written
+    ///     directly into this buffer, for instance the transfer buffer of the device. An empty buffer
+    ///     signals that the page can not be uploaded.
+    bool uploadTextures(const std::function<tcb::span<uint8_t>(uint32_t gramAddr, const uint32_t size)> pageBufferProvider)
+    {
+        // Only the textures in the dirty list are visited. Textures which failed to upload stay in the list.
+        const uint32_t currentFence = getCurrentFence();
+        freeDeferredPages(false);
+        std::size_t remainingDirtyTextures = 0;
+        for (std::size_t i = 0; i < m_dirtyTexturesCount; i++)
         {
-            Texture& texture = m_textures[i];
-            TextureEntry& textureEntry = m_textureEntryFlags[i];
-            if (textureEntry.requiresUpload)
+            const std::size_t textureSlot = m_dirtyTextures[i];
+            Texture& texture = m_textures[textureSlot];
+            TextureEntry& textureEntry = m_textureEntryFlags[textureSlot];
+            // Only the display list which uses a pending texture waits for it. Otherwise it stays in the list.
+            const bool pending = !m_textureJobs.isDone(texture.pendingJob) && (texture.lastUseFence != currentFence);
+            if (!pending && (textureEntry.requiresUpload || texture.dirtyPages.any()))
             {
+                m_textureJobs.wait(texture.pendingJob);
+                texture.pendingJob = TextureJobQueue::NO_JOB;
+                // A complete upload contains all pages, otherwise only the changed pages are uploaded
                 bool ret { true };
-                std::array<uint8_t, TEXTURE_PAGE_SIZE> buffer;
-                std::size_t j = 0;
-                for (tcb::span<const uint8_t> b = texture.getPageData(j, buffer); !b.empty(); b = texture.getPageData(++j, buffer))
+                for (std::size_t j = 0; ret && (j < texture.pages); j++)
+                {
+                    if (textureEntry.requiresUpload || texture.dirtyPages[j])
+                    {
+                        const tcb::span<uint8_t> buffer = pageBufferProvider(texture.getPageAddress(j), texture.getPageUploadSize());
+                        ret = !buffer.empty() && !texture.getPageData(j, buffer).empty();
+                    }
+                }
+                if (ret)
                 {
-                    ret = ret && uploader(static_cast<std::size_t>(texture.pageTable[j]) * TEXTURE_PAGE_SIZE, { buffer });
+                    textureEntry.requiresUpload = false;
+                    texture.dirtyPages.reset();
+                    // A released host copy is read back from the device when the texture is modified
+                    if (RenderConfig::RELEASE_TEXTURE_HOST_COPIES && m_device.canReadFromDeviceMemory()
+                        && !textureEntry.requiresDelete && (texture.pages > 0))
+                    {
+                        releaseHostCopy(textureSlot);
+                    }
                 }
-                textureEntry.requiresUpload = !ret;
             }
 
             if (textureEntry.requiresDelete)
             {
                 textureEntry.requiresDelete = false;
-                textureEntry.inUse = false;
+                textureEntry.requiresUpload = false;
+                texture.dirtyPages.reset();
                 texture.textures = {};
-                deallocPages(texture);
+                texture.pendingJob = TextureJobQueue::NO_JOB;
+                deallocPages(textureSlot);
+                m_textureAllocator.free(textureSlot);
+            }
+
+            if (textureEntry.requiresUpload || texture.dirtyPages.any())
+            {
+                m_dirtyTextures[remainingDirtyTextures++] = textureSlot;
+            }
+            else
+            {
+                textureEntry.dirty = false;
             }
         }
+        m_dirtyTexturesCount = remainingDirtyTextures;
+
+        compactPages(pageBufferProvider);
 
         return true;
     }
 
-private:
-    struct PageEntry
+    /// @brief Collects the fragmentation of the texture memory
+    Statistics getStatistics() const
     {
-        bool inUse { false };
-    };
+        Statistics statistics { m_statistics };
+        statistics.freePages = m_pageAllocator.getFreeCount();
+        statistics.usedPages = m_pageAllocator.size() - statistics.freePages;
+        statistics.largestFreeRange = m_pageAllocator.getLargestFreeRange();
+        statistics.sharedPages = m_sharedPagesCount;
+        for (std::size_t textureSlot = m_lruHead; textureSlot != INVALID_SLOT; textureSlot = m_textures[textureSlot].lruNext)
+        {
+            const std::size_t runs = m_textures[textureSlot].getNumberOfPageRuns();
+            statistics.textures++;
+            statistics.pageRuns += runs;
+            statistics.fragmentedTextures += (runs > 1) ? 1 : 0;
+        }
+        return statistics;
+    }
 
+    void resetStatistics()
+    {
+        m_statistics = {};
+    }
+
+private:
     struct TextureEntry
     {
-        bool inUse { false };
         bool requiresUpload { false };
         bool requiresDelete { false };
+        bool dirty { false }; ///< The texture is in the dirty list
+        bool evicted { false }; ///< The texture has no pages. Only the host copy is available.
+        bool released { false }; ///< The host copy of the pixels is freed. Only the pages are available.
+    };
+
+    static constexpr std::size_t INVALID_SLOT { RenderConfig::NUMBER_OF_TEXTURES };
+
+    // Defaults of GL_TEXTURE_BASE_LEVEL, GL_TEXTURE_MAX_LEVEL, GL_TEXTURE_MIN_LOD and GL_TEXTURE_MAX_LOD
+    struct LodRange
+    {
+        std::size_t baseLevel { 0 };
+        std::size_t maxLevel { 1000 };
+        float minLod { -1000.0f };
+        float maxLod { 1000.0f };
+    };
+
+    struct LevelRange
+    {
+        std::size_t streamStart { 0 }; ///< First streamed level. Its offset in the texture is block aligned.
+        std::size_t first { 0 }; ///< First level which can be selected by the TMU
+        std::size_t last { 0 }; ///< Last level which can be selected by the TMU
     };
 
     struct Texture
     {
         std::array<std::size_t, MAX_PAGES_PER_TEXTURE> pageTable {};
         std::size_t pages { 0 };
+        bool sharedPage { false }; ///< The texture shares its only page with other small textures
+        std::size_t pageOffset { 0 }; ///< Offset of the texture in a shared page
+        std::size_t sharedBlocks { 0 }; ///< Number of blocks in a shared page
+        std::bitset<MAX_PAGES_PER_TEXTURE> dirtyPages {}; ///< Pages which changed since the last upload
         TextureObjectMipmap textures {};
         TmuTextureReg tmuConfig {};
+        LodRange lodRange {};
+        bool generateMipmap { false }; ///< GL_GENERATE_MIPMAP: The levels are generated from level 0 when it changes
+        TextureJobQueue::Job pendingJob { TextureJobQueue::NO_JOB }; ///< Job which still writes the host copy of the texture
+
+        // Textures with pages are ordered from the least recently used to the most recently used one
+        uint32_t lastUseFence { 0 }; ///< Fence which is signaled when the last display list which uses this texture is processed
+        std::size_t lruPrev { INVALID_SLOT };
+        std::size_t lruNext { INVALID_SLOT };
+
+        static std::size_t getLevelSize(const TextureObject& level)
+        {
+            return level.getSizeInBytes();
+        }
+
+        /// @brief Paletted textures store the palette in front of the first level
+        std::size_t getPaletteSize() const
+        {
+            return textures[0].isPaletted() ? TextureObject::PALETTE_BYTES : 0;
+        }
 
         std::size_t getTextureSize() const
         {
-            std::size_t counter = 0;
+            std::size_t counter = getPaletteSize();
             for (auto& e : textures)
             {
-                counter += e.width * e.height * 2;
+                counter += getLevelSize(e);
             }
             return counter;
         }
 
+        std::size_t getNumberOfLevels() const
+        {
+            std::size_t levels = 0;
+            while ((levels < textures.size()) && (textures[levels].width > 0) && (textures[levels].height > 0))
+            {
+                levels++;
+            }
+            return levels;
+        }
+
+        std::size_t getLevelOffset(const std::size_t level) const
+        {
+            std::size_t offset = getPaletteSize();
+            for (std::size_t i = 0; (i < level) && (i < textures.size()); i++)
+            {
+                offset += getLevelSize(textures[i]);
+            }
+            return offset;
+        }
+
+        LevelRange getLevelRange() const
+        {
+            const std::size_t levels = getNumberOfLevels();
+            if (levels == 0)
+            {
+                return {};
+            }
+            LevelRange range {};
+            range.first = (std::min)(lodRange.baseLevel, levels - 1);
+            range.last = range.first;
+            if (tmuConfig.getEnableMinFilter())
+            {
+                // Conservative: Streams all levels which are selected by any lod between min and max lod
+                const std::size_t minLodLevel = lodRange.baseLevel + static_cast<std::size_t>(std::floor((std::max)(lodRange.minLod, 0.0f)));
+                const std::size_t maxLodLevel = lodRange.baseLevel + static_cast<std::size_t>(std::ceil((std::max)(lodRange.maxLod, 0.0f)));
+                range.first = (std::min)(minLodLevel, levels - 1);
+                range.last = (std::max)(range.first, (std::min)({ lodRange.maxLevel, maxLodLevel, levels - 1 }));
+            }
+            // The stream starts at a block boundary. Small levels in front of the first level are streamed as well.
+            // The TMU requires the palette at the beginning of the stream, therefore paletted textures are always streamed from the first level.
+            range.streamStart = getPaletteSize() ? 0 : range.first;
+            while ((range.streamStart > 0) && ((getLevelOffset(range.streamStart) % TEXTURE_PAGE_BLOCK_SIZE) != 0))
+            {
+                range.streamStart--;
+            }
+            return range;
+        }
+
+        std::size_t getNumberOfPages() const
+        {
+            return (getTextureSize() + TEXTURE_PAGE_SIZE - 1) / TEXTURE_PAGE_SIZE;
+        }
+
+        std::size_t getNumberOfBlocks() const
+        {
+            return (getTextureSize() + TEXTURE_PAGE_BLOCK_SIZE - 1) / TEXTURE_PAGE_BLOCK_SIZE;
+        }
+
+        uint32_t getPageAddress(const std::size_t page) const
+        {
+            return static_cast<uint32_t>((pageTable[page] * TEXTURE_PAGE_SIZE) + pageOffset);
+        }
+
+        std::size_t getPageUploadSize() const
+        {
+            // A texture in a shared page must not overwrite the blocks of the other textures
+            return sharedPage ? (sharedBlocks * TEXTURE_PAGE_BLOCK_SIZE) : TEXTURE_PAGE_SIZE;
+        }
+
+        std::size_t getNumberOfPageRuns() const
+        {
+            std::size_t runs = (pages > 0) ? 1 : 0;
+            for (std::size_t j = 1; j < pages; j++)
+            {
+                runs += (pageTable[j] != (pageTable[j - 1] + 1)) ? 1 : 0;
+            }
+            return runs;
+        }
+
+        bool hasSameLayout(const TextureObjectMipmap& other) const
+        {
+            for (std::size_t level = 0; level < textures.size(); level++)
+            {
+                if ((textures[level].width != other[level].width)
+                    || (textures[level].height != other[level].height)
+                    || (textures[level].getPixelFormat() != other[level].getPixelFormat()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         tcb::span<const uint8_t> getPageData(std::size_t page, const tcb::span<uint8_t>& buffer)
         {
-            const uint32_t addr = page * buffer.size();
+            uint32_t addr = page * buffer.size();
+            std::size_t bufferSize = 0;
+            const std::size_t paletteSize = getPaletteSize();
+            if (addr < paletteSize)
+            {
+                bufferSize = (std::min)(paletteSize - addr, buffer.size());
+                if (textures[0].palette)
+                {
+                    std::memcpy(buffer.data(), std::reinterpret_pointer_cast<const uint8_t, const uint16_t>(textures[0].palette).get() + addr, bufferSize);
+                }
+                else
+                {
+                    std::memset(buffer.data(), 0, bufferSize);
+                }
+                addr = 0;
+            }
+            else
+            {
+                addr -= paletteSize;
+            }
+
             uint32_t level = 0;
             uint32_t mipMapAddr = 0;
             for (level = 0; level < textures.size(); level++)
             {
-                if (addr < (mipMapAddr + textures[level].width * textures[level].height * 2))
+                if (addr < (mipMapAddr + getLevelSize(textures[level])))
                 {
                     mipMapAddr = addr - mipMapAddr;
                     break;
                 }
-                mipMapAddr += textures[level].width * textures[level].height * 2;
+                mipMapAddr += getLevelSize(textures[level]);
             }
 
             tcb::span<const uint8_t> ret {};
-            std::size_t bufferSize = 0;
-            for (; level < textures.size(); level++)
+            for (; (level < textures.size()) && (bufferSize < buffer.size()); level++)
             {
-                const std::size_t texSize = textures[level].width * textures[level].height * 2;
+                const std::size_t texSize = getLevelSize(textures[level]);
                 const uint8_t* pixels = std::reinterpret_pointer_cast<const uint8_t, const uint16_t>(textures[level].pixels).get() + mipMapAddr;
                 const std::size_t dataSize = (std::min)(texSize - static_cast<std::size_t>(mipMapAddr), buffer.size() - bufferSize);
                 std::memcpy(buffer.data() + bufferSize, pixels, dataSize);
@@ -336,73 +816,520 @@ private:
         }
     };
 
-    bool allocPages(Texture& tex, const std::size_t numberOfPages)
+    bool allocPages(const std::size_t textureSlot, const std::size_t numberOfPages)
     {
+        Texture& tex = m_textures[textureSlot];
         std::size_t cp = 0;
         if (numberOfPages == 0)
         {
             SPDLOG_ERROR("Called allocPages with numberOfPages == 0");
             return false;
         }
-        for (std::size_t p = 0; p < m_pageTable.size(); p++)
+        if (numberOfPages > tex.pageTable.size())
+        {
+            SPDLOG_ERROR("Texture specific page table overflown");
+            return false;
+        }
+        if (tex.getNumberOfBlocks() <= MAX_BLOCKS_PER_SHARED_TEXTURE)
+        {
+            while (!allocBlocks(textureSlot))
+            {
+                if (!evictLeastRecentlyUsedTexture() && !freeDeferredPages(true))
+                {
+                    SPDLOG_DEBUG("Not enough blocks available for texture");
+                    return false;
+                }
+            }
+            touchTexture(textureSlot);
+            return true;
+        }
+        while (numberOfPages > m_pageAllocator.getFreeCount())
+        {
+            if (!evictLeastRecentlyUsedTexture() && !freeDeferredPages(true))
+            {
+                SPDLOG_DEBUG("Not enough pages available for texture");
+                return false;
+            }
+        }
+        // Contiguous pages are preferred. They are read with consecutive memory accesses.
+        if (const std::optional<std::size_t> firstPage = m_pageAllocator.allocRange(numberOfPages))
+        {
+            for (; cp < numberOfPages; cp++)
+            {
+                tex.pageTable[cp] = *firstPage + cp;
+                m_pageOwner[*firstPage + cp] = textureSlot;
+            }
+            SPDLOG_DEBUG("Use pages: {} to {}", *firstPage, *firstPage + numberOfPages - 1);
+        }
+        else
         {
-            if (m_pageTable[p].inUse == false)
+            for (; cp < numberOfPages; cp++)
             {
+                const std::size_t p = *m_pageAllocator.alloc();
                 tex.pageTable[cp] = p;
-                m_pageTable[p].inUse = true;
+                m_pageOwner[p] = textureSlot;
                 SPDLOG_DEBUG("Use page: {}", p);
-                cp++;
-                tex.pages = cp;
-                if (cp == numberOfPages)
+            }
+        }
+        tex.pages = cp;
+        // A new texture is handled like a texture which is used by the current display list.
+        // This keeps the LRU list ordered by the fences.
+        touchTexture(textureSlot);
+        return true;
+    }
+
+    void deallocPages(const std::size_t textureSlot, const bool deferred = true)
+    {
+        // The pages might still be referenced by a display list in flight or by the display list which is currently
+        // assembled, for instance when a texture is deleted after a draw. They are freed when the last display list
+        // which uses them is processed. Without deferral, the pages are freed immediately.
+        Texture& tex = m_textures[textureSlot];
+        if (tex.sharedPage)
+        {
+            freeBlocks(textureSlot, deferred);
+        }
+        else
+        {
+            for (std::size_t j = 0; j < tex.pages; j++)
+            {
+                freePage(tex.pageTable[j], tex.lastUseFence, deferred);
+            }
+        }
+        tex.pages = 0;
+        removeFromLru(textureSlot);
+    }
+
+    void freePage(const std::size_t page, const uint32_t fence, const bool deferred)
+    {
+        if (deferred)
+        {
+            deferPageFree(page, fence);
+        }
+        else
+        {
+            m_pageAllocator.free(page);
+        }
+    }
+
+    bool allocBlocks(const std::size_t textureSlot)
+    {
+        Texture& tex = m_textures[textureSlot];
+        const std::size_t blocks = tex.getNumberOfBlocks();
+        const uint32_t mask = (uint32_t { 1 } << blocks) - 1;
+        for (std::size_t i = 0; i < m_sharedPagesCount; i++)
+        {
+            const std::size_t page = m_sharedPages[i];
+            for (std::size_t block = 0; (block + blocks) <= BLOCKS_PER_PAGE; block++)
+            {
+                if ((m_pageBlocks[page] & (mask << block)) == 0)
                 {
+                    m_pageBlocks[page] |= mask << block;
+                    tex.pageTable[0] = page;
+                    tex.pageOffset = block * TEXTURE_PAGE_BLOCK_SIZE;
+                    tex.pages = 1;
+                    tex.sharedPage = true;
+                    tex.sharedBlocks = blocks;
+                    SPDLOG_DEBUG("Use blocks {} to {} of page {}", block, block + blocks - 1, page);
+                    return true;
+                }
+            }
+        }
+        const std::optional<std::size_t> page = m_pageAllocator.alloc();
+        if (!page)
+        {
+            return false;
+        }
+        m_sharedPages[m_sharedPagesCount++] = *page;
+        m_pageBlocks[*page] = mask;
+        m_pageOwner[*page] = textureSlot;
+        tex.pageTable[0] = *page;
+        tex.pageOffset = 0;
+        tex.pages = 1;
+        tex.sharedPage = true;
+        tex.sharedBlocks = blocks;
+        SPDLOG_DEBUG("Use blocks 0 to {} of new shared page {}", blocks - 1, *page);
+        return true;
+    }
+
+    void freeBlocks(const std::size_t textureSlot, const bool deferred)
+    {
+        // A page which is still shared stays allocated. An emptied page is freed like the pages of other textures.
+        Texture& tex = m_textures[textureSlot];
+        const std::size_t page = tex.pageTable[0];
+        const uint32_t mask = (uint32_t { 1 } << tex.sharedBlocks) - 1;
+        m_pageBlocks[page] &= ~(mask << (tex.pageOffset / TEXTURE_PAGE_BLOCK_SIZE));
+        tex.sharedPage = false;
+        tex.pageOffset = 0;
+        tex.sharedBlocks = 0;
+        if (m_pageBlocks[page] == 0)
+        {
+            for (std::size_t i = 0; i < m_sharedPagesCount; i++)
+            {
+                if (m_sharedPages[i] == page)
+                {
+                    m_sharedPages[i] = m_sharedPages[--m_sharedPagesCount];
                     break;
                 }
-                if (cp >= tex.pageTable.size())
+            }
+            freePage(page, tex.lastUseFence, deferred);
+        }
+    }
+
+    void compactPages(const std::function<tcb::span<uint8_t>(uint32_t gramAddr, const uint32_t size)>& pageBufferProvider)
+    {
+        // Moves fragmented textures into contiguous pages, starting with the most recently used textures.
+        // The device can't copy from memory to memory, therefore the host copy is uploaded into the new pages.
+        // The display list which is currently assembled is streamed after this upload and might still
+        // reference the old pages. They are freed when the last display list which uses them is processed
+        // (see freeDeferredPages()). Pages of textures which are not used by the current display list are
+        // only referenced by display lists which are streamed in front of this upload. They can be
+        // overwritten. These textures are evicted.
+        const uint32_t currentFence = getCurrentFence();
+        std::size_t migratedPages = 0;
+        std::size_t candidates = 0;
+        std::size_t textureSlot = m_lruTail;
+        while ((textureSlot != INVALID_SLOT)
+            && (migratedPages < COMPACTION_PAGES_PER_UPLOAD)
+            && (candidates < COMPACTION_CANDIDATES_PER_UPLOAD))
+        {
+            const std::size_t nextTextureSlot = m_textures[textureSlot].lruPrev;
+            if (!m_textureEntryFlags[textureSlot].dirty && !m_textureEntryFlags[textureSlot].released
+                && (m_textures[textureSlot].getNumberOfPageRuns() > 1))
+            {
+                candidates++;
+                const std::optional<std::size_t> firstPage = findCompactionTarget(textureSlot, currentFence);
+                if (firstPage)
                 {
-                    SPDLOG_ERROR("Texture specific page table overflown");
-                    return false;
+                    if (!moveTexture(textureSlot, *firstPage, pageBufferProvider))
+                    {
+                        break;
+                    }
+                    migratedPages += m_textures[textureSlot].pages;
+                }
+            }
+            textureSlot = nextTextureSlot;
+        }
+        m_statistics.migratedPages += migratedPages;
+    }
+
+    std::optional<std::size_t> findCompactionTarget(const std::size_t textureSlot, const uint32_t currentFence) const
+    {
+        // Searches the run of pages which displaces the least pages of other textures. Pages of the texture
+        // itself, of textures used by the current display list, of textures with pending uploads and of textures
+        // without host copy can't be used.
+        const std::size_t numberOfPages = m_textures[textureSlot].pages;
+        const auto classify = [&](const std::size_t page)
+        {
+            struct PageClass
+            {
+                std::size_t blocked;
+                std::size_t displaced;
+            };
+            if (m_pageAllocator.isFree(page))
+            {
+                return PageClass { 0, 0 };
+            }
+            const std::size_t owner = m_pageOwner[page];
+            if ((owner == INVALID_SLOT) || (m_pageBlocks[page] != 0)
+                || (owner == textureSlot) || (m_textures[owner].lastUseFence == currentFence) || m_textureEntryFlags[owner].dirty
+                || m_textureEntryFlags[owner].released)
+            {
+                return PageClass { 1, 0 };
+            }
+            return PageClass { 0, 1 };
+        };
+
+        std::optional<std::size_t> target {};
+        std::size_t targetDisplaced = numberOfPages + 1;
+        std::size_t blocked = 0;
+        std::size_t displaced = 0;
+        for (std::size_t page = 0; page < RenderConfig::NUMBER_OF_TEXTURE_PAGES; page++)
+        {
+            const auto in = classify(page);
+            blocked += in.blocked;
+            displaced += in.displaced;
+            if (page >= numberOfPages)
+            {
+                const auto out = classify(page - numberOfPages);
+                blocked -= out.blocked;
+                displaced -= out.displaced;
+            }
+            if (((page + 1) >= numberOfPages) && (blocked == 0) && (displaced < targetDisplaced))
+            {
+                target = page + 1 - numberOfPages;
+                targetDisplaced = displaced;
+                if (displaced == 0)
+                {
+                    break;
                 }
             }
         }
-        if (cp != numberOfPages)
+        return target;
+    }
+
+    bool moveTexture(
+        const std::size_t textureSlot,
+        const std::size_t firstPage,
+        const std::function<tcb::span<uint8_t>(uint32_t gramAddr, const uint32_t size)>& pageBufferProvider)
+    {
+        Texture& tex = m_textures[textureSlot];
+        for (std::size_t page = firstPage; page < (firstPage + tex.pages); page++)
+        {
+            if (!m_pageAllocator.isFree(page))
+            {
+                evictTexture(m_pageOwner[page]);
+            }
+            m_pageAllocator.alloc(page);
+        }
+        bool ret { true };
+        for (std::size_t j = 0; ret && (j < tex.pages); j++)
         {
-            SPDLOG_ERROR("Not enough pages available for texture");
+            const tcb::span<uint8_t> buffer = pageBufferProvider((firstPage + j) * TEXTURE_PAGE_SIZE, TEXTURE_PAGE_SIZE);
+            ret = !buffer.empty() && !tex.getPageData(j, buffer).empty();
+        }
+        if (!ret)
+        {
+            SPDLOG_ERROR("Was not able to move texture slot {} into contiguous pages", textureSlot);
+            for (std::size_t j = 0; j < tex.pages; j++)
+            {
+                m_pageAllocator.free(firstPage + j);
+            }
             return false;
         }
+        for (std::size_t j = 0; j < tex.pages; j++)
+        {
+            deferPageFree(tex.pageTable[j], tex.lastUseFence);
+            tex.pageTable[j] = firstPage + j;
+            m_pageOwner[firstPage + j] = textureSlot;
+        }
+        SPDLOG_DEBUG("Moved texture slot {} into pages {} to {}", textureSlot, firstPage, firstPage + tex.pages - 1);
         return true;
     }
 
-    void deallocPages(Texture& tex)
+    void deferPageFree(const std::size_t page, const uint32_t fence)
     {
-        for (std::size_t j = 0; j < tex.pages; j++)
+        if (m_device.isFenceSignaled(fence))
         {
-            m_pageTable[tex.pageTable[j]].inUse = false;
+            m_pageAllocator.free(page);
+            return;
         }
-        tex.pages = 0;
+        // The page has no owner anymore, it can't be evicted or displaced until it is freed
+        m_pageOwner[page] = INVALID_SLOT;
+        m_deferredPages[m_deferredPagesCount++] = { page, fence };
     }
 
-    std::optional<std::size_t> allocTexture()
+    bool freeDeferredPages(const bool wait)
     {
-        for (std::size_t i = 1; i < RenderConfig::NUMBER_OF_TEXTURES; i++)
+        // Frees the old pages of moved and deleted textures, when the display lists which reference them are processed.
+        // The display list which is currently assembled is not streamed yet, its fence can't be waited for.
+        const uint32_t currentFence = getCurrentFence();
+        std::size_t remainingPages = 0;
+        bool freed { false };
+        for (std::size_t i = 0; i < m_deferredPagesCount; i++)
         {
-            if (m_textureEntryFlags[i].inUse == false)
+            const DeferredPage deferredPage = m_deferredPages[i];
+            if (wait && (deferredPage.fence != currentFence))
             {
-                m_textureEntryFlags[i].inUse = true;
-                SPDLOG_DEBUG("Allocating texture {}", i);
-                return std::make_optional(i);
+                m_device.blockUntilFenceIsSignaled(deferredPage.fence);
             }
+            if (m_device.isFenceSignaled(deferredPage.fence))
+            {
+                m_pageAllocator.free(deferredPage.page);
+                freed = true;
+            }
+            else
+            {
+                m_deferredPages[remainingPages++] = deferredPage;
+            }
+        }
+        m_deferredPagesCount = remainingPages;
+        return freed;
+    }
+
+    bool evictLeastRecentlyUsedTexture()
+    {
+        // The LRU list is ordered by the fences. If the head is still used by the current display list, all others are too.
+        // Textures without host copy can't be reloaded, they are skipped.
+        std::size_t textureSlot = m_lruHead;
+        while ((textureSlot != INVALID_SLOT) && m_textureEntryFlags[textureSlot].released)
+        {
+            textureSlot = m_textures[textureSlot].lruNext;
         }
-        SPDLOG_ERROR("Ran out of memory during texture allocation");
-        return std::nullopt;
+        if ((textureSlot == INVALID_SLOT) || (m_textures[textureSlot].lastUseFence == getCurrentFence()))
+        {
+            return false;
+        }
+        // Wait until the pages are not referenced anymore by a display list in flight
+        m_device.blockUntilFenceIsSignaled(m_textures[textureSlot].lastUseFence);
+        evictTexture(textureSlot);
+        return true;
     }
 
+    void evictTexture(const std::size_t textureSlot)
+    {
+        SPDLOG_DEBUG("Evict texture slot {} with {} pages", textureSlot, m_textures[textureSlot].pages);
+
+        // The host copy in textures is kept for the reload. The texture is not used by the display list which is
+        // currently assembled. Its pages are only referenced by display lists which are streamed in front of the next
+        // upload, or, when evicted by the LRU, not referenced anymore. They can be reused immediately.
+        deallocPages(textureSlot, false);
+        m_textures[textureSlot].dirtyPages.reset();
+        m_textureEntryFlags[textureSlot].requiresUpload = false;
+        m_textureEntryFlags[textureSlot].evicted = true;
+    }
+
+    void releaseHostCopy(const std::size_t textureSlot)
+    {
+        // The palette is small and kept. It is also required to restore the layout of the pages.
+        for (TextureObject& level : m_textures[textureSlot].textures)
+        {
+            level.pixels = {};
+        }
+        m_textureEntryFlags[textureSlot].released = true;
+    }
+
+    bool restoreHostCopy(const std::size_t textureSlot)
+    {
+        // Reads the pages back from the device memory. The pages contain the palette followed by the levels.
+        Texture& tex = m_textures[textureSlot];
+        const std::size_t uploadSize = tex.getPageUploadSize();
+        std::vector<uint8_t> data(tex.pages * uploadSize);
+        bool ret { true };
+        for (std::size_t j = 0; ret && (j < tex.pages); j++)
+        {
+            ret = m_device.readFromDeviceMemory({ data.data() + (j * uploadSize), uploadSize }, tex.getPageAddress(j));
+        }
+        if (!ret)
+        {
+            // The texture stays released. Its pages are still valid and can be used.
+            SPDLOG_ERROR("Was not able to read back the host copy of texture slot {}", textureSlot);
+            return false;
+        }
+        SPDLOG_DEBUG("Read back texture slot {} from {} pages", textureSlot, tex.pages);
+        for (std::size_t level = 0; level < tex.getNumberOfLevels(); level++)
+        {
+            const std::size_t levelSize = Texture::getLevelSize(tex.textures[level]);
+            std::shared_ptr<uint16_t> pixels(new uint16_t[(levelSize + 1) / 2], [](const uint16_t* p)
+                { delete[] p; });
+            std::memcpy(pixels.get(), data.data() + tex.getLevelOffset(level), levelSize);
+            tex.textures[level].pixels = pixels;
+        }
+        m_textureEntryFlags[textureSlot].released = false;
+        return true;
+    }
+
+    uint32_t getCurrentFence() const
+    {
+        // The fence which is signaled when the display list, which is currently assembled, is processed
+        return m_device.insertFence() + 1;
+    }
+
+    void touchTexture(const std::size_t textureSlot)
+    {
+        removeFromLru(textureSlot);
+        Texture& tex = m_textures[textureSlot];
+        tex.lastUseFence = getCurrentFence();
+        tex.lruPrev = m_lruTail;
+        tex.lruNext = INVALID_SLOT;
+        if (m_lruTail != INVALID_SLOT)
+        {
+            m_textures[m_lruTail].lruNext = textureSlot;
+        }
+        else
+        {
+            m_lruHead = textureSlot;
+        }
+        m_lruTail = textureSlot;
+    }
+
+    void removeFromLru(const std::size_t textureSlot)
+    {
+        Texture& tex = m_textures[textureSlot];
+        if ((tex.lruPrev == INVALID_SLOT) && (m_lruHead != textureSlot))
+        {
+            // Not in the list
+            return;
+        }
+        if (tex.lruPrev != INVALID_SLOT)
+        {
+            m_textures[tex.lruPrev].lruNext = tex.lruNext;
+        }
+        else
+        {
+            m_lruHead = tex.lruNext;
+        }
+        if (tex.lruNext != INVALID_SLOT)
+        {
+            m_textures[tex.lruNext].lruPrev = tex.lruPrev;
+        }
+        else
+        {
+            m_lruTail = tex.lruPrev;
+        }
+        tex.lruPrev = INVALID_SLOT;
+        tex.lruNext = INVALID_SLOT;
+    }
+
+    std::optional<std::size_t> allocTexture()
+    {
+        const std::optional<std::size_t> textureSlot = m_textureAllocator.alloc();
+        if (!textureSlot)
+        {
+            SPDLOG_ERROR("Ran out of memory during texture allocation");
+            return std::nullopt;
+        }
+        SPDLOG_DEBUG("Allocating texture {}", *textureSlot);
+        m_textureEntryFlags[*textureSlot] = {};
+        return textureSlot;
+    }
+
+    void markDirty(const std::size_t textureSlot)
+    {
+        // Every slot is at most once in the list, therefore the list can not overflow
+        if (!m_textureEntryFlags[textureSlot].dirty)
+        {
+            m_textureEntryFlags[textureSlot].dirty = true;
+            m_dirtyTextures[m_dirtyTexturesCount++] = textureSlot;
+        }
+    }
+
+    IDevice& m_device;
+
+    // Jobs which write the host copies of the textures
+    TextureJobQueue m_textureJobs;
+
     // Texture memory allocator
     std::array<Texture, RenderConfig::NUMBER_OF_TEXTURES> m_textures;
     std::array<TextureEntry, RenderConfig::NUMBER_OF_TEXTURES> m_textureEntryFlags {};
     std::array<std::optional<std::size_t>, RenderConfig::NUMBER_OF_TEXTURES> m_textureLut {};
-    std::array<PageEntry, RenderConfig::NUMBER_OF_TEXTURE_PAGES> m_pageTable {};
+    BitmapAllocator<RenderConfig::NUMBER_OF_TEXTURE_PAGES> m_pageAllocator {};
+    std::array<std::size_t, RenderConfig::NUMBER_OF_TEXTURE_PAGES> m_pageOwner {}; ///< Texture slot of an allocated page
+
+    // Pages which are shared by small textures. A set bit in m_pageBlocks marks a used block of a page.
+    std::array<uint32_t, RenderConfig::NUMBER_OF_TEXTURE_PAGES> m_pageBlocks {};
+    std::array<std::size_t, RenderConfig::NUMBER_OF_TEXTURE_PAGES> m_sharedPages {};
+    std::size_t m_sharedPagesCount { 0 };
+
+    // Old pages of moved and deleted textures, which are freed when the fence is signaled
+    struct DeferredPage
+    {
+        std::size_t page;
+        uint32_t fence;
+    };
+    std::array<DeferredPage, RenderConfig::NUMBER_OF_TEXTURE_PAGES> m_deferredPages {};
+    std::size_t m_deferredPagesCount { 0 };
+    BitmapAllocator<RenderConfig::NUMBER_OF_TEXTURES> m_textureAllocator {};
+    BitmapAllocator<RenderConfig::NUMBER_OF_TEXTURES> m_textureNameAllocator {};
+
+    // Textures which require an upload or a delete
+    std::array<std::size_t, RenderConfig::NUMBER_OF_TEXTURES> m_dirtyTextures {};
+    std::size_t m_dirtyTexturesCount { 0 };
+
+    // List of the textures with pages, ordered by their last use
+    std::size_t m_lruHead { INVALID_SLOT };
+    std::size_t m_lruTail { INVALID_SLOT };
 
-    bool m_textureUpdateRequired { false };
+    Statistics m_statistics {};
 };
 
 } // namespace rr
@@ -36,8 +36,16 @@ struct TextureObject
         RGB,
         RGBA,
         RGBA1,
+        COMPRESSED_RGB_DXT1,
+        COMPRESSED_RGBA_DXT1,
+        COLOR_INDEX8,
     };
 
+    static constexpr std::size_t COMPRESSED_BLOCK_SIZE { 4 }; ///< Width and height of a compressed block in texels
+    static constexpr std::size_t COMPRESSED_BLOCK_BYTES { 8 }; ///< Size of a compressed block in bytes
+    static constexpr std::size_t PALETTE_SIZE { 256 }; ///< Number of colors in the palette of a paletted texture
+    static constexpr std::size_t PALETTE_BYTES { PALETTE_SIZE * 2 }; ///< Size of the palette in bytes
+
     static uint16_t convertColor(
         const IntendedInternalPixelFormat ipf,
         const uint8_t r,
@@ -117,18 +125,95 @@ struct TextureObject
         case IntendedInternalPixelFormat::RGBA1:
             format = PixelFormat::RGBA5551;
             break;
+        case IntendedInternalPixelFormat::COMPRESSED_RGB_DXT1:
+            format = PixelFormat::RGB_DXT1;
+            break;
+        case IntendedInternalPixelFormat::COMPRESSED_RGBA_DXT1:
+            format = PixelFormat::RGBA_DXT1;
+            break;
+        case IntendedInternalPixelFormat::COLOR_INDEX8:
+            format = getPalettePixelFormat();
+            break;
         default:
             break;
         }
         return format;
     }
 
-    std::shared_ptr<const uint16_t> pixels {}; ///< The texture in the format defined by PixelFormat
+    bool isCompressed() const
+    {
+        return (intendedPixelFormat == IntendedInternalPixelFormat::COMPRESSED_RGB_DXT1)
+            || (intendedPixelFormat == IntendedInternalPixelFormat::COMPRESSED_RGBA_DXT1);
+    }
+
+    bool isPaletted() const
+    {
+        return intendedPixelFormat == IntendedInternalPixelFormat::COLOR_INDEX8;
+    }
+
+    /// @brief Returns the size of the pixel data in bytes.
+    /// Compressed textures are stored in blocks of 4x4 texels. Levels smaller than a block use a whole block.
+    /// Paletted textures use one byte per texel. The palette is not included.
+    std::size_t getSizeInBytes() const
+    {
+        if ((width == 0) || (height == 0))
+        {
+            return 0;
+        }
+        if (isCompressed())
+        {
+            return getCompressedSizeInBytes(width, height);
+        }
+        if (isPaletted())
+        {
+            return width * height;
+        }
+        return width * height * 2;
+    }
+
+    /// @brief Returns the size of a compressed image in bytes
+    static std::size_t getCompressedSizeInBytes(const std::size_t width, const std::size_t height)
+    {
+        const std::size_t blocksX = (width + COMPRESSED_BLOCK_SIZE - 1) / COMPRESSED_BLOCK_SIZE;
+        const std::size_t blocksY = (height + COMPRESSED_BLOCK_SIZE - 1) / COMPRESSED_BLOCK_SIZE;
+        return blocksX * blocksY * COMPRESSED_BLOCK_BYTES;
+    }
+
+    std::shared_ptr<const uint16_t> pixels {}; ///< The texture in the format defined by PixelFormat. Compressed textures contain the blocks. Paletted textures contain the indices.
     std::size_t width {}; ///< The width of the texture
     std::size_t height {}; ///< The height of the texture
     IntendedInternalPixelFormat intendedPixelFormat {}; ///< The intended pixel format which is converted to a type of PixelFormat
+    std::shared_ptr<const uint16_t> palette {}; ///< The PALETTE_SIZE colors of a paletted texture. Only the palette of the base level (level 0) is used.
+    IntendedInternalPixelFormat paletteFormat { IntendedInternalPixelFormat::RGBA }; ///< The intended pixel format of the palette
+
+private:
+    PixelFormat getPalettePixelFormat() const
+    {
+        // Same mapping as in getPixelFormat()
+        switch (paletteFormat)
+        {
+        case IntendedInternalPixelFormat::LUMINANCE:
+        case IntendedInternalPixelFormat::RGB:
+            return PixelFormat::INDEX8_RGB565;
+        case IntendedInternalPixelFormat::RGBA1:
+            return PixelFormat::INDEX8_RGBA5551;
+        default:
+            return PixelFormat::INDEX8_RGBA4444;
+        }
+    }
 };
 
 using TextureObjectMipmap = std::array<TextureObject, TextureObject::MAX_LOD + 1>;
+
+/// @brief Byte range of a mipmap level which was changed
+struct TextureObjectDirtyRange
+{
+    std::size_t begin { 0 }; ///< First changed byte
+    std::size_t end { 0 }; ///< Byte after the last changed byte
+
+    bool empty() const { return begin >= end; }
+};
+
+using TextureObjectMipmapDirtyRanges = std::array<TextureObjectDirtyRange, TextureObject::MAX_LOD + 1>;
 } // namespace rr
 #endif // TEXTURE_OBJECT_HPP
@@ -20,6 +20,7 @@
 
 #include "RenderConfigs.hpp"
 #include "renderer/displaylist/DisplayList.hpp"
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <tcb/span.hpp>
@@ -36,17 +37,31 @@ class TextureStreamCmd
     static constexpr uint32_t TEXTURE_STREAM_TMU_NR_POS { 19 }; // size: 2 bit
     static constexpr uint32_t TEXTURE_STREAM_TMU_NR_MASK { 0x3 }; // size: 2 bit
     static constexpr uint32_t OP_MASK { 0xF000'0000 };
+    static constexpr std::size_t BLOCKS_PER_PAGE { RenderConfig::TEXTURE_PAGE_SIZE / RenderConfig::TEXTURE_PAGE_BLOCK_SIZE };
+    static_assert(BLOCKS_PER_PAGE < 64, "The number of blocks must fit into the lower bits of the page address");
 
 public:
     using PayloadType = tcb::span<const uint32_t>;
     using CommandType = uint32_t;
 
     TextureStreamCmd() = default;
-    TextureStreamCmd(const std::size_t tmu, const tcb::span<const std::size_t>& pages)
+    /// @brief Streams a texture into a TMU
+    /// @param tmu The TMU which receives the texture
+    /// @param pages The pages of the texture
+    /// @param pageOffset Offset of the texture in the first page. Used by small textures which share a page.
+    /// @param textureSize The size of the texture in bytes. Only the blocks of a page which contain texture data are streamed.
+    TextureStreamCmd(const std::size_t tmu, const tcb::span<const std::size_t>& pages, const std::size_t pageOffset, const std::size_t textureSize)
     {
+        std::size_t remainingSize = textureSize;
         for (std::size_t i = 0; i < pages.size(); i++)
         {
-            m_pages[i] = RenderConfig::GRAM_MEMORY_LOC + static_cast<uint32_t>(pages[i] * RenderConfig::TEXTURE_PAGE_SIZE);
+            const std::size_t offset = (i == 0) ? pageOffset : 0;
+            const std::size_t size = (std::min)(remainingSize, RenderConfig::TEXTURE_PAGE_SIZE - offset);
+            const std::size_t blocks = (size + RenderConfig::TEXTURE_PAGE_BLOCK_SIZE - 1) / RenderConfig::TEXTURE_PAGE_BLOCK_SIZE;
+            remainingSize -= size;
+            // The lower bits of the block aligned address contain the number of blocks. 0 streams the complete page.
+            m_pages[i] = RenderConfig::GRAM_MEMORY_LOC + static_cast<uint32_t>((pages[i] * RenderConfig::TEXTURE_PAGE_SIZE) + offset);
+            m_pages[i] |= (blocks < BLOCKS_PER_PAGE) ? static_cast<uint32_t>(blocks) : 0;
         }
         m_payload = { m_pages.data(), pages.size() };
 
@@ -24,6 +24,7 @@
 #include "renderer/commands/TriangleStreamTypes.hpp"
 #include "renderer/displaylist/DisplayList.hpp"
 #include <array>
+#include <bitset>
 #include <cstdint>
 #include <tcb/span.hpp>
 #include <type_traits>
@@ -51,6 +52,26 @@ public:
 
     TriangleStreamCmd(const TriangleStreamCmd& c) { operator=(c); }
 
+    /// @brief Sets up all triangles of a batch at once
+    /// @param rasterizer The rasterizer which is used for the setup
+    /// @param batch The triangles to set up
+    /// @param cmds Receives the triangles. Only the first batch.count commands are written.
+    static void rasterize(const Rasterizer& rasterizer,
+        const Rasterizer::TriangleBatch& batch,
+        std::array<TriangleStreamCmd, Rasterizer::BATCH_SIZE>& cmds)
+    {
+        std::array<TriangleStreamTypes::TriangleDesc*, Rasterizer::BATCH_SIZE> descs;
+        for (std::size_t i = 0; i < descs.size(); i++)
+        {
+            descs[i] = &cmds[i].m_desc[0];
+        }
+        const std::bitset<Rasterizer::BATCH_SIZE> visible = rasterizer.rasterize(descs, batch);
+        for (std::size_t i = 0; i < batch.count; i++)
+        {
+            cmds[i].m_visible = visible[i];
+        }
+    }
+
     bool isInBounds(const std::size_t lineStart, const std::size_t lineEnd) const
     {
         return Rasterizer::checkIfTriangleIsInBounds(m_desc[0].param, lineStart, lineEnd);
@@ -58,11 +79,20 @@ public:
 
     TriangleStreamCmd getIncremented(const std::size_t lineStart, const std::size_t lineEnd)
     {
-        TriangleStreamCmd cmd = *this;
+        TriangleStreamCmd cmd = getTightened(lineStart, lineEnd);
         Rasterizer::increment(cmd.m_desc[0], lineStart, lineEnd);
         return cmd;
     }
 
+    /// @brief Returns a copy with a bounding box which only contains the part of the triangle within
+    ///     the lines. The copy is not visible, if the triangle has no pixel in these lines.
+    TriangleStreamCmd getTightened(const std::size_t lineStart, const std::size_t lineEnd) const
+    {
+        TriangleStreamCmd cmd = *this;
+        cmd.m_visible = Rasterizer::tightenBoundingBox(cmd.m_desc[0], lineStart, lineEnd);
+        return cmd;
+    }
+
     bool isVisible() const { return m_visible; };
 
     using PayloadType = std::array<TriangleStreamTypes::TriangleDesc, 1>;
@@ -85,6 +115,46 @@ private:
     bool m_visible { false };
 };
 
+// Collects triangles and sets them up in batches of Rasterizer::BATCH_SIZE.
+// The batch must be flushed before the rasterizer changes and before other commands are added to the
+// display list. Otherwise the order of the commands changes.
+class TriangleStreamBatch
+{
+public:
+    /// @brief Adds a triangle to the batch
+    /// @param triangle The triangle. It is copied into the batch.
+    /// @return true when the batch is full and must be flushed
+    bool add(const TransformedTriangle& triangle) { return m_batch.add(triangle); }
+
+    /// @brief Sets up all collected triangles and empties the batch
+    /// @param rasterizer The rasterizer which is used for the setup
+    /// @param addTriangle Is called in order with every visible triangle (TriangleStreamCmd&)
+    /// @return false if one of the addTriangle calls failed
+    template <typename Function>
+    bool flush(const Rasterizer& rasterizer, const Function& addTriangle)
+    {
+        if (m_batch.count == 0)
+        {
+            return true;
+        }
+        TriangleStreamCmd::rasterize(rasterizer, m_batch, m_cmds);
+        bool ret = true;
+        for (std::size_t i = 0; i < m_batch.count; i++)
+        {
+            if (m_cmds[i].isVisible())
+            {
+                ret = addTriangle(m_cmds[i]) && ret;
+            }
+        }
+        m_batch.count = 0;
+        return ret;
+    }
+
+private:
+    Rasterizer::TriangleBatch m_batch {};
+    std::array<TriangleStreamCmd, Rasterizer::BATCH_SIZE> m_cmds {};
+};
+
 } // namespace rr
 
 #endif // _TRIANGLE_STREAM_CMD_HPP_
@@ -132,6 +132,11 @@ public:
         return writePos <= readPos;
     }
 
+    std::size_t getCurrentReadPos() const
+    {
+        return readPos;
+    }
+
     void resetGet()
     {
         readPos = 0;
@@ -22,6 +22,10 @@
 #include "IBusConnector.hpp"
 #include "RenderConfigs.hpp"
 #include "renderer/IDevice.hpp"
+#include <array>
+#include <bitset>
+#include <optional>
+#include <spdlog/spdlog.h>
 
 namespace rr::DSEC
 {
@@ -38,23 +42,141 @@ public:
 
     void streamDisplayList(const uint8_t index, uint32_t size) override
     {
+        // Pending writes must arrive in front of the display list, which might use them
+        flushWritesToDeviceMemory();
         size = fillWhenDataIsTooSmall(index, size);
         const uint32_t commandSize = addDseStreamCommand(index, size);
-        m_busConnector.writeData(index, size + commandSize);
+        m_streamedDisplayLists++;
+        m_displayListOfBuffer[index] = m_streamedDisplayLists;
+        startTransfer(index, size + commandSize);
+    }
+
+    void streamPartialDisplayList(const uint8_t, const uint32_t, const bool) override
+    {
+        // The DSE can only stream complete display lists.
     }
 
     void writeToDeviceMemory(tcb::span<const uint8_t> data, const uint32_t addr) override
     {
-        const uint32_t commandSize = addDseStoreCommand(
-            (std::max)(static_cast<uint32_t>(data.size()), DEVICE_MIN_TRANSFER_SIZE),
-            addr + RenderConfig::GRAM_MEMORY_LOC);
-        addDseStorePayload(commandSize, data);
-        m_busConnector.writeData(getStoreBufferIndex(), commandSize + data.size());
+        tcb::span<uint8_t> buffer = requestWriteToDeviceMemory(addr, data.size());
+        if (buffer.empty())
+        {
+            return;
+        }
+        std::copy(data.begin(), data.end(), buffer.begin());
+        flushWritesToDeviceMemory();
+    }
+
+    tcb::span<uint8_t> requestWriteToDeviceMemory(const uint32_t addr, const uint32_t size) override
+    {
+        // The writes are collected as a sequence of store commands in the store buffer. The DSE executes
+        // them one after another. A write which directly follows the previous one extends its store command.
+        const uint32_t payloadSize = (std::max)(size, DEVICE_MIN_TRANSFER_SIZE);
+        const std::size_t storeBufferSize = m_busConnector.requestBuffer(getStoreBufferIndex()).size();
+        if ((sizeof(Command) + payloadSize) > storeBufferSize)
+        {
+            SPDLOG_ERROR("Write of {} bytes to device memory does not fit into the store buffer", size);
+            return {};
+        }
+
+        const bool extendStore = m_nextStoreAddr && (*m_nextStoreAddr == addr);
+        const std::size_t requiredSize = payloadSize + (extendStore ? 0 : sizeof(Command));
+        if ((m_storeSize + requiredSize) > storeBufferSize)
+        {
+            flushWritesToDeviceMemory();
+            return requestWriteToDeviceMemory(addr, size);
+        }
+
+        blockUntilBufferIsFree(getStoreBufferIndex());
+
+        if (extendStore)
+        {
+            m_lastStoreSize += payloadSize;
+        }
+        else
+        {
+            m_lastStoreOffset = m_storeSize;
+            m_lastStoreAddr = addr + RenderConfig::GRAM_MEMORY_LOC;
+            m_lastStoreSize = payloadSize;
+            m_storeSize += sizeof(Command);
+        }
+        addDseCommand(getStoreBufferIndex(), m_lastStoreOffset, OP_STORE, m_lastStoreSize, m_lastStoreAddr);
+
+        tcb::span<uint8_t> buffer = m_busConnector.requestBuffer(getStoreBufferIndex()).subspan(m_storeSize, size);
+        m_storeSize += payloadSize;
+        // Only writes without padding can be extended
+        m_nextStoreAddr = (payloadSize == size) ? std::make_optional(addr + size) : std::nullopt;
+        return buffer;
+    }
+
+    void flushWritesToDeviceMemory() override
+    {
+        if (m_storeSize == 0)
+        {
+            return;
+        }
+        startTransfer(getStoreBufferIndex(), m_storeSize);
+        m_storeSize = 0;
+        m_nextStoreAddr = std::nullopt;
+    }
+
+    bool readFromDeviceMemory(tcb::span<uint8_t> data, const uint32_t addr) override
+    {
+        // The DSE can only load the memory into the TMU stream. Therefore the memory is read by the bus connector,
+        // after the DSE has executed all stores.
+        flushWritesToDeviceMemory();
+        blockUntilDeviceIsIdle();
+        return m_busConnector.readData(addr + RenderConfig::GRAM_MEMORY_LOC, data);
+    }
+
+    bool canReadFromDeviceMemory() const override
+    {
+        return m_busConnector.canReadData();
     }
 
     void blockUntilDeviceIsIdle() override
     {
         m_busConnector.blockUntilWriteComplete();
+        m_buffersInFlight.reset();
+    }
+
+    uint32_t insertFence() override
+    {
+        return m_streamedDisplayLists;
+    }
+
+    bool isFenceSignaled(const uint32_t fence) override
+    {
+        // Every display list buffer which is in flight holds a display list. The fence is signaled,
+        // when all display lists in front of it are streamed and their buffers are transferred.
+        if (!isFenceReached(m_streamedDisplayLists, fence))
+        {
+            return false;
+        }
+        for (uint8_t i = 0; i < getDisplayListBufferCount(); i++)
+        {
+            if (isInFrontOfFence(i, fence) && !isBufferFree(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void blockUntilFenceIsSignaled(const uint32_t fence) override
+    {
+        for (uint8_t i = 0; i < getDisplayListBufferCount(); i++)
+        {
+            if (isInFrontOfFence(i, fence))
+            {
+                blockUntilBufferIsFree(i);
+            }
+        }
+    }
+
+    void blockUntilDisplayListBufferIsFree(const uint8_t index) override
+    {
+        blockUntilBufferIsFree(index);
     }
 
     tcb::span<uint8_t> requestDisplayListBuffer(const uint8_t index) override
@@ -74,31 +196,55 @@ private:
         return m_busConnector.getBufferCount() - 1;
     }
 
-    uint32_t addDseStreamCommand(const uint8_t index, const uint32_t size)
+    void startTransfer(const uint8_t index, const uint32_t size)
+    {
+        m_busConnector.writeData(index, size);
+        if (!m_busConnector.canQueueTransfers())
+        {
+            // writeData() returns when the previous transfer is finished
+            m_buffersInFlight.reset();
+        }
+        m_buffersInFlight.set(index);
+    }
+
+    bool isBufferFree(const uint8_t index)
+    {
+        if (m_buffersInFlight.test(index) && !m_busConnector.isBufferFree(index))
+        {
+            return false;
+        }
+        m_buffersInFlight.reset(index);
+        return true;
+    }
+
+    void blockUntilBufferIsFree(const uint8_t index)
     {
-        return addDseCommand(index, OP_STREAM, size, 0);
+        if (m_buffersInFlight.test(index))
+        {
+            m_busConnector.blockUntilBufferIsFree(index);
+            m_buffersInFlight.reset(index);
+        }
     }
 
-    uint32_t addDseStoreCommand(const uint32_t size, const uint32_t addr)
+    bool isInFrontOfFence(const uint8_t index, const uint32_t fence) const
     {
-        return addDseCommand(getStoreBufferIndex(), OP_STORE, size, addr);
+        return m_buffersInFlight.test(index) && isFenceReached(fence, m_displayListOfBuffer[index]);
     }
 
-    uint32_t addDseStorePayload(const std::size_t offset, const tcb::span<const uint8_t> payload)
+    uint32_t addDseStreamCommand(const uint8_t index, const uint32_t size)
     {
-        tcb::span<uint8_t> s = m_busConnector.requestBuffer(getStoreBufferIndex());
-        std::copy(payload.begin(), payload.end(), s.last(s.size() - offset).begin());
-        return (std::max)(static_cast<uint32_t>(payload.size()), DEVICE_MIN_TRANSFER_SIZE);
+        return addDseCommand(index, 0, OP_STREAM, size, 0);
     }
 
     uint32_t addDseCommand(
         const uint8_t index,
+        const std::size_t offset,
         const uint32_t op,
         const uint32_t size,
         const uint32_t addr)
     {
         tcb::span<uint8_t> s = m_busConnector.requestBuffer(index);
-        Command* c = reinterpret_cast<Command*>(s.first<sizeof(Command)>().data());
+        Command* c = reinterpret_cast<Command*>(s.subspan(offset, sizeof(Command)).data());
         c->op = op | (IMM_MASK & size);
         c->addr = addr;
         return sizeof(Command);
@@ -115,6 +261,18 @@ private:
     }
 
     IBusConnector& m_busConnector;
+    uint32_t m_streamedDisplayLists { 0 };
+
+    // Buffers which might still be transferred by the bus connector
+    std::bitset<256> m_buffersInFlight {};
+    std::array<uint32_t, 256> m_displayListOfBuffer {}; ///< Number of the display list which was streamed from a buffer
+
+    // Collected writes to the device memory
+    std::size_t m_storeSize { 0 }; ///< Used bytes of the store buffer
+    std::size_t m_lastStoreOffset { 0 }; ///< Position of the last store command in the store buffer
+    uint32_t m_lastStoreAddr { 0 };
+    uint32_t m_lastStoreSize { 0 };
+    std::optional<uint32_t> m_nextStoreAddr {}; ///< Address which can extend the last store command
 };
 
 } // namespace rr::DSEC
@@ -34,6 +34,11 @@ public:
     static_assert(static_cast<uint32_t>(PixelFormat::RGBA4444) == 0);
     static_assert(static_cast<uint32_t>(PixelFormat::RGBA5551) == 1);
     static_assert(static_cast<uint32_t>(PixelFormat::RGB565) == 2);
+    static_assert(static_cast<uint32_t>(PixelFormat::RGB_DXT1) == 3);
+    static_assert(static_cast<uint32_t>(PixelFormat::RGBA_DXT1) == 4);
+    static_assert(static_cast<uint32_t>(PixelFormat::INDEX8_RGBA4444) == 5);
+    static_assert(static_cast<uint32_t>(PixelFormat::INDEX8_RGBA5551) == 6);
+    static_assert(static_cast<uint32_t>(PixelFormat::INDEX8_RGB565) == 7);
 
     TmuTextureReg() = default;
     void setTextureWidth(const uint16_t val) { m_regVal.fields.texWidth = static_cast<uint32_t>(log2f(static_cast<float>(val))); }
@@ -43,6 +48,8 @@ public:
     void setEnableMagFilter(const bool val) { m_regVal.fields.enableMagFilter = val; }
     void setEnableMinFilter(const bool val) { m_regVal.fields.enableMinFilter = val; }
     void setPixelFormat(const PixelFormat val) { m_regVal.fields.pixelFormat = static_cast<uint32_t>(val); }
+    void setMinLod(const uint8_t val) { m_regVal.fields.minLod = val; }
+    void setMaxLod(const uint8_t val) { m_regVal.fields.maxLod = val; }
 
     uint16_t getTextureWidth() const { return powf(2.0f, m_regVal.fields.texWidth); }
     uint16_t getTextureHeight() const { return powf(2.0f, m_regVal.fields.texHeight); }
@@ -51,6 +58,8 @@ public:
     bool getEnableMagFilter() const { return m_regVal.fields.enableMagFilter; }
     bool getEnableMinFilter() const { return m_regVal.fields.enableMinFilter; }
     PixelFormat getPixelFormat() const { return static_cast<PixelFormat>(m_regVal.fields.pixelFormat); }
+    uint8_t getMinLod() const { return m_regVal.fields.minLod; }
+    uint8_t getMaxLod() const { return m_regVal.fields.maxLod; }
 
     void setTmu(const std::size_t tmu) { m_offset = tmu * TMU_OFFSET; }
     uint32_t serialize() const { return m_regVal.data; }
@@ -58,6 +67,7 @@ public:
 
 private:
     static constexpr std::size_t TMU_OFFSET { 3 };
+    static constexpr uint32_t MAX_LOD { 15 };
     union RegVal
     {
 #pragma pack(push, 1)
@@ -71,6 +81,8 @@ private:
                 , enableMagFilter { false }
                 , enableMinFilter { true }
                 , pixelFormat { static_cast<uint32_t>(PixelFormat::RGBA4444) }
+                , minLod { 0 }
+                , maxLod { MAX_LOD }
             {
             }
 
@@ -81,6 +93,8 @@ private:
             uint32_t enableMagFilter : 1;
             uint32_t enableMinFilter : 1;
             uint32_t pixelFormat : 4;
+            uint32_t minLod : 4;
+            uint32_t maxLod : 4;
         } fields {};
         uint32_t data;
 #pragma pack(pop)
@@ -0,0 +1,83 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef _SPSC_RING_BUFFER_HPP_
+#define _SPSC_RING_BUFFER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace rr
+{
+
+// Bounded lock-free ring buffer for exactly one producer thread and one consumer thread.
+// push() must only be called from the producer, pop() only from the consumer.
+template <typename T, std::size_t CAPACITY>
+class SpscRingBuffer
+{
+public:
+    /// @brief Adds an element to the ring buffer
+    /// @param value The element to add
+    /// @return false if the ring buffer is full
+    bool push(const T& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if ((tail - m_head.load(std::memory_order_acquire)) >= CAPACITY)
+        {
+            return false;
+        }
+        m_buffer[tail % CAPACITY] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Removes the oldest element from the ring buffer
+    /// @param value Receives the removed element
+    /// @return false if the ring buffer is empty
+    bool pop(T& value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value = m_buffer[head % CAPACITY];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Returns the number of elements in the ring buffer. The value is only a snapshot
+    ///     when the other side works concurrently on the ring buffer.
+    std::size_t size() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr std::size_t capacity() { return CAPACITY; }
+
+private:
+    std::array<T, CAPACITY> m_buffer {};
+    std::atomic<std::size_t> m_head { 0 };
+    std::atomic<std::size_t> m_tail { 0 };
+};
+
+} // namespace rr
+
+#endif // _SPSC_RING_BUFFER_HPP_
@@ -18,13 +18,22 @@
 #ifndef _THREADED_RASTERIZER_HPP_
 #define _THREADED_RASTERIZER_HPP_
 
+#include "IThreadRunner.hpp"
+#include "renderer/CoarseDepthBuffer.hpp"
 #include "renderer/IDevice.hpp"
 #include "renderer/displaylist/DisplayList.hpp"
 #include "renderer/displaylist/DisplayListAssembler.hpp"
 #include "renderer/displaylist/DisplayListDoubleBuffer.hpp"
 #include "renderer/displaylist/RIXDisplayListAssembler.hpp"
+#include "renderer/threadedRasterizer/SpscRingBuffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <optional>
 #include <tcb/span.hpp>
+#include <thread>
+#include <vector>
 
 #include "renderer/commands/FogLutStreamCmd.hpp"
 #include "renderer/commands/FramebufferCmd.hpp"
@@ -39,63 +48,184 @@
 #include "renderer/Rasterizer.hpp"
 #include "renderer/registers/BaseColorReg.hpp"
 
+#include "renderer/registers/ColorBufferAddrReg.hpp"
 #include "renderer/registers/FeatureEnableReg.hpp"
+#include "renderer/registers/RenderResolutionReg.hpp"
 #include "renderer/registers/ScissorEndReg.hpp"
 #include "renderer/registers/ScissorStartReg.hpp"
+#include "renderer/registers/StencilReg.hpp"
+#include "renderer/registers/YOffsetReg.hpp"
 
 #include <spdlog/spdlog.h>
 
 namespace rr
 {
 
-template <std::size_t BUFFER_COUNT, std::size_t BUFFER_SIZE>
+// The display lists are handed over to the worker in chunks via a bounded single producer single consumer ring.
+// The worker starts decoding the first chunks while the application is still writing the rest of the display list.
+// CHUNK_SIZE is the minimum number of bytes a partial display list must grow before a new chunk is published.
+// QUEUE_DEPTH is the number of chunks which can be in flight.
+template <std::size_t BUFFER_COUNT, std::size_t BUFFER_SIZE, std::size_t CHUNK_SIZE, std::size_t QUEUE_DEPTH>
 class ThreadedRasterizer : public IDevice
 {
 public:
-    ThreadedRasterizer(IDevice& device, IThreadRunner& uploadThread, IThreadRunner& workerThread)
+    struct Statistics
+    {
+        std::size_t chunks { 0 }; ///< Number of chunks pushed into the queue
+        std::size_t maxQueueDepth { 0 }; ///< Maximum number of chunks which were waiting in the queue
+        std::chrono::microseconds stallTime { 0 }; ///< Time the application waited for the worker
+    };
+
+    /// @brief Creates the threaded rasterizer
+    /// @param device The device which receives the rasterized display lists
+    /// @param uploadThread Runner which streams the display lists to the device
+    /// @param workerThread Runner which decodes the display lists and rasterizes the triangles
+    /// @param vertexThreads Additional runners to transform, clip and set up independent draws in
+    ///     parallel. If empty, all vertices are processed by the workerThread.
+    ThreadedRasterizer(IDevice& device, IThreadRunner& uploadThread, IThreadRunner& workerThread, const std::vector<IThreadRunner*>& vertexThreads = {})
         : m_device { device }
         , m_uploadThread { uploadThread }
         , m_workerThread { workerThread }
+        , m_vertexThreads { vertexThreads }
     {
         initDisplayLists();
         SPDLOG_INFO("Treaded rasterization enabled");
+        if (!m_vertexThreads.empty())
+        {
+            SPDLOG_INFO("Parallel vertex processing with {} additional threads enabled", m_vertexThreads.size());
+        }
     }
 
     void deinit()
     {
         m_workerThread.wait();
+        for (IThreadRunner* vertexThread : m_vertexThreads)
+        {
+            vertexThread->wait();
+        }
         m_uploadThread.wait();
         m_device.blockUntilDeviceIsIdle();
     }
 
     void streamDisplayList(const uint8_t index, const uint32_t size) override
     {
-        const std::function<void()> compute = [this, index, size]()
-        {
-            displaylist::DisplayList srcList {};
-            srcList.setBuffer(requestDisplayListBuffer(index));
-            srcList.resetGet();
-            srcList.setCurrentSize(size);
+        pushChunk({ index, size, true });
+        m_publishedSize = 0;
+        m_submittedDisplayLists++;
 
-            while (!srcList.atEnd())
+        // The application writes the next display list into the other buffer. Wait till the worker has released it.
+        if (m_completedDisplayLists.load(std::memory_order_acquire) + 1 < m_submittedDisplayLists)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            while (m_completedDisplayLists.load(std::memory_order_acquire) + 1 < m_submittedDisplayLists)
             {
-                if (!decodeAndCopyCommand(srcList))
-                {
-                    SPDLOG_CRITICAL("Decoding of displaylist failed.");
-                }
+                std::this_thread::yield();
             }
-            swapAndUploadDisplayLists();
-        };
-        m_workerThread.wait();
-        m_workerThread.run(compute);
+            m_statistics.stallTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        }
+
+        SPDLOG_DEBUG("Display list {} submitted in {} chunks, max queue depth {}, stall time {} us",
+            m_submittedDisplayLists,
+            m_statistics.chunks,
+            m_statistics.maxQueueDepth,
+            m_statistics.stallTime.count());
+        m_lastStatistics = m_statistics;
+        m_statistics = {};
+    }
+
+    void streamPartialDisplayList(const uint8_t index, const uint32_t size, const bool force) override
+    {
+        if ((size > m_publishedSize) && (force || ((size - m_publishedSize) >= CHUNK_SIZE)))
+        {
+            pushChunk({ index, size, false });
+            m_publishedSize = size;
+        }
     }
 
     void writeToDeviceMemory(tcb::span<const uint8_t> data, const uint32_t addr) override
     {
+        tcb::span<uint8_t> buffer = requestWriteToDeviceMemory(addr, data.size());
+        if (buffer.empty())
+        {
+            return;
+        }
+        std::copy(data.begin(), data.end(), buffer.begin());
+        flushWritesToDeviceMemory();
+    }
+
+    /// @brief Returns a buffer in the staging buffer of the threaded rasterizer, not in the transfer buffer of
+    ///     the device. The device, and with it its transfer buffers, is only accessed from the upload thread,
+    ///     which still streams the previous display lists. Handing out the transfer buffer would require to
+    ///     wait until they are streamed. Therefore the writes are collected in the staging buffer and are
+    ///     queued like a display list chunk. The upload thread copies them in order with the display lists
+    ///     into the transfer buffer of the device (see uploadDeviceMemoryWrites()). This is the only copy of
+    ///     the data, the caller writes the pages directly into the staging buffer.
+    tcb::span<uint8_t> requestWriteToDeviceMemory(const uint32_t addr, const uint32_t size) override
+    {
+        const std::size_t payloadSize = (size + sizeof(DeviceMemoryWrite) - 1) & ~(sizeof(DeviceMemoryWrite) - 1);
+        if ((sizeof(DeviceMemoryWrite) + payloadSize) > m_deviceMemoryWriteBuffer.size())
+        {
+            SPDLOG_ERROR("Write of {} bytes to device memory does not fit into the staging buffer", size);
+            return {};
+        }
+
+        const bool extendWrite = m_nextDeviceMemoryWriteAddr && (*m_nextDeviceMemoryWriteAddr == addr);
+        const std::size_t requiredSize = payloadSize + (extendWrite ? 0 : sizeof(DeviceMemoryWrite));
+        if ((m_deviceMemoryWriteSize + requiredSize) > m_deviceMemoryWriteBuffer.size())
+        {
+            flushWritesToDeviceMemory();
+            return requestWriteToDeviceMemory(addr, size);
+        }
+
+        if (m_deviceMemoryWriteSize == 0)
+        {
+            // The staging buffer is reused when the worker has handed over the previous writes
+            while (m_uploadedDeviceMemoryWrites.load(std::memory_order_acquire) != m_submittedDeviceMemoryWrites)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        if (!extendWrite)
+        {
+            m_lastDeviceMemoryWrite = reinterpret_cast<DeviceMemoryWrite*>(m_deviceMemoryWriteBuffer.data() + m_deviceMemoryWriteSize);
+            *m_lastDeviceMemoryWrite = { addr, 0 };
+            m_deviceMemoryWriteSize += sizeof(DeviceMemoryWrite);
+        }
+        m_lastDeviceMemoryWrite->size += payloadSize;
+
+        tcb::span<uint8_t> buffer { m_deviceMemoryWriteBuffer.data() + m_deviceMemoryWriteSize, size };
+        m_deviceMemoryWriteSize += payloadSize;
+        // Only writes without padding can be extended
+        m_nextDeviceMemoryWriteAddr = (payloadSize == size) ? std::make_optional(addr + size) : std::nullopt;
+        return buffer;
+    }
+
+    void flushWritesToDeviceMemory() override
+    {
+        if (m_deviceMemoryWriteSize == 0)
+        {
+            return;
+        }
+        m_submittedDeviceMemoryWrites++;
+        pushChunk({ 0, m_deviceMemoryWriteSize, false, true });
+        m_deviceMemoryWriteSize = 0;
+        m_nextDeviceMemoryWriteAddr = std::nullopt;
+    }
+
+    bool readFromDeviceMemory(tcb::span<uint8_t> data, const uint32_t addr) override
+    {
+        // The queued writes and display lists are handed to the device first. Afterwards the worker and the
+        // upload thread are stopped, so that the device can be accessed from this thread.
+        flushWritesToDeviceMemory();
         m_workerThread.wait();
         m_uploadThread.wait();
-        m_device.blockUntilDeviceIsIdle();
-        m_device.writeToDeviceMemory(data, addr);
+        return m_device.readFromDeviceMemory(data, addr);
+    }
+
+    bool canReadFromDeviceMemory() const override
+    {
+        return m_device.canReadFromDeviceMemory();
     }
 
     void blockUntilDeviceIsIdle() override
@@ -103,6 +233,32 @@ public:
         m_workerThread.wait();
     }
 
+    uint32_t insertFence() override
+    {
+        return m_submittedDisplayLists;
+    }
+
+    bool isFenceSignaled(const uint32_t fence) override
+    {
+        return isFenceReached(m_uploadedDisplayLists.load(std::memory_order_acquire), fence);
+    }
+
+    void blockUntilFenceIsSignaled(const uint32_t fence) override
+    {
+        if (!isFenceSignaled(fence))
+        {
+            // All display lists in front of the fence are already in the queue. The worker returns when it has
+            // drained the queue and has started the upload of the last display list.
+            m_workerThread.wait();
+            m_uploadThread.wait();
+        }
+    }
+
+    void blockUntilDisplayListBufferIsFree(const uint8_t) override
+    {
+        // streamDisplayList() returns when the worker has released the other buffer
+    }
+
     tcb::span<uint8_t> requestDisplayListBuffer(const uint8_t index) override
     {
         return { m_buffer[index] };
@@ -113,7 +269,128 @@ public:
         return m_buffer.size();
     }
 
+    /// @brief Returns the statistics of the chunk queue of the last submitted display list
+    const Statistics& getStatistics() const { return m_lastStatistics; }
+
 private:
+    struct DisplayListChunk
+    {
+        uint8_t index { 0 };
+        uint32_t size { 0 }; ///< Size of the display list, including the previous chunks
+        bool last { false }; ///< Marks the end of the display list
+        bool deviceMemoryWrite { false }; ///< The chunk contains the writes of the staging buffer instead of a display list
+    };
+
+    struct DeviceMemoryWrite
+    {
+        uint32_t addr;
+        uint32_t size; ///< Size of the payload which directly follows this header
+    };
+
+    void pushChunk(const DisplayListChunk& chunk)
+    {
+        m_statistics.chunks++;
+        m_statistics.maxQueueDepth = (std::max)(m_statistics.maxQueueDepth, m_chunkQueue.size() + 1);
+        if (!m_chunkQueue.push(chunk))
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            while (!m_chunkQueue.push(chunk))
+            {
+                std::this_thread::yield();
+            }
+            m_statistics.stallTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        }
+        startWorker();
+    }
+
+    void startWorker()
+    {
+        // m_workerActive is only false, when the worker has drained the queue and is about to return.
+        if (!m_workerActive.exchange(true))
+        {
+            m_workerThread.wait();
+            m_workerThread.run(m_chunkWorker);
+        }
+    }
+
+    void processChunks()
+    {
+        while (true)
+        {
+            DisplayListChunk chunk {};
+            while (m_chunkQueue.pop(chunk))
+            {
+                processChunk(chunk);
+            }
+            m_workerActive.store(false);
+            // A chunk might be pushed after the queue was drained but before m_workerActive was reset.
+            // Continue if this chunk was not already seen by the producer, otherwise the producer starts a new run.
+            if (m_chunkQueue.empty() || m_workerActive.exchange(true))
+            {
+                return;
+            }
+        }
+    }
+
+    void processChunk(const DisplayListChunk& chunk)
+    {
+        if (chunk.deviceMemoryWrite)
+        {
+            uploadDeviceMemoryWrites(chunk.size);
+            return;
+        }
+
+        if (m_startOfSrcList)
+        {
+            m_srcList.setBuffer(requestDisplayListBuffer(chunk.index));
+            m_srcList.resetGet();
+            m_startOfSrcList = false;
+        }
+        m_srcList.setCurrentSize(chunk.size);
+        m_srcListComplete = chunk.last;
+
+        while (!m_srcList.atEnd())
+        {
+            if (m_vertexThreads.empty())
+            {
+                decodeAndCopyCommandChecked(m_srcList);
+            }
+            else
+            {
+                decodeAndCopyCommandsParallel(m_srcList);
+            }
+        }
+
+        if (chunk.last)
+        {
+            flushTriangleBatch();
+            if constexpr (RenderConfig::COARSE_OCCLUSION_CULLING)
+            {
+                m_coarseDepthBuffer.logStatistics();
+            }
+            swapAndUploadDisplayLists(true);
+            m_startOfSrcList = true;
+            m_completedDisplayLists.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // Number of draws which are collected before they are distributed to the vertex threads
+    static constexpr std::size_t VERTEX_SEGMENTS_PER_BATCH { 64 };
+
+    // A draw (SetVertexCtxCmd followed by PushVertexCmds) with an own rasterizer state, which is
+    // transformed on a vertex thread. The results are merged in submission order.
+    struct VertexSegment
+    {
+        displaylist::DisplayList list {};
+        std::size_t vertexCount { 0 };
+        std::optional<Rasterizer> rasterizer {};
+        std::vector<TriangleStreamCmd> triangles {};
+        // The stencil config is applied before the triangle with the given index
+        std::vector<std::pair<std::size_t, StencilReg>> stencilConfigs {};
+        TriangleStreamBatch triangleBatch {};
+        bool success { true };
+    };
+
     using DisplayListAssemblerType = displaylist::DisplayListAssembler<RenderConfig::TMU_COUNT, displaylist::DisplayList>;
     using DisplayListAssemblerArrayType = std::array<DisplayListAssemblerType, RenderConfig::getDisplayLines()>;
     using DisplayListDispatcherType = displaylist::DisplayListDispatcher<RenderConfig, DisplayListAssemblerArrayType>;
@@ -132,9 +409,9 @@ private:
         m_displayListBuffer.getBack().clearDisplayListAssembler();
     }
 
-    void uploadDisplayList()
+    void uploadDisplayList(const bool lastOfDisplayList)
     {
-        const std::function<void()> uploader = [this]()
+        const std::function<void()> uploader = [this, lastOfDisplayList]()
         {
             m_displayListBuffer.getFront().displayListLooper(
                 [this](
@@ -153,7 +430,33 @@ private:
                     return true;
                 });
             m_device.blockUntilDeviceIsIdle();
+            if (lastOfDisplayList)
+            {
+                m_uploadedDisplayLists.fetch_add(1, std::memory_order_release);
+            }
+        };
+        m_uploadThread.run(uploader);
+    }
+
+    void uploadDeviceMemoryWrites(const uint32_t size)
+    {
+        // The writes are executed on the upload thread, to keep them in order with the display lists.
+        // The staging buffer is copied into the transfer buffer of the device, which is not accessible
+        // from the application thread (see requestWriteToDeviceMemory()).
+        const std::function<void()> uploader = [this, size]()
+        {
+            for (std::size_t offset = 0; offset < size;)
+            {
+                const DeviceMemoryWrite* write = reinterpret_cast<const DeviceMemoryWrite*>(m_deviceMemoryWriteBuffer.data() + offset);
+                offset += sizeof(DeviceMemoryWrite);
+                tcb::span<uint8_t> buffer = m_device.requestWriteToDeviceMemory(write->addr, write->size);
+                std::copy_n(m_deviceMemoryWriteBuffer.data() + offset, buffer.size(), buffer.begin());
+                offset += write->size;
+            }
+            m_device.flushWritesToDeviceMemory();
+            m_uploadedDeviceMemoryWrites.fetch_add(1, std::memory_order_release);
         };
+        m_uploadThread.wait();
         m_uploadThread.run(uploader);
     }
 
@@ -163,8 +466,11 @@ private:
         src.getNext<typename SetVertexCtxCmd::CommandType>();
         const PayloadType* t = src.getNext<PayloadType>();
 
+        // m_vertexTransform only references the context. A draw can be continued in the next display list,
+        // while the application already writes into the buffer of this one. Therefore it uses a copy.
+        m_vertexCtx = t->ctx;
         new (&m_vertexTransform) vertextransforming::VertexTransformingCalc<decltype(drawTriangleLambda), decltype(setStencilBufferConfigLambda)> {
-            t->ctx,
+            m_vertexCtx,
             drawTriangleLambda,
             setStencilBufferConfigLambda,
         };
@@ -179,6 +485,231 @@ private:
         return m_vertexTransform.pushVertex(src.getNext<PayloadType>()->vertex);
     }
 
+    template <typename TCmd>
+    static void skipCmd(displaylist::DisplayList& src)
+    {
+        using PayloadType = typename std::remove_const<typename std::remove_reference<decltype(TCmd {}.payload()[0])>::type>::type;
+        const typename TCmd::CommandType* op = src.getNext<typename TCmd::CommandType>();
+        const std::size_t numberOfElements = TCmd::getNumberOfElementsInPayloadByCommand(*op);
+        for (std::size_t i = 0; i < numberOfElements; i++)
+        {
+            src.getNext<PayloadType>();
+        }
+    }
+
+    void decodeAndCopyCommandChecked(displaylist::DisplayList& srcList)
+    {
+        if (!decodeAndCopyCommand(srcList))
+        {
+            SPDLOG_CRITICAL("Decoding of displaylist failed.");
+        }
+    }
+
+    void decodeAndCopyCommandsParallel(displaylist::DisplayList& srcList)
+    {
+        displaylist::DisplayList batchEnd { srcList };
+        collectVertexSegments(batchEnd);
+        if (batchEnd.getCurrentReadPos() == srcList.getCurrentReadPos())
+        {
+            // The next command can't be part of a batch, for instance a PushVertexCmd which continues
+            // a draw from the previous display list.
+            decodeAndCopyCommandChecked(srcList);
+            return;
+        }
+        transformVertexSegments();
+        mergeVertexSegments(srcList, batchEnd.getCurrentReadPos());
+        // The draws of the batch are not pushed through m_vertexTransform. It still contains the context and
+        // the primitive assembler of the last sequentially decoded draw and is stale now. A PushVertexCmd
+        // without a SetVertexCtxCmd in front can't follow, because a batch contains all PushVertexCmds of its
+        // draws, and the draw at the end of a complete display list, which might be continued in the next
+        // one, is never part of a batch (see collectVertexSegments()).
+    }
+
+    void collectVertexSegments(displaylist::DisplayList& scanList)
+    {
+        // The rasterizer state is tracked here to give every draw the state it would have, when
+        // the display list would be decoded sequentially.
+        Rasterizer rasterizer { m_rasterizer };
+        m_vertexSegmentCount = 0;
+        while (!scanList.atEnd() && (m_vertexSegmentCount < m_vertexSegments.size()))
+        {
+            const uint32_t op = *(scanList.lookAhead<uint32_t>());
+            if (SetVertexCtxCmd::isThis(op))
+            {
+                const displaylist::DisplayList segmentStart { scanList };
+                skipCmd<SetVertexCtxCmd>(scanList);
+                std::size_t vertexCount = 0;
+                while (!scanList.atEnd() && PushVertexCmd::isThis(*(scanList.lookAhead<uint32_t>())))
+                {
+                    skipCmd<PushVertexCmd>(scanList);
+                    vertexCount++;
+                }
+                if (scanList.atEnd() && m_srcListComplete)
+                {
+                    // The draw might be continued in the next display list. Decode it sequentially
+                    // to keep the state of the primitive assembler in m_vertexTransform.
+                    // Partial display lists always end in front of a SetVertexCtxCmd, so the draw is complete there.
+                    scanList = segmentStart;
+                    return;
+                }
+                VertexSegment& segment = m_vertexSegments[m_vertexSegmentCount];
+                segment.list = segmentStart;
+                segment.vertexCount = vertexCount;
+                segment.rasterizer.emplace(rasterizer);
+                m_vertexSegmentCount++;
+            }
+            else if (WriteRegisterCmd<BaseColorReg>::isThis(op))
+            {
+                updateRasterizer(rasterizer, WriteRegisterCmd<BaseColorReg>::getRegAddr(op), *(scanList.lookAhead<uint32_t>(2)));
+                skipCmd<WriteRegisterCmd<BaseColorReg>>(scanList);
+            }
+            else if (NopCmd::isThis(op))
+            {
+                skipCmd<NopCmd>(scanList);
+            }
+            else if (TextureStreamCmd::isThis(op))
+            {
+                skipCmd<TextureStreamCmd>(scanList);
+            }
+            else if (FramebufferCmd::isThis(op))
+            {
+                skipCmd<FramebufferCmd>(scanList);
+            }
+            else if (FogLutStreamCmd::isThis(op))
+            {
+                skipCmd<FogLutStreamCmd>(scanList);
+            }
+            else
+            {
+                // PushVertexCmds without a context and invalid commands are decoded sequentially
+                return;
+            }
+        }
+    }
+
+    void transformVertexSegments()
+    {
+        if (m_vertexSegmentCount == 0)
+        {
+            return;
+        }
+        m_nextVertexSegment = 0;
+        const std::function<void()> worker = [this]()
+        { transformVertexSegmentsWorker(); };
+        for (IThreadRunner* vertexThread : m_vertexThreads)
+        {
+            vertexThread->wait();
+            vertexThread->run(worker);
+        }
+        transformVertexSegmentsWorker();
+        for (IThreadRunner* vertexThread : m_vertexThreads)
+        {
+            vertexThread->wait();
+        }
+    }
+
+    void transformVertexSegmentsWorker()
+    {
+        for (std::size_t i = m_nextVertexSegment.fetch_add(1); i < m_vertexSegmentCount; i = m_nextVertexSegment.fetch_add(1))
+        {
+            transformVertexSegment(m_vertexSegments[i]);
+        }
+    }
+
+    static void transformVertexSegment(VertexSegment& segment)
+    {
+        using CtxPayloadType = typename std::remove_const<typename std::remove_reference<decltype(SetVertexCtxCmd {}.payload()[0])>::type>::type;
+        using VertexPayloadType = typename std::remove_const<typename std::remove_reference<decltype(PushVertexCmd {}.payload()[0])>::type>::type;
+
+        segment.triangles.clear();
+        segment.stencilConfigs.clear();
+        segment.success = true;
+
+        const std::function<bool(const TransformedTriangle&)> drawTriangle = [&segment](const TransformedTriangle& triangle)
+        {
+            if (segment.triangleBatch.add(triangle))
+            {
+                flushTriangleBatch(segment);
+            }
+            return true;
+        };
+        const std::function<bool(const StencilReg&)> setStencilBufferConfig = [&segment](const StencilReg& stencilConf)
+        {
+            flushTriangleBatch(segment);
+            segment.stencilConfigs.push_back({ segment.triangles.size(), stencilConf });
+            return true;
+        };
+
+        displaylist::DisplayList& src = segment.list;
+        src.getNext<typename SetVertexCtxCmd::CommandType>();
+        const CtxPayloadType* t = src.getNext<CtxPayloadType>();
+        vertextransforming::VertexTransformingCalc<decltype(drawTriangle), decltype(setStencilBufferConfig)> vertexTransform {
+            t->ctx,
+            drawTriangle,
+            setStencilBufferConfig,
+        };
+        for (std::size_t i = 0; i < segment.vertexCount; i++)
+        {
+            src.getNext<typename PushVertexCmd::CommandType>();
+            segment.success = vertexTransform.pushVertex(src.getNext<VertexPayloadType>()->vertex) && segment.success;
+        }
+        flushTriangleBatch(segment);
+    }
+
+    static void flushTriangleBatch(VertexSegment& segment)
+    {
+        segment.triangleBatch.flush(*segment.rasterizer, [&segment](TriangleStreamCmd& triangleCmd)
+            {
+                segment.triangles.push_back(triangleCmd);
+                return true;
+            });
+    }
+
+    void mergeVertexSegments(displaylist::DisplayList& srcList, const std::size_t batchEnd)
+    {
+        std::size_t segmentIndex = 0;
+        while (srcList.getCurrentReadPos() < batchEnd)
+        {
+            if ((segmentIndex < m_vertexSegmentCount) && SetVertexCtxCmd::isThis(*(srcList.lookAhead<uint32_t>())))
+            {
+                if (!addVertexSegment(srcList, m_vertexSegments[segmentIndex]))
+                {
+                    SPDLOG_CRITICAL("Decoding of displaylist failed.");
+                }
+                segmentIndex++;
+            }
+            else
+            {
+                decodeAndCopyCommandChecked(srcList);
+            }
+        }
+    }
+
+    bool addVertexSegment(displaylist::DisplayList& src, VertexSegment& segment)
+    {
+        skipCmd<SetVertexCtxCmd>(src);
+        for (std::size_t i = 0; i < segment.vertexCount; i++)
+        {
+            skipCmd<PushVertexCmd>(src);
+        }
+
+        // Triangles of a previous draw, which was decoded sequentially, must be added first
+        bool ret = flushTriangleBatch() && segment.success;
+        std::size_t stencilIndex = 0;
+        for (std::size_t i = 0; i <= segment.triangles.size(); i++)
+        {
+            for (; (stencilIndex < segment.stencilConfigs.size()) && (segment.stencilConfigs[stencilIndex].first == i); stencilIndex++)
+            {
+                ret = setStencilBufferConfig(segment.stencilConfigs[stencilIndex].second) && ret;
+            }
+            if (i < segment.triangles.size())
+            {
+                ret = addTriangleCmd(segment.triangles[i]) && ret;
+            }
+        }
+        return ret;
+    }
+
     template <typename TArg>
     bool writeReg(const TArg& regVal)
     {
@@ -271,11 +802,13 @@ private:
                 // The floating point rasterizer can automatically increment all attributes
                 if constexpr (RenderConfig::USE_FLOAT_INTERPOLATION)
                 {
-                    return dispatcher.addCommand(i, triangleCmd);
+                    const TriangleCmd cmd = triangleCmd.getTightened(currentScreenPositionStart, currentScreenPositionEnd);
+                    return !cmd.isVisible() || dispatcher.addCommand(i, cmd);
                 }
                 else
                 {
-                    return dispatcher.addCommand(i, triangleCmd.getIncremented(currentScreenPositionStart, currentScreenPositionEnd));
+                    const TriangleCmd cmd = triangleCmd.getIncremented(currentScreenPositionStart, currentScreenPositionEnd);
+                    return !cmd.isVisible() || dispatcher.addCommand(i, cmd);
                 }
             }
             return true;
@@ -285,12 +818,28 @@ private:
 
     bool addTriangleCmd(const TransformedTriangle& triangle)
     {
-        TriangleStreamCmd triangleCmd { m_rasterizer, triangle };
-        if (!triangleCmd.isVisible())
+        if (m_triangleBatch.add(triangle))
         {
-            return true;
+            return flushTriangleBatch();
         }
+        return true;
+    }
 
+    bool flushTriangleBatch()
+    {
+        return m_triangleBatch.flush(m_rasterizer, [this](TriangleStreamCmd& triangleCmd)
+            { return addTriangleCmd(triangleCmd); });
+    }
+
+    bool addTriangleCmd(TriangleStreamCmd& triangleCmd)
+    {
+        if constexpr (RenderConfig::COARSE_OCCLUSION_CULLING)
+        {
+            if (!m_coarseDepthBuffer.drawTriangle(triangleCmd.payload()[0]))
+            {
+                return true;
+            }
+        }
         if constexpr (DisplayListDispatcherType::singleList())
         {
             return addCommand(triangleCmd);
@@ -322,6 +871,13 @@ private:
         // Clear
         if (cmd.getEnableMemset())
         {
+            if constexpr (RenderConfig::COARSE_OCCLUSION_CULLING)
+            {
+                if (cmd.setSelectDepthBuffer())
+                {
+                    m_coarseDepthBuffer.clear();
+                }
+            }
             return addCommandWithFactory_if(
                 [&cmd](const std::size_t, const std::size_t, const std::size_t resX, const std::size_t resY)
                 {
@@ -377,19 +933,53 @@ private:
             });
     }
 
+    static void updateRasterizer(Rasterizer& rasterizer, const uint32_t regAddr, const uint32_t regData)
+    {
+        switch (regAddr)
+        {
+        case FeatureEnableReg::getAddr():
+        {
+            FeatureEnableReg reg {};
+            reg.deserialize(regData);
+            rasterizer.enableScissor(reg.getEnableScissor());
+            rasterizer.enableTmu(0, reg.getEnableTmu(0));
+            rasterizer.enableTmu(1, reg.getEnableTmu(1));
+        }
+        break;
+        case ScissorStartReg::getAddr():
+        {
+            ScissorStartReg reg {};
+            reg.deserialize(regData);
+            rasterizer.setScissorStart(reg.getX(), reg.getY());
+        }
+        break;
+        case ScissorEndReg::getAddr():
+        {
+            ScissorEndReg reg {};
+            reg.deserialize(regData);
+            rasterizer.setScissorEnd(reg.getX(), reg.getY());
+        }
+        break;
+        default:
+            break;
+        }
+    }
+
     bool handleWriteRegisterCmd(displaylist::DisplayList& src)
     {
         const uint32_t op = *(src.lookAhead<uint32_t>(1));
         const uint32_t regData = *(src.lookAhead<uint32_t>(2));
+        updateRasterizer(m_rasterizer, WriteRegisterCmd<BaseColorReg>::getRegAddr(op), regData);
+        if constexpr (RenderConfig::COARSE_OCCLUSION_CULLING)
+        {
+            m_coarseDepthBuffer.setRegister(WriteRegisterCmd<BaseColorReg>::getRegAddr(op), regData);
+        }
         switch (WriteRegisterCmd<BaseColorReg>::getRegAddr(op))
         {
         case FeatureEnableReg::getAddr():
         {
             FeatureEnableReg reg {};
             reg.deserialize(regData);
-            m_rasterizer.enableScissor(reg.getEnableScissor());
-            m_rasterizer.enableTmu(0, reg.getEnableTmu(0));
-            m_rasterizer.enableTmu(1, reg.getEnableTmu(1));
             m_scissorEnabled = reg.getEnableScissor();
             return copyCmd<WriteRegisterCmd<FeatureEnableReg>>(src);
         }
@@ -398,7 +988,6 @@ private:
         {
             ScissorStartReg reg {};
             reg.deserialize(regData);
-            m_rasterizer.setScissorStart(reg.getX(), reg.getY());
             m_scissorYStart = reg.getY();
             return copyCmd<WriteRegisterCmd<ScissorStartReg>>(src);
         }
@@ -407,7 +996,6 @@ private:
         {
             ScissorEndReg reg {};
             reg.deserialize(regData);
-            m_rasterizer.setScissorEnd(reg.getX(), reg.getY());
             m_scissorYEnd = reg.getY();
             return copyCmd<WriteRegisterCmd<ScissorEndReg>>(src);
         }
@@ -458,6 +1046,10 @@ private:
         const uint32_t op = *(srcList.lookAhead<uint32_t>());
         bool ret = true;
 
+        // The triangles of the previous PushVertexCmds must be in the display list before the next
+        // command is added or the rasterizer changes
+        const bool flushed = PushVertexCmd::isThis(op) || flushTriangleBatch();
+
         if (PushVertexCmd::isThis(op))
         {
             ret = pushVertex(srcList);
@@ -501,26 +1093,35 @@ private:
             SPDLOG_CRITICAL("Unknown command (0x{:X})found. This might cause the renderer to crash ...", op);
             ret = false;
         }
-        return ret;
+        return ret && flushed;
     }
 
-    void swapAndUploadDisplayLists()
+    void swapAndUploadDisplayLists(const bool lastOfDisplayList)
     {
+        if constexpr (RenderConfig::COARSE_OCCLUSION_CULLING)
+        {
+            // Each band only keeps its part of the depth buffer while its display list is executed
+            if (!m_displayListBuffer.getBack().singleList())
+            {
+                m_coarseDepthBuffer.invalidate();
+            }
+        }
         switchDisplayLists();
-        uploadDisplayList();
+        uploadDisplayList(lastOfDisplayList);
     }
 
     void intermediateUpload()
     {
         if (m_displayListBuffer.getBack().singleList())
         {
-            swapAndUploadDisplayLists();
+            swapAndUploadDisplayLists(false);
         }
     }
 
     bool setStencilBufferConfig(const StencilReg& stencilConf)
     {
-        return m_displayListBuffer.getBack().addCommand(WriteRegisterCmd<StencilReg> { stencilConf });
+        const bool ret = flushTriangleBatch();
+        return m_displayListBuffer.getBack().addCommand(WriteRegisterCmd<StencilReg> { stencilConf }) && ret;
     }
 
     using ConcreteDisplayListAssembler = displaylist::DisplayListAssembler<RenderConfig::TMU_COUNT, displaylist::DisplayList, false>;
@@ -528,6 +1129,7 @@ private:
     IDevice& m_device;
     IThreadRunner& m_uploadThread;
     IThreadRunner& m_workerThread;
+    const std::vector<IThreadRunner*> m_vertexThreads;
     std::array<DisplayListAssemblerArrayType, 2> m_displayListAssembler {};
     std::array<DisplayListDispatcherType, 2> m_displayListDispatcher { m_displayListAssembler[0], m_displayListAssembler[1] };
     DisplayListDoubleBufferType m_displayListBuffer { m_displayListDispatcher[0], m_displayListDispatcher[1] };
@@ -535,18 +1137,51 @@ private:
     std::array<std::array<uint8_t, BUFFER_SIZE>, BUFFER_COUNT> m_buffer;
 
     Rasterizer m_rasterizer { !RenderConfig::USE_FLOAT_INTERPOLATION };
+    CoarseDepthBuffer m_coarseDepthBuffer {};
 
     const std::function<bool(const TransformedTriangle&)> drawTriangleLambda = [this](const TransformedTriangle& triangle)
     { return addTriangleCmd(triangle); };
     const std::function<bool(const StencilReg&)> setStencilBufferConfigLambda = [this](const StencilReg& stencilConf)
     { return setStencilBufferConfig(stencilConf); };
 
+    vertextransforming::VertexTransformingData m_vertexCtx {};
     vertextransforming::VertexTransformingCalc<decltype(drawTriangleLambda), decltype(setStencilBufferConfigLambda)> m_vertexTransform {
-        {},
+        m_vertexCtx,
         drawTriangleLambda,
         setStencilBufferConfigLambda,
     };
 
+    // Producer side of the chunk queue
+    uint32_t m_publishedSize { 0 };
+    uint32_t m_submittedDisplayLists { 0 };
+    Statistics m_statistics {};
+    Statistics m_lastStatistics {};
+
+    // Consumer side of the chunk queue
+    displaylist::DisplayList m_srcList {};
+    bool m_startOfSrcList { true };
+    bool m_srcListComplete { false };
+
+    SpscRingBuffer<DisplayListChunk, QUEUE_DEPTH> m_chunkQueue {};
+    std::atomic<bool> m_workerActive { false };
+    std::atomic<uint32_t> m_completedDisplayLists { 0 };
+    std::atomic<uint32_t> m_uploadedDisplayLists { 0 };
+
+    alignas(DeviceMemoryWrite) std::array<uint8_t, BUFFER_SIZE> m_deviceMemoryWriteBuffer;
+    uint32_t m_deviceMemoryWriteSize { 0 };
+    DeviceMemoryWrite* m_lastDeviceMemoryWrite { nullptr };
+    std::optional<uint32_t> m_nextDeviceMemoryWriteAddr {};
+    uint32_t m_submittedDeviceMemoryWrites { 0 };
+    std::atomic<uint32_t> m_uploadedDeviceMemoryWrites { 0 };
+    const std::function<void()> m_chunkWorker = [this]()
+    { processChunks(); };
+
+    TriangleStreamBatch m_triangleBatch {};
+
+    std::array<VertexSegment, VERTEX_SEGMENTS_PER_BATCH> m_vertexSegments {};
+    std::size_t m_vertexSegmentCount { 0 };
+    std::atomic<std::size_t> m_nextVertexSegment { 0 };
+
     uint32_t m_colorBufferAddr {};
     bool m_scissorEnabled { false };
     int32_t m_scissorYStart { 0 };
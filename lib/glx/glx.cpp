@@ -30,7 +30,7 @@ class GLInitGuard
 public:
     GLInitGuard()
     {
-        rr::RIXGL::createInstance(m_busConnector, m_workerThread, m_uploadThread);
+        rr::RIXGL::createInstance(m_busConnector, m_workerThread, m_uploadThread, { &m_vertexThreads[0], &m_vertexThreads[1] });
 #define ADDRESS_OF(X) reinterpret_cast<const void*>(&X)
         rr::RIXGL::getInstance().addLibProcedure("glXChooseVisual", ADDRESS_OF(glXChooseVisual));
         rr::RIXGL::getInstance().addLibProcedure("glXCreateContext", ADDRESS_OF(glXCreateContext));
@@ -66,6 +66,7 @@ private:
     rr::DMAProxyBusConnector m_busConnector {};
     rr::MultiThreadRunner m_workerThread {};
     rr::MultiThreadRunner m_uploadThread {};
+    std::array<rr::MultiThreadRunner, 2> m_vertexThreads {};
 } guard;
 
 GLAPI XVisualInfo* APIENTRY glXChooseVisual(Display* dpy, int screen,
@@ -0,0 +1,99 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CACHEDBUFFERBUSCONNECTOR_HPP
+#define CACHEDBUFFERBUSCONNECTOR_HPP
+
+#include "IBusConnector.hpp"
+#include <cstdint>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <tcb/span.hpp>
+#include <vector>
+
+namespace rr
+{
+
+// Wraps a bus connector whose buffers are DMA memory which is mapped uncached or write combined, like the
+// buffers of the DMAProxyBusConnector. The display lists are assembled with many small scattered writes,
+// which are slow on such memory. This connector hands out buffers in the cached host memory instead.
+// When a transfer is started, the used part of the buffer is copied with one large memcpy (which uses
+// wide NEON loads and stores on the Zynq) into the buffer of the wrapped connector.
+class CachedBufferBusConnector : public IBusConnector
+{
+public:
+    /// @brief Creates the connector
+    /// @param busConnector The connector which transfers the data
+    CachedBufferBusConnector(IBusConnector& busConnector)
+        : m_busConnector { busConnector }
+        , m_buffers(busConnector.getBufferCount())
+    {
+    }
+
+    virtual ~CachedBufferBusConnector() = default;
+
+    virtual void writeData(const uint8_t index, const uint32_t size) override
+    {
+        if (index >= m_buffers.size())
+        {
+            SPDLOG_ERROR("Index {} out of bounds.", index);
+            return;
+        }
+        tcb::span<uint8_t> buffer = m_busConnector.requestBuffer(index);
+        if ((size > m_buffers[index].size()) || (size > buffer.size()))
+        {
+            SPDLOG_ERROR("Size {} of index {} out of bounds.", size, index);
+            return;
+        }
+        // The buffer of the wrapped connector might still be transferred
+        m_busConnector.blockUntilBufferIsFree(index);
+        std::memcpy(buffer.data(), m_buffers[index].data(), size);
+        m_busConnector.writeData(index, size);
+    }
+
+    virtual void blockUntilWriteComplete() override { m_busConnector.blockUntilWriteComplete(); }
+    virtual bool isWriteComplete() override { return m_busConnector.isWriteComplete(); }
+    virtual bool canQueueTransfers() const override { return m_busConnector.canQueueTransfers(); }
+    virtual void blockUntilBufferIsFree(const uint8_t index) override { m_busConnector.blockUntilBufferIsFree(index); }
+    virtual bool isBufferFree(const uint8_t index) override { return m_busConnector.isBufferFree(index); }
+
+    virtual tcb::span<uint8_t> requestBuffer(const uint8_t index) override
+    {
+        if (index >= m_buffers.size())
+        {
+            SPDLOG_ERROR("Index {} out of bounds.", index);
+            return {};
+        }
+        if (m_buffers[index].empty())
+        {
+            m_buffers[index].resize(m_busConnector.requestBuffer(index).size());
+        }
+        return { m_buffers[index] };
+    }
+
+    virtual uint8_t getBufferCount() const override { return m_buffers.size(); }
+
+    virtual bool canReadData() const override { return m_busConnector.canReadData(); }
+    virtual bool readData(const uint32_t addr, tcb::span<uint8_t> data) override { return m_busConnector.readData(addr, data); }
+
+private:
+    IBusConnector& m_busConnector;
+    std::vector<std::vector<uint8_t>> m_buffers {};
+};
+
+} // namespace rr
+#endif // #ifndef CACHEDBUFFERBUSCONNECTOR_HPP
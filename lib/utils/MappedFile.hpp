@@ -0,0 +1,80 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstdint>
+#include <fcntl.h>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rr
+{
+
+// Maps a file read only into the memory (POSIX only). The mapping is released when the last
+// reference to data() is gone, for instance when a texture which was loaded from it is deleted.
+class MappedFile
+{
+public:
+    /// @brief Maps a file
+    /// @param path The path of the file
+    /// @return false if the file can't be mapped
+    bool open(const char* path)
+    {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st
+        {
+        };
+        if ((fstat(fd, &st) != 0) || (st.st_size <= 0))
+        {
+            ::close(fd);
+            return false;
+        }
+        const std::size_t size = static_cast<std::size_t>(st.st_size);
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping stays valid after the file is closed
+        ::close(fd);
+        if (addr == MAP_FAILED)
+        {
+            return false;
+        }
+        m_data = { reinterpret_cast<const uint8_t*>(addr), [size](const uint8_t* p)
+            { munmap(const_cast<uint8_t*>(p), size); } };
+        m_size = size;
+        return true;
+    }
+
+    /// @return The mapped file, or nullptr if no file is mapped
+    const std::shared_ptr<const uint8_t>& data() const { return m_data; }
+
+    /// @return The size of the mapped file in bytes
+    std::size_t size() const { return m_size; }
+
+private:
+    std::shared_ptr<const uint8_t> m_data {};
+    std::size_t m_size { 0 };
+};
+
+} // namespace rr
+#endif // #ifndef MAPPEDFILE_HPP
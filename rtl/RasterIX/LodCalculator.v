@@ -24,6 +24,9 @@
 // |            | this pixel | Pixel only used for mipmap calculation
 //  -------------------------
 //
+// The lod is clamped to the range confMinLod to confMaxLod. When the
+// calculation is disabled, the lod is always confMinLod.
+//
 // Pipelined: yes
 // Depth: 1 cycles
 module LodCalculator
@@ -35,6 +38,8 @@ module LodCalculator
     input  wire                         resetn,
 
     input  wire                         confEnable,
+    input  wire [ 3 : 0]                confMinLod,
+    input  wire [ 3 : 0]                confMaxLod,
 
     output wire                         s_ready,
     input  wire                         s_valid,
@@ -77,13 +82,17 @@ module LodCalculator
             8'b1???????: lodReg = 8;
         endcase
 
-        if (confEnable)
+        if (!confEnable || (lodReg < confMinLod))
         begin
-            m_lod <= lodReg;
+            m_lod <= confMinLod;
+        end
+        else if (lodReg > confMaxLod)
+        begin
+            m_lod <= confMaxLod;
         end
         else
         begin
-            m_lod <= 0;
+            m_lod <= lodReg;
         end
         m_valid <= s_valid;
         m_user <= s_user;
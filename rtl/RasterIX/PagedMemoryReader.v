@@ -20,6 +20,17 @@
 // in one read page and streamed to the s_axis.
 // The last m_axis_tlast page will trigger a s_axis_tlast on the last
 // beat.
+// The addresses are aligned to 1 kB blocks. The lower bits of an address
+// contain the number of 1 kB blocks which are read from this address.
+// 0 reads the complete page. This is used to read only a part of a page,
+// for instance when several small textures share one page:
+// +------------------------+------+----------------------+
+// | 22'h address [31 : 10] | 4'h0 | 6'h number of blocks |
+// +------------------------+------+----------------------+
+// The m_axis interface can stall the memory read channel. After the last
+// page of a stream (s_axis_tlast), the s_axis interface gets ready again,
+// when the last beat was consumed and the m_axis receiver is ready, so that
+// it has processed the whole stream. Other pages don't wait for the receiver.
 module PagedMemoryReader #(
     // Width of the axi interfaces
     parameter DATA_WIDTH = 32,
@@ -35,6 +46,7 @@ module PagedMemoryReader #(
     input  wire                         resetn,
 
     output reg                          m_axis_tvalid,
+    input  wire                         m_axis_tready,
     output reg                          m_axis_tlast,
     output reg  [DATA_WIDTH - 1 : 0]    m_axis_tdata,
 
@@ -60,7 +72,7 @@ module PagedMemoryReader #(
     input  wire [ 1 : 0]                m_mem_axi_rresp,
     input  wire                         m_mem_axi_rlast,
     input  wire                         m_mem_axi_rvalid,
-    output reg                          m_mem_axi_rready
+    output wire                         m_mem_axi_rready
 );
     localparam BYTES_PER_BEAT = DATA_WIDTH / 8;
     localparam LG_BEAT_SIZE = $clog2(BYTES_PER_BEAT);
@@ -69,6 +81,10 @@ module PagedMemoryReader #(
     localparam BEATS = 1024 / BYTES_PER_BEAT;
 
     localparam INCREMENT = BEATS << LG_BEAT_SIZE;
+
+    localparam BLOCK_ADDR_BITS = 10;
+    localparam BLOCKS_POS = 0;
+    localparam BLOCKS_SIZE = 6;
     initial 
     begin
         if (DATA_WIDTH < 32)
@@ -98,12 +114,16 @@ module PagedMemoryReader #(
     localparam LAST_TRANSFER = 3;
 
     reg  [15 : 0]               index;
+    reg  [15 : 0]               length;
     reg  [ADDR_WIDTH - 1 : 0]   addr;
     reg  [ 1 : 0]               state;
     reg                         lastTransfer;
+    reg                         lastPage;
     reg  [15 : 0]               transfersRequested;
     reg  [15 : 0]               transfersReceived;
 
+    assign m_mem_axi_rready = !m_axis_tvalid || m_axis_tready;
+
     // Memory Request
     always @(posedge aclk)
     begin
@@ -116,6 +136,7 @@ module PagedMemoryReader #(
             m_mem_axi_arvalid <= 0;
 
             lastTransfer <= 0;
+            lastPage <= 0;
 
             transfersRequested <= 0;
             
@@ -128,10 +149,19 @@ module PagedMemoryReader #(
                 begin
                     if (s_axis_tvalid)
                     begin
-                        addr <= s_axis_tdata;
+                        addr <= { s_axis_tdata[31 : BLOCK_ADDR_BITS], { BLOCK_ADDR_BITS { 1'b0 } } };
+                        if (|s_axis_tdata[BLOCKS_POS +: BLOCKS_SIZE])
+                        begin
+                            length <= { s_axis_tdata[BLOCKS_POS +: BLOCKS_SIZE], { BLOCK_ADDR_BITS { 1'b0 } } };
+                        end
+                        else
+                        begin
+                            length <= PAGE_SIZE[15 : 0];
+                        end
                         index <= 0;
                         s_axis_tready <= 0;
                         lastTransfer <= s_axis_tlast;
+                        lastPage <= s_axis_tlast;
                         state <= REQUEST_MEMORY;
                     end
                 end
@@ -148,7 +178,7 @@ module PagedMemoryReader #(
                     if (m_mem_axi_arready)
                     begin
                         m_mem_axi_arvalid <= 0;
-                        if (index == PAGE_SIZE)
+                        if (index == length)
                         begin
                             state <= LAST_TRANSFER;
                         end
@@ -160,8 +190,9 @@ module PagedMemoryReader #(
                 end
                 LAST_TRANSFER:
                 begin
-                    // Stall here till the last data has transferred through the read channel
-                    if (!lastTransfer)
+                    // Stall here till the last data has transferred through the read channel.
+                    // The last page of a stream also waits till it was processed by the receiver.
+                    if (!lastTransfer && (!lastPage || (!m_axis_tvalid && m_axis_tready)))
                     begin
                         s_axis_tready <= 1;
                         state <= RECEIVE_ADDR;
@@ -173,30 +204,32 @@ module PagedMemoryReader #(
         if (!resetn)
         begin
             m_axis_tvalid <= 0;
-            m_mem_axi_rready <= 1;
 
             transfersReceived <= 0;
         end
         else
         begin
-            m_axis_tvalid <= m_mem_axi_rvalid;
-            m_axis_tdata <= m_mem_axi_rdata;
-            if (m_mem_axi_rvalid)
+            if (m_mem_axi_rready)
             begin
-                if (m_mem_axi_rlast)
-                begin
-                    transfersReceived <= transfersReceived + 1;
-                end
-                if (m_mem_axi_rlast && lastTransfer && (transfersRequested == (transfersReceived + 1)))
+                m_axis_tvalid <= m_mem_axi_rvalid;
+                m_axis_tdata <= m_mem_axi_rdata;
+                if (m_mem_axi_rvalid)
                 begin
-                    lastTransfer <= 0;
-                    transfersRequested <= 0;
-                    transfersReceived <= 0;
-                    m_axis_tlast <= 1;
-                end
-                else
-                begin
-                    m_axis_tlast <= 0;
+                    if (m_mem_axi_rlast)
+                    begin
+                        transfersReceived <= transfersReceived + 1;
+                    end
+                    if (m_mem_axi_rlast && lastTransfer && (transfersRequested == (transfersReceived + 1)))
+                    begin
+                        lastTransfer <= 0;
+                        transfersRequested <= 0;
+                        transfersReceived <= 0;
+                        m_axis_tlast <= 1;
+                    end
+                    else
+                    begin
+                        m_axis_tlast <= 0;
+                    end
                 end
             end
         end
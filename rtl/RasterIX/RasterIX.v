@@ -55,6 +55,8 @@ module RasterIX #(
     // Number of TMUs. Currently supported values: 1 and 2
     parameter TMU_COUNT = 2,
     parameter ENABLE_MIPMAPPING = 1,
+    parameter ENABLE_TEXTURE_COMPRESSION = 1,
+    parameter ENABLE_PALETTED_TEXTURES = 1,
     parameter ENABLE_TEXTURE_FILTERING = 1,
     parameter TEXTURE_PAGE_SIZE = 4096,
 
@@ -163,6 +165,8 @@ module RasterIX #(
                 .ENABLE_DEPTH_BUFFER(ENABLE_DEPTH_BUFFER),
                 .TMU_COUNT(TMU_COUNT),
                 .ENABLE_MIPMAPPING(ENABLE_MIPMAPPING),
+                .ENABLE_TEXTURE_COMPRESSION(ENABLE_TEXTURE_COMPRESSION),
+                .ENABLE_PALETTED_TEXTURES(ENABLE_PALETTED_TEXTURES),
                 .ENABLE_TEXTURE_FILTERING(ENABLE_TEXTURE_FILTERING),
                 .ENABLE_FOG(ENABLE_FOG),
                 .TEXTURE_PAGE_SIZE(TEXTURE_PAGE_SIZE),
@@ -241,6 +245,8 @@ module RasterIX #(
                 .ENABLE_BLOCKING_STREAM(ENABLE_BLOCKING_STREAM),
                 .TMU_COUNT(TMU_COUNT),
                 .ENABLE_MIPMAPPING(ENABLE_MIPMAPPING),
+                .ENABLE_TEXTURE_COMPRESSION(ENABLE_TEXTURE_COMPRESSION),
+                .ENABLE_PALETTED_TEXTURES(ENABLE_PALETTED_TEXTURES),
                 .ENABLE_TEXTURE_FILTERING(ENABLE_TEXTURE_FILTERING),
                 .ENABLE_FOG(ENABLE_FOG),
                 .TEXTURE_PAGE_SIZE(TEXTURE_PAGE_SIZE),
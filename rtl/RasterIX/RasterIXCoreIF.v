@@ -51,6 +51,8 @@ module RasterIXCoreIF #(
     // Number of TMUs. Currently supported values: 1 and 2
     parameter TMU_COUNT = 2,
     parameter ENABLE_MIPMAPPING = 1,
+    parameter ENABLE_TEXTURE_COMPRESSION = 1,
+    parameter ENABLE_PALETTED_TEXTURES = 1,
     parameter ENABLE_TEXTURE_FILTERING = 1,
     parameter TEXTURE_PAGE_SIZE = 2048,
 
@@ -442,6 +444,8 @@ module RasterIXCoreIF #(
         .ID_WIDTH(ID_WIDTH),
         .TMU_COUNT(TMU_COUNT),
         .ENABLE_MIPMAPPING(ENABLE_MIPMAPPING),
+        .ENABLE_TEXTURE_COMPRESSION(ENABLE_TEXTURE_COMPRESSION),
+        .ENABLE_PALETTED_TEXTURES(ENABLE_PALETTED_TEXTURES),
         .ENABLE_TEXTURE_FILTERING(ENABLE_TEXTURE_FILTERING),
         .ENABLE_FOG(ENABLE_FOG),
         .TMU_MEMORY_WIDTH(DATA_WIDTH),
@@ -31,6 +31,8 @@ module RasterIXRenderCore #(
     // Number of TMUs. Currently supported values: 1 and 2
     parameter TMU_COUNT = 2,
     parameter ENABLE_MIPMAPPING = 1,
+    parameter ENABLE_TEXTURE_COMPRESSION = 1,
+    parameter ENABLE_PALETTED_TEXTURES = 1,
     parameter ENABLE_TEXTURE_FILTERING = 1,
     parameter TMU_MEMORY_WIDTH = 64,
     parameter TEXTURE_PAGE_SIZE = 2048,
@@ -552,6 +554,7 @@ module RasterIXRenderCore #(
     // Clocks: n/a
     ////////////////////////////////////////////////////////////////////////////
     wire                                axis_tmu0_tvalid;
+    wire                                axis_tmu0_tready;
     wire                                axis_tmu0_tlast;
     wire  [TMU_MEMORY_WIDTH - 1 : 0]    axis_tmu0_tdata;
     PagedMemoryReader pagedMemoryReaderTmu0 (
@@ -559,6 +562,7 @@ module RasterIXRenderCore #(
         .resetn(resetn),
 
         .m_axis_tvalid(axis_tmu0_tvalid),
+        .m_axis_tready(axis_tmu0_tready),
         .m_axis_tlast(axis_tmu0_tlast),
         .m_axis_tdata(axis_tmu0_tdata),
 
@@ -602,6 +606,8 @@ module RasterIXRenderCore #(
         .resetn(resetn),
 
         .confPixelFormat(confTMU0TextureConfig[RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_POS +: RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_SIZE]),
+        .confTextureSizeWidth(confTMU0TextureConfig[RENDER_CONFIG_TMU_TEXTURE_WIDTH_POS +: RENDER_CONFIG_TMU_TEXTURE_WIDTH_SIZE]),
+        .confTextureSizeHeight(confTMU0TextureConfig[RENDER_CONFIG_TMU_TEXTURE_HEIGHT_POS +: RENDER_CONFIG_TMU_TEXTURE_HEIGHT_SIZE]),
 
         .texelAddr00(texel0Addr00),
         .texelAddr01(texel0Addr01),
@@ -614,6 +620,7 @@ module RasterIXRenderCore #(
         .texelOutput11(texel0Input11),
 
         .s_axis_tvalid(axis_tmu0_tvalid),
+        .s_axis_tready(axis_tmu0_tready),
         .s_axis_tlast(axis_tmu0_tlast),
         .s_axis_tdata(axis_tmu0_tdata)
     );
@@ -621,6 +628,8 @@ module RasterIXRenderCore #(
     defparam textureBufferTMU0.MAX_TEXTURE_SIZE = MAX_TEXTURE_SIZE;
     defparam textureBufferTMU0.PIXEL_WIDTH = COLOR_NUMBER_OF_SUB_PIXEL * COLOR_SUB_PIXEL_WIDTH;
     defparam textureBufferTMU0.ENABLE_LOD = ENABLE_MIPMAPPING;
+    defparam textureBufferTMU0.ENABLE_TEXTURE_COMPRESSION = ENABLE_TEXTURE_COMPRESSION;
+    defparam textureBufferTMU0.ENABLE_PALETTED_TEXTURES = ENABLE_PALETTED_TEXTURES;
 
     ////////////////////////////////////////////////////////////////////////////
     // Texture Mapping Unit Buffer 1
@@ -639,6 +648,7 @@ module RasterIXRenderCore #(
         if (ENABLE_SECOND_TMU)
         begin
             wire                                axis_tmu1_tvalid;
+            wire                                axis_tmu1_tready;
             wire                                axis_tmu1_tlast;
             wire  [TMU_MEMORY_WIDTH - 1 : 0]    axis_tmu1_tdata;
             PagedMemoryReader pagedMemoryReaderTmu1 (
@@ -646,6 +656,7 @@ module RasterIXRenderCore #(
                 .resetn(resetn),
 
                 .m_axis_tvalid(axis_tmu1_tvalid),
+                .m_axis_tready(axis_tmu1_tready),
                 .m_axis_tlast(axis_tmu1_tlast),
                 .m_axis_tdata(axis_tmu1_tdata),
 
@@ -681,6 +692,8 @@ module RasterIXRenderCore #(
                 .resetn(resetn),
 
                 .confPixelFormat(confTMU1TextureConfig[RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_POS +: RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_SIZE]),
+                .confTextureSizeWidth(confTMU1TextureConfig[RENDER_CONFIG_TMU_TEXTURE_WIDTH_POS +: RENDER_CONFIG_TMU_TEXTURE_WIDTH_SIZE]),
+                .confTextureSizeHeight(confTMU1TextureConfig[RENDER_CONFIG_TMU_TEXTURE_HEIGHT_POS +: RENDER_CONFIG_TMU_TEXTURE_HEIGHT_SIZE]),
 
                 .texelAddr00(texel1Addr00),
                 .texelAddr01(texel1Addr01),
@@ -693,6 +706,7 @@ module RasterIXRenderCore #(
                 .texelOutput11(texel1Input11),
 
                 .s_axis_tvalid(axis_tmu1_tvalid),
+                .s_axis_tready(axis_tmu1_tready),
                 .s_axis_tlast(axis_tmu1_tlast),
                 .s_axis_tdata(axis_tmu1_tdata)
             );
@@ -700,6 +714,8 @@ module RasterIXRenderCore #(
             defparam textureBufferTMU1.MAX_TEXTURE_SIZE = MAX_TEXTURE_SIZE;
             defparam textureBufferTMU1.PIXEL_WIDTH = COLOR_NUMBER_OF_SUB_PIXEL * COLOR_SUB_PIXEL_WIDTH;
             defparam textureBufferTMU1.ENABLE_LOD = ENABLE_MIPMAPPING;
+            defparam textureBufferTMU1.ENABLE_TEXTURE_COMPRESSION = ENABLE_TEXTURE_COMPRESSION;
+            defparam textureBufferTMU1.ENABLE_PALETTED_TEXTURES = ENABLE_PALETTED_TEXTURES;
         end
         else
         begin
@@ -778,6 +794,8 @@ module RasterIXRenderCore #(
     defparam rop.Y_BIT_WIDTH = SCREEN_POS_WIDTH;
     defparam rop.INDEX_WIDTH = INDEX_WIDTH;
     defparam rop.RASTERIZER_ENABLE_INITIAL_Y_INC = RASTERIZER_ENABLE_FLOAT_INTERPOLATION;
+    // The float interpolation uses the bounding box position instead of the increments and can therefore jump over pixels
+    defparam rop.RASTERIZER_ENABLE_SPAN_SKIPPING = RASTERIZER_ENABLE_FLOAT_INTERPOLATION;
 
     ////////////////////////////////////////////////////////////////////////////
     // STEP 1
@@ -43,6 +43,8 @@ module RasterIX_IF #(
     // Number of TMUs. Currently supported values: 1 and 2
     parameter TMU_COUNT = 2,
     parameter ENABLE_MIPMAPPING = 1,
+    parameter ENABLE_TEXTURE_COMPRESSION = 1,
+    parameter ENABLE_PALETTED_TEXTURES = 1,
     parameter ENABLE_TEXTURE_FILTERING = 1,
     parameter TEXTURE_PAGE_SIZE = 4096,
 
@@ -614,6 +616,8 @@ module RasterIX_IF #(
         .ENABLE_DEPTH_BUFFER(ENABLE_DEPTH_BUFFER),
         .MAX_TEXTURE_SIZE(MAX_TEXTURE_SIZE),
         .ENABLE_MIPMAPPING(ENABLE_MIPMAPPING),
+        .ENABLE_TEXTURE_COMPRESSION(ENABLE_TEXTURE_COMPRESSION),
+        .ENABLE_PALETTED_TEXTURES(ENABLE_PALETTED_TEXTURES),
         .ENABLE_TEXTURE_FILTERING(ENABLE_TEXTURE_FILTERING),
         .ENABLE_FOG(ENABLE_FOG),
         .FRAMEBUFFER_SUB_PIXEL_WIDTH(FRAMEBUFFER_SUB_PIXEL_WIDTH),
@@ -55,6 +55,19 @@
 //      Typically when m_rr_tpixel and m_rr_tvalid is true, a pixel can be drawn. It is expected that the the current attributes
 //      can be used. The attributes of the current m_rr_tcmd a needed for the attributes in the next cycle. So a single cycle
 //      interpolator can run in parallel to the perspective correction.
+//
+// When RASTERIZER_ENABLE_SPAN_SKIPPING is set, the edge walker is replaced by a span traversal:
+//                      +Bounding Box----------------+
+//                      |          +------+          |
+//                      | +--->+-->X--->XXX>+        |  Jump with the edge functions to the first pixel of the span,
+//                      |          +---------+       |  walk the span and then start the next line.
+//                      | +--->+----->XXXXXX>+       |
+//                      |          +-------------+   |
+//                      +----------------------------+
+// Each line starts at the bounding box start. The rasterizer jumps by up to 2^(SPAN_SKIP_LEVELS - 1) pixels, as long as one
+// of the edge functions is negative at the first and the last pixel of the jump. Because the edge functions are linear,
+// all pixels in between are outside of the triangle. A line ends with the first pixel after the span.
+// The jumps are not reflected in m_rr_tcmd. This mode requires an interpolator which uses m_rr_tbbx and m_rr_tbby.
 module Rasterizer
 #(
     `include "RasterizerCommands.vh"
@@ -69,6 +82,10 @@ module Rasterizer
     // to the current screen position
     parameter RASTERIZER_ENABLE_INITIAL_Y_INC = 1,
 
+    // Jumps directly to the spans of the triangle instead of walking to the edges.
+    // Incompatible with incremental interpolators which are using m_rr_tcmd.
+    parameter RASTERIZER_ENABLE_SPAN_SKIPPING = 0,
+
     localparam ATTRIBUTE_SIZE = 32,
 
     localparam KEEP_WIDTH = 1
@@ -149,6 +166,45 @@ module Rasterizer
     localparam EDGE_WALKING_DIRECTION_LEFT = 1'b0;
     localparam EDGE_WALKING_DIRECTION_RIGHT = 1'b1;
 
+    // Span skipping variables
+    localparam SPAN_SKIP_LEVELS = 6;
+    localparam SPAN_SKIP_LEVEL_WIDTH = $clog2(SPAN_SKIP_LEVELS);
+    reg  [ATTRIBUTE_SIZE - 1 : 0]           lineW0;
+    reg  [ATTRIBUTE_SIZE - 1 : 0]           lineW1;
+    reg  [ATTRIBUTE_SIZE - 1 : 0]           lineW2;
+    reg                                     spanStarted;
+    wire [SPAN_SKIP_LEVELS - 1 : 0]         spanSkipSafe;
+    reg  [SPAN_SKIP_LEVEL_WIDTH - 1 : 0]    spanSkipLevel;
+    wire [X_BIT_WIDTH : 0]                  spanJumpSize = { { X_BIT_WIDTH { 1'b0 } }, 1'b1 } << spanSkipLevel;
+    wire [X_BIT_WIDTH : 0]                  spanJumpEnd = { 1'b0, x } + spanJumpSize;
+    wire                                    spanLineDone = spanStarted || (spanJumpEnd >= { 1'b0, bbEnd[BB_X_POS +: X_BIT_WIDTH] });
+
+    generate
+        genvar i;
+        for (i = 0; i < SPAN_SKIP_LEVELS; i = i + 1)
+        begin
+            // Edge functions at the last pixel of a jump of 2^i pixels
+            wire [ATTRIBUTE_SIZE - 1 : 0] w0JumpEnd = regW0 + (w0IncX << i) - w0IncX;
+            wire [ATTRIBUTE_SIZE - 1 : 0] w1JumpEnd = regW1 + (w1IncX << i) - w1IncX;
+            wire [ATTRIBUTE_SIZE - 1 : 0] w2JumpEnd = regW2 + (w2IncX << i) - w2IncX;
+            assign spanSkipSafe[i] = (regW0[31] & w0JumpEnd[31]) | (regW1[31] & w1JumpEnd[31]) | (regW2[31] & w2JumpEnd[31]);
+        end
+    endgenerate
+
+    // Selects the widest safe jump. A jump is safe, when all smaller jumps are also safe.
+    integer j;
+    always @(*)
+    begin
+        spanSkipLevel = 0;
+        for (j = 1; j < SPAN_SKIP_LEVELS; j = j + 1)
+        begin
+            if (spanSkipSafe[j])
+            begin
+                spanSkipLevel = j[SPAN_SKIP_LEVEL_WIDTH - 1 : 0];
+            end
+        end
+    end
+
     always @(posedge clk)
     begin
         if (reset)
@@ -191,12 +247,18 @@ module Rasterizer
                         regW0 <= w0;
                         regW1 <= w1;
                         regW2 <= w2;
+                        lineW0 <= w0;
+                        lineW1 <= w1;
+                        lineW2 <= w2;
                     end
                     else
                     begin
                         regW0 <= w0 + ($signed(w0IncY) * lineBBStart);
                         regW1 <= w1 + ($signed(w1IncY) * lineBBStart);
                         regW2 <= w2 + ($signed(w2IncY) * lineBBStart);
+                        lineW0 <= w0 + ($signed(w0IncY) * lineBBStart);
+                        lineW1 <= w1 + ($signed(w1IncY) * lineBBStart);
+                        lineW2 <= w2 + ($signed(w2IncY) * lineBBStart);
                     end
                 end
                 else
@@ -204,7 +266,11 @@ module Rasterizer
                     regW0 <= w0;
                     regW1 <= w1;
                     regW2 <= w2;
+                    lineW0 <= w0;
+                    lineW1 <= w1;
+                    lineW2 <= w2;
                 end
+                spanStarted <= 0;
 
                 // Shift the triangle to the current framebuffer line. Everything can be calculated in software if this implementation
                 // takes too much logic. It can be completely discarded, when the framebuffer is big enough to contain the whole screen. This is only 
@@ -250,179 +316,230 @@ module Rasterizer
                 // A rasterization cycle is only executed if the shader is free. Otherwise the rasterizer will stall
                 if (m_rr_tready)
                 begin
-                    // Triangle increments
-                    if (edgeWalkingState == RASTERIZER_EDGEWALKER_CHECK_WALKING_DIR)
-                    begin
-                        // Do nothing here, just avoid an increment.
-                        // It is convenient to do that when we are checking the new direction,
-                        // because in 50% of the cases, we are walking in the wrong direction
-                        // anyway, so this gives us no advantage, but when we just keep walking
-                        // we risk an over or underflow of x.
-                        m_rr_tvalid <= 0;
-                    end 
-                    else if ((edgeWalkingState == RASTERIZER_EDGEWALKER_WALK) & !isInTriangleAndInBounds)
+                    if (RASTERIZER_ENABLE_SPAN_SKIPPING)
                     begin
-                        // Line Increment
-                        y <= y + 1;
-                        yScreen <= yScreen + 1;
-
-                        regW0 <= regW0 + $signed(w0IncY);
-                        regW1 <= regW1 + $signed(w1IncY);
-                        regW2 <= regW2 + $signed(w2IncY);
-
-                        m_rr_tcmd <= RR_CMD_Y_INC;
-                        m_rr_tvalid <= 1;
-                    end
-                    else 
-                    begin
-                        if (edgeWalkingDirection == EDGE_WALKING_DIRECTION_RIGHT)
+                        if (isInTriangleAndInBounds)
                         begin
-                            // Pixel Increment
+                            // Walk through the span
+                            spanStarted <= 1;
                             x <= x + 1;
 
-                            regW0 <= regW0 + $signed(w0IncX);
-                            regW1 <= regW1 + $signed(w1IncX);
-                            regW2 <= regW2 + $signed(w2IncX);
+                            regW0 <= regW0 + w0IncX;
+                            regW1 <= regW1 + w1IncX;
+                            regW2 <= regW2 + w2IncX;
+                        end
+                        else if (spanLineDone)
+                        begin
+                            // The span ended or there is no pixel of the triangle left in this line.
+                            // Start the next line at the beginning of the bounding box.
+                            spanStarted <= 0;
+                            x <= bbStart[BB_X_POS +: X_BIT_WIDTH];
+                            y <= y + 1;
+                            yScreen <= yScreen + 1;
 
-                            m_rr_tcmd <= RR_CMD_X_INC;
-                            m_rr_tvalid <= 1;
+                            regW0 <= lineW0 + w0IncY;
+                            regW1 <= lineW1 + w1IncY;
+                            regW2 <= lineW2 + w2IncY;
+                            lineW0 <= lineW0 + w0IncY;
+                            lineW1 <= lineW1 + w1IncY;
+                            lineW2 <= lineW2 + w2IncY;
                         end
                         else
                         begin
-                            // Pixel Decrement
-                            x <= x - 1;
-
-                            regW0 <= regW0 - $signed(w0IncX);
-                            regW1 <= regW1 - $signed(w1IncX);
-                            regW2 <= regW2 - $signed(w2IncX);
+                            // Jump over pixels which are outside of the triangle
+                            x <= x + spanJumpSize[0 +: X_BIT_WIDTH];
 
-                            m_rr_tcmd <= RR_CMD_X_DEC;
-                            m_rr_tvalid <= 1;
+                            regW0 <= regW0 + (w0IncX << spanSkipLevel);
+                            regW1 <= regW1 + (w1IncX << spanSkipLevel);
+                            regW2 <= regW2 + (w2IncX << spanSkipLevel);
                         end
-                    end
 
-                    if (yScreen < yScreenEnd)
+                        m_rr_tcmd <= RR_CMD_X_INC;
+                        m_rr_tvalid <= 1;
+                    end
+                    else
                     begin
-                        case (edgeWalkingState)
-                        RASTERIZER_EDGEWALKER_INIT:
+                        // Triangle increments
+                        if (edgeWalkingState == RASTERIZER_EDGEWALKER_CHECK_WALKING_DIR)
                         begin
-                            // Check if the first pixel is already in the triangle
-                            if (isInTriangle)
-                            begin
-                                // If yes, then there is nothing to do. We are already at position (0, 0)
-                                m_rr_tpixel <= 1;
-                                edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK;
-                            end
-                            else
-                            begin
-                                // If not, search the edge
-                                m_rr_tpixel <= 0;
-                                edgeWalkingState <= RASTERIZER_EDGEWALKER_SEARCH_EDGE;
-                            end
+                            // Do nothing here, just avoid an increment.
+                            // It is convenient to do that when we are checking the new direction,
+                            // because in 50% of the cases, we are walking in the wrong direction
+                            // anyway, so this gives us no advantage, but when we just keep walking
+                            // we risk an over or underflow of x.
+                            m_rr_tvalid <= 0;
+                        end 
+                        else if ((edgeWalkingState == RASTERIZER_EDGEWALKER_WALK) & !isInTriangleAndInBounds)
+                        begin
+                            // Line Increment
+                            y <= y + 1;
+                            yScreen <= yScreen + 1;
+
+                            regW0 <= regW0 + $signed(w0IncY);
+                            regW1 <= regW1 + $signed(w1IncY);
+                            regW2 <= regW2 + $signed(w2IncY);
+
+                            m_rr_tcmd <= RR_CMD_Y_INC;
+                            m_rr_tvalid <= 1;
                         end
-                        RASTERIZER_EDGEWALKER_CHECK_WALKING_DIR:
+                        else 
                         begin
-                            // Check if after a line increment the pixel is inside the triangle
-                            if (isInTriangle)
+                            if (edgeWalkingDirection == EDGE_WALKING_DIRECTION_RIGHT)
                             begin
-                                // If yes, walk out. It will continue walking in the old direction, this should be closest to the edge
-                                // Improvement: Save this position inside in the triangle. Also during walk out it is possible to render this pixel.
-                                //      currently we are wasting just clock cycles. Normaly, the pixel are really not far away from the edge.
-                                edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK_OUT;
+                                // Pixel Increment
+                                x <= x + 1;
+
+                                regW0 <= regW0 + $signed(w0IncX);
+                                regW1 <= regW1 + $signed(w1IncX);
+                                regW2 <= regW2 + $signed(w2IncX);
+
+                                m_rr_tcmd <= RR_CMD_X_INC;
+                                m_rr_tvalid <= 1;
                             end
                             else
                             begin
-                                // The current pixel is outside of the triangle. We assume, that the triangle is always on the opposite direction.
-                                // This assumption is most of the time true, but there are edge cases, where this is wrong. This edge cases are handled 
-                                // in the RASTERIZER_EDGEWALKER_SEARCH_EDGE state.
-                                edgeWalkingDirection <= !edgeWalkingDirection; // Change walking direction
-                                edgeWalkingState <= RASTERIZER_EDGEWALKER_SEARCH_EDGE;
+                                // Pixel Decrement
+                                x <= x - 1;
+
+                                regW0 <= regW0 - $signed(w0IncX);
+                                regW1 <= regW1 - $signed(w1IncX);
+                                regW2 <= regW2 - $signed(w2IncX);
+
+                                m_rr_tcmd <= RR_CMD_X_DEC;
+                                m_rr_tvalid <= 1;
                             end
                         end
-                        RASTERIZER_EDGEWALKER_SEARCH_EDGE:
+                    end
+
+                    if (yScreen < yScreenEnd)
+                    begin
+                        if (RASTERIZER_ENABLE_SPAN_SKIPPING)
                         begin
-                            if (isInTriangleAndInBounds)
+                            m_rr_tpixel <= isInTriangleAndInBounds;
+                        end
+                        else
+                        begin
+                            case (edgeWalkingState)
+                            RASTERIZER_EDGEWALKER_INIT:
                             begin
-                                // The triangle is withing it bounds and everything is fine. So, just shade the pixel
-                                edgeWalkTryOtherside <= 0;
-                                m_rr_tpixel <= 1; // To prevent, that the first pixel of the triangle is skipped
-                                edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK;
+                                // Check if the first pixel is already in the triangle
+                                if (isInTriangle)
+                                begin
+                                    // If yes, then there is nothing to do. We are already at position (0, 0)
+                                    m_rr_tpixel <= 1;
+                                    edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK;
+                                end
+                                else
+                                begin
+                                    // If not, search the edge
+                                    m_rr_tpixel <= 0;
+                                    edgeWalkingState <= RASTERIZER_EDGEWALKER_SEARCH_EDGE;
+                                end
                             end
-                            else if (x == bbEnd[BB_X_POS +: X_BIT_WIDTH])
+                            RASTERIZER_EDGEWALKER_CHECK_WALKING_DIR:
                             begin
-                                // The rasterizer reaches the end of the bounding box and has to handle this now. There are now to possible cases:
-                                //      Easiest case: Rasterizer was iterating from the left to the right, and there was no triangle on the way.
-                                //          In this case, we could just do a line increment.
-                                //      Edge Case: Normally we assume, that after a line increment, the current position is near the triangle or in the 
-                                //          triangel and  when we change direction, that we hit the triangle. That is for most of the triangles true. But 
-                                //          in some cases it is wrong. For instance, walking from left to right. After we run out of the triangle, we 
-                                //          make our line increment. We assume now, that after the line increment, the triangle should be on the left side.
-                                //          But this is not always true. In some cases when we are on the edge points of the triangle, it can happen, that
-                                //          the triangle is even after a line increment on the right side. That is something we have to cover, otherwise
-                                //          some triangles are not completely rendered.
-                                //          To cover this, the variable edgeWalkTryOtherside is introduced. If we reach the end of the bounding box without
-                                //          rendering a triangle, then we switch the walking direction and try again to find the triangle until we reaching
-                                //          the beginning of the bounding box. If the triangle would be on the wrong side, we would find it now. Otherwise
-                                //          we are sure, that there is no triangle on this line and we can trigger a line increment.
-                                //      Imrpovement: Similar to RASTERIZER_EDGEWALKER_WALK_OUT we could save our starting point and could reset to this point
-                                //          if we don't find a triangle. This would save cycles because we a don't check pixel twice. Currenlty, (in an extrem
-                                //          case) we would travers from left to right and back. That means, we check all pixels in a line twice.
-                                if ((edgeWalkingDirection == EDGE_WALKING_DIRECTION_RIGHT) & edgeWalkTryOtherside)
+                                // Check if after a line increment the pixel is inside the triangle
+                                if (isInTriangle)
                                 begin
-                                    // No triangle in the line found, so trigger a line increment
-                                    edgeWalkTryOtherside <= 0;
-                                    edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK;
+                                    // If yes, walk out. It will continue walking in the old direction, this should be closest to the edge
+                                    // Improvement: Save this position inside in the triangle. Also during walk out it is possible to render this pixel.
+                                    //      currently we are wasting just clock cycles. Normaly, the pixel are really not far away from the edge.
+                                    edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK_OUT;
                                 end
-                                else 
+                                else
                                 begin
-                                    // No line in the triangle found. But here the rasterizers assumes, that it does not start from the beginning, so 
-                                    // it tries to walk also into the other direction
-                                    edgeWalkTryOtherside <= 1;
-                                    edgeWalkingDirection <= EDGE_WALKING_DIRECTION_LEFT;
+                                    // The current pixel is outside of the triangle. We assume, that the triangle is always on the opposite direction.
+                                    // This assumption is most of the time true, but there are edge cases, where this is wrong. This edge cases are handled 
+                                    // in the RASTERIZER_EDGEWALKER_SEARCH_EDGE state.
+                                    edgeWalkingDirection <= !edgeWalkingDirection; // Change walking direction
+                                    edgeWalkingState <= RASTERIZER_EDGEWALKER_SEARCH_EDGE;
                                 end
-                            end 
-                            else if (x == bbStart[BB_X_POS +: X_BIT_WIDTH])
+                            end
+                            RASTERIZER_EDGEWALKER_SEARCH_EDGE:
                             begin
-                                // This case is similar to the case above. It handles just the other direction
-                                if ((edgeWalkingDirection == EDGE_WALKING_DIRECTION_LEFT) & edgeWalkTryOtherside)
+                                if (isInTriangleAndInBounds)
                                 begin
-                                    // No triangle in the line found, so trigger a line increment
+                                    // The triangle is withing it bounds and everything is fine. So, just shade the pixel
                                     edgeWalkTryOtherside <= 0;
+                                    m_rr_tpixel <= 1; // To prevent, that the first pixel of the triangle is skipped
                                     edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK;
                                 end
-                                else 
+                                else if (x == bbEnd[BB_X_POS +: X_BIT_WIDTH])
                                 begin
-                                    // No line in the triangle found. But here the rasterizers assumes, that it does not start from the beginning, so 
-                                    // it tries to walk also into the other direction
-                                    edgeWalkTryOtherside <= 1;
-                                    edgeWalkingDirection <= EDGE_WALKING_DIRECTION_RIGHT;
+                                    // The rasterizer reaches the end of the bounding box and has to handle this now. There are now to possible cases:
+                                    //      Easiest case: Rasterizer was iterating from the left to the right, and there was no triangle on the way.
+                                    //          In this case, we could just do a line increment.
+                                    //      Edge Case: Normally we assume, that after a line increment, the current position is near the triangle or in the 
+                                    //          triangel and  when we change direction, that we hit the triangle. That is for most of the triangles true. But 
+                                    //          in some cases it is wrong. For instance, walking from left to right. After we run out of the triangle, we 
+                                    //          make our line increment. We assume now, that after the line increment, the triangle should be on the left side.
+                                    //          But this is not always true. In some cases when we are on the edge points of the triangle, it can happen, that
+                                    //          the triangle is even after a line increment on the right side. That is something we have to cover, otherwise
+                                    //          some triangles are not completely rendered.
+                                    //          To cover this, the variable edgeWalkTryOtherside is introduced. If we reach the end of the bounding box without
+                                    //          rendering a triangle, then we switch the walking direction and try again to find the triangle until we reaching
+                                    //          the beginning of the bounding box. If the triangle would be on the wrong side, we would find it now. Otherwise
+                                    //          we are sure, that there is no triangle on this line and we can trigger a line increment.
+                                    //      Imrpovement: Similar to RASTERIZER_EDGEWALKER_WALK_OUT we could save our starting point and could reset to this point
+                                    //          if we don't find a triangle. This would save cycles because we a don't check pixel twice. Currenlty, (in an extrem
+                                    //          case) we would travers from left to right and back. That means, we check all pixels in a line twice.
+                                    if ((edgeWalkingDirection == EDGE_WALKING_DIRECTION_RIGHT) & edgeWalkTryOtherside)
+                                    begin
+                                        // No triangle in the line found, so trigger a line increment
+                                        edgeWalkTryOtherside <= 0;
+                                        edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK;
+                                    end
+                                    else 
+                                    begin
+                                        // No line in the triangle found. But here the rasterizers assumes, that it does not start from the beginning, so 
+                                        // it tries to walk also into the other direction
+                                        edgeWalkTryOtherside <= 1;
+                                        edgeWalkingDirection <= EDGE_WALKING_DIRECTION_LEFT;
+                                    end
+                                end 
+                                else if (x == bbStart[BB_X_POS +: X_BIT_WIDTH])
+                                begin
+                                    // This case is similar to the case above. It handles just the other direction
+                                    if ((edgeWalkingDirection == EDGE_WALKING_DIRECTION_LEFT) & edgeWalkTryOtherside)
+                                    begin
+                                        // No triangle in the line found, so trigger a line increment
+                                        edgeWalkTryOtherside <= 0;
+                                        edgeWalkingState <= RASTERIZER_EDGEWALKER_WALK;
+                                    end
+                                    else 
+                                    begin
+                                        // No line in the triangle found. But here the rasterizers assumes, that it does not start from the beginning, so 
+                                        // it tries to walk also into the other direction
+                                        edgeWalkTryOtherside <= 1;
+                                        edgeWalkingDirection <= EDGE_WALKING_DIRECTION_RIGHT;
+                                    end
                                 end
                             end
-                        end
-                        RASTERIZER_EDGEWALKER_WALK_OUT:
-                        begin
-                            // Walk out of the triangle. To improve the performance: If the rasterizer could save the starting point,
-                            // it could also shade pixel while walking out, and if it is out reset to this point, switch direction
-                            // and shade the left pixels. But this would again occupy arround 400 luts.
-                            if (!isInTriangle | (x == bbStart[BB_X_POS +: X_BIT_WIDTH]) | (x >= bbEnd[BB_X_POS +: X_BIT_WIDTH]))
-                            begin                             
-                                // Change the walking direction and shade
-                                edgeWalkingDirection <= !edgeWalkingDirection;
-                                edgeWalkingState <= RASTERIZER_EDGEWALKER_SEARCH_EDGE;
+                            RASTERIZER_EDGEWALKER_WALK_OUT:
+                            begin
+                                // Walk out of the triangle. To improve the performance: If the rasterizer could save the starting point,
+                                // it could also shade pixel while walking out, and if it is out reset to this point, switch direction
+                                // and shade the left pixels. But this would again occupy arround 400 luts.
+                                if (!isInTriangle | (x == bbStart[BB_X_POS +: X_BIT_WIDTH]) | (x >= bbEnd[BB_X_POS +: X_BIT_WIDTH]))
+                                begin                             
+                                    // Change the walking direction and shade
+                                    edgeWalkingDirection <= !edgeWalkingDirection;
+                                    edgeWalkingState <= RASTERIZER_EDGEWALKER_SEARCH_EDGE;
+                                end
                             end
-                        end
-                        RASTERIZER_EDGEWALKER_WALK:
-                        begin
-                            // Render pixels
-                            if (!isInTriangleAndInBounds)
+                            RASTERIZER_EDGEWALKER_WALK:
                             begin
-                                // Now we are outside on the left side of the triangle.
-                                // The edge walker will now search again the left edge
-                                edgeWalkingState <= RASTERIZER_EDGEWALKER_CHECK_WALKING_DIR;
+                                // Render pixels
+                                if (!isInTriangleAndInBounds)
+                                begin
+                                    // Now we are outside on the left side of the triangle.
+                                    // The edge walker will now search again the left edge
+                                    edgeWalkingState <= RASTERIZER_EDGEWALKER_CHECK_WALKING_DIR;
+                                end
+                                m_rr_tpixel <= isInTriangleAndInBounds;
                             end
-                            m_rr_tpixel <= isInTriangleAndInBounds;
+                            endcase
                         end
-                        endcase
 
                         /* verilator lint_off WIDTH */
                         // Check that the index never exceeds the borders of the view port
@@ -267,10 +267,11 @@ localparam RENDER_CONFIG_TMU_TEX_ENV_SHIFT_ALPHA_SIZE = 2;
 
 // OP_RENDER_CONFIG_TMU0_TEXTURE_CONFIG
 // OP_RENDER_CONFIG_TMU1_TEXTURE_CONFIG
-//  +---------------------------------------------------------------------------------------------------------------------------------+
-//  | 16'hx reserved | 4'hx pixel format | 1'hx min filter | 1'hx mag filter | 1'hx clamp t | 1'hx clamp s | 4'hx height | 4'hx width |
-//  +---------------------------------------------------------------------------------------------------------------------------------+
+//  +-----------------------------------------------------------------------------------------------------------------------------------------------------------------+
+//  | 8'hx reserved | 4'hx max lod | 4'hx min lod | 4'hx pixel format | 1'hx min filter | 1'hx mag filter | 1'hx clamp t | 1'hx clamp s | 4'hx height | 4'hx width |
+//  +-----------------------------------------------------------------------------------------------------------------------------------------------------------------+
 // Texture hight and width are in power of two minus one, means: 4'b0 = 1px, 4'b1 = 2px, 4'b10 = 8px ...
+// The calculated lod is clamped between min lod and max lod. Without min filter, min lod is used.
 localparam RENDER_CONFIG_TMU_TEXTURE_WIDTH_POS = 0;
 localparam RENDER_CONFIG_TMU_TEXTURE_WIDTH_SIZE = 4;
 localparam RENDER_CONFIG_TMU_TEXTURE_HEIGHT_POS = RENDER_CONFIG_TMU_TEXTURE_WIDTH_POS + RENDER_CONFIG_TMU_TEXTURE_WIDTH_SIZE;
@@ -285,10 +286,22 @@ localparam RENDER_CONFIG_TMU_TEXTURE_MIN_FILTER_POS = RENDER_CONFIG_TMU_TEXTURE_
 localparam RENDER_CONFIG_TMU_TEXTURE_MIN_FILTER_SIZE = 1;
 localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_POS = RENDER_CONFIG_TMU_TEXTURE_MIN_FILTER_POS + RENDER_CONFIG_TMU_TEXTURE_MIN_FILTER_SIZE;
 localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_SIZE = 4;
+localparam RENDER_CONFIG_TMU_TEXTURE_MIN_LOD_POS = RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_POS + RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_SIZE;
+localparam RENDER_CONFIG_TMU_TEXTURE_MIN_LOD_SIZE = 4;
+localparam RENDER_CONFIG_TMU_TEXTURE_MAX_LOD_POS = RENDER_CONFIG_TMU_TEXTURE_MIN_LOD_POS + RENDER_CONFIG_TMU_TEXTURE_MIN_LOD_SIZE;
+localparam RENDER_CONFIG_TMU_TEXTURE_MAX_LOD_SIZE = 4;
 
 localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA4444 = 0;
 localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA5551 = 1;
 localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB565 = 2;
+// DXT1 compressed textures. The texture is streamed in 4x4 texel blocks and decoded into RGB565 or RGBA5551.
+localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB_DXT1 = 3;
+localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA_DXT1 = 4;
+// Paletted textures. The texture is streamed as a palette with 256 colors followed by 8 bit indices.
+// The indices are expanded into texels in the format of the palette.
+localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_INDEX8_RGBA4444 = 5;
+localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_INDEX8_RGBA5551 = 6;
+localparam RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_INDEX8_RGB565 = 7;
 
 // OP_RENDER_CONFIG_Y_OFFSET
 //  +-----------------------------------------+
@@ -0,0 +1,300 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Decodes a stream of DXT1 (BC1) compressed texture blocks into 16 bit texels
+// for the texture buffer. A block contains 4x4 texels in 64 bits:
+// +-----------------------------------+---------------+---------------+
+// | 32'h indices (2 bit per texel)    | 16'h color1   | 16'h color0   |
+// +-----------------------------------+---------------+---------------+
+// The colors are in the RGB565 format. The texels are written row by row
+// into the texture buffer. When confEnableAlpha is set, the texels are
+// written as RGBA5551, otherwise as RGB565.
+// The stream contains the mipmap levels one after another, starting with
+// the level configured with confTextureSizeWidth and confTextureSizeHeight.
+// Levels which are smaller than a block are stored in one block.
+// s_axis_tlast marks the end of the stream and resets the level.
+// Pipelined: no
+// Depth: 1 block per (1 + (4 * number of writes per block row)) cycles
+module TextureBlockDecoder #(
+    // Width of the stream and the write port
+    parameter STREAM_WIDTH = 64,
+
+    parameter TEX_ADDR_WIDTH = 17,
+
+    localparam PIXEL_WIDTH = 16,
+    localparam TEXELS_PER_WRITE = STREAM_WIDTH / PIXEL_WIDTH,
+    localparam TEXELS_PER_WRITE_LG = $clog2(TEXELS_PER_WRITE),
+    localparam BLOCK_WIDTH = 64,
+    localparam BUFFER_WIDTH = (STREAM_WIDTH > BLOCK_WIDTH) ? STREAM_WIDTH : BLOCK_WIDTH,
+    localparam BUFFER_BITS_WIDTH = $clog2(BUFFER_WIDTH) + 1
+)
+(
+    input  wire                                             aclk,
+    input  wire                                             resetn,
+
+    input  wire                                             confEnableAlpha,
+    input  wire [ 3 : 0]                                    confTextureSizeWidth,
+    input  wire [ 3 : 0]                                    confTextureSizeHeight,
+
+    // Compressed stream
+    input  wire                                             s_axis_tvalid,
+    output wire                                             s_axis_tready,
+    input  wire                                             s_axis_tlast,
+    input  wire [STREAM_WIDTH - 1 : 0]                      s_axis_tdata,
+
+    // Decoded texels. The address is a word address with a width of STREAM_WIDTH.
+    output reg                                              m_write,
+    output reg  [TEX_ADDR_WIDTH - TEXELS_PER_WRITE_LG - 1 : 0] m_writeAddr,
+    output reg  [STREAM_WIDTH - 1 : 0]                      m_writeData,
+    output reg  [TEXELS_PER_WRITE - 1 : 0]                  m_writeMask
+);
+    initial
+    begin
+        if (STREAM_WIDTH < 32)
+        begin
+            $error("STREAM_WIDTH must be at least 32 bit");
+            $finish;
+        end
+    end
+
+    // Floor of x / 3 for x < 190
+    function [5 : 0] Div3;
+        input [7 : 0] x;
+        reg   [15 : 0] p;
+        begin
+            p = x * 16'd171;
+            Div3 = p[9 +: 6];
+        end
+    endfunction
+
+    // (2 * a + b) / 3 for each channel of a RGB565 color
+    function [15 : 0] Interpolate3;
+        input [15 : 0] a;
+        input [15 : 0] b;
+        reg   [ 5 : 0] r;
+        reg   [ 5 : 0] g;
+        reg   [ 5 : 0] bl;
+        begin
+            r  = Div3({ 2'b0, a[11 +: 5], 1'b0 } + { 3'b0, b[11 +: 5] });
+            g  = Div3({ 1'b0, a[5  +: 6], 1'b0 } + { 2'b0, b[5  +: 6] });
+            bl = Div3({ 2'b0, a[0  +: 5], 1'b0 } + { 3'b0, b[0  +: 5] });
+            Interpolate3 = { r[0 +: 5], g, bl[0 +: 5] };
+        end
+    endfunction
+
+    // (a + b) / 2 for each channel of a RGB565 color
+    function [15 : 0] Interpolate2;
+        input [15 : 0] a;
+        input [15 : 0] b;
+        reg   [ 5 : 0] r;
+        reg   [ 6 : 0] g;
+        reg   [ 5 : 0] bl;
+        begin
+            r  = { 1'b0, a[11 +: 5] } + { 1'b0, b[11 +: 5] };
+            g  = { 1'b0, a[5  +: 6] } + { 1'b0, b[5  +: 6] };
+            bl = { 1'b0, a[0  +: 5] } + { 1'b0, b[0  +: 5] };
+            Interpolate2 = { r[1 +: 5], g[1 +: 6], bl[1 +: 5] };
+        end
+    endfunction
+
+    // Converts a RGB565 color into the output format
+    function [15 : 0] ConvertColor;
+        input [15 : 0] color;
+        input          alpha;
+        input          enableAlpha;
+        begin
+            if (enableAlpha)
+            begin
+                ConvertColor = { color[11 +: 5], color[6 +: 5], color[0 +: 5], alpha };
+            end
+            else
+            begin
+                ConvertColor = (alpha) ? color : 16'h0;
+            end
+        end
+    endfunction
+
+    localparam FILL = 0;
+    localparam PALETTE = 1;
+    localparam WRITE = 2;
+
+    reg  [ 1 : 0]                       state;
+    reg  [BUFFER_WIDTH - 1 : 0]         buffer;
+    reg  [BUFFER_BITS_WIDTH - 1 : 0]    bufferBits;
+    reg                                 bufferLast;
+    reg                                 levelInit;
+
+    // Position of the current block
+    reg  [TEX_ADDR_WIDTH - 1 : 0]       levelOffset;
+    reg  [ 3 : 0]                       levelWidth;
+    reg  [ 3 : 0]                       levelHeight;
+    reg  [ 7 : 0]                       blockX;
+    reg  [ 7 : 0]                       blockY;
+    reg  [ 1 : 0]                       row;
+    reg  [ 1 : 0]                       chunk;
+
+    reg  [PIXEL_WIDTH - 1 : 0]          palette [0 : 3];
+    reg  [31 : 0]                       indices;
+
+    wire [BUFFER_WIDTH + STREAM_WIDTH - 1 : 0] bufferAppend = { { STREAM_WIDTH { 1'b0 } }, buffer }
+                                                            | ({ { BUFFER_WIDTH { 1'b0 } }, s_axis_tdata } << bufferBits);
+
+    assign s_axis_tready = (state == FILL) && (bufferBits <= (BUFFER_WIDTH - STREAM_WIDTH));
+
+    // Texels of the current row of the block
+    wire [63 : 0]                       rowTexels = { palette[indices[(row * 8) + 6 +: 2]],
+                                                      palette[indices[(row * 8) + 4 +: 2]],
+                                                      palette[indices[(row * 8) + 2 +: 2]],
+                                                      palette[indices[(row * 8) + 0 +: 2]] };
+    wire [ 2 : 0]                       texelsPerRow = (levelWidth == 0) ? 1 : (levelWidth == 1) ? 2 : 4;
+    wire                                rowValid = (levelHeight >= 2) || ({ 2'b0, row } < (4'h1 << levelHeight));
+    wire [ 1 : 0]                       lastChunk = (texelsPerRow > TEXELS_PER_WRITE) ? (texelsPerRow / TEXELS_PER_WRITE) - 1 : 0;
+    wire [TEX_ADDR_WIDTH - 1 : 0]       rowAddr = levelOffset
+                                                + ({ { (TEX_ADDR_WIDTH - 10) { 1'b0 } }, blockY, row } << levelWidth)
+                                                + { { (TEX_ADDR_WIDTH - 10) { 1'b0 } }, blockX, 2'b0 };
+    wire [TEX_ADDR_WIDTH - 1 : 0]       chunkAddr = rowAddr + (chunk * TEXELS_PER_WRITE);
+    wire [TEXELS_PER_WRITE_LG - 1 : 0]  lane = chunkAddr[0 +: TEXELS_PER_WRITE_LG];
+    wire [ 2 : 0]                       chunkTexels = ((texelsPerRow - (chunk * TEXELS_PER_WRITE)) > TEXELS_PER_WRITE)
+                                                    ? TEXELS_PER_WRITE
+                                                    : texelsPerRow - (chunk * TEXELS_PER_WRITE);
+    wire [STREAM_WIDTH + 63 : 0]        chunkData = ({ { STREAM_WIDTH { 1'b0 } }, rowTexels } >> (chunk * TEXELS_PER_WRITE * PIXEL_WIDTH))
+                                                    << (lane * PIXEL_WIDTH);
+    wire [TEXELS_PER_WRITE + 3 : 0]     chunkMask = ((1 << chunkTexels) - 1) << lane;
+
+    wire [ 7 : 0]                       lastBlockX = (levelWidth > 2) ? (8'h1 << (levelWidth - 2)) - 1 : 0;
+    wire [ 7 : 0]                       lastBlockY = (levelHeight > 2) ? (8'h1 << (levelHeight - 2)) - 1 : 0;
+
+    always @(posedge aclk)
+    begin
+        if (!resetn)
+        begin
+            state <= FILL;
+            buffer <= 0;
+            bufferBits <= 0;
+            bufferLast <= 0;
+            levelInit <= 1;
+            m_write <= 0;
+        end
+        else
+        begin
+            m_write <= 0;
+            case (state)
+                FILL:
+                begin
+                    if (bufferBits >= BLOCK_WIDTH)
+                    begin
+                        state <= PALETTE;
+                    end
+                    else if (s_axis_tvalid && s_axis_tready)
+                    begin
+                        buffer <= bufferAppend[0 +: BUFFER_WIDTH];
+                        bufferBits <= bufferBits + STREAM_WIDTH[BUFFER_BITS_WIDTH - 1 : 0];
+                        bufferLast <= s_axis_tlast;
+                        if (levelInit)
+                        begin
+                            levelInit <= 0;
+                            levelOffset <= 0;
+                            levelWidth <= confTextureSizeWidth;
+                            levelHeight <= confTextureSizeHeight;
+                            blockX <= 0;
+                            blockY <= 0;
+                        end
+                    end
+                end
+                PALETTE:
+                begin : BuildPalette
+                    reg [15 : 0] c0;
+                    reg [15 : 0] c1;
+                    c0 = buffer[0 +: 16];
+                    c1 = buffer[16 +: 16];
+                    palette[0] <= ConvertColor(c0, 1, confEnableAlpha);
+                    palette[1] <= ConvertColor(c1, 1, confEnableAlpha);
+                    if (c0 > c1)
+                    begin
+                        palette[2] <= ConvertColor(Interpolate3(c0, c1), 1, confEnableAlpha);
+                        palette[3] <= ConvertColor(Interpolate3(c1, c0), 1, confEnableAlpha);
+                    end
+                    else
+                    begin
+                        // Three color mode. The fourth color is black or transparent.
+                        palette[2] <= ConvertColor(Interpolate2(c0, c1), 1, confEnableAlpha);
+                        palette[3] <= ConvertColor(16'h0, 0, confEnableAlpha);
+                    end
+                    indices <= buffer[32 +: 32];
+                    row <= 0;
+                    chunk <= 0;
+                    state <= WRITE;
+                end
+                WRITE:
+                begin
+                    m_write <= rowValid;
+                    m_writeAddr <= chunkAddr[TEXELS_PER_WRITE_LG +: TEX_ADDR_WIDTH - TEXELS_PER_WRITE_LG];
+                    m_writeData <= chunkData[0 +: STREAM_WIDTH];
+                    m_writeMask <= chunkMask[0 +: TEXELS_PER_WRITE];
+
+                    if (chunk == lastChunk)
+                    begin
+                        chunk <= 0;
+                        row <= row + 1;
+                        if (row == 3)
+                        begin
+                            // Block done, select the next block
+                            buffer <= buffer >> BLOCK_WIDTH;
+                            bufferBits <= bufferBits - BLOCK_WIDTH[BUFFER_BITS_WIDTH - 1 : 0];
+                            if (bufferLast && (bufferBits == BLOCK_WIDTH[BUFFER_BITS_WIDTH - 1 : 0]))
+                            begin
+                                bufferLast <= 0;
+                                levelInit <= 1;
+                            end
+
+                            if (blockX == lastBlockX)
+                            begin
+                                blockX <= 0;
+                                if (blockY == lastBlockY)
+                                begin
+                                    // Level done, select the next mipmap level
+                                    blockY <= 0;
+                                    levelOffset <= levelOffset + ({ { (TEX_ADDR_WIDTH - 1) { 1'b0 } }, 1'b1 } << ({ 1'b0, levelWidth } + { 1'b0, levelHeight }));
+                                    levelWidth <= (levelWidth != 0) ? levelWidth - 1 : 0;
+                                    levelHeight <= (levelHeight != 0) ? levelHeight - 1 : 0;
+                                end
+                                else
+                                begin
+                                    blockY <= blockY + 1;
+                                end
+                            end
+                            else
+                            begin
+                                blockX <= blockX + 1;
+                            end
+                            state <= FILL;
+                        end
+                    end
+                    else
+                    begin
+                        chunk <= chunk + 1;
+                    end
+                end
+                default:
+                begin
+                    state <= FILL;
+                end
+            endcase
+        end
+    end
+
+endmodule
@@ -19,7 +19,9 @@
 
 // Texture buffer which stores a whole texture. When reading a texel, the texture buffer
 // reads a texel quad with the neighbored texels. Additionally it returns the sub pixel 
-// coordinates which later can be used for texture filtering
+// coordinates which later can be used for texture filtering.
+// Compressed textures (DXT1) are decoded and paletted textures are expanded while
+// they are written into the buffer.
 // Pipelined: yes
 // Depth: 2 cycle
 module TextureBuffer #(
@@ -30,6 +32,12 @@ module TextureBuffer #(
 
     parameter ENABLE_LOD = 1,
 
+    // Enables the decoder for compressed textures
+    parameter ENABLE_TEXTURE_COMPRESSION = 1,
+
+    // Enables the palette lookup for paletted textures
+    parameter ENABLE_PALETTED_TEXTURES = 1,
+
     localparam NUMBER_OF_SUB_PIXELS = 4,
 
     parameter PIXEL_WIDTH = 32,
@@ -51,6 +59,8 @@ module TextureBuffer #(
     input  wire                             resetn,
 
     input  wire [ 3 : 0]                    confPixelFormat,
+    input  wire [ 3 : 0]                    confTextureSizeWidth,
+    input  wire [ 3 : 0]                    confTextureSizeHeight,
 
     // Texture Read
     input  wire [TEX_ADDR_WIDTH - 1 : 0]    texelAddr00,
@@ -64,6 +74,7 @@ module TextureBuffer #(
 
     // Texture Write
     input  wire                             s_axis_tvalid,
+    output wire                             s_axis_tready,
     input  wire                             s_axis_tlast,
     input  wire [STREAM_WIDTH - 1 : 0]      s_axis_tdata
 );
@@ -122,7 +133,19 @@ module TextureBuffer #(
 
     `Expand(Expand, SUB_PIXEL_WIDTH_INT, SUB_PIXEL_WIDTH, NUMBER_OF_SUB_PIXELS)
 
+    localparam TEXELS_PER_WRITE = STREAM_WIDTH / PIXEL_WIDTH_INT;
+
     reg  [ADDR_WIDTH - 1 : 0]           memWriteAddr = 0;
+    wire                                memWrite;
+    wire [ADDR_WIDTH - 1 : 0]           memWriteAddrSel;
+    wire [STREAM_WIDTH - 1 : 0]         memWriteData;
+    wire [TEXELS_PER_WRITE - 1 : 0]     memWriteMask;
+    wire [(TEXELS_PER_WRITE / 2) - 1 : 0] memWriteMaskEven;
+    wire [(TEXELS_PER_WRITE / 2) - 1 : 0] memWriteMaskOdd;
+    wire                                confCompressed;
+    wire                                confPaletted;
+    wire                                confFormatRgb565;
+    wire                                confFormatRgba5551;
     reg  [TEX_ADDR_WIDTH - 1 : 0]       texelAddrForDecoding00;
     reg  [TEX_ADDR_WIDTH - 1 : 0]       texelAddrForDecoding01;
     reg  [TEX_ADDR_WIDTH - 1 : 0]       texelAddrForDecoding10;
@@ -157,9 +180,9 @@ module TextureBuffer #(
         .reset(!resetn),
 
         .writeData(tdataEvenS),
-        .write(s_axis_tvalid),
-        .writeAddr((s_axis_tvalid) ? memWriteAddr : memReadAddrEven1),
-        .writeMask({(STREAM_WIDTH_HALF / PIXEL_WIDTH_INT){1'b1}}),
+        .write(memWrite),
+        .writeAddr((memWrite) ? memWriteAddrSel : memReadAddrEven1),
+        .writeMask(memWriteMaskEven),
         .writeDataOut(memReadDataEven1),
 
         .readData(memReadDataEven0),
@@ -177,9 +200,9 @@ module TextureBuffer #(
         .reset(!resetn),
 
         .writeData(tdataOddS),
-        .write(s_axis_tvalid),
-        .writeAddr((s_axis_tvalid) ? memWriteAddr : memReadAddrOdd1),
-        .writeMask({(STREAM_WIDTH_HALF / PIXEL_WIDTH_INT){1'b1}}),
+        .write(memWrite),
+        .writeAddr((memWrite) ? memWriteAddrSel : memReadAddrOdd1),
+        .writeMask(memWriteMaskOdd),
         .writeDataOut(memReadDataOdd1),
 
         .readData(memReadDataOdd0),
@@ -209,6 +232,15 @@ module TextureBuffer #(
     //////////////////////////////////////////////
     // Demux RAM adress and expand pixels
     //////////////////////////////////////////////
+    // The compressed formats are decoded into RGB565 and RGBA5551 texels.
+    // The paletted formats are expanded into the format of the palette.
+    assign confFormatRgb565 = (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB565)
+        || (confCompressed && (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB_DXT1))
+        || (confPaletted && (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_INDEX8_RGB565));
+    assign confFormatRgba5551 = (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA5551)
+        || (confCompressed && (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA_DXT1))
+        || (confPaletted && (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_INDEX8_RGBA5551));
+
     // Demux the RAM access and access the texels in the read vector
     generate
         if (STREAM_WIDTH == 32)
@@ -244,18 +276,18 @@ module TextureBuffer #(
         end
     endgenerate
 
-    assign texelOutput00 = (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB565)  ? RGB565TO8888(texelSelect00)
-                                                                                    : (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA5551) ? RGBA5551TO8888(texelSelect00) 
-                                                                                                                                                : Expand(texelSelect00);
-    assign texelOutput01 = (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB565)  ? RGB565TO8888(texelSelect01)
-                                                                                    : (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA5551) ? RGBA5551TO8888(texelSelect01) 
-                                                                                                                                                : Expand(texelSelect01);
-    assign texelOutput10 = (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB565)  ? RGB565TO8888(texelSelect10)
-                                                                                    : (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA5551) ? RGBA5551TO8888(texelSelect10) 
-                                                                                                                                                : Expand(texelSelect10);
-    assign texelOutput11 = (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB565)  ? RGB565TO8888(texelSelect11)
-                                                                                    : (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA5551) ? RGBA5551TO8888(texelSelect11) 
-                                                                                                                                                : Expand(texelSelect11);
+    assign texelOutput00 = (confFormatRgb565)   ? RGB565TO8888(texelSelect00)
+                           : (confFormatRgba5551) ? RGBA5551TO8888(texelSelect00)
+                                                  : Expand(texelSelect00);
+    assign texelOutput01 = (confFormatRgb565)   ? RGB565TO8888(texelSelect01)
+                           : (confFormatRgba5551) ? RGBA5551TO8888(texelSelect01)
+                                                  : Expand(texelSelect01);
+    assign texelOutput10 = (confFormatRgb565)   ? RGB565TO8888(texelSelect10)
+                           : (confFormatRgba5551) ? RGBA5551TO8888(texelSelect10)
+                                                  : Expand(texelSelect10);
+    assign texelOutput11 = (confFormatRgb565)   ? RGB565TO8888(texelSelect11)
+                           : (confFormatRgba5551) ? RGBA5551TO8888(texelSelect11)
+                                                  : Expand(texelSelect11);
 
     //////////////////////////////////////////////
     // AXIS Interface
@@ -269,7 +301,7 @@ module TextureBuffer #(
         end
         else
         begin
-            if (s_axis_tvalid)
+            if (s_axis_tvalid && !confCompressed && !confPaletted)
             begin
                 if (s_axis_tlast)
                 begin
@@ -283,6 +315,107 @@ module TextureBuffer #(
         end
     end
 
+    wire                                                        decoderWrite;
+    wire [TEX_ADDR_WIDTH - $clog2(TEXELS_PER_WRITE) - 1 : 0]    decoderWriteAddr;
+    wire [STREAM_WIDTH - 1 : 0]                                 decoderWriteData;
+    wire [TEXELS_PER_WRITE - 1 : 0]                             decoderWriteMask;
+    wire                                                        decoderTready;
+
+    wire                                                        paletteWrite;
+    wire [TEX_ADDR_WIDTH - $clog2(TEXELS_PER_WRITE) - 1 : 0]    paletteWriteAddr;
+    wire [STREAM_WIDTH - 1 : 0]                                 paletteWriteData;
+    wire [TEXELS_PER_WRITE - 1 : 0]                             paletteWriteMask;
+    wire                                                        paletteTready;
+
+    generate
+        if (ENABLE_TEXTURE_COMPRESSION)
+        begin
+            assign confCompressed = (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGB_DXT1)
+                || (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA_DXT1);
+
+            TextureBlockDecoder #(
+                .STREAM_WIDTH(STREAM_WIDTH),
+                .TEX_ADDR_WIDTH(TEX_ADDR_WIDTH)
+            ) textureBlockDecoder (
+                .aclk(aclk),
+                .resetn(resetn),
+
+                .confEnableAlpha(confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_RGBA_DXT1),
+                .confTextureSizeWidth(confTextureSizeWidth),
+                .confTextureSizeHeight(confTextureSizeHeight),
+
+                .s_axis_tvalid(s_axis_tvalid && confCompressed),
+                .s_axis_tready(decoderTready),
+                .s_axis_tlast(s_axis_tlast),
+                .s_axis_tdata(s_axis_tdata),
+
+                .m_write(decoderWrite),
+                .m_writeAddr(decoderWriteAddr),
+                .m_writeData(decoderWriteData),
+                .m_writeMask(decoderWriteMask)
+            );
+        end
+        else
+        begin
+            assign confCompressed = 0;
+            assign decoderTready = 1;
+            assign decoderWrite = 0;
+            assign decoderWriteAddr = 0;
+            assign decoderWriteData = 0;
+            assign decoderWriteMask = 0;
+        end
+
+        if (ENABLE_PALETTED_TEXTURES)
+        begin
+            assign confPaletted = (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_INDEX8_RGBA4444)
+                || (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_INDEX8_RGBA5551)
+                || (confPixelFormat == RENDER_CONFIG_TMU_TEXTURE_PIXEL_FORMAT_INDEX8_RGB565);
+
+            TexturePaletteDecoder #(
+                .STREAM_WIDTH(STREAM_WIDTH),
+                .TEX_ADDR_WIDTH(TEX_ADDR_WIDTH)
+            ) texturePaletteDecoder (
+                .aclk(aclk),
+                .resetn(resetn),
+
+                .s_axis_tvalid(s_axis_tvalid && confPaletted),
+                .s_axis_tready(paletteTready),
+                .s_axis_tlast(s_axis_tlast),
+                .s_axis_tdata(s_axis_tdata),
+
+                .m_write(paletteWrite),
+                .m_writeAddr(paletteWriteAddr),
+                .m_writeData(paletteWriteData),
+                .m_writeMask(paletteWriteMask)
+            );
+        end
+        else
+        begin
+            assign confPaletted = 0;
+            assign paletteTready = 1;
+            assign paletteWrite = 0;
+            assign paletteWriteAddr = 0;
+            assign paletteWriteData = 0;
+            assign paletteWriteMask = 0;
+        end
+    endgenerate
+
+    assign s_axis_tready = (confCompressed) ? decoderTready
+                         : (confPaletted)   ? paletteTready
+                                            : 1;
+    assign memWrite = (confCompressed) ? decoderWrite
+                    : (confPaletted)   ? paletteWrite
+                                       : s_axis_tvalid;
+    assign memWriteAddrSel = (confCompressed) ? decoderWriteAddr[0 +: ADDR_WIDTH]
+                           : (confPaletted)   ? paletteWriteAddr[0 +: ADDR_WIDTH]
+                                              : memWriteAddr;
+    assign memWriteData = (confCompressed) ? decoderWriteData
+                        : (confPaletted)   ? paletteWriteData
+                                           : s_axis_tdata;
+    assign memWriteMask = (confCompressed) ? decoderWriteMask
+                        : (confPaletted)   ? paletteWriteMask
+                                           : { TEXELS_PER_WRITE { 1'b1 } };
+
     generate 
     begin
         // Stride the incoming data. All even pixel on the X coordinate have to go to the even RAM
@@ -294,7 +427,8 @@ module TextureBuffer #(
         begin
             localparam ii = i * (PIXEL_WIDTH_INT * 2);
             localparam jj = i * PIXEL_WIDTH_INT;
-            assign tdataEvenS[jj +: PIXEL_WIDTH_INT] = s_axis_tdata[ii +: PIXEL_WIDTH_INT];
+            assign tdataEvenS[jj +: PIXEL_WIDTH_INT] = memWriteData[ii +: PIXEL_WIDTH_INT];
+            assign memWriteMaskEven[i] = memWriteMask[i * 2];
         end
 
         // Stride for the uneven RAM
@@ -302,7 +436,8 @@ module TextureBuffer #(
         begin
             localparam ii = (i * (PIXEL_WIDTH_INT * 2)) + PIXEL_WIDTH_INT;
             localparam jj = i * PIXEL_WIDTH_INT;
-            assign tdataOddS[jj +: PIXEL_WIDTH_INT] = s_axis_tdata[ii +: PIXEL_WIDTH_INT];
+            assign tdataOddS[jj +: PIXEL_WIDTH_INT] = memWriteData[ii +: PIXEL_WIDTH_INT];
+            assign memWriteMaskOdd[i] = memWriteMask[(i * 2) + 1];
         end
     end
     endgenerate
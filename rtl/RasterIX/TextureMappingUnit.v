@@ -96,6 +96,8 @@ module TextureMappingUnit
                 .resetn(resetn),
 
                 .confEnable(confTextureConfig[RENDER_CONFIG_TMU_TEXTURE_MIN_FILTER_POS +: RENDER_CONFIG_TMU_TEXTURE_MIN_FILTER_SIZE]),
+                .confMinLod(confTextureConfig[RENDER_CONFIG_TMU_TEXTURE_MIN_LOD_POS +: RENDER_CONFIG_TMU_TEXTURE_MIN_LOD_SIZE]),
+                .confMaxLod(confTextureConfig[RENDER_CONFIG_TMU_TEXTURE_MAX_LOD_POS +: RENDER_CONFIG_TMU_TEXTURE_MAX_LOD_SIZE]),
 
                 .s_valid(s_valid),
                 .s_ready(s_ready),
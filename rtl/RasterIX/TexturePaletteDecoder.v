@@ -0,0 +1,179 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Expands a stream of a paletted texture into 16 bit texels for the texture buffer.
+// The stream starts with the palette, 256 colors with 16 bit each:
+// +---------------+-----+---------------+---------------+
+// | 16'h color255 | ... | 16'h color1   | 16'h color0   |
+// +---------------+-----+---------------+---------------+
+// The palette is followed by the 8 bit indices of all mipmap levels. Each index
+// is replaced by its color and written into the texture buffer in the same order
+// as it is received. The palette is not converted, it must already be in the
+// format which the texture buffer expects.
+// s_axis_tlast marks the end of the stream. The next stream starts with a new palette.
+// The palette RAM is split into banks and replicated for every texel of a write,
+// to look up all texels of a write in one cycle.
+// Pipelined: no
+// Depth: 1 cycle per palette beat, 2 cycles per index beat
+module TexturePaletteDecoder #(
+    // Width of the stream and the write port
+    parameter STREAM_WIDTH = 64,
+
+    parameter TEX_ADDR_WIDTH = 17,
+
+    localparam PIXEL_WIDTH = 16,
+    localparam INDEX_WIDTH = 8,
+    localparam PALETTE_SIZE = 256,
+    localparam TEXELS_PER_WRITE = STREAM_WIDTH / PIXEL_WIDTH,
+    localparam TEXELS_PER_WRITE_LG = $clog2(TEXELS_PER_WRITE),
+    localparam PALETTE_BEATS = PALETTE_SIZE / TEXELS_PER_WRITE,
+    localparam PALETTE_BEATS_LG = $clog2(PALETTE_BEATS)
+)
+(
+    input  wire                                             aclk,
+    input  wire                                             resetn,
+
+    // Palette and index stream
+    input  wire                                             s_axis_tvalid,
+    output wire                                             s_axis_tready,
+    input  wire                                             s_axis_tlast,
+    input  wire [STREAM_WIDTH - 1 : 0]                      s_axis_tdata,
+
+    // Expanded texels. The address is a word address with a width of STREAM_WIDTH.
+    output reg                                              m_write,
+    output reg  [TEX_ADDR_WIDTH - TEXELS_PER_WRITE_LG - 1 : 0] m_writeAddr,
+    output reg  [STREAM_WIDTH - 1 : 0]                      m_writeData,
+    output reg  [TEXELS_PER_WRITE - 1 : 0]                  m_writeMask
+);
+    initial
+    begin
+        if (STREAM_WIDTH < 32)
+        begin
+            $error("STREAM_WIDTH must be at least 32 bit");
+            $finish;
+        end
+    end
+
+    reg                                         paletteLoad;
+    reg  [PALETTE_BEATS_LG - 1 : 0]             paletteBeat;
+
+    // An index beat contains the indices of two writes
+    reg  [STREAM_WIDTH - 1 : 0]                 indexBuffer;
+    reg                                         pending;
+    reg                                         pendingLast;
+    reg                                         half;
+    reg  [TEX_ADDR_WIDTH - TEXELS_PER_WRITE_LG - 1 : 0] writeAddr;
+
+    wire                                        paletteWrite = paletteLoad && s_axis_tvalid && s_axis_tready;
+    wire [(STREAM_WIDTH / 2) - 1 : 0]           indices = (half) ? indexBuffer[STREAM_WIDTH / 2 +: STREAM_WIDTH / 2]
+                                                                 : indexBuffer[0 +: STREAM_WIDTH / 2];
+    wire [STREAM_WIDTH - 1 : 0]                 texels;
+
+    // A new beat is accepted while the last write of the previous beat is executed
+    assign s_axis_tready = !pending || half;
+
+    generate
+        genvar lane;
+        genvar bank;
+        for (lane = 0; lane < TEXELS_PER_WRITE; lane = lane + 1)
+        begin : PaletteLane
+            wire [INDEX_WIDTH - 1 : 0]  index = indices[lane * INDEX_WIDTH +: INDEX_WIDTH];
+            wire [STREAM_WIDTH - 1 : 0] bankData;
+
+            // Bank n contains the colors (n, n + TEXELS_PER_WRITE, n + (2 * TEXELS_PER_WRITE), ...).
+            // A palette beat writes one color into every bank.
+            for (bank = 0; bank < TEXELS_PER_WRITE; bank = bank + 1)
+            begin : PaletteBank
+                reg [PIXEL_WIDTH - 1 : 0] palette [0 : PALETTE_BEATS - 1];
+
+                always @(posedge aclk)
+                begin
+                    if (paletteWrite)
+                    begin
+                        palette[paletteBeat] <= s_axis_tdata[bank * PIXEL_WIDTH +: PIXEL_WIDTH];
+                    end
+                end
+
+                assign bankData[bank * PIXEL_WIDTH +: PIXEL_WIDTH] = palette[index[TEXELS_PER_WRITE_LG +: INDEX_WIDTH - TEXELS_PER_WRITE_LG]];
+            end
+
+            assign texels[lane * PIXEL_WIDTH +: PIXEL_WIDTH] = bankData[index[0 +: TEXELS_PER_WRITE_LG] * PIXEL_WIDTH +: PIXEL_WIDTH];
+        end
+    endgenerate
+
+    always @(posedge aclk)
+    begin
+        if (!resetn)
+        begin
+            paletteLoad <= 1;
+            paletteBeat <= 0;
+            pending <= 0;
+            pendingLast <= 0;
+            half <= 0;
+            writeAddr <= 0;
+            m_write <= 0;
+        end
+        else
+        begin
+            m_write <= 0;
+            if (pending)
+            begin
+                m_write <= 1;
+                m_writeAddr <= writeAddr;
+                m_writeData <= texels;
+                m_writeMask <= { TEXELS_PER_WRITE { 1'b1 } };
+                half <= !half;
+                if (half)
+                begin
+                    pending <= 0;
+                    pendingLast <= 0;
+                    writeAddr <= (pendingLast) ? 0 : writeAddr + 1;
+                end
+                else
+                begin
+                    writeAddr <= writeAddr + 1;
+                end
+            end
+
+            if (s_axis_tvalid && s_axis_tready)
+            begin
+                if (paletteLoad)
+                begin
+                    paletteBeat <= paletteBeat + 1;
+                    if (paletteBeat == (PALETTE_BEATS - 1))
+                    begin
+                        paletteLoad <= 0;
+                    end
+                end
+                else
+                begin
+                    indexBuffer <= s_axis_tdata;
+                    pending <= 1;
+                    pendingLast <= s_axis_tlast;
+                    half <= 0;
+                end
+
+                if (s_axis_tlast)
+                begin
+                    paletteLoad <= 1;
+                    paletteBeat <= 0;
+                end
+            end
+        end
+    end
+
+endmodule
@@ -61,6 +61,8 @@ read_verilog ./../../../../RasterIX/StreamConcatFifo.v
 read_verilog ./../../../../RasterIX/StreamFramebuffer.v
 read_verilog ./../../../../RasterIX/TestFunc.v
 read_verilog ./../../../../RasterIX/TexEnv.v
+read_verilog ./../../../../RasterIX/TextureBlockDecoder.v
+read_verilog ./../../../../RasterIX/TexturePaletteDecoder.v
 read_verilog ./../../../../RasterIX/TextureBuffer.v
 read_verilog ./../../../../RasterIX/TextureFilter.v
 read_verilog ./../../../../RasterIX/TextureMappingUnit.v
@@ -0,0 +1,137 @@
+// Compares two ways to build the display lists:
+//   direct: The display lists are written directly into the buffers of the bus connector.
+//   cached: The display lists are written into cached host memory and copied into the buffers of the
+//           bus connector when they are transferred (see lib/utils/CachedBufferBusConnector.hpp).
+// With RIX_DRIVER_DMA_PROXY, the DMAProxyBusConnector is used and the frames are rendered by the hardware.
+// Otherwise the display lists are discarded and only the host side is measured.
+//
+// Usage: busBenchmark [frames] [triangles]
+//   frames: number of measured frames per path (default: 100)
+//   triangles: number of triangles per frame (default: 10000)
+
+#include "CachedBufferBusConnector.hpp"
+#include "GenericMemoryBusConnector.hpp"
+#include "MultiThreadRunner.hpp"
+#include "RIXGL.hpp"
+#include "gl.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#if defined(RIX_BUS_BENCHMARK_DMA_PROXY)
+#include "DMAProxyBusConnector.hpp"
+#endif
+
+#if !defined(RIX_BUS_BENCHMARK_DMA_PROXY)
+// Discards everything. The number of buffers is sufficient for the threaded rasterization.
+class NullBusConnector : public rr::GenericMemoryBusConnector<24, 1024 * 1024>
+{
+public:
+    void writeData(const uint8_t, const uint32_t) override { }
+    void blockUntilWriteComplete() override { }
+    bool isWriteComplete() override { return true; }
+};
+#endif
+
+static constexpr GLsizei RESOLUTION_W = 1024;
+static constexpr GLsizei RESOLUTION_H = 600;
+
+static void drawFrame(const int frame, const int triangles)
+{
+    // Small triangles in a grid over the screen. Each triangle has its own colors and texture coordinates,
+    // which results in many small writes into the display lists.
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(triangles))));
+    const float cellW = static_cast<float>(RESOLUTION_W) / columns;
+    const float cellH = static_cast<float>(RESOLUTION_H) / columns;
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glBegin(GL_TRIANGLES);
+    for (int i = 0; i < triangles; i++)
+    {
+        const float x = (i % columns) * cellW + (frame % 4);
+        const float y = (i / columns) * cellH;
+        glColor3ub(static_cast<GLubyte>(i), static_cast<GLubyte>(i >> 8), static_cast<GLubyte>(frame));
+        glTexCoord2f(0.0f, 0.0f);
+        glVertex2f(x, y);
+        glTexCoord2f(1.0f, 0.0f);
+        glVertex2f(x + cellW, y);
+        glTexCoord2f(0.0f, 1.0f);
+        glVertex2f(x, y + cellH);
+    }
+    glEnd();
+}
+
+static double run(rr::IBusConnector& busConnector, rr::IThreadRunner& workerThread, rr::IThreadRunner& uploadThread, const int frames, const int triangles)
+{
+    rr::RIXGL::createInstance(busConnector, workerThread, uploadThread);
+    rr::RIXGL::getInstance().setRenderResolution(RESOLUTION_W, RESOLUTION_H);
+
+    std::vector<GLubyte> texels(64 * 64 * 4);
+    for (std::size_t i = 0; i < texels.size(); i++)
+    {
+        texels[i] = static_cast<GLubyte>(i ^ (i >> 8));
+    }
+    GLuint texture {};
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 64, 64, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glEnable(GL_TEXTURE_2D);
+    glEnable(GL_DEPTH_TEST);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0.0, RESOLUTION_W, 0.0, RESOLUTION_H, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    // Warm up, the first frames also upload the texture
+    for (int frame = 0; frame < 3; frame++)
+    {
+        drawFrame(frame, triangles);
+        rr::RIXGL::getInstance().swapDisplayList();
+    }
+    glFinish();
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        drawFrame(frame, triangles);
+        rr::RIXGL::getInstance().swapDisplayList();
+    }
+    glFinish();
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+
+    glDeleteTextures(1, &texture);
+    rr::RIXGL::destroy();
+    return duration.count() / frames;
+}
+
+int main(int argc, char** argv)
+{
+    const int frames = (argc > 1) ? std::atoi(argv[1]) : 100;
+    const int triangles = (argc > 2) ? std::atoi(argv[2]) : 10000;
+    if ((frames <= 0) || (triangles <= 0))
+    {
+        std::printf("Usage: %s [frames] [triangles]\n", argv[0]);
+        return 1;
+    }
+
+#if defined(RIX_BUS_BENCHMARK_DMA_PROXY)
+    static rr::DMAProxyBusConnector busConnector {};
+#else
+    static NullBusConnector busConnector {};
+#endif
+    static rr::CachedBufferBusConnector cachedBusConnector { busConnector };
+    rr::MultiThreadRunner workerThread {};
+    rr::MultiThreadRunner uploadThread {};
+
+    std::printf("%d frames with %d triangles\n", frames, triangles);
+    const double direct = run(busConnector, workerThread, uploadThread, frames, triangles);
+    std::printf("direct: %.3f ms per frame\n", direct);
+    const double cached = run(cachedBusConnector, workerThread, uploadThread, frames, triangles);
+    std::printf("cached: %.3f ms per frame\n", cached);
+
+    // The runners start a thread on construction, which must be joined
+    workerThread.wait();
+    uploadThread.wait();
+    return 0;
+}
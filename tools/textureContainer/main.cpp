@@ -0,0 +1,191 @@
+// Converts an image into a texture container (see lib/gl/TextureContainer.hpp).
+// The image is converted by the same code which converts the textures of glTexImage2D.
+// The tool must be built with the same RIX_CORE_* configuration as the target, because
+// the container depends on the page size, the maximum texture size and the mipmapping.
+//
+// Usage: textureContainer [-f format] [-m] input.ppm|input.pam output.rixt
+//   -f format: rgb, rgba, rgba1, luminance, luminance_alpha, alpha or intensity (default: rgba)
+//   -m: generates the mipmap levels
+// The input is a binary PPM (P6) or PAM (P7 with the depth 3 or 4) image with 8 bit per channel.
+
+#include "GenericMemoryBusConnector.hpp"
+#include "NoThreadRunner.hpp"
+#include "RIXGL.hpp"
+#include "gl.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Discards everything, the texture is only converted. The number of buffers is sufficient for the threaded rasterization.
+class NullBusConnector : public rr::GenericMemoryBusConnector<24, 256 * 1024>
+{
+public:
+    void writeData(const uint8_t, const uint32_t) override { }
+    void blockUntilWriteComplete() override { }
+    bool isWriteComplete() override { return true; }
+};
+
+struct Image
+{
+    std::size_t width { 0 };
+    std::size_t height { 0 };
+    std::size_t depth { 0 };
+    std::vector<uint8_t> pixels {};
+};
+
+static bool readToken(std::istream& in, std::string& token)
+{
+    // Skips white spaces and comments
+    token.clear();
+    char c {};
+    while (in.get(c))
+    {
+        if (c == '#')
+        {
+            std::string comment {};
+            std::getline(in, comment);
+        }
+        else if (!std::isspace(static_cast<unsigned char>(c)))
+        {
+            token.push_back(c);
+            break;
+        }
+    }
+    while (in.get(c) && !std::isspace(static_cast<unsigned char>(c)))
+    {
+        token.push_back(c);
+    }
+    return !token.empty();
+}
+
+static bool readImage(const char* path, Image& image)
+{
+    std::ifstream in { path, std::ios::binary };
+    std::string token {};
+    if (!in || !readToken(in, token))
+    {
+        return false;
+    }
+    std::size_t maxVal { 0 };
+    if (token == "P6")
+    {
+        std::string w {}, h {}, m {};
+        if (!readToken(in, w) || !readToken(in, h) || !readToken(in, m))
+        {
+            return false;
+        }
+        image.width = std::stoul(w);
+        image.height = std::stoul(h);
+        image.depth = 3;
+        maxVal = std::stoul(m);
+    }
+    else if (token == "P7")
+    {
+        std::map<std::string, std::string> header {};
+        std::string key {};
+        while (readToken(in, key) && (key != "ENDHDR"))
+        {
+            std::string value {};
+            std::getline(in, value);
+            header[key] = value;
+        }
+        image.width = std::stoul(header["WIDTH"]);
+        image.height = std::stoul(header["HEIGHT"]);
+        image.depth = std::stoul(header["DEPTH"]);
+        maxVal = std::stoul(header["MAXVAL"]);
+    }
+    if ((maxVal != 255) || (image.width == 0) || (image.height == 0) || ((image.depth != 3) && (image.depth != 4)))
+    {
+        return false;
+    }
+    image.pixels.resize(image.width * image.height * image.depth);
+    in.read(reinterpret_cast<char*>(image.pixels.data()), image.pixels.size());
+    return static_cast<std::size_t>(in.gcount()) == image.pixels.size();
+}
+
+int main(int argc, char** argv)
+{
+    static const std::map<std::string, GLint> formats {
+        { "rgb", GL_RGB },
+        { "rgba", GL_RGBA },
+        { "rgba1", GL_RGB5_A1 },
+        { "luminance", GL_LUMINANCE },
+        { "luminance_alpha", GL_LUMINANCE_ALPHA },
+        { "alpha", GL_ALPHA },
+        { "intensity", GL_INTENSITY },
+    };
+    GLint internalFormat { GL_RGBA };
+    bool mipmap { false };
+    std::vector<const char*> files {};
+    for (int i = 1; i < argc; i++)
+    {
+        if ((std::strcmp(argv[i], "-f") == 0) && ((i + 1) < argc) && formats.count(argv[i + 1]))
+        {
+            internalFormat = formats.at(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "-m") == 0)
+        {
+            mipmap = true;
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.size() != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-f rgb|rgba|rgba1|luminance|luminance_alpha|alpha|intensity] [-m] input.ppm|input.pam output.rixt" << std::endl;
+        return 1;
+    }
+
+    Image image {};
+    if (!readImage(files[0], image))
+    {
+        std::cerr << "Unable to read " << files[0] << ". Only binary PPM and PAM images with 8 bit per channel are supported." << std::endl;
+        return 1;
+    }
+
+    static NullBusConnector busConnector {};
+    rr::NoThreadRunner workerThread {};
+    rr::NoThreadRunner uploadThread {};
+    rr::RIXGL::createInstance(busConnector, workerThread, uploadThread);
+    // Nothing is drawn. A small resolution keeps the display lists small.
+    rr::RIXGL::getInstance().setRenderResolution(64, 64);
+
+    GLuint texture {};
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, mipmap ? GL_TRUE : GL_FALSE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D,
+        0,
+        internalFormat,
+        static_cast<GLsizei>(image.width),
+        static_cast<GLsizei>(image.height),
+        0,
+        (image.depth == 4) ? GL_RGBA : GL_RGB,
+        GL_UNSIGNED_BYTE,
+        image.pixels.data());
+    const GLenum error = glGetError();
+    const std::vector<uint8_t> container = rr::RIXGL::getInstance().saveTextureContainer();
+    rr::RIXGL::destroy();
+    if ((error != GL_NO_ERROR) || container.empty())
+    {
+        std::cerr << "Unable to convert " << files[0] << " (error 0x" << std::hex << error << ")" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out { files[1], std::ios::binary };
+    out.write(reinterpret_cast<const char*>(container.data()), container.size());
+    if (!out)
+    {
+        std::cerr << "Unable to write " << files[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
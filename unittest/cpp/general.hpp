@@ -19,6 +19,8 @@
 #include "../3rdParty/catch.hpp"
 
 // Include common routines
+#include <cstdint>
+#include <type_traits>
 #include <verilated.h>
 
 namespace rr::ut
@@ -42,4 +44,32 @@ void reset(T* t)
     clk(t);
 }
 
+// Verilator uses integers for ports with up to 64 bit and VlWide for wider ports.
+// These functions access a 32 bit word of a port of any width.
+template <typename T>
+void setWord(T& port, const std::size_t index, const uint32_t word)
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        port = (port & ~(static_cast<T>(0xffff'ffff) << (index * 32))) | (static_cast<T>(word) << (index * 32));
+    }
+    else
+    {
+        port[index] = word;
+    }
+}
+
+template <typename T>
+uint32_t getWord(const T& port, const std::size_t index)
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        return static_cast<uint32_t>(port >> (index * 32));
+    }
+    else
+    {
+        return port[index];
+    }
+}
+
 } // namespace rr::ut
\ No newline at end of file
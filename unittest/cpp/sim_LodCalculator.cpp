@@ -19,6 +19,7 @@
 // #include "../Unittests/3rdParty/catch.hpp"
 
 #include "general.hpp"
+#include <algorithm>
 
 // Include model header, generated from Verilating "top.v"
 #include "VLodCalculator.h"
@@ -27,6 +28,7 @@ TEST_CASE("Check max lod", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -46,6 +48,7 @@ TEST_CASE("Check lod xy", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -69,6 +72,7 @@ TEST_CASE("Check lod x", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -93,6 +97,7 @@ TEST_CASE("Check lod y", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -117,6 +122,7 @@ TEST_CASE("Check lod xy negative", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -141,6 +147,7 @@ TEST_CASE("Check lod xy max with varying texture size", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -165,6 +172,7 @@ TEST_CASE("Check lod xy 0 with varying texture size", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -189,6 +197,7 @@ TEST_CASE("Check lod xy 0 with varying values", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -217,6 +226,7 @@ TEST_CASE("Check lod xy when calculation is disabled", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = false;
 
@@ -241,6 +251,7 @@ TEST_CASE("Check stall", "[LodCalculator]")
 {
     VLodCalculator* t = new VLodCalculator();
     t->m_ready = 1;
+    t->confMaxLod = 15;
 
     t->confEnable = true;
 
@@ -278,4 +289,34 @@ TEST_CASE("Check stall", "[LodCalculator]")
     REQUIRE(t->m_user == 0);
     REQUIRE(t->m_valid == 0);
     REQUIRE(t->s_ready == 1);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Check lod clamping", "[LodCalculator]")
+{
+    VLodCalculator* t = new VLodCalculator();
+    t->m_ready = 1;
+
+    t->confEnable = true;
+    t->confMinLod = 2;
+    t->confMaxLod = 5;
+
+    t->s_textureSizeWidth = 8;
+    t->s_textureSizeHeight = 8;
+
+    t->s_texelS = 0x1 << (15 - 8);
+    t->s_texelT = 0x1 << (15 - 8);
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        t->s_texelSxy = 0x1 << (15 - i);
+        t->s_texelTxy = 0x1 << (15 - i);
+
+        rr::ut::clk(t);
+
+        REQUIRE(t->m_lod == std::clamp<uint32_t>(8 - i, 2, 5));
+    }
+
+    // Without min filter, the min lod is used
+    t->confEnable = false;
+    rr::ut::clk(t);
+    REQUIRE(t->m_lod == 2);
+}
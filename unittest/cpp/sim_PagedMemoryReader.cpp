@@ -23,11 +23,43 @@
 // Include model header, generated from Verilating "top.v"
 #include "VPagedMemoryReader.h"
 
+namespace
+{
+
+// The data width of the model. It is selected with -GDATA_WIDTH when verilating.
+static constexpr std::size_t DATA_WIDTH { sizeof(VPagedMemoryReader::m_axis_tdata) * 8 };
+static constexpr std::size_t BYTES_PER_BEAT { DATA_WIDTH / 8 };
+
+// Every word of a beat gets a different value
+template <typename T>
+void setBeat(T& port, const std::size_t value)
+{
+    for (std::size_t i = 0; i < (DATA_WIDTH / 32); i++)
+    {
+        rr::ut::setWord(port, i, static_cast<uint32_t>(value + (i << 20)));
+    }
+}
+
+template <typename T>
+bool isBeat(const T& port, const std::size_t value)
+{
+    for (std::size_t i = 0; i < (DATA_WIDTH / 32); i++)
+    {
+        if (rr::ut::getWord(port, i) != static_cast<uint32_t>(value + (i << 20)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 TEST_CASE("Read data from memory and stream it", "[VPagedMemoryReader]")
 {
-    static constexpr std::size_t BEATS { 256 };
+    static constexpr std::size_t BEATS { 1024 / BYTES_PER_BEAT };
     static constexpr std::size_t PAGE_SIZE { 2048 };
-    static constexpr std::size_t TRANSFER_SIZE { BEATS * 4 };
+    static constexpr std::size_t TRANSFER_SIZE { BEATS * BYTES_PER_BEAT };
 
     VPagedMemoryReader* t = new VPagedMemoryReader();
     auto testMemoryAddressGeneration = [t]()
@@ -67,6 +99,7 @@ TEST_CASE("Read data from memory and stream it", "[VPagedMemoryReader]")
     t->m_mem_axi_arready = 0;
     t->m_mem_axi_rvalid = 0;
     t->m_mem_axi_rlast = 0;
+    t->m_axis_tready = 1;
 
     // Reset hardware
     rr::ut::reset(t);
@@ -83,15 +116,15 @@ TEST_CASE("Read data from memory and stream it", "[VPagedMemoryReader]")
     CHECK(t->s_axis_tready == 0);
 
     // The memory data is now streamed to the axis interface
-    for (std::size_t i = 0; i < ((PAGE_SIZE * 2) / 4) - 1; i++)
+    for (std::size_t i = 0; i < ((PAGE_SIZE * 2) / BYTES_PER_BEAT) - 1; i++)
     {
         t->m_mem_axi_rlast = ((i % BEATS) == (BEATS - 1));
         t->m_mem_axi_rvalid = 1;
-        t->m_mem_axi_rdata = i;
+        setBeat(t->m_mem_axi_rdata, i);
         rr::ut::clk(t);
         CHECK(t->m_axis_tvalid == 1);
         CHECK(t->m_axis_tlast == 0);
-        CHECK(t->m_axis_tdata == i);
+        CHECK(isBeat(t->m_axis_tdata, i));
         // Make sure that the page interface is still stalling
         CHECK(t->s_axis_tready == 0);
     }
@@ -99,22 +132,216 @@ TEST_CASE("Read data from memory and stream it", "[VPagedMemoryReader]")
     // Last beat is streamed
     t->m_mem_axi_rlast = 1;
     t->m_mem_axi_rvalid = 1;
-    t->m_mem_axi_rdata = 123;
+    setBeat(t->m_mem_axi_rdata, 123);
     rr::ut::clk(t);
     CHECK(t->m_axis_tvalid == 1);
     CHECK(t->m_axis_tlast == 1);
-    CHECK(t->m_axis_tdata == 123);
+    CHECK(isBeat(t->m_axis_tdata, 123));
     // Make sure that the page interface is still stalling
     CHECK(t->s_axis_tready == 0);
 
     // Last beat is streamed
     t->m_mem_axi_rlast = 0;
     t->m_mem_axi_rvalid = 0;
-    t->m_mem_axi_rdata = 0;
+    setBeat(t->m_mem_axi_rdata, 0);
+    rr::ut::clk(t);
+    CHECK(t->m_axis_tvalid == 0);
+    CHECK(t->s_axis_tready == 0);
+
+    // The page interface is now ready again to receive new data
+    rr::ut::clk(t);
+    CHECK(t->s_axis_tready == 1);
+
+    // Destroy model
+    delete t;
+}
+
+TEST_CASE("Read only a part of a page", "[VPagedMemoryReader]")
+{
+    static constexpr std::size_t BEATS { 1024 / BYTES_PER_BEAT };
+    static constexpr std::size_t TRANSFER_SIZE { BEATS * BYTES_PER_BEAT };
+    static constexpr std::size_t BLOCKS { 2 };
+    static constexpr uint32_t ADDR { 0x1000'0400 };
+
+    VPagedMemoryReader* t = new VPagedMemoryReader();
+
+    t->s_axis_tvalid = 0;
+    t->s_axis_tlast = 0;
+
+    t->m_mem_axi_arready = 0;
+    t->m_mem_axi_rvalid = 0;
+    t->m_mem_axi_rlast = 0;
+    t->m_axis_tready = 1;
+
+    // Reset hardware
+    rr::ut::reset(t);
+    CHECK(t->m_axis_tvalid == 0);
+    CHECK(t->s_axis_tready == 1);
+
+    // Send the address with the number of blocks in the lower bits
+    t->s_axis_tvalid = 1;
+    t->s_axis_tlast = 1;
+    t->s_axis_tdata = ADDR | BLOCKS;
+    rr::ut::clk(t);
+    t->s_axis_tvalid = 0;
+    CHECK(t->s_axis_tready == 0);
+    CHECK(t->m_mem_axi_arvalid == 0);
+
+    // Only the requested blocks are read, starting at the block aligned address
+    for (std::size_t i = 0; i < BLOCKS; i++)
+    {
+        rr::ut::clk(t);
+        CHECK(t->m_mem_axi_arvalid == 1);
+        CHECK(t->m_mem_axi_araddr == (ADDR + (i * TRANSFER_SIZE)));
+
+        t->m_mem_axi_arready = 1;
+        rr::ut::clk(t);
+        CHECK(t->m_mem_axi_arvalid == 0);
+        t->m_mem_axi_arready = 0;
+    }
+    rr::ut::clk(t);
+    CHECK(t->m_mem_axi_arvalid == 0);
+    CHECK(t->s_axis_tready == 0);
+
+    // The memory data is now streamed to the axis interface
+    for (std::size_t i = 0; i < (BLOCKS * BEATS); i++)
+    {
+        t->m_mem_axi_rlast = ((i % BEATS) == (BEATS - 1));
+        t->m_mem_axi_rvalid = 1;
+        setBeat(t->m_mem_axi_rdata, i);
+        rr::ut::clk(t);
+        CHECK(t->m_axis_tvalid == 1);
+        CHECK(t->m_axis_tlast == (i == ((BLOCKS * BEATS) - 1)));
+        CHECK(isBeat(t->m_axis_tdata, i));
+    }
+
+    t->m_mem_axi_rlast = 0;
+    t->m_mem_axi_rvalid = 0;
     rr::ut::clk(t);
     CHECK(t->m_axis_tvalid == 0);
+    CHECK(t->s_axis_tready == 0);
+
     // The page interface is now ready again to receive new data
+    rr::ut::clk(t);
+    CHECK(t->s_axis_tready == 1);
+
+    // Destroy model
+    delete t;
+}
+
+TEST_CASE("Stall the stream", "[VPagedMemoryReader]")
+{
+    static constexpr std::size_t BEATS { 1024 / BYTES_PER_BEAT };
+
+    VPagedMemoryReader* t = new VPagedMemoryReader();
+
+    t->s_axis_tvalid = 0;
+    t->s_axis_tlast = 0;
+
+    t->m_mem_axi_arready = 1;
+    t->m_mem_axi_rvalid = 0;
+    t->m_mem_axi_rlast = 0;
+    t->m_axis_tready = 1;
+
+    // Reset hardware
+    rr::ut::reset(t);
+
+    // Request one block
+    t->s_axis_tvalid = 1;
+    t->s_axis_tlast = 1;
+    t->s_axis_tdata = 0x1000'0000 | 1;
+    rr::ut::clk(t);
+    t->s_axis_tvalid = 0;
+    rr::ut::clk(t);
+    rr::ut::clk(t);
+    rr::ut::clk(t);
+
+    // The first beat is stored in the output register
+    t->m_mem_axi_rvalid = 1;
+    setBeat(t->m_mem_axi_rdata, 0);
+    rr::ut::clk(t);
+    CHECK(t->m_axis_tvalid == 1);
+    CHECK(isBeat(t->m_axis_tdata, 0));
+
+    // The receiver stalls. The memory read channel must stall too.
+    t->m_axis_tready = 0;
+    setBeat(t->m_mem_axi_rdata, 1);
+    t->eval();
+    CHECK(t->m_mem_axi_rready == 0);
+    rr::ut::clk(t);
+    CHECK(t->m_axis_tvalid == 1);
+    CHECK(isBeat(t->m_axis_tdata, 0));
+
+    // Stream the remaining beats
+    t->m_axis_tready = 1;
+    for (std::size_t i = 1; i < BEATS; i++)
+    {
+        t->m_mem_axi_rlast = (i == (BEATS - 1));
+        setBeat(t->m_mem_axi_rdata, i);
+        t->eval();
+        CHECK(t->m_mem_axi_rready == 1);
+        rr::ut::clk(t);
+        CHECK(t->m_axis_tvalid == 1);
+        CHECK(isBeat(t->m_axis_tdata, i));
+        CHECK(t->m_axis_tlast == (i == (BEATS - 1)));
+    }
+    t->m_mem_axi_rvalid = 0;
+    t->m_mem_axi_rlast = 0;
+
+    // The receiver is still busy with the last beat. The page interface must wait.
+    t->m_axis_tready = 0;
+    rr::ut::clk(t);
+    rr::ut::clk(t);
+    CHECK(t->m_axis_tvalid == 1);
+    CHECK(t->s_axis_tready == 0);
+
+    t->m_axis_tready = 1;
+    rr::ut::clk(t);
+    CHECK(t->m_axis_tvalid == 0);
+    CHECK(t->s_axis_tready == 0);
+    rr::ut::clk(t);
+    CHECK(t->s_axis_tready == 1);
+
+    // Destroy model
+    delete t;
+}
+
+TEST_CASE("Only the last page of a stream waits for the receiver", "[VPagedMemoryReader]")
+{
+    VPagedMemoryReader* t = new VPagedMemoryReader();
+
+    t->s_axis_tvalid = 0;
+    t->s_axis_tlast = 0;
+
+    t->m_mem_axi_arready = 1;
+    t->m_mem_axi_rvalid = 0;
+    t->m_mem_axi_rlast = 0;
+    t->m_axis_tready = 1;
+
+    // Reset hardware
+    rr::ut::reset(t);
+
+    // Request one block of a page which is not the last page of the stream
+    t->s_axis_tvalid = 1;
+    t->s_axis_tlast = 0;
+    t->s_axis_tdata = 0x1000'0000 | 1;
+    rr::ut::clk(t);
+    t->s_axis_tvalid = 0;
+
+    // A beat is stored in the output register and the receiver stalls
+    t->m_mem_axi_rvalid = 1;
+    setBeat(t->m_mem_axi_rdata, 0);
+    rr::ut::clk(t);
+    CHECK(t->m_axis_tvalid == 1);
+    t->m_axis_tready = 0;
+    t->m_mem_axi_rvalid = 0;
+
+    // The memory request is sent. The page interface accepts the next page without waiting for the receiver.
+    rr::ut::clk(t);
+    CHECK(t->s_axis_tready == 0);
+    rr::ut::clk(t);
     CHECK(t->s_axis_tready == 1);
+    CHECK(t->m_axis_tvalid == 1);
 
     // Destroy model
     delete t;
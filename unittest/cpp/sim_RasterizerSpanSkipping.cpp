@@ -0,0 +1,314 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#define CATCH_CONFIG_MAIN // This tells Catch to provide a main() - only do this in one cpp file
+#include "../3rdParty/catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <optional>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Include common routines
+#include <verilated.h>
+
+// Include model header, generated from Verilating "top.v"
+#include "VRasterizer.h"
+
+namespace
+{
+
+static constexpr uint32_t SUB_PIXEL_BITS = 4;
+static constexpr uint32_t X_RESOLUTION = 320;
+static constexpr uint32_t Y_RESOLUTION = 240;
+// The rasterizer requires per line a few cycles to find the span, plus one cycle for the line increment
+// and one cycle for the first pixel after the span.
+static constexpr uint32_t SPAN_SEARCH_CYCLES = 8;
+static constexpr uint32_t SPAN_SKIP_MAX_JUMP = 32;
+
+using Pixel = std::pair<uint32_t, uint32_t>;
+
+struct Triangle
+{
+    std::array<int32_t, 3> x; // Sub pixel position
+    std::array<int32_t, 3> y;
+};
+
+struct Beat
+{
+    bool pixel;
+    uint32_t spx;
+    uint32_t spy;
+    uint32_t bbx;
+    uint32_t bby;
+    uint32_t index;
+
+    bool operator==(const Beat& other) const
+    {
+        return std::tie(pixel, spx, spy, bbx, bby, index) == std::tie(other.pixel, other.spx, other.spy, other.bbx, other.bby, other.index);
+    }
+};
+
+struct Result
+{
+    std::multiset<Pixel> pixels {};
+    std::vector<Beat> beats {};
+    uint32_t cycles { 0 };
+};
+
+Beat getBeat(const VRasterizer* t)
+{
+    return { t->m_rr_tpixel != 0, t->m_rr_tspx, t->m_rr_tspy, t->m_rr_tbbx, t->m_rr_tbby, t->m_rr_tindex };
+}
+
+void clk(VRasterizer* t)
+{
+    t->clk = 0;
+    t->eval();
+    t->clk = 1;
+    t->eval();
+}
+
+void reset(VRasterizer* t)
+{
+    t->reset = 1;
+    clk(t);
+    t->reset = 0;
+    clk(t);
+}
+
+int64_t edgeFunction(const int32_t ax, const int32_t ay, const int32_t bx, const int32_t by, const int32_t cx, const int32_t cy)
+{
+    return (static_cast<int64_t>(cx - ax) * (by - ay)) - (static_cast<int64_t>(cy - ay) * (bx - ax));
+}
+
+class TriangleSetup
+{
+public:
+    TriangleSetup(const Triangle& t)
+    {
+        const int64_t area = edgeFunction(t.x[0], t.y[0], t.x[1], t.y[1], t.x[2], t.y[2]);
+        const int64_t sign = (area < 0) ? -1 : 1;
+        bbStartX = *std::min_element(t.x.begin(), t.x.end()) >> SUB_PIXEL_BITS;
+        bbStartY = *std::min_element(t.y.begin(), t.y.end()) >> SUB_PIXEL_BITS;
+        bbEndX = std::min<uint32_t>((*std::max_element(t.x.begin(), t.x.end()) >> SUB_PIXEL_BITS) + 1, X_RESOLUTION);
+        bbEndY = std::min<uint32_t>((*std::max_element(t.y.begin(), t.y.end()) >> SUB_PIXEL_BITS) + 1, Y_RESOLUTION);
+        static constexpr std::array<std::array<std::size_t, 2>, 3> EDGES { { { 1, 2 }, { 2, 0 }, { 0, 1 } } };
+        for (std::size_t i = 0; i < 3; i++)
+        {
+            const std::size_t a = EDGES[i][0];
+            const std::size_t b = EDGES[i][1];
+            const auto f = [&](const int32_t px, const int32_t py)
+            {
+                return static_cast<int32_t>(sign * edgeFunction(t.x[a], t.y[a], t.x[b], t.y[b], px << SUB_PIXEL_BITS, py << SUB_PIXEL_BITS));
+            };
+            w[i] = f(bbStartX, bbStartY);
+            wIncX[i] = f(bbStartX + 1, bbStartY) - w[i];
+            wIncY[i] = f(bbStartX, bbStartY + 1) - w[i];
+        }
+    }
+
+    bool isInside(const uint32_t x, const uint32_t y) const
+    {
+        for (std::size_t i = 0; i < 3; i++)
+        {
+            const int32_t v = w[i] + (wIncX[i] * static_cast<int32_t>(x - bbStartX)) + (wIncY[i] * static_cast<int32_t>(y - bbStartY));
+            if (v < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::multiset<Pixel> getReference() const
+    {
+        std::multiset<Pixel> pixels {};
+        for (uint32_t y = bbStartY; y < bbEndY; y++)
+        {
+            for (uint32_t x = bbStartX; x < bbEndX; x++)
+            {
+                if (isInside(x, y))
+                {
+                    pixels.insert({ x, y });
+                }
+            }
+        }
+        return pixels;
+    }
+
+    uint32_t bbStartX;
+    uint32_t bbStartY;
+    uint32_t bbEndX;
+    uint32_t bbEndY;
+    std::array<int32_t, 3> w;
+    std::array<int32_t, 3> wIncX;
+    std::array<int32_t, 3> wIncY;
+};
+
+Result rasterize(VRasterizer* top, const TriangleSetup& setup, std::mt19937* stall = nullptr)
+{
+    top->yOffset = 0;
+    top->xResolution = X_RESOLUTION;
+    top->yResolution = Y_RESOLUTION;
+    top->bbStart = (setup.bbStartY << 16) | setup.bbStartX;
+    top->bbEnd = (setup.bbEndY << 16) | setup.bbEndX;
+    top->w0 = setup.w[0];
+    top->w1 = setup.w[1];
+    top->w2 = setup.w[2];
+    top->w0IncX = setup.wIncX[0];
+    top->w1IncX = setup.wIncX[1];
+    top->w2IncX = setup.wIncX[2];
+    top->w0IncY = setup.wIncY[0];
+    top->w1IncY = setup.wIncY[1];
+    top->w2IncY = setup.wIncY[2];
+
+    top->m_rr_tready = 1;
+    top->startRendering = 1;
+    clk(top);
+    top->startRendering = 0;
+    REQUIRE(top->rasterizerRunning == 1);
+
+    Result result {};
+    std::optional<Beat> stalledBeat {};
+    for (uint32_t i = 0; i < 1000000; i++)
+    {
+        // A beat which was not accepted must stay on the stream until it is accepted
+        if (stalledBeat)
+        {
+            REQUIRE(top->m_rr_tvalid);
+            REQUIRE(getBeat(top) == *stalledBeat);
+        }
+        top->m_rr_tready = stall ? ((*stall)() % 3) != 0 : 1;
+        stalledBeat.reset();
+        if (top->m_rr_tvalid && !top->m_rr_tready)
+        {
+            stalledBeat = getBeat(top);
+        }
+        if (top->m_rr_tvalid && top->m_rr_tready)
+        {
+            if (top->m_rr_tlast)
+            {
+                REQUIRE(top->m_rr_tkeep == 0);
+                return result;
+            }
+            result.beats.push_back(getBeat(top));
+            if (top->m_rr_tpixel)
+            {
+                REQUIRE(top->m_rr_tbbx == (top->m_rr_tspx - setup.bbStartX));
+                REQUIRE(top->m_rr_tbby == (top->m_rr_tspy - setup.bbStartY));
+                result.pixels.insert({ top->m_rr_tspx, top->m_rr_tspy });
+            }
+        }
+        if (top->m_rr_tready)
+        {
+            result.cycles++;
+        }
+        clk(top);
+    }
+    FAIL("Rasterizer did not terminate");
+    return result;
+}
+
+uint32_t maxCycles(const TriangleSetup& setup, const std::size_t pixels)
+{
+    const uint32_t lines = setup.bbEndY - setup.bbStartY;
+    const uint32_t width = setup.bbEndX - setup.bbStartX;
+    return pixels + (lines * ((width / SPAN_SKIP_MAX_JUMP) + SPAN_SEARCH_CYCLES)) + SPAN_SEARCH_CYCLES;
+}
+
+Triangle randomTriangle(std::mt19937& rng, const bool thin)
+{
+    Triangle t {};
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        t.x[i] = rng() % (X_RESOLUTION << SUB_PIXEL_BITS);
+        t.y[i] = rng() % (Y_RESOLUTION << SUB_PIXEL_BITS);
+    }
+    if (thin)
+    {
+        t.x[2] = std::clamp<int32_t>(t.x[0] + static_cast<int32_t>(rng() % 64) - 32, 0, (X_RESOLUTION << SUB_PIXEL_BITS) - 1);
+        t.y[2] = std::clamp<int32_t>(t.y[0] + static_cast<int32_t>(rng() % 64) - 32, 0, (Y_RESOLUTION << SUB_PIXEL_BITS) - 1);
+    }
+    return t;
+}
+
+} // namespace
+
+TEST_CASE("Rasterize a thin diagonal triangle", "[RasterizerSpanSkipping]")
+{
+    VRasterizer* top = new VRasterizer();
+    reset(top);
+
+    const Triangle t { { 2 << SUB_PIXEL_BITS, 300 << SUB_PIXEL_BITS, 303 << SUB_PIXEL_BITS }, { 3 << SUB_PIXEL_BITS, 200 << SUB_PIXEL_BITS, 196 << SUB_PIXEL_BITS } };
+    const TriangleSetup setup { t };
+    const std::multiset<Pixel> reference = setup.getReference();
+    const Result result = rasterize(top, setup);
+
+    REQUIRE(result.pixels == reference);
+    // The bounding box contains about 60000 pixels
+    REQUIRE(result.cycles <= maxCycles(setup, reference.size()));
+
+    delete top;
+}
+
+TEST_CASE("Rasterize random triangles", "[RasterizerSpanSkipping]")
+{
+    VRasterizer* top = new VRasterizer();
+    reset(top);
+
+    std::mt19937 rng { 1 };
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        const TriangleSetup setup { randomTriangle(rng, i & 1) };
+        const std::multiset<Pixel> reference = setup.getReference();
+        const Result result = rasterize(top, setup);
+
+        REQUIRE(result.pixels == reference);
+        REQUIRE(result.cycles <= maxCycles(setup, reference.size()));
+    }
+
+    delete top;
+}
+
+TEST_CASE("Rasterize triangles with stalls", "[RasterizerSpanSkipping]")
+{
+    VRasterizer* top = new VRasterizer();
+    reset(top);
+
+    std::mt19937 rng { 2 };
+    std::mt19937 stall { 3 };
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        const TriangleSetup setup { randomTriangle(rng, i & 1) };
+        const Result reference = rasterize(top, setup);
+        const Result result = rasterize(top, setup, &stall);
+
+        // The stalls must not change the stream, only delay it. The first beat is the empty beat of the
+        // triangle start, which still contains the position of the previous triangle.
+        REQUIRE(result.pixels == setup.getReference());
+        REQUIRE(result.beats.size() == reference.beats.size());
+        REQUIRE(std::equal(result.beats.begin() + 1, result.beats.end(), reference.beats.begin() + 1));
+    }
+
+    delete top;
+}
@@ -0,0 +1,260 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "general.hpp"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+// Include model header, generated from Verilating "top.v"
+#include "VTextureBlockDecoder.h"
+
+namespace
+{
+
+// The stream width of the model. It is selected with -GSTREAM_WIDTH when verilating.
+static constexpr std::size_t STREAM_WIDTH { sizeof(VTextureBlockDecoder::s_axis_tdata) * 8 };
+static constexpr std::size_t TEXELS_PER_WRITE { STREAM_WIDTH / 16 };
+static constexpr std::size_t WORDS_PER_BEAT { STREAM_WIDTH / 32 };
+
+uint16_t interpolate3(const uint16_t a, const uint16_t b)
+{
+    const uint16_t r = ((2 * ((a >> 11) & 0x1f)) + ((b >> 11) & 0x1f)) / 3;
+    const uint16_t g = ((2 * ((a >> 5) & 0x3f)) + ((b >> 5) & 0x3f)) / 3;
+    const uint16_t bl = ((2 * (a & 0x1f)) + (b & 0x1f)) / 3;
+    return (r << 11) | (g << 5) | bl;
+}
+
+uint16_t interpolate2(const uint16_t a, const uint16_t b)
+{
+    const uint16_t r = (((a >> 11) & 0x1f) + ((b >> 11) & 0x1f)) / 2;
+    const uint16_t g = (((a >> 5) & 0x3f) + ((b >> 5) & 0x3f)) / 2;
+    const uint16_t bl = ((a & 0x1f) + (b & 0x1f)) / 2;
+    return (r << 11) | (g << 5) | bl;
+}
+
+uint16_t convert(const uint16_t color, const bool alpha, const bool enableAlpha)
+{
+    if (enableAlpha)
+    {
+        return ((color >> 11) << 11) | (((color >> 6) & 0x1f) << 6) | ((color & 0x1f) << 1) | alpha;
+    }
+    return alpha ? color : 0;
+}
+
+// Reference decoder. Decodes all levels into a texel array.
+std::vector<uint16_t> decode(const std::vector<uint64_t>& blocks, std::size_t widthLg, std::size_t heightLg, const std::size_t levels, const bool enableAlpha)
+{
+    std::vector<uint16_t> texels {};
+    std::size_t block = 0;
+    for (std::size_t level = 0; level < levels; level++)
+    {
+        const std::size_t width = 1 << widthLg;
+        const std::size_t height = 1 << heightLg;
+        std::vector<uint16_t> levelTexels(width * height);
+        for (std::size_t by = 0; by < ((height + 3) / 4); by++)
+        {
+            for (std::size_t bx = 0; bx < ((width + 3) / 4); bx++)
+            {
+                const uint64_t b = blocks[block++];
+                const uint16_t c0 = b & 0xffff;
+                const uint16_t c1 = (b >> 16) & 0xffff;
+                std::array<uint16_t, 4> palette {};
+                palette[0] = convert(c0, true, enableAlpha);
+                palette[1] = convert(c1, true, enableAlpha);
+                if (c0 > c1)
+                {
+                    palette[2] = convert(interpolate3(c0, c1), true, enableAlpha);
+                    palette[3] = convert(interpolate3(c1, c0), true, enableAlpha);
+                }
+                else
+                {
+                    palette[2] = convert(interpolate2(c0, c1), true, enableAlpha);
+                    palette[3] = convert(0, false, enableAlpha);
+                }
+                for (std::size_t y = 0; y < 4; y++)
+                {
+                    for (std::size_t x = 0; x < 4; x++)
+                    {
+                        const std::size_t index = (b >> (32 + (y * 8) + (x * 2))) & 0x3;
+                        if (((bx * 4 + x) < width) && ((by * 4 + y) < height))
+                        {
+                            levelTexels[((by * 4 + y) * width) + (bx * 4) + x] = palette[index];
+                        }
+                    }
+                }
+            }
+        }
+        texels.insert(texels.end(), levelTexels.begin(), levelTexels.end());
+        widthLg = (widthLg > 0) ? widthLg - 1 : 0;
+        heightLg = (heightLg > 0) ? heightLg - 1 : 0;
+    }
+    return texels;
+}
+
+std::size_t numberOfBlocks(std::size_t widthLg, std::size_t heightLg, const std::size_t levels)
+{
+    std::size_t blocks = 0;
+    for (std::size_t level = 0; level < levels; level++)
+    {
+        blocks += (((1 << widthLg) + 3) / 4) * (((1 << heightLg) + 3) / 4);
+        widthLg = (widthLg > 0) ? widthLg - 1 : 0;
+        heightLg = (heightLg > 0) ? heightLg - 1 : 0;
+    }
+    return blocks;
+}
+
+void collectWrite(VTextureBlockDecoder* t, std::vector<uint16_t>& texels)
+{
+    if (t->m_write)
+    {
+        for (std::size_t i = 0; i < TEXELS_PER_WRITE; i++)
+        {
+            const std::size_t addr = (t->m_writeAddr * TEXELS_PER_WRITE) + i;
+            if ((t->m_writeMask & (1 << i)) && (addr < texels.size()))
+            {
+                texels[addr] = (rr::ut::getWord(t->m_writeData, i / 2) >> ((i % 2) * 16)) & 0xffff;
+            }
+        }
+    }
+}
+
+// Streams the blocks into the decoder and returns the decoded texels
+std::vector<uint16_t> stream(VTextureBlockDecoder* t, const std::vector<uint64_t>& blocks, const std::size_t texelCount, std::mt19937* stall = nullptr)
+{
+    // A block is split into several beats when the stream is narrower than a block. A wider stream
+    // contains several blocks in one beat. The last beat is padded.
+    std::vector<uint32_t> words {};
+    for (const uint64_t b : blocks)
+    {
+        words.push_back(static_cast<uint32_t>(b));
+        words.push_back(static_cast<uint32_t>(b >> 32));
+    }
+    words.resize(((words.size() + WORDS_PER_BEAT - 1) / WORDS_PER_BEAT) * WORDS_PER_BEAT);
+    const std::size_t beats = words.size() / WORDS_PER_BEAT;
+
+    std::vector<uint16_t> texels(texelCount, 0xdead);
+    for (std::size_t i = 0; i < beats;)
+    {
+        t->s_axis_tvalid = stall ? ((*stall)() % 2) : 1;
+        t->s_axis_tlast = (i == (beats - 1));
+        for (std::size_t j = 0; j < WORDS_PER_BEAT; j++)
+        {
+            rr::ut::setWord(t->s_axis_tdata, j, words[(i * WORDS_PER_BEAT) + j]);
+        }
+        t->eval();
+        if (t->s_axis_tvalid && t->s_axis_tready)
+        {
+            i++;
+        }
+        rr::ut::clk(t);
+        collectWrite(t, texels);
+    }
+    t->s_axis_tvalid = 0;
+    t->s_axis_tlast = 0;
+
+    // Wait till the decoder has processed the last block
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        rr::ut::clk(t);
+        collectWrite(t, texels);
+    }
+    CHECK(t->s_axis_tready == 1);
+    return texels;
+}
+
+std::vector<uint64_t> randomBlocks(std::mt19937& rng, const std::size_t count)
+{
+    std::vector<uint64_t> blocks(count);
+    for (uint64_t& b : blocks)
+    {
+        b = (static_cast<uint64_t>(rng()) << 32) | rng();
+    }
+    return blocks;
+}
+
+} // namespace
+
+TEST_CASE("Decode a RGB texture with mipmap levels", "[TextureBlockDecoder]")
+{
+    VTextureBlockDecoder* t = new VTextureBlockDecoder();
+    std::mt19937 rng { 1 };
+
+    // 16x8, 8x4, 4x2, 2x1, 1x1
+    t->confEnableAlpha = 0;
+    t->confTextureSizeWidth = 4;
+    t->confTextureSizeHeight = 3;
+    t->s_axis_tvalid = 0;
+    rr::ut::reset(t);
+
+    const std::vector<uint64_t> blocks = randomBlocks(rng, numberOfBlocks(4, 3, 5));
+    const std::vector<uint16_t> reference = decode(blocks, 4, 3, 5, false);
+    REQUIRE(stream(t, blocks, reference.size()) == reference);
+
+    delete t;
+}
+
+TEST_CASE("Decode a RGBA texture with transparent texels", "[TextureBlockDecoder]")
+{
+    VTextureBlockDecoder* t = new VTextureBlockDecoder();
+    std::mt19937 rng { 2 };
+
+    t->confEnableAlpha = 1;
+    t->confTextureSizeWidth = 3;
+    t->confTextureSizeHeight = 3;
+    t->s_axis_tvalid = 0;
+    rr::ut::reset(t);
+
+    std::vector<uint64_t> blocks = randomBlocks(rng, numberOfBlocks(3, 3, 4));
+    // Force the three color mode (color0 <= color1) for the first block
+    blocks[0] = 0xffff'ffff'f800'001full;
+    const std::vector<uint16_t> reference = decode(blocks, 3, 3, 4, true);
+    const std::vector<uint16_t> texels = stream(t, blocks, reference.size());
+    REQUIRE(texels == reference);
+    // All texels of the first block use index 3 which is transparent
+    CHECK(texels[0] == 0);
+
+    delete t;
+}
+
+TEST_CASE("Decode several textures with a stalling stream", "[TextureBlockDecoder]")
+{
+    VTextureBlockDecoder* t = new VTextureBlockDecoder();
+    std::mt19937 rng { 3 };
+    std::mt19937 stall { 4 };
+
+    t->confEnableAlpha = 0;
+    t->s_axis_tvalid = 0;
+    rr::ut::reset(t);
+
+    for (std::size_t i = 0; i < 10; i++)
+    {
+        // The level is reset after the last block of the stream
+        const std::size_t widthLg = rng() % 6;
+        const std::size_t heightLg = rng() % 6;
+        const std::size_t levels = (std::max)(widthLg, heightLg) + 1;
+        t->confTextureSizeWidth = widthLg;
+        t->confTextureSizeHeight = heightLg;
+
+        const std::vector<uint64_t> blocks = randomBlocks(rng, numberOfBlocks(widthLg, heightLg, levels));
+        const std::vector<uint16_t> reference = decode(blocks, widthLg, heightLg, levels, false);
+        REQUIRE(stream(t, blocks, reference.size(), &stall) == reference);
+    }
+
+    delete t;
+}
@@ -0,0 +1,198 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "general.hpp"
+#include <array>
+#include <random>
+#include <vector>
+
+// Include model header, generated from Verilating "top.v"
+#include "VTexturePaletteDecoder.h"
+
+namespace
+{
+
+// The stream width of the model. It is selected with -GSTREAM_WIDTH when verilating.
+static constexpr std::size_t STREAM_WIDTH { sizeof(VTexturePaletteDecoder::s_axis_tdata) * 8 };
+static constexpr std::size_t TEXELS_PER_WRITE { STREAM_WIDTH / 16 };
+static constexpr std::size_t INDICES_PER_BEAT { STREAM_WIDTH / 8 };
+static_assert((STREAM_WIDTH == 32) || (STREAM_WIDTH == 64), "Only a STREAM_WIDTH of 32 or 64 bit is supported by this test");
+
+void collectWrite(VTexturePaletteDecoder* t, std::vector<uint16_t>& texels)
+{
+    if (t->m_write)
+    {
+        for (std::size_t i = 0; i < TEXELS_PER_WRITE; i++)
+        {
+            const std::size_t addr = (t->m_writeAddr * TEXELS_PER_WRITE) + i;
+            if ((t->m_writeMask & (1 << i)) && (addr < texels.size()))
+            {
+                texels[addr] = (t->m_writeData >> (i * 16)) & 0xffff;
+            }
+        }
+    }
+}
+
+// Streams the palette and the indices into the decoder and returns the written texels
+std::vector<uint16_t> stream(VTexturePaletteDecoder* t, const std::array<uint16_t, 256>& palette, const std::vector<uint8_t>& indices, std::mt19937* stall = nullptr)
+{
+    std::vector<uint64_t> beats {};
+    for (std::size_t i = 0; i < palette.size(); i += TEXELS_PER_WRITE)
+    {
+        uint64_t beat = 0;
+        for (std::size_t j = 0; j < TEXELS_PER_WRITE; j++)
+        {
+            beat |= static_cast<uint64_t>(palette[i + j]) << (j * 16);
+        }
+        beats.push_back(beat);
+    }
+    for (std::size_t i = 0; i < indices.size(); i += INDICES_PER_BEAT)
+    {
+        uint64_t beat = 0;
+        for (std::size_t j = 0; j < INDICES_PER_BEAT; j++)
+        {
+            beat |= static_cast<uint64_t>(indices[i + j]) << (j * 8);
+        }
+        beats.push_back(beat);
+    }
+
+    std::vector<uint16_t> texels(indices.size(), 0xdead);
+    for (std::size_t i = 0; i < beats.size();)
+    {
+        t->s_axis_tvalid = stall ? ((*stall)() % 2) : 1;
+        t->s_axis_tlast = (i == (beats.size() - 1));
+        t->s_axis_tdata = beats[i];
+        t->eval();
+        if (t->s_axis_tvalid && t->s_axis_tready)
+        {
+            i++;
+        }
+        rr::ut::clk(t);
+        collectWrite(t, texels);
+    }
+    t->s_axis_tvalid = 0;
+    t->s_axis_tlast = 0;
+
+    // Wait till the decoder has written the last texels
+    for (std::size_t i = 0; i < 10; i++)
+    {
+        rr::ut::clk(t);
+        collectWrite(t, texels);
+    }
+    CHECK(t->s_axis_tready == 1);
+    return texels;
+}
+
+std::array<uint16_t, 256> randomPalette(std::mt19937& rng)
+{
+    std::array<uint16_t, 256> palette {};
+    for (uint16_t& c : palette)
+    {
+        c = rng() & 0xffff;
+    }
+    return palette;
+}
+
+std::vector<uint8_t> randomIndices(std::mt19937& rng, const std::size_t count)
+{
+    std::vector<uint8_t> indices(count);
+    for (uint8_t& i : indices)
+    {
+        i = rng() & 0xff;
+    }
+    return indices;
+}
+
+std::vector<uint16_t> expand(const std::array<uint16_t, 256>& palette, const std::vector<uint8_t>& indices)
+{
+    std::vector<uint16_t> texels {};
+    for (const uint8_t i : indices)
+    {
+        texels.push_back(palette[i]);
+    }
+    return texels;
+}
+
+} // namespace
+
+TEST_CASE("Expand a paletted texture", "[TexturePaletteDecoder]")
+{
+    VTexturePaletteDecoder* t = new VTexturePaletteDecoder();
+    std::mt19937 rng { 1 };
+
+    t->s_axis_tvalid = 0;
+    rr::ut::reset(t);
+
+    // 32x32 texture with all mipmap levels, padded to a whole beat
+    const std::array<uint16_t, 256> palette = randomPalette(rng);
+    const std::vector<uint8_t> indices = randomIndices(rng, 1368);
+    REQUIRE(stream(t, palette, indices) == expand(palette, indices));
+
+    delete t;
+}
+
+TEST_CASE("Expand several paletted textures with a stalling stream", "[TexturePaletteDecoder]")
+{
+    VTexturePaletteDecoder* t = new VTexturePaletteDecoder();
+    std::mt19937 rng { 2 };
+    std::mt19937 stall { 3 };
+
+    t->s_axis_tvalid = 0;
+    rr::ut::reset(t);
+
+    for (std::size_t i = 0; i < 10; i++)
+    {
+        // Every stream starts with a new palette and writes from address zero
+        const std::array<uint16_t, 256> palette = randomPalette(rng);
+        const std::vector<uint8_t> indices = randomIndices(rng, INDICES_PER_BEAT * ((rng() % 64) + 1));
+        REQUIRE(stream(t, palette, indices, &stall) == expand(palette, indices));
+    }
+
+    delete t;
+}
+
+TEST_CASE("Start with a new palette after a stream which ended in the palette", "[TexturePaletteDecoder]")
+{
+    VTexturePaletteDecoder* t = new VTexturePaletteDecoder();
+    std::mt19937 rng { 4 };
+
+    t->s_axis_tvalid = 0;
+    rr::ut::reset(t);
+
+    // A stream which ends before the palette is complete must not write texels
+    for (std::size_t i = 0; i < 10; i++)
+    {
+        t->s_axis_tvalid = 1;
+        t->s_axis_tlast = (i == 9);
+        t->s_axis_tdata = static_cast<decltype(t->s_axis_tdata)>(~0ull);
+        t->eval();
+        REQUIRE(t->s_axis_tready == 1);
+        rr::ut::clk(t);
+        REQUIRE(t->m_write == 0);
+    }
+    t->s_axis_tvalid = 0;
+    t->s_axis_tlast = 0;
+    rr::ut::clk(t);
+    REQUIRE(t->m_write == 0);
+
+    // The tlast resets the palette, the next stream loads its palette from the first color
+    const std::array<uint16_t, 256> palette = randomPalette(rng);
+    const std::vector<uint8_t> indices = randomIndices(rng, INDICES_PER_BEAT * 8);
+    REQUIRE(stream(t, palette, indices) == expand(palette, indices));
+
+    delete t;
+}
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <array>
 #include <math.h>
+#include <vector>
 
 // Include model header, generated from Verilating "top.v"
 #include "VTextureSamplerTestModule.h"
@@ -1002,4 +1003,160 @@ TEST_CASE("Check stall", "[TextureBuffer]")
 
     // Destroy model
     delete top;
-}
\ No newline at end of file
+}
+
+void uploadPalettedTexture(VTextureSamplerTestModule* top, const std::array<uint16_t, 256>& palette, const uint32_t indices)
+{
+    // 2x2 texture with RGBA4444 palette
+    top->textureSizeWidth = 0x1;
+    top->textureSizeHeight = 0x1;
+    top->confPixelFormat = 5; // INDEX8_RGBA4444
+
+    std::vector<uint32_t> stream {};
+    for (std::size_t i = 0; i < palette.size(); i += 2)
+    {
+        stream.push_back((static_cast<uint32_t>(palette[i + 1]) << 16) | palette[i]);
+    }
+    stream.push_back(indices);
+
+    // The palette decoder requires two cycles per index beat. Wait for s_axis_tready.
+    for (std::size_t i = 0; i < stream.size();)
+    {
+        top->s_axis_tvalid = 1;
+        top->s_axis_tlast = (i == (stream.size() - 1));
+        top->s_axis_tdata = stream[i];
+        top->eval();
+        if (top->s_axis_tready)
+        {
+            i++;
+        }
+        rr::ut::clk(top);
+    }
+    top->s_axis_tvalid = 0;
+    top->s_axis_tlast = 0;
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+
+    top->s_clampS = 0;
+    top->s_clampT = 0;
+}
+
+TEST_CASE("Get various values from a paletted texture", "[TextureBuffer]")
+{
+    VTextureSamplerTestModule* top = new VTextureSamplerTestModule();
+    rr::ut::reset(top);
+    top->m_ready = 1;
+
+    // The used colors are distributed over different banks of the palette RAM
+    std::array<uint16_t, 256> palette {};
+    palette.fill(0x1234);
+    palette[0x10] = 0xf000;
+    palette[0x21] = 0x0f00;
+    palette[0x32] = 0x00f0;
+    palette[0x43] = 0x000f;
+
+    // 2x2 texture
+    // | 0x10 | 0x21 |
+    // | 0x32 | 0x43 |
+    uploadPalettedTexture(top, palette, 0x4332'2110);
+
+    // (0, 0)
+    top->s_texelS = 0;
+    top->s_texelT = 0;
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    REQUIRE(top->m_texel00 == 0xff000000);
+    REQUIRE(top->m_texel01 == 0x00ff0000);
+    REQUIRE(top->m_texel10 == 0x0000ff00);
+    REQUIRE(top->m_texel11 == 0x000000ff);
+
+    // (0.99.., 0.99..)
+    top->s_texelS = 0x7fff;
+    top->s_texelT = 0x7fff;
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    REQUIRE(top->m_texel00 == 0x000000ff);
+    REQUIRE(top->m_texel01 == 0x0000ff00);
+    REQUIRE(top->m_texel10 == 0x00ff0000);
+    REQUIRE(top->m_texel11 == 0xff000000);
+
+    // A new stream loads a new palette
+    palette[0x10] = 0x000f;
+    palette[0x43] = 0xf000;
+    uploadPalettedTexture(top, palette, 0x4332'2110);
+
+    // (0, 0)
+    top->s_texelS = 0;
+    top->s_texelT = 0;
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    rr::ut::clk(top);
+    REQUIRE(top->m_texel00 == 0x000000ff);
+    REQUIRE(top->m_texel01 == 0x00ff0000);
+    REQUIRE(top->m_texel10 == 0x0000ff00);
+    REQUIRE(top->m_texel11 == 0xff000000);
+
+    // Destroy model
+    delete top;
+}
+
+TEST_CASE("Upload paletted and non-paletted textures alternately", "[TextureBuffer]")
+{
+    VTextureSamplerTestModule* top = new VTextureSamplerTestModule();
+    rr::ut::reset(top);
+    top->m_ready = 1;
+
+    std::array<uint16_t, 256> palette {};
+    palette.fill(0x1234);
+    palette[0x10] = 0x000f;
+    palette[0x21] = 0x00f0;
+    palette[0x32] = 0x0f00;
+    palette[0x43] = 0xf000;
+
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        // The non-paletted stream is not seen by the palette decoder. The following palette stream
+        // must still start with the palette and write its texels from the first address.
+        top->confPixelFormat = 0; // RGBA4444
+        uploadTexture(top);
+
+        top->s_texelS = 0;
+        top->s_texelT = 0;
+        rr::ut::clk(top);
+        rr::ut::clk(top);
+        rr::ut::clk(top);
+        rr::ut::clk(top);
+        rr::ut::clk(top);
+        REQUIRE(top->m_texel00 == 0xff000000);
+        REQUIRE(top->m_texel01 == 0x00ff0000);
+        REQUIRE(top->m_texel10 == 0x0000ff00);
+        REQUIRE(top->m_texel11 == 0x000000ff);
+
+        // 2x2 texture with the colors of the non-paletted texture in reversed order
+        uploadPalettedTexture(top, palette, 0x4332'2110);
+
+        top->s_texelS = 0;
+        top->s_texelT = 0;
+        rr::ut::clk(top);
+        rr::ut::clk(top);
+        rr::ut::clk(top);
+        rr::ut::clk(top);
+        rr::ut::clk(top);
+        REQUIRE(top->m_texel00 == 0x000000ff);
+        REQUIRE(top->m_texel01 == 0x0000ff00);
+        REQUIRE(top->m_texel10 == 0x00ff0000);
+        REQUIRE(top->m_texel11 == 0xff000000);
+    }
+
+    // Destroy model
+    delete top;
+}
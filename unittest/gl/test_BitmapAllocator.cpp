@@ -0,0 +1,248 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "renderer/BitmapAllocator.hpp"
+#include <bitset>
+#include <random>
+
+// 70 resources use three words, the last one only partially
+using TestAllocator = rr::BitmapAllocator<70>;
+
+TEST_CASE("Allocate all resources in ascending order", "[BitmapAllocator]")
+{
+    TestAllocator allocator {};
+    REQUIRE(allocator.getFreeCount() == 70);
+    REQUIRE(allocator.getLargestFreeRange() == 70);
+
+    for (std::size_t i = 0; i < TestAllocator::size(); i++)
+    {
+        const std::optional<std::size_t> index = allocator.alloc();
+        REQUIRE(index);
+        REQUIRE(*index == i);
+        REQUIRE(!allocator.isFree(i));
+    }
+    // The unused bits of the last word are never handed out
+    REQUIRE(!allocator.alloc());
+    REQUIRE(allocator.getFreeCount() == 0);
+    REQUIRE(allocator.getLargestFreeRange() == 0);
+    REQUIRE(!allocator.isFree(70));
+    REQUIRE(!allocator.isFree(95));
+
+    allocator.reset();
+    REQUIRE(allocator.getFreeCount() == 70);
+    REQUIRE(*allocator.alloc() == 0);
+}
+
+TEST_CASE("Reuse the lowest freed resource", "[BitmapAllocator]")
+{
+    TestAllocator allocator {};
+    for (std::size_t i = 0; i < TestAllocator::size(); i++)
+    {
+        allocator.alloc();
+    }
+
+    // Free resources in the last, the first and the middle word
+    allocator.free(65);
+    allocator.free(40);
+    allocator.free(3);
+    REQUIRE(allocator.getFreeCount() == 3);
+    REQUIRE(*allocator.alloc() == 3);
+    REQUIRE(*allocator.alloc() == 40);
+    REQUIRE(*allocator.alloc() == 65);
+    REQUIRE(!allocator.alloc());
+
+    // Freeing twice or out of range does not change the free count
+    allocator.free(31);
+    allocator.free(31);
+    allocator.free(70);
+    allocator.free(1000);
+    REQUIRE(allocator.getFreeCount() == 1);
+    REQUIRE(*allocator.alloc() == 31);
+    REQUIRE(!allocator.alloc());
+}
+
+TEST_CASE("Allocate specific resources", "[BitmapAllocator]")
+{
+    TestAllocator allocator {};
+    REQUIRE(allocator.alloc(0));
+    REQUIRE(allocator.alloc(32));
+    REQUIRE(allocator.alloc(69));
+    REQUIRE(!allocator.alloc(32));
+    REQUIRE(!allocator.alloc(70));
+    REQUIRE(allocator.getFreeCount() == 67);
+
+    // The lowest free resource skips the specifically allocated ones
+    REQUIRE(*allocator.alloc() == 1);
+    allocator.free(0);
+    REQUIRE(*allocator.alloc() == 0);
+    REQUIRE(*allocator.alloc() == 2);
+}
+
+TEST_CASE("Allocate consecutive resources", "[BitmapAllocator]")
+{
+    TestAllocator allocator {};
+
+    SECTION("Invalid counts")
+    {
+        REQUIRE(!allocator.allocRange(0));
+        REQUIRE(!allocator.allocRange(71));
+        REQUIRE(allocator.getFreeCount() == 70);
+    }
+
+    SECTION("The whole allocator")
+    {
+        REQUIRE(*allocator.allocRange(70) == 0);
+        REQUIRE(allocator.getFreeCount() == 0);
+        REQUIRE(!allocator.allocRange(1));
+    }
+
+    SECTION("A run across the word boundaries")
+    {
+        REQUIRE(*allocator.allocRange(30) == 0);
+        // Uses the end of the first, the whole second and the begin of the third word
+        REQUIRE(*allocator.allocRange(36) == 30);
+        for (std::size_t i = 0; i < 66; i++)
+        {
+            REQUIRE(!allocator.isFree(i));
+        }
+        REQUIRE(allocator.getFreeCount() == 4);
+        REQUIRE(allocator.getLargestFreeRange() == 4);
+        // The run can not reach into the unused bits of the last word
+        REQUIRE(!allocator.allocRange(5));
+        REQUIRE(*allocator.allocRange(4) == 66);
+        REQUIRE(allocator.getFreeCount() == 0);
+    }
+
+    SECTION("Skip runs which are too short")
+    {
+        for (std::size_t i = 0; i < TestAllocator::size(); i++)
+        {
+            allocator.alloc();
+        }
+        // Holes of 2 and 3 resources in front of a hole of 4 resources in the last word
+        allocator.free(5);
+        allocator.free(6);
+        allocator.free(29);
+        allocator.free(30);
+        allocator.free(31);
+        for (std::size_t i = 64; i < 68; i++)
+        {
+            allocator.free(i);
+        }
+        REQUIRE(allocator.getLargestFreeRange() == 4);
+
+        // The second word is completely allocated and skipped
+        REQUIRE(*allocator.allocRange(4) == 64);
+        REQUIRE(*allocator.allocRange(3) == 29);
+        REQUIRE(!allocator.allocRange(3));
+        REQUIRE(*allocator.allocRange(2) == 5);
+        REQUIRE(allocator.getFreeCount() == 0);
+    }
+
+    SECTION("A run which is split by a word boundary")
+    {
+        for (std::size_t i = 0; i < TestAllocator::size(); i++)
+        {
+            allocator.alloc();
+        }
+        // Free 30..33 which spans the first and the second word
+        for (std::size_t i = 30; i < 34; i++)
+        {
+            allocator.free(i);
+        }
+        REQUIRE(allocator.getLargestFreeRange() == 4);
+        REQUIRE(!allocator.allocRange(5));
+        REQUIRE(*allocator.allocRange(4) == 30);
+    }
+}
+
+TEST_CASE("Compare random allocations with a reference", "[BitmapAllocator]")
+{
+    rr::BitmapAllocator<100> allocator {};
+    std::bitset<100> used {};
+    std::mt19937 rng { 3 };
+
+    const auto lowestFree = [&used]() -> std::optional<std::size_t>
+    {
+        for (std::size_t i = 0; i < used.size(); i++)
+        {
+            if (!used[i])
+            {
+                return i;
+            }
+        }
+        return std::nullopt;
+    };
+    const auto firstRun = [&used](const std::size_t count) -> std::optional<std::size_t>
+    {
+        std::size_t runLength = 0;
+        for (std::size_t i = 0; i < used.size(); i++)
+        {
+            runLength = used[i] ? 0 : (runLength + 1);
+            if (runLength == count)
+            {
+                return i + 1 - count;
+            }
+        }
+        return std::nullopt;
+    };
+
+    bool matches = true;
+    for (std::size_t step = 0; (step < 20000) && matches; step++)
+    {
+        const uint32_t operation = rng() % 3;
+        if (operation == 0)
+        {
+            const std::optional<std::size_t> expected = lowestFree();
+            const std::optional<std::size_t> index = allocator.alloc();
+            matches = (expected == index);
+            if (index)
+            {
+                used.set(*index);
+            }
+        }
+        else if (operation == 1)
+        {
+            const std::size_t count = 1 + (rng() % 40);
+            const std::optional<std::size_t> expected = firstRun(count);
+            const std::optional<std::size_t> index = allocator.allocRange(count);
+            matches = (expected == index);
+            for (std::size_t i = 0; index && (i < count); i++)
+            {
+                used.set(*index + i);
+            }
+        }
+        else
+        {
+            // Frees more often to keep the allocator fragmented but not full
+            for (std::size_t i = 0; i < 3; i++)
+            {
+                const std::size_t index = rng() % used.size();
+                allocator.free(index);
+                used.reset(index);
+            }
+        }
+        matches = matches && (allocator.getFreeCount() == (used.size() - used.count()));
+    }
+    REQUIRE(matches);
+    for (std::size_t i = 0; i < used.size(); i++)
+    {
+        REQUIRE(allocator.isFree(i) == !used[i]);
+    }
+}
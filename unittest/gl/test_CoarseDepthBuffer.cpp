@@ -0,0 +1,191 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "renderer/CoarseDepthBuffer.hpp"
+#include "renderer/Rasterizer.hpp"
+#include "renderer/registers/DepthBufferClearDepthReg.hpp"
+#include "renderer/registers/FeatureEnableReg.hpp"
+#include "renderer/registers/FragmentPipelineReg.hpp"
+#include "renderer/registers/RenderResolutionReg.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr std::size_t RESOLUTION_X { 64 };
+constexpr std::size_t RESOLUTION_Y { 48 };
+
+// Per pixel depth buffer which evaluates the triangles like the hardware
+class ReferenceDepthBuffer
+{
+public:
+    ReferenceDepthBuffer()
+        : m_depth(RESOLUTION_X * RESOLUTION_Y, 1.0f)
+    {
+    }
+
+    /// @brief Draws the triangle with the depth function LESS
+    /// @return true if at least one pixel passes the depth test
+    bool drawTriangle(const rr::TriangleStreamTypes::StaticParams& params)
+    {
+        bool visible = false;
+        for (int32_t y = params.bbStartY; y < std::min<int32_t>(params.bbEndY, RESOLUTION_Y); y++)
+        {
+            for (int32_t x = params.bbStartX; x < std::min<int32_t>(params.bbEndX, RESOLUTION_X); x++)
+            {
+                const int64_t dx = x - params.bbStartX;
+                const int64_t dy = y - params.bbStartY;
+                bool inside = true;
+                for (std::size_t i = 0; i < 3; i++)
+                {
+                    inside = inside && ((params.wInit[i] + (params.wXInc[i] * dx) + (params.wYInc[i] * dy)) >= 0);
+                }
+                const float depth = std::clamp(params.depthZw[0] + (params.depthZwXInc[0] * dx) + (params.depthZwYInc[0] * dy), 0.0f, 1.0f);
+                float& pixel = m_depth[(y * RESOLUTION_X) + x];
+                if (inside && (depth < pixel))
+                {
+                    pixel = depth;
+                    visible = true;
+                }
+            }
+        }
+        return visible;
+    }
+
+private:
+    std::vector<float> m_depth {};
+};
+
+class TriangleSetup
+{
+public:
+    bool rasterize(rr::TriangleStreamTypes::TriangleDesc& desc, const rr::Vec4& v0, const rr::Vec4& v1, const rr::Vec4& v2) const
+    {
+        const rr::TransformedTriangle triangle { v0, v1, v2, m_texture, m_texture, m_texture, m_color, m_color, m_color };
+        return m_rasterizer.rasterize(desc, triangle);
+    }
+
+private:
+    rr::Rasterizer m_rasterizer { true };
+    std::array<rr::Vec4, rr::RenderConfig::TMU_COUNT> m_texture {};
+    rr::Vec4 m_color { 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+void setUpDepthTest(rr::CoarseDepthBuffer& coarseDepthBuffer)
+{
+    rr::RenderResolutionReg resolution {};
+    resolution.setX(RESOLUTION_X);
+    resolution.setY(RESOLUTION_Y);
+    coarseDepthBuffer.setRegister(resolution.getAddr(), resolution.serialize());
+
+    rr::FeatureEnableReg featureEnable {};
+    featureEnable.setEnableDepthTest(true);
+    coarseDepthBuffer.setRegister(featureEnable.getAddr(), featureEnable.serialize());
+
+    rr::FragmentPipelineReg fragmentPipeline {};
+    fragmentPipeline.setDepthFunc(rr::TestFunc::LESS);
+    fragmentPipeline.setDepthMask(true);
+    coarseDepthBuffer.setRegister(fragmentPipeline.getAddr(), fragmentPipeline.serialize());
+
+    rr::DepthBufferClearDepthReg clearDepth {};
+    clearDepth.setValue(65535);
+    coarseDepthBuffer.setRegister(clearDepth.getAddr(), clearDepth.serialize());
+    coarseDepthBuffer.clear();
+}
+
+} // namespace
+
+TEST_CASE("Coarse occlusion culling rejects only hidden triangles", "[CoarseDepthBuffer]")
+{
+    rr::CoarseDepthBuffer coarseDepthBuffer {};
+    ReferenceDepthBuffer reference {};
+    const TriangleSetup setup {};
+    setUpDepthTest(coarseDepthBuffer);
+
+    // Occluder which covers the center of the screen
+    const rr::Vec4 o0 { 8.0f, 8.0f, 0.5f, 1.0f };
+    const rr::Vec4 o1 { 56.0f, 8.0f, 0.5f, 1.0f };
+    const rr::Vec4 o2 { 56.0f, 40.0f, 0.5f, 1.0f };
+    const rr::Vec4 o3 { 8.0f, 40.0f, 0.5f, 1.0f };
+    rr::TriangleStreamTypes::TriangleDesc desc {};
+    REQUIRE(setup.rasterize(desc, o0, o1, o2));
+    CHECK(coarseDepthBuffer.drawTriangle(desc));
+    reference.drawTriangle(desc.param);
+    REQUIRE(setup.rasterize(desc, o0, o2, o3));
+    CHECK(coarseDepthBuffer.drawTriangle(desc));
+    reference.drawTriangle(desc.param);
+    CHECK(coarseDepthBuffer.getStatistics().occluderTriangles == 2);
+
+    SECTION("A triangle behind the occluder is culled")
+    {
+        // The tiles on the diagonal of the occluder are not completely covered by one of its triangles
+        REQUIRE(setup.rasterize(desc, { 32.0f, 10.0f, 0.75f, 1.0f }, { 52.0f, 10.0f, 0.75f, 1.0f }, { 52.0f, 28.0f, 0.75f, 1.0f }));
+        CHECK(!reference.drawTriangle(desc.param));
+        CHECK(!coarseDepthBuffer.drawTriangle(desc));
+    }
+
+    SECTION("A triangle in front of the occluder is visible")
+    {
+        REQUIRE(setup.rasterize(desc, { 16.0f, 16.0f, 0.25f, 1.0f }, { 40.0f, 16.0f, 0.25f, 1.0f }, { 24.0f, 32.0f, 0.25f, 1.0f }));
+        CHECK(reference.drawTriangle(desc.param));
+        CHECK(coarseDepthBuffer.drawTriangle(desc));
+    }
+
+    SECTION("A triangle which intersects the occluder is visible")
+    {
+        REQUIRE(setup.rasterize(desc, { 16.0f, 16.0f, 0.9f, 1.0f }, { 40.0f, 16.0f, 0.9f, 1.0f }, { 24.0f, 32.0f, 0.1f, 1.0f }));
+        CHECK(reference.drawTriangle(desc.param));
+        CHECK(coarseDepthBuffer.drawTriangle(desc));
+    }
+
+    SECTION("A triangle behind the occluder which reaches into the uncovered border is visible")
+    {
+        REQUIRE(setup.rasterize(desc, { 2.0f, 2.0f, 0.75f, 1.0f }, { 40.0f, 16.0f, 0.75f, 1.0f }, { 24.0f, 32.0f, 0.75f, 1.0f }));
+        CHECK(reference.drawTriangle(desc.param));
+        CHECK(coarseDepthBuffer.drawTriangle(desc));
+    }
+
+    SECTION("No visible triangle of a random scene is culled")
+    {
+        std::mt19937 rng { 1234 };
+        std::uniform_real_distribution<float> x { -8.0f, RESOLUTION_X + 8.0f };
+        std::uniform_real_distribution<float> y { -8.0f, RESOLUTION_Y + 8.0f };
+        std::uniform_real_distribution<float> z { 0.0f, 1.0f };
+        std::size_t culled = 0;
+        for (std::size_t i = 0; i < 2000; i++)
+        {
+            if (!setup.rasterize(desc, { x(rng), y(rng), z(rng), 1.0f }, { x(rng), y(rng), z(rng), 1.0f }, { x(rng), y(rng), z(rng), 1.0f }))
+            {
+                continue;
+            }
+            const bool visible = reference.drawTriangle(desc.param);
+            if (!coarseDepthBuffer.drawTriangle(desc))
+            {
+                INFO("Triangle " << i);
+                REQUIRE(!visible);
+                culled++;
+            }
+        }
+        CHECK(culled > 0);
+        CHECK(culled == coarseDepthBuffer.getStatistics().culledTriangles);
+    }
+}
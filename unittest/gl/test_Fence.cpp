@@ -0,0 +1,380 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "IBusConnector.hpp"
+#include "RIXGL.hpp"
+#include "gl.h"
+#include "renderer/dse/DmaStreamEngine.hpp"
+#include "renderer/registers/FogColorReg.hpp"
+#include "renderer/threadedRasterizer/ThreadedRasterizer.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Bus connector whose transfers are completed by the test in the order they were started.
+// Blocking calls either wait till the test completes the transfers from another thread, or complete
+// them on their own, like a real transfer finishes while the caller waits.
+class FakeBusConnector : public rr::IBusConnector
+{
+public:
+    FakeBusConnector(const std::size_t bufferCount, const bool canQueue)
+        : m_buffers(bufferCount, std::vector<uint8_t>(256 * 1024))
+        , m_canQueue { canQueue }
+    {
+    }
+
+    void writeData(const uint8_t index, const uint32_t) override
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        if (!m_canQueue)
+        {
+            waitUntil(lock, [this]()
+                { return m_transfers.empty(); });
+        }
+        m_transfers.push_back(index);
+        m_transfersStarted++;
+    }
+
+    void blockUntilWriteComplete() override
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        waitUntil(lock, [this]()
+            { return m_transfers.empty(); });
+    }
+
+    bool isWriteComplete() override
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        return m_transfers.empty();
+    }
+
+    bool canQueueTransfers() const override { return m_canQueue; }
+
+    void blockUntilBufferIsFree(const uint8_t index) override
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        waitUntil(lock, [this, index]()
+            { return !isTransferred(index); });
+    }
+
+    bool isBufferFree(const uint8_t index) override
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        return !isTransferred(index);
+    }
+
+    tcb::span<uint8_t> requestBuffer(const uint8_t index) override { return { m_buffers[index] }; }
+    uint8_t getBufferCount() const override { return m_buffers.size(); }
+
+    /// @brief Blocking calls complete the transfers instead of waiting for the test
+    void completeWhenBlocking(const bool enable)
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        m_completeWhenBlocking = enable;
+    }
+
+    /// @brief Completes the oldest transfer
+    void completeTransfer()
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        if (!m_transfers.empty())
+        {
+            m_transfers.pop_front();
+        }
+        m_transferCompleted.notify_all();
+    }
+
+    void completeAllTransfers()
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        m_transfers.clear();
+        m_transferCompleted.notify_all();
+    }
+
+    std::size_t getTransfersInFlight()
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        return m_transfers.size();
+    }
+
+    std::size_t getTransfersStarted()
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        return m_transfersStarted;
+    }
+
+private:
+    bool isTransferred(const uint8_t index) const
+    {
+        return std::find(m_transfers.begin(), m_transfers.end(), index) != m_transfers.end();
+    }
+
+    template <typename TPredicate>
+    void waitUntil(std::unique_lock<std::mutex>& lock, const TPredicate& predicate)
+    {
+        if (m_completeWhenBlocking)
+        {
+            while (!predicate())
+            {
+                m_transfers.pop_front();
+            }
+            return;
+        }
+        m_transferCompleted.wait(lock, predicate);
+    }
+
+    std::vector<std::vector<uint8_t>> m_buffers {};
+    const bool m_canQueue { true };
+    std::mutex m_mutex {};
+    std::condition_variable m_transferCompleted {};
+    std::deque<uint8_t> m_transfers {};
+    std::size_t m_transfersStarted { 0 };
+    bool m_completeWhenBlocking { false };
+};
+
+// Executes the operation in the calling thread
+class InlineThreadRunner : public rr::IThreadRunner
+{
+public:
+    void wait() override { }
+    void run(const std::function<void()>& operation) override { operation(); }
+};
+
+class ThreadRunner : public rr::IThreadRunner
+{
+public:
+    ~ThreadRunner() { wait(); }
+
+    void wait() override
+    {
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void run(const std::function<void()>& operation) override
+    {
+        wait();
+        m_thread = std::thread { operation };
+    }
+
+private:
+    std::thread m_thread {};
+};
+
+// Display list buffers for the threaded rasterizer (one per display line and double buffered) and the store buffer
+constexpr std::size_t BUS_BUFFER_COUNT { (rr::RenderConfig::getDisplayLines() * 2) + 1 };
+
+} // namespace
+
+TEST_CASE("Fences are compared across the wrap around of the sequence numbers", "[Fence]")
+{
+    REQUIRE(rr::IDevice::isFenceReached(5, 5));
+    REQUIRE(rr::IDevice::isFenceReached(6, 5));
+    REQUIRE(!rr::IDevice::isFenceReached(4, 5));
+
+    REQUIRE(rr::IDevice::isFenceReached(0xffff'ffff, 0xffff'ffff));
+    REQUIRE(rr::IDevice::isFenceReached(0, 0xffff'ffff));
+    REQUIRE(rr::IDevice::isFenceReached(3, 0xffff'fffe));
+    REQUIRE(!rr::IDevice::isFenceReached(0xffff'ffff, 0));
+    REQUIRE(!rr::IDevice::isFenceReached(0xffff'fffe, 3));
+
+    // The distance must be less than 2^31
+    REQUIRE(rr::IDevice::isFenceReached(0x7fff'ffff, 0));
+    REQUIRE(!rr::IDevice::isFenceReached(0x8000'0000, 0));
+}
+
+TEST_CASE("A fence of the DmaStreamEngine is signaled after its display list is transferred", "[Fence]")
+{
+    FakeBusConnector bus { 4, true };
+    rr::DSEC::DmaStreamEngine dse { bus };
+
+    // Nothing was streamed yet
+    REQUIRE(dse.isFenceSignaled(dse.insertFence()));
+
+    // The display list which is assembled now is not streamed
+    const uint32_t first = dse.insertFence() + 1;
+    REQUIRE(!dse.isFenceSignaled(first));
+
+    dse.streamDisplayList(0, 64);
+    REQUIRE(dse.insertFence() == first);
+    REQUIRE(!dse.isFenceSignaled(first));
+
+    dse.streamDisplayList(1, 64);
+    const uint32_t second = dse.insertFence();
+    REQUIRE(bus.getTransfersInFlight() == 2);
+    REQUIRE(!dse.isFenceSignaled(first));
+    REQUIRE(!dse.isFenceSignaled(second));
+
+    bus.completeTransfer();
+    REQUIRE(dse.isFenceSignaled(first));
+    REQUIRE(!dse.isFenceSignaled(second));
+
+    bus.completeTransfer();
+    REQUIRE(dse.isFenceSignaled(first));
+    REQUIRE(dse.isFenceSignaled(second));
+}
+
+TEST_CASE("Blocking on a fence of the DmaStreamEngine only waits for the display lists in front of it", "[Fence]")
+{
+    SECTION("Bus which queues transfers")
+    {
+        FakeBusConnector bus { 4, true };
+        rr::DSEC::DmaStreamEngine dse { bus };
+        dse.streamDisplayList(0, 64);
+        const uint32_t first = dse.insertFence();
+        dse.streamDisplayList(1, 64);
+        const uint32_t second = dse.insertFence();
+
+        bus.completeWhenBlocking(true);
+        dse.blockUntilFenceIsSignaled(first);
+        REQUIRE(dse.isFenceSignaled(first));
+        REQUIRE(!dse.isFenceSignaled(second));
+        REQUIRE(bus.getTransfersInFlight() == 1);
+
+        dse.blockUntilFenceIsSignaled(second);
+        REQUIRE(dse.isFenceSignaled(second));
+        REQUIRE(bus.getTransfersInFlight() == 0);
+    }
+    SECTION("Bus which starts a transfer when the previous is finished")
+    {
+        FakeBusConnector bus { 4, false };
+        rr::DSEC::DmaStreamEngine dse { bus };
+        bus.completeWhenBlocking(true);
+        dse.streamDisplayList(0, 64);
+        const uint32_t first = dse.insertFence();
+        REQUIRE(!dse.isFenceSignaled(first));
+
+        // Starting the next transfer waits for the previous one
+        dse.streamDisplayList(1, 64);
+        const uint32_t second = dse.insertFence();
+        REQUIRE(dse.isFenceSignaled(first));
+        REQUIRE(!dse.isFenceSignaled(second));
+
+        dse.blockUntilFenceIsSignaled(second);
+        REQUIRE(dse.isFenceSignaled(second));
+    }
+}
+
+TEST_CASE("A fence of the ThreadedRasterizer is signaled after its display list is uploaded and transferred", "[Fence]")
+{
+    FakeBusConnector bus { BUS_BUFFER_COUNT, true };
+    rr::DSEC::DmaStreamEngine dse { bus };
+    InlineThreadRunner workerThread {};
+    ThreadRunner uploadThread {};
+    rr::ThreadedRasterizer<2, 16 * 1024, 1024, 4> rasterizer { dse, uploadThread, workerThread };
+
+    rr::displaylist::DisplayListAssembler<rr::RenderConfig::TMU_COUNT, rr::displaylist::DisplayList> assembler {};
+    assembler.setBuffer(rasterizer.requestDisplayListBuffer(0), 0);
+    assembler.clearAssembler();
+    REQUIRE(assembler.addCommand(rr::WriteRegisterCmd { rr::FogColorReg { rr::Vec4i { 1, 2, 3, 4 } } }));
+
+    // A partial display list is not complete
+    const uint32_t fence = rasterizer.insertFence() + 1;
+    rasterizer.streamPartialDisplayList(0, assembler.getDisplayListSize(), true);
+    REQUIRE(!rasterizer.isFenceSignaled(fence));
+
+    rasterizer.streamDisplayList(0, assembler.getDisplayListSize());
+    REQUIRE(rasterizer.insertFence() == fence);
+
+    // The upload thread waits in the DmaStreamEngine till the transfers are complete
+    while (bus.getTransfersStarted() == 0)
+    {
+        std::this_thread::yield();
+    }
+    REQUIRE(!rasterizer.isFenceSignaled(fence));
+
+    bus.completeAllTransfers();
+    rasterizer.blockUntilFenceIsSignaled(fence);
+    REQUIRE(rasterizer.isFenceSignaled(fence));
+    REQUIRE(bus.getTransfersInFlight() == 0);
+    rasterizer.deinit();
+}
+
+TEST_CASE("NV_fence is signaled after the commands in front of it are processed", "[Fence]")
+{
+    FakeBusConnector bus { BUS_BUFFER_COUNT, true };
+    bus.completeWhenBlocking(true);
+    InlineThreadRunner workerThread {};
+    InlineThreadRunner uploadThread {};
+    REQUIRE(rr::RIXGL::createInstance(bus, workerThread, uploadThread));
+
+    GLuint fences[2] {};
+    glGenFencesNV(2, fences);
+    REQUIRE(fences[0] != fences[1]);
+    REQUIRE(!glIsFenceNV(fences[0]));
+    glTestFenceNV(fences[0]);
+    REQUIRE(glGetError() == GL_INVALID_OPERATION);
+    glSetFenceNV(fences[0], GL_FENCE_STATUS_NV);
+    REQUIRE(glGetError() == GL_INVALID_ENUM);
+
+    glBegin(GL_TRIANGLES);
+    glVertex3f(-0.5f, -0.5f, 0.0f);
+    glVertex3f(0.5f, -0.5f, 0.0f);
+    glVertex3f(0.0f, 0.5f, 0.0f);
+    glEnd();
+    glSetFenceNV(fences[0], GL_ALL_COMPLETED_NV);
+    REQUIRE(glGetError() == GL_NO_ERROR);
+    REQUIRE(glIsFenceNV(fences[0]));
+    REQUIRE(!glTestFenceNV(fences[0]));
+    GLint status = GL_TRUE;
+    glGetFenceivNV(fences[0], GL_FENCE_STATUS_NV, &status);
+    REQUIRE(status == GL_FALSE);
+
+    if constexpr (rr::RenderConfig::THREADED_RASTERIZATION)
+    {
+        // The display list is completed and transferred with the swap
+        rr::RIXGL::getInstance().swapDisplayList();
+    }
+    else
+    {
+        // The display list was streamed with the fence
+        REQUIRE(bus.getTransfersInFlight() > 0);
+        bus.completeAllTransfers();
+    }
+    REQUIRE(glTestFenceNV(fences[0]));
+    glGetFenceivNV(fences[0], GL_FENCE_STATUS_NV, &status);
+    REQUIRE(status == GL_TRUE);
+
+    // A fence behind the following commands is not signaled by the processing of the previous ones
+    glClear(GL_COLOR_BUFFER_BIT);
+    glSetFenceNV(fences[1], GL_ALL_COMPLETED_NV);
+    REQUIRE(!glTestFenceNV(fences[1]));
+    if constexpr (rr::RenderConfig::THREADED_RASTERIZATION)
+    {
+        rr::RIXGL::getInstance().swapDisplayList();
+    }
+    else
+    {
+        glFinishFenceNV(fences[1]);
+    }
+    REQUIRE(glTestFenceNV(fences[1]));
+
+    glDeleteFencesNV(2, fences);
+    REQUIRE(!glIsFenceNV(fences[0]));
+    REQUIRE(!glIsFenceNV(fences[1]));
+    rr::RIXGL::destroy();
+}
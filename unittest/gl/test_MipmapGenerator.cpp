@@ -0,0 +1,299 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "GenericMemoryBusConnector.hpp"
+#include "NoThreadRunner.hpp"
+#include "RIXGL.hpp"
+#include "gl.h"
+#include "vertexpipeline/VertexPipeline.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// Discards the display lists, only the host copies of the textures are checked
+class NullBusConnector : public rr::GenericMemoryBusConnector<24, 256 * 1024>
+{
+public:
+    void writeData(const uint8_t, const uint32_t) override { }
+    void blockUntilWriteComplete() override { }
+    bool isWriteComplete() override { return true; }
+};
+
+class GlContext
+{
+public:
+    GlContext()
+    {
+        REQUIRE(rr::RIXGL::createInstance(*m_bus, m_workerThread, m_uploadThread));
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+
+    ~GlContext() { rr::RIXGL::destroy(); }
+
+private:
+    std::unique_ptr<NullBusConnector> m_bus { std::make_unique<NullBusConnector>() };
+    rr::NoThreadRunner m_workerThread {};
+    rr::NoThreadRunner m_uploadThread {};
+};
+
+struct Component
+{
+    uint8_t pos;
+    uint8_t size;
+};
+
+struct Format
+{
+    GLint internalFormat;
+    GLenum format;
+    GLenum type; ///< Packed type which is stored without conversion
+    std::vector<Component> components;
+};
+
+const std::vector<Format> FORMATS {
+    { GL_RGB, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, { { 11, 5 }, { 5, 6 }, { 0, 5 } } },
+    { GL_RGBA, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, { { 12, 4 }, { 8, 4 }, { 4, 4 }, { 0, 4 } } },
+    { GL_RGB5_A1, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, { { 11, 5 }, { 6, 5 }, { 1, 5 }, { 0, 1 } } },
+};
+
+struct Level
+{
+    std::size_t width;
+    std::size_t height;
+    std::vector<uint16_t> texels;
+};
+
+std::vector<uint16_t> createImage(const std::size_t size, std::mt19937& rng)
+{
+    std::vector<uint16_t> image(size);
+    for (uint16_t& texel : image)
+    {
+        texel = static_cast<uint16_t>(rng());
+    }
+    return image;
+}
+
+// 2x2 box filter with rounding. The last column and row are repeated for levels with a width or height of one.
+Level downsample(const Format& format, const Level& src)
+{
+    Level dst { (std::max)(src.width / 2, std::size_t { 1 }), (std::max)(src.height / 2, std::size_t { 1 }), {} };
+    dst.texels.resize(dst.width * dst.height);
+    for (std::size_t y = 0; y < dst.height; y++)
+    {
+        for (std::size_t x = 0; x < dst.width; x++)
+        {
+            const std::size_t xa = x * 2;
+            const std::size_t xb = (std::min)(xa + 1, src.width - 1);
+            const std::size_t ya = y * 2;
+            const std::size_t yb = (std::min)(ya + 1, src.height - 1);
+            const uint16_t texels[4] {
+                src.texels[(ya * src.width) + xa],
+                src.texels[(ya * src.width) + xb],
+                src.texels[(yb * src.width) + xa],
+                src.texels[(yb * src.width) + xb],
+            };
+            uint16_t color = 0;
+            for (const Component& c : format.components)
+            {
+                const uint32_t mask = (1u << c.size) - 1;
+                uint32_t sum = 2;
+                for (const uint16_t t : texels)
+                {
+                    sum += (t >> c.pos) & mask;
+                }
+                color |= static_cast<uint16_t>((sum >> 2) << c.pos);
+            }
+            dst.texels[(y * dst.width) + x] = color;
+        }
+    }
+    return dst;
+}
+
+// Reads the levels of the bound texture from its host copy
+std::vector<Level> readLevels()
+{
+    rr::Texture& texture = rr::RIXGL::getInstance().pipeline().texture();
+    texture.waitForTextureJobs();
+    const rr::TextureObjectMipmap& mipmap = texture.getTexture();
+    std::vector<Level> levels {};
+    for (const rr::TextureObject& level : mipmap)
+    {
+        if ((level.width == 0) || (level.height == 0) || !level.pixels)
+        {
+            break;
+        }
+        levels.push_back({ level.width, level.height, { level.pixels.get(), level.pixels.get() + (level.width * level.height) } });
+    }
+    return levels;
+}
+
+GLuint createTexture(const Format& format, const std::size_t width, const std::size_t height, const std::vector<uint16_t>& image)
+{
+    GLuint texId {};
+    glGenTextures(1, &texId);
+    glBindTexture(GL_TEXTURE_2D, texId);
+    glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+    glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, width, height, 0, format.format, format.type, image.data());
+    REQUIRE(glGetError() == GL_NO_ERROR);
+    return texId;
+}
+
+// Checks the size of every level and that every level is the filtered previous level
+bool isMipmapChain(const Format& format, const std::vector<Level>& levels)
+{
+    if (levels.empty())
+    {
+        return false;
+    }
+    for (std::size_t i = 1; i < levels.size(); i++)
+    {
+        const Level expected = downsample(format, levels[i - 1]);
+        if ((levels[i].width != expected.width) || (levels[i].height != expected.height) || (levels[i].texels != expected.texels))
+        {
+            UNSCOPED_INFO("level " << i << " " << levels[i].width << "x" << levels[i].height << " differs from the filtered level " << (i - 1));
+            return false;
+        }
+    }
+    // The last level is 1x1
+    return (levels.back().width == 1) && (levels.back().height == 1);
+}
+
+bool isSameMipmap(const std::vector<Level>& a, const std::vector<Level>& b)
+{
+    if (a.size() != b.size())
+    {
+        UNSCOPED_INFO("number of levels " << a.size() << " != " << b.size());
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); i++)
+    {
+        if ((a[i].width != b[i].width) || (a[i].height != b[i].height) || (a[i].texels != b[i].texels))
+        {
+            UNSCOPED_INFO("level " << i << " differs");
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Size
+{
+    std::size_t width;
+    std::size_t height;
+};
+
+// Square levels use the SIMD filter in the first levels. The others end in 1xN and Nx1 levels.
+const std::vector<Size> SIZES { { 64, 64 }, { 128, 2 }, { 64, 4 }, { 4, 64 }, { 1, 32 }, { 32, 1 } };
+
+} // namespace
+
+TEST_CASE("Generate the mipmap levels with a box filter", "[MipmapGenerator]")
+{
+    if constexpr (!rr::RenderConfig::ENABLE_MIPMAPPING)
+    {
+        return;
+    }
+    GlContext context {};
+    std::mt19937 rng { 11 };
+
+    for (const Format& format : FORMATS)
+    {
+        for (const Size& size : SIZES)
+        {
+            INFO("format 0x" << std::hex << format.internalFormat << std::dec << " size " << size.width << "x" << size.height);
+            const std::vector<uint16_t> image = createImage(size.width * size.height, rng);
+            createTexture(format, size.width, size.height, image);
+            const std::vector<Level> levels = readLevels();
+            REQUIRE(!levels.empty());
+            CHECK(levels[0].texels == image);
+            CHECK(isMipmapChain(format, levels));
+        }
+    }
+}
+
+TEST_CASE("Regenerate only the region which depends on the changed texels", "[MipmapGenerator]")
+{
+    if constexpr (!rr::RenderConfig::ENABLE_MIPMAPPING)
+    {
+        return;
+    }
+    GlContext context {};
+    std::mt19937 rng { 13 };
+
+    struct Region
+    {
+        std::size_t x;
+        std::size_t y;
+        std::size_t width;
+        std::size_t height;
+    };
+    // Regions at odd and even offsets, one which is wide enough for the SIMD filter, and single texels in the corners
+    const std::vector<Region> regions {
+        { 5, 3, 7, 9 },
+        { 3, 2, 40, 5 },
+        { 0, 0, 1, 1 },
+        { 1000, 1000, 1, 1 },
+        { 0, 1, 1000, 1 },
+    };
+
+    for (const Format& format : FORMATS)
+    {
+        for (const Size& size : SIZES)
+        {
+            for (const Region& r : regions)
+            {
+                // Clip the region into the texture
+                const std::size_t x = (std::min)(r.x, size.width - 1);
+                const std::size_t y = (std::min)(r.y, size.height - 1);
+                const std::size_t width = (std::min)(r.width, size.width - x);
+                const std::size_t height = (std::min)(r.height, size.height - y);
+                INFO("format 0x" << std::hex << format.internalFormat << std::dec << " size " << size.width << "x" << size.height
+                                 << " region " << x << ", " << y << ", " << width << "x" << height);
+
+                std::vector<uint16_t> image = createImage(size.width * size.height, rng);
+                const std::vector<uint16_t> subImage = createImage(width * height, rng);
+                const GLuint partial = createTexture(format, size.width, size.height, image);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format.format, format.type, subImage.data());
+                REQUIRE(glGetError() == GL_NO_ERROR);
+                const std::vector<Level> partialLevels = readLevels();
+
+                // The same image, generated completely
+                for (std::size_t j = 0; j < height; j++)
+                {
+                    std::copy_n(subImage.begin() + (j * width), width, image.begin() + ((y + j) * size.width) + x);
+                }
+                const GLuint full = createTexture(format, size.width, size.height, image);
+                const std::vector<Level> fullLevels = readLevels();
+
+                REQUIRE(!partialLevels.empty());
+                CHECK(partialLevels[0].texels == image);
+                CHECK(isSameMipmap(partialLevels, fullLevels));
+                CHECK(isMipmapChain(format, partialLevels));
+
+                // Unbinding applies the levels which were read back, before the texture is deleted
+                glBindTexture(GL_TEXTURE_2D, 0);
+                glDeleteTextures(1, &partial);
+                glDeleteTextures(1, &full);
+            }
+        }
+    }
+}
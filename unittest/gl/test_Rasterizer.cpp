@@ -0,0 +1,172 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "renderer/Rasterizer.hpp"
+#include "renderer/commands/TriangleStreamCmd.hpp"
+#include <random>
+#include <vector>
+
+namespace
+{
+
+struct TriangleData
+{
+    std::array<rr::Vec4, 3> vertex;
+    std::array<std::array<rr::Vec4, rr::RenderConfig::TMU_COUNT>, 3> texture;
+    std::array<rr::Vec4, 3> color;
+
+    rr::TransformedTriangle get() const
+    {
+        return { vertex[0], vertex[1], vertex[2], texture[0], texture[1], texture[2], color[0], color[1], color[2] };
+    }
+};
+
+class TriangleGenerator
+{
+public:
+    TriangleData next()
+    {
+        TriangleData t {};
+        // Small triangles test the sample point coverage, large ones the bounding box and the interpolation
+        const bool small = m_select(m_rng) < 0.25f;
+        const float baseX = m_position(m_rng);
+        const float baseY = m_position(m_rng);
+        for (std::size_t v = 0; v < 3; v++)
+        {
+            const float x = small ? (baseX + m_offset(m_rng)) : m_position(m_rng);
+            const float y = small ? (baseY + m_offset(m_rng)) : m_position(m_rng);
+            t.vertex[v] = rr::Vec4 { x, y, m_unit(m_rng), 0.1f + (2.0f * m_unit(m_rng)) };
+            t.color[v] = rr::Vec4 { m_unit(m_rng), m_unit(m_rng), m_unit(m_rng), m_unit(m_rng) };
+            for (std::size_t tmu = 0; tmu < rr::RenderConfig::TMU_COUNT; tmu++)
+            {
+                t.texture[v][tmu] = rr::Vec4 { m_texCoord(m_rng), m_texCoord(m_rng), 0.0f, 0.5f + m_unit(m_rng) };
+            }
+        }
+        return t;
+    }
+
+private:
+    std::mt19937 m_rng { 42 };
+    std::uniform_real_distribution<float> m_select { 0.0f, 1.0f };
+    std::uniform_real_distribution<float> m_position { -32.0f, 320.0f };
+    std::uniform_real_distribution<float> m_offset { -1.5f, 1.5f };
+    std::uniform_real_distribution<float> m_unit { 0.0f, 1.0f };
+    std::uniform_real_distribution<float> m_texCoord { -10.0f, 10.0f };
+};
+
+// Both paths use the same operations in the same order. Only a compiler which contracts them differently
+// into fused multiply adds can change the last bits.
+template <std::size_t N>
+void checkVec(const rr::Vec<N>& batched, const rr::Vec<N>& scalar)
+{
+    for (std::size_t i = 0; i < N; i++)
+    {
+        CHECK(batched[i] == Approx(scalar[i]).epsilon(1e-6).margin(1e-9));
+    }
+}
+
+void checkVec(const rr::Vec3i& batched, const rr::Vec3i& scalar)
+{
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        CHECK(batched[i] == scalar[i]);
+    }
+}
+
+void checkTriangle(const rr::TriangleStreamCmd& batched, const rr::TriangleStreamCmd& scalar)
+{
+    REQUIRE(batched.isVisible() == scalar.isVisible());
+    if (!scalar.isVisible())
+    {
+        return;
+    }
+    const rr::TriangleStreamTypes::StaticParams& b = batched.payload()[0].param;
+    const rr::TriangleStreamTypes::StaticParams& s = scalar.payload()[0].param;
+    CHECK(b.bbStartX == s.bbStartX);
+    CHECK(b.bbStartY == s.bbStartY);
+    CHECK(b.bbEndX == s.bbEndX);
+    CHECK(b.bbEndY == s.bbEndY);
+    checkVec(b.wInit, s.wInit);
+    checkVec(b.wXInc, s.wXInc);
+    checkVec(b.wYInc, s.wYInc);
+    checkVec(b.color, s.color);
+    checkVec(b.colorXInc, s.colorXInc);
+    checkVec(b.colorYInc, s.colorYInc);
+    checkVec(b.depthZw, s.depthZw);
+    checkVec(b.depthZwXInc, s.depthZwXInc);
+    checkVec(b.depthZwYInc, s.depthZwYInc);
+    for (std::size_t tmu = 0; tmu < rr::RenderConfig::TMU_COUNT; tmu++)
+    {
+        checkVec(batched.payload()[0].texture[tmu].texStq, scalar.payload()[0].texture[tmu].texStq);
+        checkVec(batched.payload()[0].texture[tmu].texStqXInc, scalar.payload()[0].texture[tmu].texStqXInc);
+        checkVec(batched.payload()[0].texture[tmu].texStqYInc, scalar.payload()[0].texture[tmu].texStqYInc);
+    }
+}
+
+void compareBatchedWithScalar(const rr::Rasterizer& rasterizer)
+{
+    TriangleGenerator generator {};
+    std::size_t visible = 0;
+    for (std::size_t run = 0; run < 500; run++)
+    {
+        // The last batch of a run is not full
+        const std::size_t count = ((run % 4) == 3) ? (run % rr::Rasterizer::BATCH_SIZE) + 1 : rr::Rasterizer::BATCH_SIZE;
+        std::vector<TriangleData> triangles {};
+        rr::Rasterizer::TriangleBatch batch {};
+        for (std::size_t i = 0; i < count; i++)
+        {
+            triangles.push_back(generator.next());
+            batch.add(triangles.back().get());
+        }
+        std::array<rr::TriangleStreamCmd, rr::Rasterizer::BATCH_SIZE> cmds {};
+        rr::TriangleStreamCmd::rasterize(rasterizer, batch, cmds);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            INFO("Run " << run << " triangle " << i);
+            const rr::TriangleStreamCmd scalar { rasterizer, triangles[i].get() };
+            checkTriangle(cmds[i], scalar);
+            visible += scalar.isVisible() ? 1 : 0;
+        }
+    }
+    CHECK(visible > 0);
+}
+
+} // namespace
+
+TEST_CASE("The batched triangle setup is equal to the scalar triangle setup", "[Rasterizer]")
+{
+    const bool enableScaling = GENERATE(false, true);
+    rr::Rasterizer rasterizer { enableScaling };
+    for (std::size_t tmu = 0; tmu < rr::RenderConfig::TMU_COUNT; tmu++)
+    {
+        rasterizer.enableTmu(tmu, true);
+    }
+
+    SECTION("Without scissor")
+    {
+        compareBatchedWithScalar(rasterizer);
+    }
+
+    SECTION("With scissor")
+    {
+        rasterizer.setScissorBox(40, 30, 200, 150);
+        rasterizer.enableScissor(true);
+        compareBatchedWithScalar(rasterizer);
+    }
+}
@@ -0,0 +1,117 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "renderer/threadedRasterizer/SpscRingBuffer.hpp"
+#include <thread>
+
+TEST_CASE("Fill and drain the ring buffer across the wrap around", "[SpscRingBuffer]")
+{
+    rr::SpscRingBuffer<uint32_t, 4> ring {};
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+
+    // Every round fills the ring with a different offset to the end of the storage
+    for (std::size_t round = 0; round < 10; round++)
+    {
+        while (ring.size() < ring.capacity())
+        {
+            REQUIRE(ring.push(pushed));
+            pushed++;
+        }
+        REQUIRE(ring.size() == ring.capacity());
+        REQUIRE(!ring.push(0xdead));
+
+        // One free slot
+        uint32_t value = 0;
+        REQUIRE(ring.pop(value));
+        REQUIRE(value == popped);
+        popped++;
+        REQUIRE(ring.push(pushed));
+        pushed++;
+        REQUIRE(!ring.push(0xdead));
+
+        // Keep (round % capacity) elements for the next round
+        while (ring.size() > (round % ring.capacity()))
+        {
+            REQUIRE(ring.pop(value));
+            REQUIRE(value == popped);
+            popped++;
+        }
+    }
+
+    uint32_t value = 0;
+    while (ring.pop(value))
+    {
+        REQUIRE(value == popped);
+        popped++;
+    }
+    REQUIRE(popped == pushed);
+    REQUIRE(ring.empty());
+    REQUIRE(!ring.pop(value));
+}
+
+TEST_CASE("Transfer elements from a producer to a consumer thread", "[SpscRingBuffer]")
+{
+    static constexpr uint32_t ELEMENTS { 200000 };
+    static constexpr uint32_t PAUSE_INTERVAL { 10000 };
+    rr::SpscRingBuffer<uint32_t, 8> ring {};
+
+    std::thread producer { [&ring]()
+        {
+            for (uint32_t i = 0; i < ELEMENTS; i++)
+            {
+                while (!ring.push(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        } };
+
+    // The consumer checks the order and that no element gets lost or duplicated when the indices wrap around.
+    // It pauses regularly till the producer has filled the ring, to run into the full ring from the other thread.
+    bool inOrder = true;
+    std::size_t fullRing = 0;
+    uint32_t expected = 0;
+    while (expected < ELEMENTS)
+    {
+        if ((expected % PAUSE_INTERVAL) == 0)
+        {
+            while (ring.size() < ring.capacity())
+            {
+                std::this_thread::yield();
+            }
+            fullRing++;
+        }
+        uint32_t value = 0;
+        if (ring.pop(value))
+        {
+            inOrder = inOrder && (value == expected);
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    REQUIRE(inOrder);
+    REQUIRE(fullRing == (ELEMENTS / PAUSE_INTERVAL));
+    REQUIRE(ring.empty());
+}
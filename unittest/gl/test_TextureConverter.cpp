@@ -0,0 +1,296 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "RIXGL.hpp"
+#include "TextureConverter.hpp"
+#include "gl.h"
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using IPF = rr::TextureObject::IntendedInternalPixelFormat;
+
+struct Rgba
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
+// Replicates the upper bits of a component into the lower bits
+uint8_t expand(const uint32_t value, const uint32_t bits)
+{
+    const uint32_t v = value & ((1u << bits) - 1);
+    return static_cast<uint8_t>((v << (8 - bits)) | (v >> ((2 * bits) - 8)));
+}
+
+template <typename T>
+T load(const uint8_t* p)
+{
+    T val;
+    std::memcpy(&val, p, sizeof(T));
+    return val;
+}
+
+// Decodes the client pixels as described in the OpenGL specification. The converter has its own readers.
+struct SourceFormat
+{
+    GLenum format;
+    GLenum type;
+    std::size_t bytes;
+    Rgba (*read)(const uint8_t* p);
+};
+
+const std::vector<SourceFormat> SOURCE_FORMATS {
+    { GL_RGB, GL_UNSIGNED_BYTE, 3, [](const uint8_t* p)
+        { return Rgba { p[0], p[1], p[2], 0xff }; } },
+    { GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2, [](const uint8_t* p)
+        {
+            const uint16_t c = load<uint16_t>(p);
+            return Rgba { expand(c >> 11, 5), expand(c >> 5, 6), expand(c, 5), 0xff };
+        } },
+    { GL_RGBA, GL_UNSIGNED_BYTE, 4, [](const uint8_t* p)
+        { return Rgba { p[0], p[1], p[2], p[3] }; } },
+    { GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, 2, [](const uint8_t* p)
+        {
+            const uint16_t c = load<uint16_t>(p);
+            return Rgba { expand(c >> 11, 5), expand(c >> 6, 5), expand(c >> 1, 5), static_cast<uint8_t>((c & 0x1) ? 0xff : 0) };
+        } },
+    { GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, 2, [](const uint8_t* p)
+        {
+            const uint16_t c = load<uint16_t>(p);
+            return Rgba { expand(c >> 12, 4), expand(c >> 8, 4), expand(c >> 4, 4), expand(c, 4) };
+        } },
+    { GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, 4, [](const uint8_t* p)
+        {
+            const uint32_t c = load<uint32_t>(p);
+            return Rgba { static_cast<uint8_t>(c >> 24), static_cast<uint8_t>(c >> 16), static_cast<uint8_t>(c >> 8), static_cast<uint8_t>(c) };
+        } },
+    { GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, 4, [](const uint8_t* p)
+        {
+            const uint32_t c = load<uint32_t>(p);
+            return Rgba { static_cast<uint8_t>(c), static_cast<uint8_t>(c >> 8), static_cast<uint8_t>(c >> 16), static_cast<uint8_t>(c >> 24) };
+        } },
+    { GL_BGR, GL_UNSIGNED_BYTE, 3, [](const uint8_t* p)
+        { return Rgba { p[2], p[1], p[0], 0xff }; } },
+    { GL_BGRA, GL_UNSIGNED_BYTE, 4, [](const uint8_t* p)
+        { return Rgba { p[2], p[1], p[0], p[3] }; } },
+    { GL_BGRA, GL_UNSIGNED_SHORT_1_5_5_5_REV, 2, [](const uint8_t* p)
+        {
+            const uint16_t c = load<uint16_t>(p);
+            return Rgba { expand(c >> 10, 5), expand(c >> 5, 5), expand(c, 5), static_cast<uint8_t>((c >> 15) ? 0xff : 0) };
+        } },
+    { GL_BGRA, GL_UNSIGNED_SHORT_4_4_4_4_REV, 2, [](const uint8_t* p)
+        {
+            const uint16_t c = load<uint16_t>(p);
+            return Rgba { expand(c >> 8, 4), expand(c >> 4, 4), expand(c, 4), expand(c >> 12, 4) };
+        } },
+    { GL_BGRA, GL_UNSIGNED_INT_8_8_8_8, 4, [](const uint8_t* p)
+        {
+            const uint32_t c = load<uint32_t>(p);
+            return Rgba { static_cast<uint8_t>(c >> 8), static_cast<uint8_t>(c >> 16), static_cast<uint8_t>(c >> 24), static_cast<uint8_t>(c) };
+        } },
+    { GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 4, [](const uint8_t* p)
+        {
+            const uint32_t c = load<uint32_t>(p);
+            return Rgba { static_cast<uint8_t>(c >> 16), static_cast<uint8_t>(c >> 8), static_cast<uint8_t>(c), static_cast<uint8_t>(c >> 24) };
+        } },
+    { GL_ALPHA, GL_UNSIGNED_BYTE, 1, [](const uint8_t* p)
+        { return Rgba { 0, 0, 0, p[0] }; } },
+    { GL_RED, GL_UNSIGNED_BYTE, 1, [](const uint8_t* p)
+        { return Rgba { p[0], 0, 0, 0xff }; } },
+    { GL_GREEN, GL_UNSIGNED_BYTE, 1, [](const uint8_t* p)
+        { return Rgba { 0, p[0], 0, 0xff }; } },
+    { GL_BLUE, GL_UNSIGNED_BYTE, 1, [](const uint8_t* p)
+        { return Rgba { 0, 0, p[0], 0xff }; } },
+    { GL_LUMINANCE, GL_UNSIGNED_BYTE, 1, [](const uint8_t* p)
+        { return Rgba { p[0], p[0], p[0], 0xff }; } },
+    { GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, 2, [](const uint8_t* p)
+        { return Rgba { p[0], p[0], p[0], p[1] }; } },
+};
+
+const std::vector<IPF> TEXTURE_FORMATS {
+    IPF::ALPHA,
+    IPF::LUMINANCE,
+    IPF::INTENSITY,
+    IPF::LUMINANCE_ALPHA,
+    IPF::RGB,
+    IPF::RGBA,
+    IPF::RGBA1,
+};
+
+constexpr uint16_t UNTOUCHED { 0xdead };
+
+std::vector<uint8_t> createPixels(const std::size_t size, const uint32_t seed)
+{
+    std::mt19937 rng { seed };
+    std::vector<uint8_t> pixels(size);
+    for (uint8_t& p : pixels)
+    {
+        p = static_cast<uint8_t>(rng());
+    }
+    return pixels;
+}
+
+std::shared_ptr<uint16_t> createTextureMemory(const std::size_t size)
+{
+    std::shared_ptr<uint16_t> texels(new uint16_t[size], [](const uint16_t* p)
+        { delete[] p; });
+    std::fill(texels.get(), texels.get() + size, UNTOUCHED);
+    return texels;
+}
+
+// Returns the texel which the converter is expected to write for the client pixel at x, y
+uint16_t expectedTexel(
+    const IPF ipf,
+    const SourceFormat& source,
+    const std::vector<uint8_t>& pixels,
+    const rr::RIXGL::PixelStore& unpack,
+    const std::size_t width,
+    const std::size_t x,
+    const std::size_t y)
+{
+    const std::size_t rowLength = (unpack.rowLength > 0) ? unpack.rowLength : width;
+    const std::size_t rowStride = ((rowLength * source.bytes + unpack.alignment - 1) / unpack.alignment) * unpack.alignment;
+    const Rgba c = source.read(pixels.data() + ((unpack.skipRows + y) * rowStride) + ((unpack.skipPixels + x) * source.bytes));
+    return rr::TextureObject::convertColor(ipf, c.r, c.g, c.b, c.a);
+}
+
+} // namespace
+
+TEST_CASE("Convert all client formats into all texture formats", "[TextureConverter]")
+{
+    // Row lengths around the SIMD width of eight texels. Texels behind the last complete vector are converted by the scalar loop.
+    static constexpr std::size_t HEIGHT { 3 };
+    const std::vector<std::size_t> widths { 1, 3, 7, 8, 9, 15, 16, 17, 33 };
+    const rr::RIXGL::PixelStore unpack { 0, 0, 0, 1 };
+
+    uint32_t seed = 0;
+    bool matches = true;
+    for (const SourceFormat& source : SOURCE_FORMATS)
+    {
+        for (const IPF ipf : TEXTURE_FORMATS)
+        {
+            for (const std::size_t width : widths)
+            {
+                const std::vector<uint8_t> pixels = createPixels(width * HEIGHT * source.bytes, seed++);
+                const std::shared_ptr<uint16_t> texels = createTextureMemory((width + 1) * HEIGHT);
+                rr::TextureConverter::convert(texels, ipf, width + 1, 0, 0, width, HEIGHT, source.format, source.type, pixels.data(), unpack);
+
+                for (std::size_t y = 0; y < HEIGHT; y++)
+                {
+                    for (std::size_t x = 0; x < width; x++)
+                    {
+                        const uint16_t expected = expectedTexel(ipf, source, pixels, unpack, width, x, y);
+                        const uint16_t texel = texels.get()[(y * (width + 1)) + x];
+                        if (texel != expected)
+                        {
+                            UNSCOPED_INFO("format 0x" << std::hex << source.format << " type 0x" << source.type << std::dec
+                                                      << " ipf " << static_cast<int>(ipf) << " width " << width
+                                                      << " texel " << x << ", " << y << ": " << texel << " != " << expected);
+                            matches = false;
+                        }
+                    }
+                    // The converter does not write behind the row
+                    matches = matches && (texels.get()[(y * (width + 1)) + width] == UNTOUCHED);
+                }
+            }
+        }
+    }
+    REQUIRE(matches);
+}
+
+TEST_CASE("Apply the unpack state of the client pixels", "[TextureConverter]")
+{
+    const SourceFormat& source = SOURCE_FORMATS[0]; // GL_RGB, GL_UNSIGNED_BYTE
+    static constexpr std::size_t WIDTH { 5 };
+    static constexpr std::size_t HEIGHT { 4 };
+    // Texture memory with a border around the image
+    static constexpr std::size_t TEXTURE_WIDTH { 8 };
+    static constexpr std::size_t TEXTURE_HEIGHT { 6 };
+    static constexpr GLint XOFFSET { 2 };
+    static constexpr GLint YOFFSET { 1 };
+
+    const auto testCopy = [&](const rr::RIXGL::PixelStore& unpack, const bool copyPixels)
+    {
+        // Large enough for all tested row lengths, skips and alignments
+        std::vector<uint8_t> pixels = createPixels(1024, static_cast<uint32_t>(unpack.rowLength + unpack.alignment));
+        const std::vector<uint8_t> clientPixels = pixels;
+        const std::shared_ptr<uint16_t> texels = createTextureMemory(TEXTURE_WIDTH * TEXTURE_HEIGHT);
+        const std::function<void()> conversion = rr::TextureConverter::prepareConversion(
+            texels, IPF::RGB, TEXTURE_WIDTH, XOFFSET, YOFFSET, WIDTH, HEIGHT, source.format, source.type, pixels.data(), unpack, copyPixels);
+        REQUIRE(conversion);
+        if (copyPixels)
+        {
+            // A copied image does not depend on the client memory anymore
+            std::fill(pixels.begin(), pixels.end(), 0);
+        }
+        conversion();
+
+        for (std::size_t y = 0; y < TEXTURE_HEIGHT; y++)
+        {
+            for (std::size_t x = 0; x < TEXTURE_WIDTH; x++)
+            {
+                const bool inside = (x >= XOFFSET) && (x < (XOFFSET + WIDTH)) && (y >= YOFFSET) && (y < (YOFFSET + HEIGHT));
+                const uint16_t expected = inside
+                    ? expectedTexel(IPF::RGB, source, clientPixels, unpack, WIDTH, x - XOFFSET, y - YOFFSET)
+                    : UNTOUCHED;
+                INFO("copyPixels " << copyPixels << " texel " << x << ", " << y);
+                CHECK(texels.get()[(y * TEXTURE_WIDTH) + x] == expected);
+            }
+        }
+    };
+
+    // The image is converted from the client memory and from a copy
+    const auto test = [&](const rr::RIXGL::PixelStore& unpack)
+    {
+        testCopy(unpack, false);
+        testCopy(unpack, true);
+    };
+
+    SECTION("Default alignment of four bytes")
+    {
+        // 5 RGB pixels are 15 bytes, a row starts every 16 bytes
+        test({ 0, 0, 0, 4 });
+    }
+    SECTION("Alignments")
+    {
+        for (const std::size_t alignment : { 1, 2, 8 })
+        {
+            INFO("alignment " << alignment);
+            test({ 0, 0, 0, alignment });
+        }
+    }
+    SECTION("Row length")
+    {
+        test({ 13, 0, 0, 1 });
+        test({ 13, 0, 0, 8 });
+    }
+    SECTION("Skipped rows and pixels")
+    {
+        test({ 0, 2, 0, 4 });
+        test({ 13, 0, 3, 4 });
+        test({ 13, 2, 3, 8 });
+    }
+}
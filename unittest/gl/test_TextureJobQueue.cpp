@@ -0,0 +1,143 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "renderer/TextureJobQueue.hpp"
+#include <vector>
+
+namespace
+{
+
+// Runner which keeps the operation until the test finishes it or a caller waits for it.
+// It behaves like a thread whose progress is controlled by the test.
+class ManualThreadRunner : public rr::IThreadRunner
+{
+public:
+    void wait() override { finish(); }
+    void run(const std::function<void()>& operation) override { m_operation = operation; }
+
+    /// @brief Executes the operation, like a thread which finishes it in the background
+    void finish()
+    {
+        const std::function<void()> operation { std::move(m_operation) };
+        m_operation = {};
+        if (operation)
+        {
+            operation();
+        }
+    }
+
+    bool isRunning() const { return static_cast<bool>(m_operation); }
+
+private:
+    std::function<void()> m_operation {};
+};
+
+} // namespace
+
+TEST_CASE("Jobs run on the calling thread without runners", "[TextureJobQueue]")
+{
+    rr::TextureJobQueue queue { {} };
+    std::vector<int> executed {};
+    CHECK(!queue.isAsync());
+    const rr::TextureJobQueue::Job job = queue.post([&]()
+        { executed.push_back(1); });
+    CHECK(job == rr::TextureJobQueue::NO_JOB);
+    CHECK(executed == std::vector<int> { 1 });
+    CHECK(queue.isDone(job));
+    queue.wait(job);
+    queue.waitAll();
+}
+
+TEST_CASE("Jobs are distributed round robin to the runners", "[TextureJobQueue]")
+{
+    ManualThreadRunner runner0 {};
+    ManualThreadRunner runner1 {};
+    rr::TextureJobQueue queue { { &runner0, &runner1 } };
+    std::vector<int> executed {};
+    CHECK(queue.isAsync());
+
+    const rr::TextureJobQueue::Job job0 = queue.post([&]()
+        { executed.push_back(0); });
+    const rr::TextureJobQueue::Job job1 = queue.post([&]()
+        { executed.push_back(1); });
+    CHECK(job0 != rr::TextureJobQueue::NO_JOB);
+    CHECK(job1 != rr::TextureJobQueue::NO_JOB);
+    CHECK(job0 != job1);
+    CHECK(runner0.isRunning());
+    CHECK(runner1.isRunning());
+    CHECK(!queue.isDone(job0));
+    CHECK(!queue.isDone(job1));
+    CHECK(executed.empty());
+
+    // The jobs finish independently of each other
+    runner1.finish();
+    CHECK(!queue.isDone(job0));
+    CHECK(queue.isDone(job1));
+    queue.wait(job0);
+    CHECK(queue.isDone(job0));
+    CHECK(executed == std::vector<int> { 1, 0 });
+
+    // A runner executes one job at a time. The post waits for the previous job of the selected runner.
+    const rr::TextureJobQueue::Job job2 = queue.post([&]()
+        { executed.push_back(2); });
+    const rr::TextureJobQueue::Job job3 = queue.post([&]()
+        { executed.push_back(3); });
+    const rr::TextureJobQueue::Job job4 = queue.post([&]()
+        { executed.push_back(4); });
+    CHECK(executed == std::vector<int> { 1, 0, 2 });
+    // The replaced job is not assigned to a runner anymore and therefore finished
+    CHECK(queue.isDone(job2));
+    CHECK(!queue.isDone(job3));
+    CHECK(!queue.isDone(job4));
+    CHECK(runner0.isRunning());
+    CHECK(runner1.isRunning());
+
+    runner1.finish();
+    CHECK(executed == std::vector<int> { 1, 0, 2, 3 });
+    CHECK(queue.isDone(job3));
+    CHECK(!queue.isDone(job4));
+    queue.waitAll();
+    CHECK(executed == std::vector<int> { 1, 0, 2, 3, 4 });
+    CHECK(queue.isDone(job4));
+    CHECK(!runner0.isRunning());
+    CHECK(!runner1.isRunning());
+}
+
+TEST_CASE("Waiting for a job does not wait for the other runners", "[TextureJobQueue]")
+{
+    ManualThreadRunner runner0 {};
+    ManualThreadRunner runner1 {};
+    rr::TextureJobQueue queue { { &runner0, &runner1 } };
+    std::vector<int> executed {};
+
+    queue.post([&]()
+        { executed.push_back(0); });
+    const rr::TextureJobQueue::Job job1 = queue.post([&]()
+        { executed.push_back(1); });
+    queue.wait(job1);
+    CHECK(executed == std::vector<int> { 1 });
+    CHECK(runner0.isRunning());
+
+    // Waiting for a finished job or for no job returns immediately
+    queue.wait(job1);
+    queue.wait(rr::TextureJobQueue::NO_JOB);
+    CHECK(runner0.isRunning());
+    queue.waitAll();
+    CHECK(executed == std::vector<int> { 1, 0 });
+}
@@ -0,0 +1,683 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "RenderConfigs.hpp"
+#include "renderer/IDevice.hpp"
+#include "renderer/TextureMemoryManager.hpp"
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace
+{
+
+struct TestConfig : public rr::RenderConfig
+{
+    static constexpr std::size_t NUMBER_OF_TEXTURE_PAGES { 16 };
+    static constexpr std::size_t NUMBER_OF_TEXTURES { 32 };
+    static constexpr std::size_t TEXTURE_PAGE_SIZE { 4096 };
+    static constexpr bool RELEASE_TEXTURE_HOST_COPIES { false };
+};
+
+// Device which only provides the fences. A fence is signaled, when the display list is processed.
+class FenceDevice : public rr::IDevice
+{
+public:
+    void streamDisplayList(const uint8_t, const uint32_t) override { }
+    void streamPartialDisplayList(const uint8_t, const uint32_t, const bool) override { }
+    void writeToDeviceMemory(tcb::span<const uint8_t>, const uint32_t) override { }
+    tcb::span<uint8_t> requestWriteToDeviceMemory(const uint32_t, const uint32_t) override { return {}; }
+    void flushWritesToDeviceMemory() override { }
+    bool readFromDeviceMemory(tcb::span<uint8_t> data, const uint32_t) override
+    {
+        std::fill(data.begin(), data.end(), 0);
+        return readable && !readFails;
+    }
+    bool canReadFromDeviceMemory() const override { return readable; }
+    void blockUntilDeviceIsIdle() override { m_processed = m_streamed; }
+    uint32_t insertFence() override { return m_streamed; }
+    bool isFenceSignaled(const uint32_t fence) override { return fence <= m_processed; }
+    void blockUntilFenceIsSignaled(const uint32_t fence) override
+    {
+        blockedFences.push_back(fence);
+        m_processed = (std::max)(m_processed, fence);
+    }
+    void blockUntilDisplayListBufferIsFree(const uint8_t) override { }
+    tcb::span<uint8_t> requestDisplayListBuffer(const uint8_t) override { return {}; }
+    uint8_t getDisplayListBufferCount() const override { return 2; }
+
+    /// @brief Streams the display list which is currently assembled
+    void streamDisplayList() { m_streamed++; }
+
+    /// @brief Finishes all streamed display lists
+    void processDisplayLists() { m_processed = m_streamed; }
+
+    bool readable { false };
+    bool readFails { false };
+    std::vector<uint32_t> blockedFences {};
+
+private:
+    uint32_t m_streamed { 0 };
+    uint32_t m_processed { 0 };
+};
+
+struct ReleaseHostCopiesConfig : public TestConfig
+{
+    static constexpr bool RELEASE_TEXTURE_HOST_COPIES { true };
+};
+
+using TextureMemoryManager = rr::TextureMemoryManager<TestConfig>;
+
+// Runner which keeps the operation until the test finishes it or a caller waits for it.
+// It behaves like a texture thread whose progress is controlled by the test.
+class ManualThreadRunner : public rr::IThreadRunner
+{
+public:
+    void wait() override { finish(); }
+    void run(const std::function<void()>& operation) override { m_operation = operation; }
+
+    /// @brief Executes the operation, like a thread which finishes it in the background
+    void finish()
+    {
+        const std::function<void()> operation { std::move(m_operation) };
+        m_operation = {};
+        if (operation)
+        {
+            operation();
+        }
+    }
+
+    bool isRunning() const { return static_cast<bool>(m_operation); }
+
+private:
+    std::function<void()> m_operation {};
+};
+
+template <typename TextureMemoryManager>
+uint16_t createTexture(TextureMemoryManager& tmm, const std::size_t width, const std::size_t height, const uint16_t value = 0)
+{
+    std::shared_ptr<uint16_t> pixels(new uint16_t[width * height], [](const uint16_t* p)
+        { delete[] p; });
+    std::fill(pixels.get(), pixels.get() + (width * height), value);
+    rr::TextureObjectMipmap mipmap {};
+    mipmap[0].pixels = pixels;
+    mipmap[0].width = width;
+    mipmap[0].height = height;
+    mipmap[0].intendedPixelFormat = rr::TextureObject::IntendedInternalPixelFormat::RGB;
+
+    const auto [ret, texId] = tmm.createTexture();
+    REQUIRE(ret);
+    REQUIRE(tmm.updateTexture(texId, mipmap));
+    return texId;
+}
+
+template <typename TextureMemoryManager>
+uint16_t createTexture(TextureMemoryManager& tmm, const std::size_t pages)
+{
+    // RGB textures use two bytes per texel, 64x32 texels fill one page
+    return createTexture(tmm, 64, 32 * pages);
+}
+
+template <typename TextureMemoryManager>
+uint16_t createFilledTexture(TextureMemoryManager& tmm, const std::size_t pages, const uint16_t value)
+{
+    return createTexture(tmm, 64, 32 * pages, value);
+}
+
+std::vector<std::size_t> getPages(const TextureMemoryManager& tmm, const uint16_t texId)
+{
+    const tcb::span<const std::size_t> pages = tmm.getTextureStream(texId).pages;
+    return { pages.begin(), pages.end() };
+}
+
+// Device memory which keeps the uploaded pages
+class PageMemory
+{
+public:
+    tcb::span<uint8_t> write(const uint32_t gramAddr, const uint32_t size)
+    {
+        const std::size_t page = gramAddr / TestConfig::TEXTURE_PAGE_SIZE;
+        writtenPages.push_back(page);
+        return { m_pages[page].data() + (gramAddr % TestConfig::TEXTURE_PAGE_SIZE), size };
+    }
+
+    bool contains(const std::size_t page, const std::size_t offset, const std::size_t size, const uint16_t value) const
+    {
+        const std::array<uint8_t, TestConfig::TEXTURE_PAGE_SIZE>& data = m_pages[page];
+        for (std::size_t i = offset; i < (offset + size); i += 2)
+        {
+            if ((data[i] | (data[i + 1] << 8)) != value)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool pageContains(const std::size_t page, const uint16_t value) const
+    {
+        return contains(page, 0, TestConfig::TEXTURE_PAGE_SIZE, value);
+    }
+
+    std::vector<std::size_t> writtenPages {};
+
+private:
+    std::array<std::array<uint8_t, TestConfig::TEXTURE_PAGE_SIZE>, TestConfig::NUMBER_OF_TEXTURE_PAGES> m_pages {};
+};
+
+// Posts a job which fills the host copy of a texture with a value, like a glTexSubImage2D on a texture thread
+template <typename TextureMemoryManager>
+void postFillJob(TextureMemoryManager& tmm, const uint16_t texId, const uint16_t value, std::vector<uint16_t>& executed)
+{
+    const std::optional<rr::TextureObjectMipmap> mipmap = tmm.getTexture(texId);
+    REQUIRE(mipmap);
+    const rr::TextureObject level = (*mipmap)[0];
+    REQUIRE(tmm.postTextureJob(texId, [level, value, &executed]()
+        {
+            uint16_t* pixels = const_cast<uint16_t*>(level.pixels.get());
+            std::fill(pixels, pixels + (level.width * level.height), value);
+            executed.push_back(value);
+        }));
+    rr::TextureObjectMipmapDirtyRanges dirtyRanges {};
+    dirtyRanges[0] = { 0, level.getSizeInBytes() };
+    REQUIRE(tmm.updateTexture(texId, *mipmap, dirtyRanges));
+}
+
+bool overlaps(const std::vector<std::size_t>& a, const std::vector<std::size_t>& b)
+{
+    return std::any_of(a.begin(), a.end(), [&](const std::size_t page)
+        { return std::find(b.begin(), b.end(), page) != b.end(); });
+}
+
+} // namespace
+
+TEST_CASE("Compaction keeps the old pages of moved textures until the display list is processed", "[TextureMemoryManager]")
+{
+    FenceDevice device {};
+    TextureMemoryManager tmm { device };
+    std::vector<uint8_t> page(TestConfig::TEXTURE_PAGE_SIZE);
+    std::vector<std::size_t> writtenPages {};
+    const auto pageBufferProvider = [&](const uint32_t gramAddr, const uint32_t size)
+    {
+        writtenPages.push_back(gramAddr / TestConfig::TEXTURE_PAGE_SIZE);
+        return tcb::span<uint8_t> { page.data(), size };
+    };
+
+    // Fill the texture memory with textures of one page
+    std::vector<uint16_t> textures {};
+    for (std::size_t i = 0; i < TestConfig::NUMBER_OF_TEXTURE_PAGES; i++)
+    {
+        textures.push_back(createTexture(tmm, 1));
+    }
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // Every second page of the first half of the memory is freed
+    for (std::size_t i = 1; i < 8; i += 2)
+    {
+        REQUIRE(tmm.deleteTexture(textures[i]));
+    }
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    REQUIRE(tmm.getStatistics().freePages == 4);
+
+    // Two textures of two pages are scattered over the holes and used by the current display list
+    const uint16_t tex0 = createTexture(tmm, 2);
+    const uint16_t tex1 = createTexture(tmm, 2);
+    REQUIRE(tmm.useTexture(tex0));
+    REQUIRE(tmm.useTexture(tex1));
+    const std::vector<std::size_t> oldPages0 = getPages(tmm, tex0);
+    const std::vector<std::size_t> oldPages1 = getPages(tmm, tex1);
+    REQUIRE(oldPages0.size() == 2);
+    REQUIRE(oldPages1.size() == 2);
+    REQUIRE(!overlaps(oldPages0, oldPages1));
+    REQUIRE(tmm.getStatistics().fragmentedTextures == 2);
+
+    // The upload moves both textures. The display list is streamed after the upload and still reads the old pages.
+    writtenPages.clear();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    const std::vector<std::size_t> newPages0 = getPages(tmm, tex0);
+    const std::vector<std::size_t> newPages1 = getPages(tmm, tex1);
+    REQUIRE(tmm.getStatistics().fragmentedTextures == 0);
+    CHECK(!overlaps(newPages0, oldPages0));
+    CHECK(!overlaps(newPages0, oldPages1));
+    CHECK(!overlaps(newPages1, oldPages0));
+    CHECK(!overlaps(newPages1, oldPages1));
+    CHECK(!overlaps(newPages0, newPages1));
+    // The first writes upload the textures into their old pages, the following writes move them
+    const std::vector<std::size_t> movedPages { writtenPages.begin() + oldPages0.size() + oldPages1.size(), writtenPages.end() };
+    CHECK(movedPages.size() == 4);
+    CHECK(!overlaps(movedPages, oldPages0));
+    CHECK(!overlaps(movedPages, oldPages1));
+
+    // The old pages are freed when the display list is processed
+    const std::size_t freePages = tmm.getStatistics().freePages;
+    device.streamDisplayList();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(tmm.getStatistics().freePages == freePages);
+    device.processDisplayLists();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(tmm.getStatistics().freePages == (freePages + 4));
+}
+
+TEST_CASE("Compaction does not use the pages of textures deleted after a draw", "[TextureMemoryManager]")
+{
+    FenceDevice device {};
+    TextureMemoryManager tmm { device };
+    std::vector<uint8_t> page(TestConfig::TEXTURE_PAGE_SIZE);
+    std::vector<std::size_t> writtenPages {};
+    const auto pageBufferProvider = [&](const uint32_t gramAddr, const uint32_t size)
+    {
+        writtenPages.push_back(gramAddr / TestConfig::TEXTURE_PAGE_SIZE);
+        return tcb::span<uint8_t> { page.data(), size };
+    };
+    const auto useTextures = [&](const std::vector<uint16_t>& textures)
+    {
+        for (const uint16_t texId : textures)
+        {
+            REQUIRE(tmm.useTexture(texId));
+        }
+    };
+
+    // Fill the texture memory. Page 4 is a shared page with one small texture.
+    std::vector<uint16_t> textures {};
+    for (std::size_t i = 0; i < TestConfig::NUMBER_OF_TEXTURE_PAGES; i++)
+    {
+        textures.push_back((i == 4) ? createTexture(tmm, 16, 16) : createTexture(tmm, 1));
+    }
+    REQUIRE(getPages(tmm, textures[4]) == std::vector<std::size_t> { 4 });
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // A texture of two pages is scattered over the pages 1 and 3. All other textures are used, they can't be displaced.
+    REQUIRE(tmm.deleteTexture(textures[1]));
+    REQUIRE(tmm.deleteTexture(textures[3]));
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    const uint16_t fragmented = createTexture(tmm, 2);
+    REQUIRE(getPages(tmm, fragmented) == std::vector<std::size_t> { 1, 3 });
+    textures.erase(textures.begin() + 3);
+    textures.erase(textures.begin() + 1);
+    textures.push_back(fragmented);
+    useTextures(textures);
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    REQUIRE(tmm.getStatistics().fragmentedTextures == 1);
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // The small texture in page 4 and the texture in page 5 are used by a draw and deleted afterwards.
+    // The display list, which is streamed after the upload, still reads page 4 and 5.
+    useTextures(textures);
+    REQUIRE(getPages(tmm, textures[2]) == std::vector<std::size_t> { 4 });
+    REQUIRE(getPages(tmm, textures[3]) == std::vector<std::size_t> { 5 });
+    REQUIRE(tmm.deleteTexture(textures[2]));
+    REQUIRE(tmm.deleteTexture(textures[3]));
+    writtenPages.clear();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(std::find(writtenPages.begin(), writtenPages.end(), 4) == writtenPages.end());
+    CHECK(std::find(writtenPages.begin(), writtenPages.end(), 5) == writtenPages.end());
+    CHECK(getPages(tmm, fragmented) == std::vector<std::size_t> { 1, 3 });
+    CHECK(tmm.getStatistics().freePages == 0);
+
+    // When the display list is processed, the pages are freed and the compaction can use them
+    device.streamDisplayList();
+    device.processDisplayLists();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(getPages(tmm, fragmented) == std::vector<std::size_t> { 4, 5 });
+    CHECK(tmm.getStatistics().fragmentedTextures == 0);
+}
+
+TEST_CASE("Host copies are only released when the device memory can be read back", "[TextureMemoryManager]")
+{
+    FenceDevice device {};
+    rr::TextureMemoryManager<ReleaseHostCopiesConfig> tmm { device };
+    std::vector<uint8_t> page(TestConfig::TEXTURE_PAGE_SIZE);
+    const auto pageBufferProvider = [&](const uint32_t, const uint32_t size)
+    {
+        return tcb::span<uint8_t> { page.data(), size };
+    };
+
+    SECTION("A device which can't read back keeps the host copy")
+    {
+        const uint16_t texId = createTexture(tmm, 1);
+        REQUIRE(tmm.uploadTextures(pageBufferProvider));
+        device.readFails = true;
+        const std::optional<rr::TextureObjectMipmap> mipmap = tmm.getTexture(texId);
+        REQUIRE(mipmap);
+        CHECK((*mipmap)[0].pixels);
+    }
+
+    SECTION("A released host copy is read back")
+    {
+        device.readable = true;
+        const uint16_t texId = createTexture(tmm, 1);
+        REQUIRE(tmm.uploadTextures(pageBufferProvider));
+        const std::optional<rr::TextureObjectMipmap> mipmap = tmm.getTexture(texId);
+        REQUIRE(mipmap);
+        CHECK((*mipmap)[0].pixels);
+    }
+
+    SECTION("A failed read back does not return a host copy")
+    {
+        device.readable = true;
+        const uint16_t texId = createTexture(tmm, 1);
+        REQUIRE(tmm.uploadTextures(pageBufferProvider));
+        device.readFails = true;
+        CHECK(!tmm.getTexture(texId));
+        // The texture is still usable with its pages
+        CHECK(tmm.useTexture(texId));
+        CHECK(tmm.getTextureStream(texId).pages.size() == 1);
+        device.readFails = false;
+        CHECK(tmm.getTexture(texId));
+    }
+}
+
+TEST_CASE("Textures are evicted in the order of their last use", "[TextureMemoryManager]")
+{
+    FenceDevice device {};
+    TextureMemoryManager tmm { device };
+    PageMemory memory {};
+    const auto pageBufferProvider = [&](const uint32_t gramAddr, const uint32_t size)
+    {
+        return memory.write(gramAddr, size);
+    };
+
+    // Fill the texture memory. Every texture contains its index + 1.
+    std::vector<uint16_t> textures {};
+    for (std::size_t i = 0; i < TestConfig::NUMBER_OF_TEXTURE_PAGES; i++)
+    {
+        textures.push_back(createFilledTexture(tmm, 1, static_cast<uint16_t>(i + 1)));
+    }
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // The first two textures are used again. The new textures displace the following textures in the order of their creation.
+    REQUIRE(tmm.useTexture(textures[0]));
+    REQUIRE(tmm.useTexture(textures[1]));
+    const uint16_t tex0 = createFilledTexture(tmm, 1, 0x100);
+    const uint16_t tex1 = createFilledTexture(tmm, 2, 0x101);
+    CHECK(getPages(tmm, tex0) == std::vector<std::size_t> { 2 });
+    CHECK(getPages(tmm, tex1) == std::vector<std::size_t> { 3, 4 });
+    CHECK(getPages(tmm, textures[2]).empty());
+    CHECK(getPages(tmm, textures[3]).empty());
+    CHECK(getPages(tmm, textures[4]).empty());
+    for (const std::size_t i : { 0, 1, 5, 6, 15 })
+    {
+        CHECK(getPages(tmm, textures[i]) == std::vector<std::size_t> { i });
+    }
+    // The evicted textures are still valid, they only lost their pages
+    CHECK(tmm.textureValid(textures[2]));
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.pageContains(2, 0x100));
+    CHECK(memory.pageContains(4, 0x101));
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // An evicted texture is reloaded from its host copy, when it is used. It displaces the least recently used texture.
+    REQUIRE(tmm.useTexture(textures[2]));
+    CHECK(getPages(tmm, textures[2]) == std::vector<std::size_t> { 5 });
+    CHECK(getPages(tmm, textures[5]).empty());
+    memory.writtenPages.clear();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.writtenPages == std::vector<std::size_t> { 5 });
+    CHECK(memory.pageContains(5, 3));
+
+    // A reloaded texture is the most recently used texture
+    device.streamDisplayList();
+    device.processDisplayLists();
+    REQUIRE(tmm.useTexture(textures[5]));
+    CHECK(getPages(tmm, textures[5]) == std::vector<std::size_t> { 6 });
+    CHECK(getPages(tmm, textures[2]) == std::vector<std::size_t> { 5 });
+}
+
+TEST_CASE("Textures used by the current display list are not evicted", "[TextureMemoryManager]")
+{
+    FenceDevice device {};
+    TextureMemoryManager tmm { device };
+    PageMemory memory {};
+    const auto pageBufferProvider = [&](const uint32_t gramAddr, const uint32_t size)
+    {
+        return memory.write(gramAddr, size);
+    };
+
+    std::vector<uint16_t> textures {};
+    for (std::size_t i = 0; i < TestConfig::NUMBER_OF_TEXTURE_PAGES; i++)
+    {
+        textures.push_back(createFilledTexture(tmm, 1, static_cast<uint16_t>(i + 1)));
+    }
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // All textures are used by the current display list. A new texture gets no pages and can't be loaded.
+    for (const uint16_t texId : textures)
+    {
+        REQUIRE(tmm.useTexture(texId));
+    }
+    const uint16_t texId = createFilledTexture(tmm, 1, 0x100);
+    CHECK(tmm.textureValid(texId));
+    CHECK(getPages(tmm, texId).empty());
+    CHECK(!tmm.useTexture(texId));
+    for (std::size_t i = 0; i < textures.size(); i++)
+    {
+        CHECK(getPages(tmm, textures[i]) == std::vector<std::size_t> { i });
+    }
+    memory.writtenPages.clear();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.writtenPages.empty());
+    CHECK(device.blockedFences.empty());
+
+    // The display list is streamed but not processed. The next display list evicts the least recently used texture.
+    // The eviction waits until the streamed display list, which still reads the pages, is processed.
+    const uint32_t streamedFence = device.insertFence() + 1;
+    device.streamDisplayList();
+    REQUIRE(tmm.useTexture(texId));
+    CHECK(device.blockedFences == std::vector<uint32_t> { streamedFence });
+    CHECK(getPages(tmm, texId) == std::vector<std::size_t> { 0 });
+    CHECK(getPages(tmm, textures[0]).empty());
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.pageContains(0, 0x100));
+}
+
+TEST_CASE("Small textures share pages", "[TextureMemoryManager]")
+{
+    static constexpr std::size_t BLOCK_SIZE { TestConfig::TEXTURE_PAGE_BLOCK_SIZE };
+    FenceDevice device {};
+    TextureMemoryManager tmm { device };
+    PageMemory memory {};
+    const auto pageBufferProvider = [&](const uint32_t gramAddr, const uint32_t size)
+    {
+        return memory.write(gramAddr, size);
+    };
+    // A page contains four blocks. Textures with at most two blocks share pages.
+    REQUIRE(TextureMemoryManager::BLOCKS_PER_PAGE == 4);
+    REQUIRE(TextureMemoryManager::MAX_BLOCKS_PER_SHARED_TEXTURE == 2);
+
+    // 16x16 texels use half a block, 32x32 texels use two blocks
+    const uint16_t tex0 = createTexture(tmm, 16, 16, 1);
+    const uint16_t tex1 = createTexture(tmm, 32, 32, 2);
+    const uint16_t tex2 = createTexture(tmm, 16, 16, 3);
+    const std::size_t sharedPage = getPages(tmm, tex0).at(0);
+    CHECK(getPages(tmm, tex1) == std::vector<std::size_t> { sharedPage });
+    CHECK(getPages(tmm, tex2) == std::vector<std::size_t> { sharedPage });
+    CHECK(tmm.getTextureStream(tex0).pageOffset == 0);
+    CHECK(tmm.getTextureStream(tex1).pageOffset == BLOCK_SIZE);
+    CHECK(tmm.getTextureStream(tex2).pageOffset == (3 * BLOCK_SIZE));
+    CHECK(tmm.getTextureStream(tex0).size == 512);
+    CHECK(tmm.getTextureStream(tex1).size == (2 * BLOCK_SIZE));
+    CHECK(tmm.getStatistics().sharedPages == 1);
+    CHECK(tmm.getStatistics().usedPages == 1);
+
+    // The page is full, the next small texture opens a new shared page
+    const uint16_t tex3 = createTexture(tmm, 16, 16, 4);
+    const std::size_t secondSharedPage = getPages(tmm, tex3).at(0);
+    CHECK(secondSharedPage != sharedPage);
+    CHECK(tmm.getTextureStream(tex3).pageOffset == 0);
+    CHECK(tmm.getStatistics().sharedPages == 2);
+
+    // A texture with three blocks uses a page of its own
+    const uint16_t tex4 = createTexture(tmm, 32, 48, 5);
+    CHECK(tmm.getTextureStream(tex4).pageOffset == 0);
+    CHECK(tmm.getStatistics().sharedPages == 2);
+    CHECK(tmm.getStatistics().usedPages == 3);
+
+    // Every texture only writes its own blocks
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.contains(sharedPage, 0, 512, 1));
+    CHECK(memory.contains(sharedPage, BLOCK_SIZE, 2 * BLOCK_SIZE, 2));
+    CHECK(memory.contains(sharedPage, 3 * BLOCK_SIZE, 512, 3));
+    CHECK(memory.contains(secondSharedPage, 0, 512, 4));
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // The freed blocks are used by the next textures. The page stays shared while it contains textures.
+    REQUIRE(tmm.deleteTexture(tex1));
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(tmm.getStatistics().sharedPages == 2);
+    const uint16_t tex5 = createTexture(tmm, 16, 32, 6);
+    const uint16_t tex6 = createTexture(tmm, 16, 32, 7);
+    const uint16_t tex7 = createTexture(tmm, 32, 32, 8);
+    CHECK(getPages(tmm, tex5) == std::vector<std::size_t> { sharedPage });
+    CHECK(getPages(tmm, tex6) == std::vector<std::size_t> { sharedPage });
+    CHECK(tmm.getTextureStream(tex5).pageOffset == BLOCK_SIZE);
+    CHECK(tmm.getTextureStream(tex6).pageOffset == (2 * BLOCK_SIZE));
+    CHECK(getPages(tmm, tex7) == std::vector<std::size_t> { secondSharedPage });
+    CHECK(tmm.getTextureStream(tex7).pageOffset == BLOCK_SIZE);
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.contains(sharedPage, 0, 512, 1));
+    CHECK(memory.contains(sharedPage, BLOCK_SIZE, BLOCK_SIZE, 6));
+    CHECK(memory.contains(sharedPage, 2 * BLOCK_SIZE, BLOCK_SIZE, 7));
+    CHECK(memory.contains(sharedPage, 3 * BLOCK_SIZE, 512, 3));
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // A page is freed with its last texture
+    const std::size_t usedPages = tmm.getStatistics().usedPages;
+    for (const uint16_t texId : { tex0, tex2, tex5 })
+    {
+        REQUIRE(tmm.deleteTexture(texId));
+    }
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(tmm.getStatistics().sharedPages == 2);
+    CHECK(tmm.getStatistics().usedPages == usedPages);
+    REQUIRE(tmm.deleteTexture(tex6));
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(tmm.getStatistics().sharedPages == 1);
+    CHECK(tmm.getStatistics().usedPages == (usedPages - 1));
+}
+
+TEST_CASE("The upload only waits for the pending jobs of textures used by the current display list", "[TextureMemoryManager]")
+{
+    ManualThreadRunner runner0 {};
+    ManualThreadRunner runner1 {};
+    FenceDevice device {};
+    TextureMemoryManager tmm { device, { &runner0, &runner1 } };
+    PageMemory memory {};
+    const auto pageBufferProvider = [&](const uint32_t gramAddr, const uint32_t size)
+    {
+        return memory.write(gramAddr, size);
+    };
+    std::vector<uint16_t> executed {};
+
+    const uint16_t used = createFilledTexture(tmm, 1, 1);
+    const uint16_t unused = createFilledTexture(tmm, 1, 2);
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    device.streamDisplayList();
+    device.processDisplayLists();
+
+    // Both textures are modified in the background. Only the first one is used by the next display list.
+    postFillJob(tmm, used, 3, executed);
+    postFillJob(tmm, unused, 4, executed);
+    REQUIRE(runner0.isRunning());
+    REQUIRE(runner1.isRunning());
+    REQUIRE(tmm.useTexture(used));
+
+    memory.writtenPages.clear();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(executed == std::vector<uint16_t> { 3 });
+    CHECK(!runner0.isRunning());
+    CHECK(runner1.isRunning());
+    CHECK(memory.writtenPages == getPages(tmm, used));
+    CHECK(memory.pageContains(getPages(tmm, used)[0], 3));
+    CHECK(memory.pageContains(getPages(tmm, unused)[0], 2));
+    // The pending texture stays dirty
+    CHECK(tmm.textureUpdateRequired());
+
+    // When the job is finished, the next upload contains the texture
+    runner1.finish();
+    memory.writtenPages.clear();
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.writtenPages == getPages(tmm, unused));
+    CHECK(memory.pageContains(getPages(tmm, unused)[0], 4));
+    CHECK(!tmm.textureUpdateRequired());
+
+    // A pending texture which is used by a later display list is waited for then
+    device.streamDisplayList();
+    device.processDisplayLists();
+    postFillJob(tmm, unused, 5, executed);
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.pageContains(getPages(tmm, unused)[0], 4));
+    device.streamDisplayList();
+    device.processDisplayLists();
+    REQUIRE(tmm.useTexture(unused));
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.pageContains(getPages(tmm, unused)[0], 5));
+    CHECK(executed == std::vector<uint16_t> { 3, 4, 5 });
+}
+
+TEST_CASE("The jobs of a texture run in the order they were posted", "[TextureMemoryManager]")
+{
+    ManualThreadRunner runner0 {};
+    ManualThreadRunner runner1 {};
+    FenceDevice device {};
+    TextureMemoryManager tmm { device, { &runner0, &runner1 } };
+    PageMemory memory {};
+    const auto pageBufferProvider = [&](const uint32_t gramAddr, const uint32_t size)
+    {
+        return memory.write(gramAddr, size);
+    };
+    std::vector<uint16_t> executed {};
+    REQUIRE(tmm.isTextureJobAsync());
+
+    const uint16_t tex0 = createFilledTexture(tmm, 1, 1);
+    const uint16_t tex1 = createFilledTexture(tmm, 1, 2);
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+
+    // The second job of a texture waits for the first one, even if it runs on another runner
+    postFillJob(tmm, tex0, 3, executed);
+    CHECK(executed.empty());
+    postFillJob(tmm, tex0, 4, executed);
+    CHECK(executed == std::vector<uint16_t> { 3 });
+
+    // The job of another texture does not wait
+    postFillJob(tmm, tex1, 5, executed);
+    CHECK(executed == std::vector<uint16_t> { 3 });
+
+    runner1.finish();
+    CHECK(executed == std::vector<uint16_t> { 3, 4 });
+    tmm.waitForTextureJobs();
+    CHECK(executed == std::vector<uint16_t> { 3, 4, 5 });
+    REQUIRE(tmm.useTexture(tex0));
+    REQUIRE(tmm.useTexture(tex1));
+    REQUIRE(tmm.uploadTextures(pageBufferProvider));
+    CHECK(memory.pageContains(getPages(tmm, tex0)[0], 4));
+    CHECK(memory.pageContains(getPages(tmm, tex1)[0], 5));
+}
@@ -0,0 +1,139 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "RenderConfigs.hpp"
+#include "renderer/commands/TextureStreamCmd.hpp"
+#include <vector>
+
+namespace
+{
+
+static constexpr std::size_t PAGE_SIZE { rr::RenderConfig::TEXTURE_PAGE_SIZE };
+static constexpr std::size_t BLOCK_SIZE { rr::RenderConfig::TEXTURE_PAGE_BLOCK_SIZE };
+static constexpr std::size_t BLOCKS_PER_PAGE { PAGE_SIZE / BLOCK_SIZE };
+
+struct StreamedPage
+{
+    uint32_t addr;
+    uint32_t blocks; ///< 0 streams the complete page
+};
+
+// Splits a payload entry into the block aligned address and the number of blocks
+StreamedPage decode(const uint32_t entry)
+{
+    return { entry & ~static_cast<uint32_t>(BLOCK_SIZE - 1), entry & static_cast<uint32_t>(BLOCK_SIZE - 1) };
+}
+
+uint32_t pageAddr(const std::size_t page, const std::size_t offset = 0)
+{
+    return rr::RenderConfig::GRAM_MEMORY_LOC + static_cast<uint32_t>((page * PAGE_SIZE) + offset);
+}
+
+} // namespace
+
+TEST_CASE("Encode the pages of a texture", "[TextureStreamCmd]")
+{
+    const std::vector<std::size_t> pages { 5, 2, 9 };
+
+    SECTION("Complete pages")
+    {
+        const rr::TextureStreamCmd cmd { 1, pages, 0, 3 * PAGE_SIZE };
+        REQUIRE(rr::TextureStreamCmd::isThis(cmd.command()));
+        REQUIRE(rr::TextureStreamCmd::getNumberOfElementsInPayloadByCommand(cmd.command()) == 3);
+        CHECK(cmd.getTmu() == 1);
+        REQUIRE(cmd.payload().size() == 3);
+        for (std::size_t i = 0; i < pages.size(); i++)
+        {
+            CHECK(decode(cmd.payload()[i]).addr == pageAddr(pages[i]));
+            CHECK(decode(cmd.payload()[i]).blocks == 0);
+        }
+    }
+
+    SECTION("A partially used last page")
+    {
+        // One and a half blocks in the last page are rounded up to two blocks
+        const rr::TextureStreamCmd cmd { 0, pages, 0, (2 * PAGE_SIZE) + BLOCK_SIZE + (BLOCK_SIZE / 2) };
+        CHECK(cmd.getTmu() == 0);
+        REQUIRE(cmd.payload().size() == 3);
+        CHECK(decode(cmd.payload()[0]).blocks == 0);
+        CHECK(decode(cmd.payload()[1]).blocks == 0);
+        CHECK(decode(cmd.payload()[2]).addr == pageAddr(9));
+        CHECK(decode(cmd.payload()[2]).blocks == 2);
+    }
+
+    SECTION("A last page which is exactly full")
+    {
+        const rr::TextureStreamCmd cmd { 0, { pages.data(), 1 }, 0, PAGE_SIZE };
+        REQUIRE(cmd.payload().size() == 1);
+        CHECK(decode(cmd.payload()[0]).addr == pageAddr(5));
+        CHECK(decode(cmd.payload()[0]).blocks == 0);
+    }
+
+    SECTION("A last page which lacks one block")
+    {
+        const rr::TextureStreamCmd cmd { 0, { pages.data(), 1 }, 0, PAGE_SIZE - BLOCK_SIZE };
+        REQUIRE(cmd.payload().size() == 1);
+        CHECK(decode(cmd.payload()[0]).blocks == (BLOCKS_PER_PAGE - 1));
+    }
+}
+
+TEST_CASE("Encode a texture in a shared page", "[TextureStreamCmd]")
+{
+    const std::vector<std::size_t> pages { 7 };
+
+    SECTION("A small texture at a block offset")
+    {
+        const rr::TextureStreamCmd cmd { 0, pages, 2 * BLOCK_SIZE, BLOCK_SIZE + 1 };
+        REQUIRE(cmd.payload().size() == 1);
+        CHECK(decode(cmd.payload()[0]).addr == pageAddr(7, 2 * BLOCK_SIZE));
+        CHECK(decode(cmd.payload()[0]).blocks == 2);
+    }
+
+    SECTION("A texture which ends with the page")
+    {
+        const rr::TextureStreamCmd cmd { 0, pages, (BLOCKS_PER_PAGE - 1) * BLOCK_SIZE, BLOCK_SIZE };
+        REQUIRE(cmd.payload().size() == 1);
+        CHECK(decode(cmd.payload()[0]).addr == pageAddr(7, (BLOCKS_PER_PAGE - 1) * BLOCK_SIZE));
+        CHECK(decode(cmd.payload()[0]).blocks == 1);
+    }
+}
+
+TEST_CASE("Stream the levels of a texture which start within a page", "[TextureStreamCmd]")
+{
+    // The offset applies only to the first page. The following pages are streamed from their beginning.
+    const std::vector<std::size_t> pages { 3, 4 };
+    const rr::TextureStreamCmd cmd { 0, pages, BLOCK_SIZE, (PAGE_SIZE - BLOCK_SIZE) + BLOCK_SIZE };
+    REQUIRE(cmd.payload().size() == 2);
+    CHECK(decode(cmd.payload()[0]).addr == pageAddr(3, BLOCK_SIZE));
+    CHECK(decode(cmd.payload()[0]).blocks == (BLOCKS_PER_PAGE - 1));
+    CHECK(decode(cmd.payload()[1]).addr == pageAddr(4));
+    CHECK(decode(cmd.payload()[1]).blocks == 1);
+}
+
+TEST_CASE("Decode the command from the display list", "[TextureStreamCmd]")
+{
+    const std::vector<std::size_t> pages { 1, 8 };
+    const rr::TextureStreamCmd cmd { 1, pages, 0, PAGE_SIZE + BLOCK_SIZE };
+    const rr::TextureStreamCmd decoded { cmd.command(), cmd.payload(), true };
+    CHECK(decoded.command() == cmd.command());
+    CHECK(decoded.getTmu() == 1);
+    REQUIRE(decoded.payload().size() == 2);
+    CHECK(decoded.payload()[0] == cmd.payload()[0]);
+    CHECK(decoded.payload()[1] == cmd.payload()[1]);
+}
@@ -0,0 +1,499 @@
+// RasterIX
+// https://github.com/ToNi3141/RasterIX
+// Copyright (c) 2025 ToNi3141
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "catch.hpp"
+
+#include "renderer/registers/DepthBufferClearDepthReg.hpp"
+#include "renderer/registers/FogColorReg.hpp"
+#include "renderer/registers/FragmentPipelineReg.hpp"
+#include "renderer/threadedRasterizer/ThreadedRasterizer.hpp"
+#include "transform/Types.hpp"
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr std::size_t RESOLUTION_X { 320 };
+constexpr std::size_t RESOLUTION_Y { 240 };
+
+// Small source buffers and chunks, to split draws across full buffers and to process many partial display lists
+using TestThreadedRasterizer = rr::ThreadedRasterizer<2, 16 * 1024, 1024, 4>;
+// Tiny chunks and a short queue, to run often into a full queue and into a drained queue
+using ChunkedThreadedRasterizer = rr::ThreadedRasterizer<2, 16 * 1024, 64, 2>;
+using SourceAssembler = rr::displaylist::DisplayListAssembler<rr::RenderConfig::TMU_COUNT, rr::displaylist::DisplayList>;
+
+// Executes the operation in the calling thread
+class InlineThreadRunner : public rr::IThreadRunner
+{
+public:
+    void wait() override { }
+    void run(const std::function<void()>& operation) override { operation(); }
+};
+
+class ThreadRunner : public rr::IThreadRunner
+{
+public:
+    ~ThreadRunner() { wait(); }
+
+    void wait() override
+    {
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void run(const std::function<void()>& operation) override
+    {
+        wait();
+        m_thread = std::thread { operation };
+    }
+
+private:
+    std::thread m_thread {};
+};
+
+struct Recording
+{
+    // The display lists, one after another
+    std::vector<uint8_t> stream {};
+    // The start of every display list in the stream, and if it is the first list of an upload.
+    // An upload contains one display list per display line.
+    std::vector<std::pair<std::size_t, bool>> lists {};
+};
+
+// Records all display lists which the threaded rasterizer streams into the device
+class RecordingDevice : public rr::IDevice
+{
+public:
+    void streamDisplayList(const uint8_t index, const uint32_t size) override
+    {
+        recording.lists.push_back({ recording.stream.size(), m_newUpload });
+        m_newUpload = false;
+        recording.stream.insert(recording.stream.end(), m_buffers[index].begin(), m_buffers[index].begin() + size);
+    }
+    void streamPartialDisplayList(const uint8_t, const uint32_t, const bool) override { }
+    void writeToDeviceMemory(tcb::span<const uint8_t>, const uint32_t) override { }
+    tcb::span<uint8_t> requestWriteToDeviceMemory(const uint32_t, const uint32_t) override { return {}; }
+    void flushWritesToDeviceMemory() override { }
+    bool readFromDeviceMemory(tcb::span<uint8_t>, const uint32_t) override { return false; }
+    bool canReadFromDeviceMemory() const override { return false; }
+    void blockUntilDeviceIsIdle() override { m_newUpload = true; }
+    uint32_t insertFence() override { return 0; }
+    bool isFenceSignaled(const uint32_t) override { return true; }
+    void blockUntilFenceIsSignaled(const uint32_t) override { }
+    void blockUntilDisplayListBufferIsFree(const uint8_t) override { }
+    tcb::span<uint8_t> requestDisplayListBuffer(const uint8_t index) override { return { m_buffers[index] }; }
+    uint8_t getDisplayListBufferCount() const override { return m_buffers.size(); }
+
+    Recording recording {};
+
+private:
+    bool m_newUpload { true };
+    std::vector<std::vector<uint8_t>> m_buffers { rr::RenderConfig::getDisplayLines() * 2, std::vector<uint8_t>(1024 * 1024) };
+};
+
+// Writes the display lists like the Renderer does with threaded rasterization
+class SourceWriter
+{
+public:
+    SourceWriter(rr::IDevice& device)
+        : m_device { device }
+    {
+        m_assembler.setBuffer(m_device.requestDisplayListBuffer(m_index), m_index);
+    }
+
+    template <typename TCmd>
+    void add(const TCmd& cmd)
+    {
+        if (!m_assembler.addCommand(cmd))
+        {
+            upload();
+            REQUIRE(m_assembler.addCommand(cmd));
+        }
+    }
+
+    void setVertexCtx(const rr::vertextransforming::VertexTransformingData& ctx)
+    {
+        partialUpload(false);
+        add(rr::SetVertexCtxCmd { ctx });
+    }
+
+    void partialUpload(const bool force)
+    {
+        m_device.streamPartialDisplayList(m_index, m_assembler.getDisplayListSize(), force);
+    }
+
+    void upload()
+    {
+        m_device.streamDisplayList(m_index, m_assembler.getDisplayListSize());
+        m_index = (m_index + 1) % m_device.getDisplayListBufferCount();
+        m_assembler.setBuffer(m_device.requestDisplayListBuffer(m_index), m_index);
+        m_assembler.clearAssembler();
+    }
+
+private:
+    rr::IDevice& m_device;
+    SourceAssembler m_assembler {};
+    uint8_t m_index { 0 };
+};
+
+template <typename TReg>
+TReg createXYReg(const uint16_t x, const uint16_t y)
+{
+    TReg reg {};
+    reg.setX(x);
+    reg.setY(y);
+    return reg;
+}
+
+rr::vertextransforming::VertexTransformingData createCtx(const rr::DrawMode mode, const bool culling)
+{
+    rr::vertextransforming::VertexTransformingData ctx {};
+    ctx.transformMatrices.modelViewProjection.identity();
+    ctx.transformMatrices.modelView.identity();
+    ctx.transformMatrices.projection.identity();
+    ctx.transformMatrices.normal.identity();
+    ctx.transformMatrices.color.identity();
+    for (rr::Mat44& m : ctx.transformMatrices.texture)
+    {
+        m.identity();
+    }
+    ctx.viewPort.viewportWidth = RESOLUTION_X;
+    ctx.viewPort.viewportHeight = RESOLUTION_Y;
+    ctx.viewPort.viewportWidthHalf = RESOLUTION_X / 2;
+    ctx.viewPort.viewportHeightHalf = RESOLUTION_Y / 2;
+    ctx.culling.enableCulling = culling;
+    ctx.primitiveAssembler.mode = mode;
+    ctx.tmuEnabled.set();
+    return ctx;
+}
+
+class FrameGenerator
+{
+public:
+    // Writes a frame with register writes between the draws and a draw which is split across a full buffer
+    void writeFrame(SourceWriter& writer)
+    {
+        writer.add(rr::WriteRegisterCmd { createXYReg<rr::RenderResolutionReg>(RESOLUTION_X, RESOLUTION_Y) });
+        writer.add(rr::WriteRegisterCmd { rr::YOffsetReg { 0, 0 } });
+        writer.add(rr::WriteRegisterCmd { rr::DepthBufferClearDepthReg { 65535 } });
+        clear(writer);
+
+        for (std::size_t i = 0; i < 150; i++)
+        {
+            writeRegisters(writer);
+            if (m_select(m_rng) < 0.05f)
+            {
+                clear(writer);
+            }
+            if (m_select(m_rng) < 0.05f)
+            {
+                // glFlush
+                writer.partialUpload(true);
+            }
+            const rr::DrawMode mode = (m_select(m_rng) < 0.5f) ? rr::DrawMode::TRIANGLES : rr::DrawMode::TRIANGLE_STRIP;
+            // The long draw does not fit into the rest of the source buffer and is continued in the next one
+            const std::size_t vertices = (i == 100) ? 900 : (3 + (m_rng() % 30));
+            writeDraw(writer, createCtx(mode, m_select(m_rng) < 0.3f), vertices);
+        }
+
+        rr::FramebufferCmd commit { true, true, true, RESOLUTION_X * RESOLUTION_Y };
+        commit.commitFramebuffer();
+        writer.add(commit);
+        writer.add(rr::WriteRegisterCmd { rr::ColorBufferAddrReg { 0x1000 } });
+        rr::FramebufferCmd swap { false, false, false, RESOLUTION_X * RESOLUTION_Y };
+        swap.selectColorBuffer();
+        swap.swapFramebuffer();
+        writer.add(swap);
+        writer.upload();
+    }
+
+private:
+    void clear(SourceWriter& writer)
+    {
+        rr::FramebufferCmd cmd { true, true, false, RESOLUTION_X * RESOLUTION_Y };
+        cmd.enableMemset();
+        writer.add(cmd);
+    }
+
+    void writeRegisters(SourceWriter& writer)
+    {
+        if (m_select(m_rng) < 0.3f)
+        {
+            // Scissor, TMU and the depth test, which enables the coarse depth buffer
+            rr::FeatureEnableReg reg {};
+            reg.setEnableScissor(m_select(m_rng) < 0.3f);
+            reg.setEnableDepthTest(m_select(m_rng) < 0.7f);
+            for (std::size_t tmu = 0; tmu < rr::RenderConfig::TMU_COUNT; tmu++)
+            {
+                reg.setEnableTmu(tmu, m_select(m_rng) < 0.5f);
+            }
+            writer.add(rr::WriteRegisterCmd { reg });
+        }
+        if (m_select(m_rng) < 0.2f)
+        {
+            const uint16_t x = m_rng() % RESOLUTION_X;
+            const uint16_t y = m_rng() % RESOLUTION_Y;
+            writer.add(rr::WriteRegisterCmd { createXYReg<rr::ScissorStartReg>(x, y) });
+            writer.add(rr::WriteRegisterCmd { createXYReg<rr::ScissorEndReg>(x + (m_rng() % RESOLUTION_X), y + (m_rng() % RESOLUTION_Y)) });
+        }
+        if (m_select(m_rng) < 0.2f)
+        {
+            // The register leaves its unused bits uninitialized. Clear them, otherwise they differ between the runs.
+            rr::FragmentPipelineReg reg {};
+            reg.deserialize(reg.serialize() & ((1u << 27) - 1));
+            reg.setDepthFunc((m_select(m_rng) < 0.7f) ? rr::TestFunc::LESS : rr::TestFunc::ALWAYS);
+            reg.setDepthMask(m_select(m_rng) < 0.8f);
+            writer.add(rr::WriteRegisterCmd { reg });
+        }
+        if (m_select(m_rng) < 0.2f)
+        {
+            // A register which does not change the rasterizer
+            writer.add(rr::WriteRegisterCmd { rr::FogColorReg { rr::Vec4i { 1, 2, 3, 4 } } });
+        }
+    }
+
+    void writeDraw(SourceWriter& writer, const rr::vertextransforming::VertexTransformingData& ctx, const std::size_t vertices)
+    {
+        writer.setVertexCtx(ctx);
+        for (std::size_t i = 0; i < vertices; i++)
+        {
+            rr::VertexParameter vertex {};
+            vertex.vertex = rr::Vec4 { m_position(m_rng), m_position(m_rng), m_depth(m_rng), 1.0f };
+            vertex.color = rr::Vec4 { m_select(m_rng), m_select(m_rng), m_select(m_rng), m_select(m_rng) };
+            for (rr::Vec4& tex : vertex.tex)
+            {
+                tex = rr::Vec4 { m_select(m_rng), m_select(m_rng), 0.0f, 1.0f };
+            }
+            writer.add(rr::PushVertexCmd { vertex });
+        }
+    }
+
+    std::mt19937 m_rng { 7 };
+    std::uniform_real_distribution<float> m_select { 0.0f, 1.0f };
+    std::uniform_real_distribution<float> m_position { -1.2f, 1.2f };
+    std::uniform_real_distribution<float> m_depth { -1.0f, 1.0f };
+};
+
+template <typename TRasterizer>
+Recording render(const std::size_t vertexThreadCount, const bool threadedWorker, const std::size_t frames)
+{
+    RecordingDevice device {};
+    std::unique_ptr<rr::IThreadRunner> uploadThread {};
+    std::unique_ptr<rr::IThreadRunner> workerThread {};
+    if (threadedWorker)
+    {
+        uploadThread = std::make_unique<ThreadRunner>();
+        workerThread = std::make_unique<ThreadRunner>();
+    }
+    else
+    {
+        uploadThread = std::make_unique<InlineThreadRunner>();
+        workerThread = std::make_unique<InlineThreadRunner>();
+    }
+    std::vector<std::unique_ptr<ThreadRunner>> vertexThreadStorage {};
+    std::vector<rr::IThreadRunner*> vertexThreads {};
+    for (std::size_t i = 0; i < vertexThreadCount; i++)
+    {
+        vertexThreadStorage.push_back(std::make_unique<ThreadRunner>());
+        vertexThreads.push_back(vertexThreadStorage.back().get());
+    }
+
+    std::unique_ptr<TRasterizer> rasterizer = std::make_unique<TRasterizer>(device, *uploadThread, *workerThread, vertexThreads);
+    SourceWriter writer { *rasterizer };
+    FrameGenerator generator {};
+    for (std::size_t i = 0; i < frames; i++)
+    {
+        generator.writeFrame(writer);
+    }
+    rasterizer->deinit();
+    return device.recording;
+}
+
+Recording render(const std::size_t vertexThreadCount)
+{
+    return render<TestThreadedRasterizer>(vertexThreadCount, false, 2);
+}
+
+template <typename TCmd>
+void skipCmd(rr::displaylist::DisplayList& list)
+{
+    using PayloadType = typename std::remove_const<typename std::remove_reference<decltype(TCmd {}.payload()[0])>::type>::type;
+    const typename TCmd::CommandType* op = list.getNext<typename TCmd::CommandType>();
+    const std::size_t numberOfElements = TCmd::getNumberOfElementsInPayloadByCommand(*op);
+    for (std::size_t i = 0; i < numberOfElements; i++)
+    {
+        list.getNext<PayloadType>();
+    }
+}
+
+// Skips all commands except the triangle stream command, which the threaded rasterizer streams
+void skipOtherCmd(rr::displaylist::DisplayList& list)
+{
+    const uint32_t op = *(list.lookAhead<uint32_t>());
+    if (rr::WriteRegisterCmd<rr::BaseColorReg>::isThis(op))
+    {
+        skipCmd<rr::WriteRegisterCmd<rr::BaseColorReg>>(list);
+    }
+    else if (rr::FramebufferCmd::isThis(op))
+    {
+        skipCmd<rr::FramebufferCmd>(list);
+    }
+    else if (rr::NopCmd::isThis(op))
+    {
+        skipCmd<rr::NopCmd>(list);
+    }
+    else
+    {
+        FAIL("Unexpected command in the display list");
+    }
+}
+
+rr::displaylist::DisplayList createList(std::vector<uint8_t>& stream)
+{
+    rr::displaylist::DisplayList list {};
+    list.setBuffer(stream);
+    list.setCurrentSize(stream.size());
+    return list;
+}
+
+std::size_t countTriangles(std::vector<uint8_t> stream)
+{
+    rr::displaylist::DisplayList list = createList(stream);
+    std::size_t triangles = 0;
+    while (!list.atEnd())
+    {
+        if (rr::TriangleStreamCmd::isThis(*(list.lookAhead<uint32_t>())))
+        {
+            skipCmd<rr::TriangleStreamCmd>(list);
+            triangles++;
+        }
+        else
+        {
+            skipOtherCmd(list);
+        }
+    }
+    return triangles;
+}
+
+// Returns the offset of the first command which differs in the recordings, or the stream size if they are equal.
+// The rasterizer does not set up the texture attributes of a disabled TMU. They contain what the triangle
+// storage contained before and are ignored like in the hardware.
+std::size_t findFirstDifference(Recording recA, Recording recB)
+{
+    if (recA.lists != recB.lists)
+    {
+        return 0;
+    }
+    rr::displaylist::DisplayList a = createList(recA.stream);
+    rr::displaylist::DisplayList b = createList(recB.stream);
+    // Every display list of an upload starts with the register state of the end of the previous upload
+    rr::FeatureEnableReg uploadFeatures {};
+    rr::FeatureEnableReg features {};
+    std::size_t nextList = 0;
+    while (!a.atEnd() && !b.atEnd())
+    {
+        const std::size_t pos = a.getCurrentReadPos();
+        for (; (nextList < recA.lists.size()) && (recA.lists[nextList].first == pos); nextList++)
+        {
+            if (recA.lists[nextList].second)
+            {
+                uploadFeatures = features;
+            }
+            features = uploadFeatures;
+        }
+        const uint32_t op = *(a.lookAhead<uint32_t>());
+        if ((pos != b.getCurrentReadPos()) || (op != *(b.lookAhead<uint32_t>())))
+        {
+            return pos;
+        }
+        if (rr::TriangleStreamCmd::isThis(op))
+        {
+            a.getNext<uint32_t>();
+            b.getNext<uint32_t>();
+            const rr::TriangleStreamTypes::TriangleDesc* descA = a.getNext<rr::TriangleStreamTypes::TriangleDesc>();
+            const rr::TriangleStreamTypes::TriangleDesc* descB = b.getNext<rr::TriangleStreamTypes::TriangleDesc>();
+            if (memcmp(&descA->param, &descB->param, sizeof(descA->param)) != 0)
+            {
+                return pos;
+            }
+            for (std::size_t i = 0; i < rr::RenderConfig::TMU_COUNT; i++)
+            {
+                if (features.getEnableTmu(i) && (memcmp(&descA->texture[i], &descB->texture[i], sizeof(descA->texture[i])) != 0))
+                {
+                    return pos;
+                }
+            }
+        }
+        else
+        {
+            skipOtherCmd(a);
+            skipOtherCmd(b);
+            if (memcmp(&recA.stream[pos], &recB.stream[pos], a.getCurrentReadPos() - pos) != 0)
+            {
+                return pos;
+            }
+            if (rr::WriteRegisterCmd<rr::FeatureEnableReg>::isThis(op)
+                && (rr::WriteRegisterCmd<rr::FeatureEnableReg>::getRegAddr(op) == rr::FeatureEnableReg::getAddr()))
+            {
+                features.deserialize(*reinterpret_cast<const uint32_t*>(&recA.stream[pos + rr::displaylist::DisplayList::sizeOf<uint32_t>()]));
+            }
+        }
+    }
+    return (a.atEnd() && b.atEnd()) ? recA.stream.size() : a.getCurrentReadPos();
+}
+
+} // namespace
+
+TEST_CASE("Parallel vertex processing streams the same display lists as the sequential decoding", "[ThreadedRasterizer]")
+{
+    const Recording sequential = render(0);
+    // Make sure that the frames contain a relevant number of triangles
+    REQUIRE(countTriangles(sequential.stream) > 1000);
+
+    SECTION("One vertex thread")
+    {
+        const Recording parallel = render(1);
+        REQUIRE(parallel.stream.size() == sequential.stream.size());
+        REQUIRE(findFirstDifference(parallel, sequential) == sequential.stream.size());
+    }
+    SECTION("Three vertex threads")
+    {
+        const Recording parallel = render(3);
+        REQUIRE(parallel.stream.size() == sequential.stream.size());
+        REQUIRE(findFirstDifference(parallel, sequential) == sequential.stream.size());
+    }
+}
+
+TEST_CASE("A worker thread decodes the chunks of the display lists in order", "[ThreadedRasterizer]")
+{
+    // The worker returns, when it has drained the queue, and is restarted by the next chunk. Many frames with
+    // tiny chunks make it likely, that a chunk is pushed while the worker is about to return.
+    const Recording sequential = render<ChunkedThreadedRasterizer>(0, false, 6);
+    for (std::size_t i = 0; i < 5; i++)
+    {
+        const Recording threaded = render<ChunkedThreadedRasterizer>(0, true, 6);
+        REQUIRE(threaded.stream.size() == sequential.stream.size());
+        REQUIRE(findFirstDifference(threaded, sequential) == sequential.stream.size());
+    }
+}
@@ -56,6 +56,7 @@ module TextureSamplerTestModule #(
 
     // Texture Write
     input  wire                         s_axis_tvalid,
+    output wire                         s_axis_tready,
     input  wire                         s_axis_tlast,
     input  wire [STREAM_WIDTH - 1 : 0]  s_axis_tdata
 );
@@ -76,6 +77,8 @@ module TextureSamplerTestModule #(
         .resetn(resetn),
 
         .confPixelFormat(confPixelFormat),
+        .confTextureSizeWidth(textureSizeWidth),
+        .confTextureSizeHeight(textureSizeHeight),
 
         .texelAddr00(texelAddr00),
         .texelAddr01(texelAddr01),
@@ -88,6 +91,7 @@ module TextureSamplerTestModule #(
         .texelOutput11(texelInput11),
 
         .s_axis_tvalid(s_axis_tvalid),
+        .s_axis_tready(s_axis_tready),
         .s_axis_tlast(s_axis_tlast),
         .s_axis_tdata(s_axis_tdata)
     );